@@ -0,0 +1,409 @@
+#include "app/App.h"
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/GpuTimer.h"
+#include "graphics/ShaderManager.h"
+#include "graphics/TextureManager.h"
+#include "graphics/VertexArrayManager.h"
+#include "graphics/device/RecordingDevice.h"
+#include "graphics/device/StateTracker.h"
+#include "graphics/scene/ModelImporter.h"
+#include "graphics/scene/RenderQueue.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchReport.h"
+#include "BenchScenarios.h"
+#include "TimedPipeline.h"
+
+using namespace RyuRenderer;
+using namespace RyuRenderer::Bench;
+
+static void PrintUsage()
+{
+    std::cout <<
+        "Usage:\n"
+        "  ryu-bench list\n"
+        "  ryu-bench run [--scenario <name>]... [--warmup <frames>] [--frames <frames>] [--fixed-dt <seconds>]\n"
+        "                [--width <pixels>] [--height <pixels>] [--window] [--samples] [--output <file.json>]\n"
+        "                [--trace <trace.json>]\n"
+        "  ryu-bench compare <baseline.json> <current.json> [--threshold <ratio>]\n"
+        "  ryu-bench load-scaling <model file> [--repeat <times>]\n";
+}
+
+static int RunList()
+{
+    for (const auto& s : GetScenarios())
+        std::cout << s.Name << "\t" << s.Description << std::endl;
+    return 0;
+}
+
+static void RunOnApp(
+    const BenchScenario& s,
+    unsigned long long warmupFrameAmount,
+    unsigned long long measuredFrameAmount,
+    BenchScenarioResult& result)
+{
+    auto pipeline = s.CreatePipeline();
+    TimedPipeline timed(pipeline.get(), warmupFrameAmount, measuredFrameAmount);
+    App::App::GetInstance().Run(&timed);
+    // Handlers registered by this pipeline must not outlive it
+    App::App::GetInstance().EventPublisher.Clear();
+
+    result.FrameTimeSamplesInMs = std::move(timed.FrameTimeSamplesInMs);
+    result.TickTimeSamplesInMs = std::move(timed.TickTimeSamplesInMs);
+}
+
+static void RunOnNullDevice(
+    const BenchScenario& s,
+    unsigned long long warmupFrameAmount,
+    unsigned long long measuredFrameAmount,
+    double deltaTimeInS,
+    BenchScenarioResult& result)
+{
+    // Cached resources belong to the previous device, release them there
+    Graphics::ShaderManager::GetInstance().Clear();
+    Graphics::TextureManager::GetInstance().Clear();
+    Graphics::Scene::RenderQueue::GetInstance().ReleaseBuffers();
+    Graphics::GeometryPool::GetInstance().Clear();
+    Graphics::VertexArrayManager::GetInstance().Clear();
+
+    auto device = std::make_shared<Graphics::Device::RecordingDevice>();
+    Graphics::Device::IDevice::SetCurrent(device);
+    {
+        auto pipeline = s.CreatePipeline();
+        TimedPipeline timed(pipeline.get(), warmupFrameAmount, measuredFrameAmount);
+        timed.Init();
+
+        const unsigned long long totalFrameAmount = warmupFrameAmount + measuredFrameAmount + 1;
+        for (unsigned long long i = 0; i < totalFrameAmount; ++i)
+        {
+            if (i == warmupFrameAmount)
+            {
+                device->Reset();
+                Graphics::Device::StateTracker::GetInstance().ResetCallAmounts();
+                Graphics::Scene::RenderQueue::GetInstance().ResetCallAmounts();
+            }
+            if (i == warmupFrameAmount + measuredFrameAmount)
+            {
+                result.IsNullDevice = true;
+                result.CommandsPerFrame = static_cast<double>(device->GetTotalCommandAmount()) / measuredFrameAmount;
+                result.DrawCallsPerFrame = static_cast<double>(device->GetDrawCallAmount()) / measuredFrameAmount;
+                result.StateChangesPerFrame = static_cast<double>(device->GetStateChangeAmount()) / measuredFrameAmount;
+                result.UniformUploadsPerFrame = static_cast<double>(device->GetUniformUploadAmount()) / measuredFrameAmount;
+                result.ElidedStateCallsPerFrame = static_cast<double>(Graphics::Device::StateTracker::GetInstance().GetElidedCallAmount()) / measuredFrameAmount;
+                result.SortSavedStateChangesPerFrame = static_cast<double>(Graphics::Scene::RenderQueue::GetInstance().GetSavedStateChangeAmount()) / measuredFrameAmount;
+                result.VisibleObjectsPerFrame = static_cast<double>(Graphics::Scene::RenderQueue::GetInstance().GetVisibleObjectAmount()) / measuredFrameAmount;
+                result.CulledObjectsPerFrame = static_cast<double>(Graphics::Scene::RenderQueue::GetInstance().GetCulledObjectAmount()) / measuredFrameAmount;
+
+                const auto poolStats = Graphics::GeometryPool::GetInstance().GetStats();
+                result.GeometryPoolCapacityBytes = poolStats.CapacityBytes;
+                result.GeometryPoolUsedBytes = poolStats.UsedBytes;
+                result.GeometryPoolFragmentation = poolStats.Fragmentation;
+            }
+            {
+                RYU_PROFILE_ZONE("Frame");
+                Graphics::GpuTimer::GetInstance().BeginFrame();
+                Graphics::TextureManager::GetInstance().UpdateUploads();
+                timed.Tick(deltaTimeInS);
+            }
+            RYU_PROFILE_COLLECT();
+        }
+
+        result.FrameTimeSamplesInMs = std::move(timed.FrameTimeSamplesInMs);
+        result.TickTimeSamplesInMs = std::move(timed.TickTimeSamplesInMs);
+    }
+    Graphics::GpuTimer::GetInstance().Clear();
+    Graphics::ShaderManager::GetInstance().Clear();
+    Graphics::TextureManager::GetInstance().Clear();
+    Graphics::Scene::RenderQueue::GetInstance().ReleaseBuffers();
+    Graphics::GeometryPool::GetInstance().Clear();
+    Graphics::VertexArrayManager::GetInstance().Clear();
+    Graphics::Device::IDevice::SetCurrent(nullptr);
+}
+
+static int RunScenarios(int argc, char* argv[])
+{
+    std::vector<std::string> scenarioNames;
+    std::string outputPath;
+    std::string tracePath;
+    bool isWritingSamples = false;
+
+    App::AppSettings settings;
+    settings.WindowName = "Ryu Bench";
+    settings.Backend = App::AppSettings::BackendType::BACKEND_HEADLESS;
+    settings.VSyncInterval = 0;
+    settings.HideCursor = false;
+    settings.LockCursorToCenter = false;
+    settings.FixedDeltaTimeInS = 1.0 / 60.0;
+
+    unsigned long long warmupFrameAmount = 60;
+    unsigned long long measuredFrameAmount = 600;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--scenario" && i + 1 < argc)
+            scenarioNames.emplace_back(argv[++i]);
+        else if (arg == "--warmup" && i + 1 < argc)
+            warmupFrameAmount = std::stoull(argv[++i]);
+        else if (arg == "--frames" && i + 1 < argc)
+            measuredFrameAmount = std::stoull(argv[++i]);
+        else if (arg == "--fixed-dt" && i + 1 < argc)
+            settings.FixedDeltaTimeInS = std::stod(argv[++i]);
+        else if (arg == "--width" && i + 1 < argc)
+            settings.WindowWidth = std::stoi(argv[++i]);
+        else if (arg == "--height" && i + 1 < argc)
+            settings.WindowHeight = std::stoi(argv[++i]);
+        else if (arg == "--window")
+            settings.Backend = App::AppSettings::BackendType::BACKEND_WINDOW;
+        else if (arg == "--samples")
+            isWritingSamples = true;
+        else if (arg == "--output" && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else
+        {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            PrintUsage();
+            return 2;
+        }
+    }
+
+    if (measuredFrameAmount == 0)
+    {
+        std::cerr << "Measured frame amount must be greater than 0" << std::endl;
+        return 2;
+    }
+
+    std::vector<const BenchScenario*> scenarios;
+    if (scenarioNames.empty())
+    {
+        for (const auto& s : GetScenarios())
+            scenarios.emplace_back(&s);
+    }
+    for (const auto& name : scenarioNames)
+    {
+        const BenchScenario* s = FindScenario(name);
+        if (!s)
+        {
+            std::cerr << "Unknown scenario: " << name << std::endl;
+            return 2;
+        }
+        scenarios.emplace_back(s);
+    }
+
+    // Context scenarios go first, resources created on the recording device must never reach a GL context
+    std::stable_partition(scenarios.begin(), scenarios.end(), [](const BenchScenario* s) { return !s->IsNullDevice; });
+    bool isContextNeeded = std::any_of(scenarios.begin(), scenarios.end(), [](const BenchScenario* s) { return !s->IsNullDevice; });
+
+    if (!tracePath.empty())
+    {
+#ifndef RYU_ENABLE_PROFILER
+        std::cerr << "Profiler zones are compiled out (RYU_ENABLE_PROFILER=OFF), the trace will be empty" << std::endl;
+#endif
+        Common::Profiler::GetInstance().SetThreadName("Main");
+        Common::Profiler::GetInstance().IsCapturing = true;
+    }
+
+    // One more frame closes the interval of the last measured frame
+    settings.MaxFrameAmount = warmupFrameAmount + measuredFrameAmount + 1;
+    if (isContextNeeded && !App::App::GetInstance().Init(settings))
+        return 2;
+
+    BenchReport report;
+    if (isContextNeeded)
+    {
+        report.Backend = App::App::GetInstance().IsHeadless() ? "headless" : "window";
+        report.Width = App::App::GetInstance().GetWindowWidth();
+        report.Height = App::App::GetInstance().GetWindowHeight();
+    }
+    else
+    {
+        report.Backend = "null";
+    }
+    report.WarmupFrameAmount = warmupFrameAmount;
+    report.MeasuredFrameAmount = measuredFrameAmount;
+    report.FixedDeltaTimeInS = settings.FixedDeltaTimeInS;
+
+    for (const BenchScenario* s : scenarios)
+    {
+        std::clog << "Running scenario: " << s->Name << std::endl;
+
+        BenchScenarioResult result;
+        result.Name = s->Name;
+        if (s->IsNullDevice)
+            RunOnNullDevice(*s, warmupFrameAmount, measuredFrameAmount, settings.FixedDeltaTimeInS, result);
+        else
+            RunOnApp(*s, warmupFrameAmount, measuredFrameAmount, result);
+
+        result.FrameAmount = result.FrameTimeSamplesInMs.size();
+        // A window closed early leaves less samples than requested
+        result.IsPassed = result.FrameAmount == measuredFrameAmount;
+        result.FrameTimeInMs = BenchStatistics::Compute(result.FrameTimeSamplesInMs);
+        result.TickTimeInMs = BenchStatistics::Compute(result.TickTimeSamplesInMs);
+
+        std::clog << "    frame p50 " << result.FrameTimeInMs.P50
+                  << " ms, p99 " << result.FrameTimeInMs.P99
+                  << " ms, tick p50 " << result.TickTimeInMs.P50 << " ms" << std::endl;
+        if (result.IsNullDevice)
+        {
+            std::clog << "    " << result.CommandsPerFrame << " commands, "
+                      << result.DrawCallsPerFrame << " draw calls, "
+                      << result.ElidedStateCallsPerFrame << " elided state calls, "
+                      << result.SortSavedStateChangesPerFrame << " state changes saved by sorting per frame" << std::endl;
+            std::clog << "    " << result.VisibleObjectsPerFrame << " visible, "
+                      << result.CulledObjectsPerFrame << " culled objects per frame" << std::endl;
+            std::clog << "    geometry pool " << result.GeometryPoolUsedBytes << " / " << result.GeometryPoolCapacityBytes
+                      << " bytes used, fragmentation " << result.GeometryPoolFragmentation << std::endl;
+        }
+
+        report.Scenarios.emplace_back(std::move(result));
+    }
+
+    if (!tracePath.empty() && !Common::Profiler::GetInstance().DumpChromeTrace(tracePath))
+        return 2;
+
+    if (outputPath.empty())
+        report.WriteJson(std::cout, isWritingSamples);
+    else if (!report.WriteJsonFile(outputPath, isWritingSamples))
+        return 2;
+
+    for (const auto& r : report.Scenarios)
+    {
+        if (!r.IsPassed)
+            return 1;
+    }
+    return 0;
+}
+
+static int RunCompare(int argc, char* argv[])
+{
+    std::vector<std::string> paths;
+    double threshold = 0.05;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--threshold" && i + 1 < argc)
+            threshold = std::stod(argv[++i]);
+        else
+            paths.emplace_back(arg);
+    }
+
+    if (paths.size() != 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    BenchReport baseline;
+    BenchReport current;
+    if (!baseline.ReadJsonFile(paths[0]) || !current.ReadJsonFile(paths[1]))
+        return 2;
+
+    if (baseline.Backend != current.Backend ||
+        baseline.Width != current.Width ||
+        baseline.Height != current.Height)
+        std::clog << "Warning: reports were recorded with different settings" << std::endl;
+
+    bool isPassed = CompareReports(baseline, current, threshold, std::cout);
+    std::cout << (isPassed ? "PASSED" : "REGRESSED") << std::endl;
+    return isPassed ? 0 : 1;
+}
+
+// CPU stage of Scene::Load with 1, 2, 4... threads up to the whole pool, best of the repeats.
+//     GL upload and batch merging stay serial and are not part of it
+static int RunLoadScaling(int argc, char* argv[])
+{
+    std::string modelFilePath;
+    unsigned long long repeatAmount = 3;
+
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc)
+            repeatAmount = std::max(std::stoull(argv[++i]), 1ull);
+        else
+            modelFilePath = arg;
+    }
+
+    if (modelFilePath.empty())
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    const size_t maxThreadAmount = Common::ThreadPool::GetInstance().GetThreadAmount() + 1;
+    std::vector<size_t> threadAmounts;
+    for (size_t t = 1; t < maxThreadAmount; t *= 2)
+        threadAmounts.push_back(t);
+    threadAmounts.push_back(maxThreadAmount);
+
+    const Graphics::MeshOptimizationSettings optimization;
+    const Graphics::MeshLodSettings lod;
+    std::vector<uint64_t> baselineHashes;
+    double baselineTimeInMs = 0.0;
+    bool isIdentical = true;
+
+    std::cout << "threads\tread ms\tprocess ms\tspeedup\tidentical" << std::endl;
+    for (size_t threadAmount : threadAmounts)
+    {
+        Graphics::Scene::ModelImportStats best;
+        std::vector<uint64_t> hashes;
+        for (unsigned long long r = 0; r < repeatAmount; ++r)
+        {
+            Graphics::Scene::ImportedModel model;
+            Graphics::Scene::ModelImportStats stats;
+            if (!Graphics::Scene::ModelImporter::Import(modelFilePath, optimization, lod, model, threadAmount, &stats))
+                return 2;
+            if (r == 0 || stats.ProcessTimeInMs < best.ProcessTimeInMs)
+                best = stats;
+
+            hashes.clear();
+            for (const auto& im : model.Meshes)
+                hashes.push_back(im.ContentHash);
+        }
+
+        if (baselineHashes.empty())
+        {
+            baselineHashes = hashes;
+            baselineTimeInMs = best.ProcessTimeInMs;
+        }
+        const bool isMatch = hashes == baselineHashes;
+        isIdentical = isIdentical && isMatch;
+        std::cout << threadAmount << "\t" << std::fixed << std::setprecision(2) << best.ReadTimeInMs
+            << "\t" << best.ProcessTimeInMs << "\t" << baselineTimeInMs / std::max(best.ProcessTimeInMs, 1e-6)
+            << "\t" << (isMatch ? "yes" : "no") << std::endl;
+    }
+    return isIdentical ? 0 : 1;
+}
+
+// Exit code: 0 passed, 1 regressed or scenario incomplete, 2 usage or environment error
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+
+    std::string mode = argv[1];
+    if (mode == "list")
+        return RunList();
+    if (mode == "run")
+        return RunScenarios(argc, argv);
+    if (mode == "compare")
+        return RunCompare(argc, argv);
+    if (mode == "load-scaling")
+        return RunLoadScaling(argc, argv);
+
+    PrintUsage();
+    return 2;
+}
\ No newline at end of file
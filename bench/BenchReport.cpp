@@ -0,0 +1,254 @@
+#include "BenchReport.h"
+
+#include "boost/property_tree/json_parser.hpp"
+#include "boost/property_tree/ptree.hpp"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace RyuRenderer::Bench
+{
+    static std::string EscapeJson(const std::string& str)
+    {
+        std::string rtn;
+        rtn.reserve(str.size());
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+                rtn += '\\';
+            rtn += c;
+        }
+        return rtn;
+    }
+
+    static void WriteStatistics(std::ostream& os, const BenchStatistics& s)
+    {
+        os << "{ \"mean\": " << s.Mean
+           << ", \"p50\": " << s.P50
+           << ", \"p95\": " << s.P95
+           << ", \"p99\": " << s.P99
+           << ", \"max\": " << s.Max << " }";
+    }
+
+    static void WriteSamples(std::ostream& os, const std::vector<double>& samples)
+    {
+        os << "[";
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            if (i > 0)
+                os << ", ";
+            os << samples[i];
+        }
+        os << "]";
+    }
+
+    static BenchStatistics ReadStatistics(const boost::property_tree::ptree& tree)
+    {
+        BenchStatistics s;
+        s.Mean = tree.get<double>("mean", 0.0);
+        s.P50 = tree.get<double>("p50", 0.0);
+        s.P95 = tree.get<double>("p95", 0.0);
+        s.P99 = tree.get<double>("p99", 0.0);
+        s.Max = tree.get<double>("max", 0.0);
+        return s;
+    }
+
+    void BenchReport::WriteJson(std::ostream& os, bool isWritingSamples) const
+    {
+        auto oldFlags = os.flags();
+        auto oldPrecision = os.precision();
+        os << std::fixed << std::setprecision(6);
+
+        os << "{\n";
+        os << "  \"settings\": {\n";
+        os << "    \"backend\": \"" << EscapeJson(Backend) << "\",\n";
+        os << "    \"width\": " << Width << ",\n";
+        os << "    \"height\": " << Height << ",\n";
+        os << "    \"warmupFrames\": " << WarmupFrameAmount << ",\n";
+        os << "    \"measuredFrames\": " << MeasuredFrameAmount << ",\n";
+        os << "    \"fixedDeltaTimeS\": " << FixedDeltaTimeInS << "\n";
+        os << "  },\n";
+        os << "  \"scenarios\": [";
+        for (size_t i = 0; i < Scenarios.size(); ++i)
+        {
+            const auto& r = Scenarios[i];
+            os << (i > 0 ? ",\n" : "\n");
+            os << "    {\n";
+            os << "      \"name\": \"" << EscapeJson(r.Name) << "\",\n";
+            os << "      \"passed\": " << (r.IsPassed ? "true" : "false") << ",\n";
+            os << "      \"frames\": " << r.FrameAmount << ",\n";
+            os << "      \"frameTimeMs\": ";
+            WriteStatistics(os, r.FrameTimeInMs);
+            os << ",\n";
+            os << "      \"tickTimeMs\": ";
+            WriteStatistics(os, r.TickTimeInMs);
+            if (r.IsNullDevice)
+            {
+                os << ",\n      \"device\": { \"commandsPerFrame\": " << r.CommandsPerFrame
+                   << ", \"drawCallsPerFrame\": " << r.DrawCallsPerFrame
+                   << ", \"stateChangesPerFrame\": " << r.StateChangesPerFrame
+                   << ", \"uniformUploadsPerFrame\": " << r.UniformUploadsPerFrame
+                   << ", \"elidedStateCallsPerFrame\": " << r.ElidedStateCallsPerFrame
+                   << ", \"sortSavedStateChangesPerFrame\": " << r.SortSavedStateChangesPerFrame
+                   << ", \"visibleObjectsPerFrame\": " << r.VisibleObjectsPerFrame
+                   << ", \"culledObjectsPerFrame\": " << r.CulledObjectsPerFrame
+                   << ", \"geometryPoolCapacityBytes\": " << r.GeometryPoolCapacityBytes
+                   << ", \"geometryPoolUsedBytes\": " << r.GeometryPoolUsedBytes
+                   << ", \"geometryPoolFragmentation\": " << r.GeometryPoolFragmentation << " }";
+            }
+            if (isWritingSamples)
+            {
+                os << ",\n      \"frameTimeSamplesMs\": ";
+                WriteSamples(os, r.FrameTimeSamplesInMs);
+                os << ",\n      \"tickTimeSamplesMs\": ";
+                WriteSamples(os, r.TickTimeSamplesInMs);
+            }
+            os << "\n    }";
+        }
+        os << (Scenarios.empty() ? "]\n" : "\n  ]\n");
+        os << "}\n";
+
+        os.flags(oldFlags);
+        os.precision(oldPrecision);
+    }
+
+    bool BenchReport::WriteJsonFile(const std::string& path, bool isWritingSamples) const
+    {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "Failed to open bench report file: " << path << std::endl;
+            return false;
+        }
+
+        WriteJson(file, isWritingSamples);
+        return file.good();
+    }
+
+    bool BenchReport::ReadJsonFile(const std::string& path)
+    {
+        boost::property_tree::ptree tree;
+        try
+        {
+            boost::property_tree::read_json(path, tree);
+        }
+        catch (const boost::property_tree::json_parser_error& e)
+        {
+            std::cerr << "Failed to read bench report: " << e.what() << std::endl;
+            return false;
+        }
+
+        Backend = tree.get<std::string>("settings.backend", "");
+        Width = tree.get<int>("settings.width", 0);
+        Height = tree.get<int>("settings.height", 0);
+        WarmupFrameAmount = tree.get<unsigned long long>("settings.warmupFrames", 0);
+        MeasuredFrameAmount = tree.get<unsigned long long>("settings.measuredFrames", 0);
+        FixedDeltaTimeInS = tree.get<double>("settings.fixedDeltaTimeS", 0.0);
+
+        Scenarios.clear();
+        auto scenarios = tree.get_child_optional("scenarios");
+        if (!scenarios)
+            return true;
+
+        for (const auto& [key, node] : *scenarios)
+        {
+            BenchScenarioResult r;
+            r.Name = node.get<std::string>("name", "");
+            r.IsPassed = node.get<bool>("passed", true);
+            r.FrameAmount = node.get<unsigned long long>("frames", 0);
+            if (auto frameTime = node.get_child_optional("frameTimeMs"))
+                r.FrameTimeInMs = ReadStatistics(*frameTime);
+            if (auto tickTime = node.get_child_optional("tickTimeMs"))
+                r.TickTimeInMs = ReadStatistics(*tickTime);
+            if (auto device = node.get_child_optional("device"))
+            {
+                r.IsNullDevice = true;
+                r.CommandsPerFrame = device->get<double>("commandsPerFrame", 0.0);
+                r.DrawCallsPerFrame = device->get<double>("drawCallsPerFrame", 0.0);
+                r.StateChangesPerFrame = device->get<double>("stateChangesPerFrame", 0.0);
+                r.UniformUploadsPerFrame = device->get<double>("uniformUploadsPerFrame", 0.0);
+                r.ElidedStateCallsPerFrame = device->get<double>("elidedStateCallsPerFrame", 0.0);
+                r.SortSavedStateChangesPerFrame = device->get<double>("sortSavedStateChangesPerFrame", 0.0);
+                r.VisibleObjectsPerFrame = device->get<double>("visibleObjectsPerFrame", 0.0);
+                r.CulledObjectsPerFrame = device->get<double>("culledObjectsPerFrame", 0.0);
+                r.GeometryPoolCapacityBytes = device->get<unsigned long long>("geometryPoolCapacityBytes", 0);
+                r.GeometryPoolUsedBytes = device->get<unsigned long long>("geometryPoolUsedBytes", 0);
+                r.GeometryPoolFragmentation = device->get<double>("geometryPoolFragmentation", 0.0);
+            }
+            Scenarios.emplace_back(std::move(r));
+        }
+        return true;
+    }
+
+    const BenchScenarioResult* BenchReport::FindScenario(const std::string& name) const
+    {
+        for (const auto& r : Scenarios)
+        {
+            if (r.Name == name)
+                return &r;
+        }
+        return nullptr;
+    }
+
+    bool CompareReports(const BenchReport& baseline, const BenchReport& current, double threshold, std::ostream& os)
+    {
+        struct Metric
+        {
+            const char* Name;
+            double BenchStatistics::* Value;
+        };
+        static constexpr Metric metrics[] = {
+            { "p50", &BenchStatistics::P50 },
+            { "p95", &BenchStatistics::P95 },
+            { "p99", &BenchStatistics::P99 },
+            { "max", &BenchStatistics::Max }
+        };
+
+        auto oldFlags = os.flags();
+        auto oldPrecision = os.precision();
+        os << std::fixed << std::setprecision(3);
+
+        bool isPassed = true;
+        for (const auto& cur : current.Scenarios)
+        {
+            const BenchScenarioResult* base = baseline.FindScenario(cur.Name);
+            if (!base)
+            {
+                os << cur.Name << ": not in baseline, skipped" << std::endl;
+                continue;
+            }
+
+            auto compare =
+                [&](const char* group, const BenchStatistics& baseStat, const BenchStatistics& curStat)
+                {
+                    for (const auto& m : metrics)
+                    {
+                        double baseValue = baseStat.*m.Value;
+                        double curValue = curStat.*m.Value;
+                        double change = baseValue > 0.0 ? (curValue - baseValue) / baseValue : 0.0;
+                        bool isRegressed = change > threshold;
+                        if (isRegressed)
+                            isPassed = false;
+
+                        os << cur.Name << " " << group << "." << m.Name << ": "
+                           << baseValue << " ms -> " << curValue << " ms ("
+                           << std::showpos << change * 100.0 << std::noshowpos << "%)"
+                           << (isRegressed ? " REGRESSED" : "") << std::endl;
+                    }
+                };
+            compare("frameTimeMs", base->FrameTimeInMs, cur.FrameTimeInMs);
+            compare("tickTimeMs", base->TickTimeInMs, cur.TickTimeInMs);
+        }
+
+        for (const auto& base : baseline.Scenarios)
+        {
+            if (!current.FindScenario(base.Name))
+                os << base.Name << ": missing in current run" << std::endl;
+        }
+
+        os.flags(oldFlags);
+        os.precision(oldPrecision);
+        return isPassed;
+    }
+}
\ No newline at end of file
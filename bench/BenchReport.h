@@ -0,0 +1,66 @@
+#ifndef __BENCHREPORT_H__
+#define __BENCHREPORT_H__
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "BenchStatistics.h"
+
+namespace RyuRenderer::Bench
+{
+    struct BenchScenarioResult
+    {
+        std::string Name;
+        bool IsPassed = true;
+        unsigned long long FrameAmount = 0;
+        BenchStatistics FrameTimeInMs;
+        BenchStatistics TickTimeInMs;
+        // Device command counters averaged over measured frames, only for null device scenarios
+        bool IsNullDevice = false;
+        double CommandsPerFrame = 0.0;
+        double DrawCallsPerFrame = 0.0;
+        double StateChangesPerFrame = 0.0;
+        double UniformUploadsPerFrame = 0.0;
+        // Binding and state calls skipped by the state tracker
+        double ElidedStateCallsPerFrame = 0.0;
+        // Program and material binds saved by render queue sorting
+        double SortSavedStateChangesPerFrame = 0.0;
+        // Objects submitted and skipped by frustum culling
+        double VisibleObjectsPerFrame = 0.0;
+        double CulledObjectsPerFrame = 0.0;
+        // Geometry pool memory at the end of the measured frames
+        unsigned long long GeometryPoolCapacityBytes = 0;
+        unsigned long long GeometryPoolUsedBytes = 0;
+        double GeometryPoolFragmentation = 0.0;
+        // Raw samples, only written when requested
+        std::vector<double> FrameTimeSamplesInMs;
+        std::vector<double> TickTimeSamplesInMs;
+    };
+
+    struct BenchReport
+    {
+        std::string Backend;
+        int Width = 0;
+        int Height = 0;
+        unsigned long long WarmupFrameAmount = 0;
+        unsigned long long MeasuredFrameAmount = 0;
+        double FixedDeltaTimeInS = 0.0;
+        std::vector<BenchScenarioResult> Scenarios;
+
+        void WriteJson(std::ostream& os, bool isWritingSamples) const;
+
+        bool WriteJsonFile(const std::string& path, bool isWritingSamples) const;
+
+        bool ReadJsonFile(const std::string& path);
+
+        const BenchScenarioResult* FindScenario(const std::string& name) const;
+    };
+
+    // Compares percentiles of every scenario in current against baseline,
+    //     a metric regresses when it is slower than baseline by more than threshold (0.05 means 5%).
+    //     Returns false when any metric regresses.
+    bool CompareReports(const BenchReport& baseline, const BenchReport& current, double threshold, std::ostream& os);
+}
+
+#endif
\ No newline at end of file
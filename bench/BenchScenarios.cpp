@@ -0,0 +1,58 @@
+#include "BenchScenarios.h"
+
+#include "SceneSubmissionPipeline.h"
+
+#include "app/render-pipeline/BlendPipeline.h"
+#include "test/GuassianBlurPipeline.h"
+#include "test/ModelViewPhongBlinnPipeline.h"
+#include "test/StencilDepthPhongBlinnPipeline.h"
+
+namespace RyuRenderer::Bench
+{
+    template<class T>
+    static std::unique_ptr<App::RenderPipeline::IRenderPipeline> Create()
+    {
+        return std::make_unique<T>();
+    }
+
+    static std::unique_ptr<App::RenderPipeline::IRenderPipeline> CreateModelViewCompressed()
+    {
+        return std::make_unique<App::RenderPipeline::ModelViewPhongBlinnPipeline>(true);
+    }
+
+    static std::unique_ptr<App::RenderPipeline::IRenderPipeline> CreateSceneSubmission100k()
+    {
+        return std::make_unique<SceneSubmissionPipeline>(100000);
+    }
+
+    static std::unique_ptr<App::RenderPipeline::IRenderPipeline> CreateSceneSubmission100kDirect()
+    {
+        return std::make_unique<SceneSubmissionPipeline>(100000, false);
+    }
+
+    const std::vector<BenchScenario>& GetScenarios()
+    {
+        static const std::vector<BenchScenario> scenarios = {
+            { "blend", "Alpha blended grass quads", Create<App::RenderPipeline::BlendPipeline>, false },
+            { "model-view", "Phong-Blinn shaded model loaded by assimp", Create<App::RenderPipeline::ModelViewPhongBlinnPipeline>, false },
+            { "model-view-compressed", "model-view with quantized vertices and 16 bit indices where they fit", CreateModelViewCompressed, false },
+            { "stencil-outline", "Phong-Blinn boxes with stencil outlines", Create<App::RenderPipeline::StencilDepthPhongBlinnPipeline>, false },
+            { "gaussian-blur", "Ping-pong frame gaussian blur", Create<App::RenderPipeline::GuassianBlurPipeline>, false },
+            { "scene-100k", "Scene::Draw of 100k Phong-Blinn objects", CreateSceneSubmission100k, false },
+            { "scene-100k-null", "Scene::Draw of 100k Phong-Blinn objects on the recording device, no GPU needed", CreateSceneSubmission100k, true },
+            { "scene-100k-direct", "scene-100k with one draw call per object instead of multi draw indirect", CreateSceneSubmission100kDirect, false },
+            { "scene-100k-null-direct", "scene-100k-null with one draw call per object instead of multi draw indirect", CreateSceneSubmission100kDirect, true }
+        };
+        return scenarios;
+    }
+
+    const BenchScenario* FindScenario(const std::string& name)
+    {
+        for (const auto& s : GetScenarios())
+        {
+            if (s.Name == name)
+                return &s;
+        }
+        return nullptr;
+    }
+}
\ No newline at end of file
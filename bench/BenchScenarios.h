@@ -0,0 +1,28 @@
+#ifndef __BENCHSCENARIOS_H__
+#define __BENCHSCENARIOS_H__
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "app/render-pipeline/IRenderPipeline.h"
+
+namespace RyuRenderer::Bench
+{
+    struct BenchScenario
+    {
+        std::string Name;
+        std::string Description;
+        std::function<std::unique_ptr<App::RenderPipeline::IRenderPipeline>()> CreatePipeline;
+        // Ticked on a recording device without any GL context, which measures CPU submission cost only
+        bool IsNullDevice = false;
+    };
+
+    // All registered scenarios, in running order
+    const std::vector<BenchScenario>& GetScenarios();
+
+    const BenchScenario* FindScenario(const std::string& name);
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef __BENCHSTATISTICS_H__
+#define __BENCHSTATISTICS_H__
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace RyuRenderer::Bench
+{
+    struct BenchStatistics
+    {
+        double Mean = 0.0;
+        double P50 = 0.0;
+        double P95 = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+
+        static BenchStatistics Compute(std::vector<double> samples)
+        {
+            BenchStatistics s;
+            if (samples.empty())
+                return s;
+
+            std::sort(samples.begin(), samples.end());
+            s.Mean = std::accumulate(samples.begin(), samples.end(), 0.0) / samples.size();
+            s.P50 = Percentile(samples, 0.50);
+            s.P95 = Percentile(samples, 0.95);
+            s.P99 = Percentile(samples, 0.99);
+            s.Max = samples.back();
+            return s;
+        }
+
+        // Linear interpolation between closest ranks, samples must be sorted
+        static double Percentile(const std::vector<double>& sortedSamples, double p)
+        {
+            if (sortedSamples.empty())
+                return 0.0;
+
+            double rank = p * (sortedSamples.size() - 1);
+            size_t lower = static_cast<size_t>(std::floor(rank));
+            size_t upper = std::min(lower + 1, sortedSamples.size() - 1);
+            double fraction = rank - lower;
+            return sortedSamples[lower] + (sortedSamples[upper] - sortedSamples[lower]) * fraction;
+        }
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,148 @@
+#ifndef __SCENESUBMISSIONPIPELINE_H__
+#define __SCENESUBMISSIONPIPELINE_H__
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "app/render-pipeline/IRenderPipeline.h"
+#include "graphics/Mesh.h"
+#include "graphics/TextureManager.h"
+#include "graphics/scene/Camera.h"
+#include "graphics/scene/MeshObject.h"
+#include "graphics/scene/MeshObjectBatch.h"
+#include "graphics/scene/PhongBlinnMaterial.h"
+#include "graphics/scene/PhongBlinnMaterialData.h"
+#include "graphics/scene/PointLight.h"
+#include "graphics/scene/RenderQueue.h"
+#include "graphics/scene/Scene.h"
+
+namespace RyuRenderer::Bench
+{
+    // Scene with a grid of textured Phong-Blinn cubes, each cube is an own object with an own mesh,
+    //     so every Tick submits one draw item per object through Scene::Draw.
+    //     Items are drawn with multi draw indirect, or one draw call each when multi draw is off.
+    class SceneSubmissionPipeline : public App::RenderPipeline::IRenderPipeline
+    {
+    public:
+        SceneSubmissionPipeline(size_t objectAmount, bool isMultiDraw = true) :
+            objectAmount(objectAmount),
+            isMultiDraw(isMultiDraw)
+        {
+        }
+
+        ~SceneSubmissionPipeline()
+        {
+            Graphics::Scene::RenderQueue::GetInstance().IsMultiDrawEnabled = true;
+        }
+
+        void Init() override
+        {
+            Graphics::Scene::RenderQueue::GetInstance().IsMultiDrawEnabled = isMultiDraw;
+
+            // Scene creates device resources, so it is created here under the device used by ticks
+            scene = std::make_unique<Graphics::Scene::Scene>();
+
+            const size_t gridSize = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(objectAmount))));
+            const float spacing = 1.5f;
+            const float halfExtent = gridSize * spacing * 0.5f;
+
+            scene->Camera = Graphics::Scene::Camera(
+                glm::vec3(0.0f, halfExtent, halfExtent * 2.0f),
+                glm::normalize(glm::vec3(0.0f, -0.5f, -1.0f)),
+                glm::vec3(0.0f, 1.0f, 0.0f),
+                0.01f,
+                1000000.f,
+                60.f,
+                16.f / 9.f,
+                true
+            );
+
+            scene->PointLights.emplace_back(Graphics::Scene::PointLight(
+                glm::vec3{ 1.0f, 1.0f, 1.0f },
+                glm::vec3{ -halfExtent, 3.f, -halfExtent }
+            ));
+            scene->PointLights.emplace_back(Graphics::Scene::PointLight(
+                glm::vec3{ 1.0f, 1.0f, 1.0f },
+                glm::vec3{ halfExtent, 3.f, halfExtent }
+            ));
+
+            Graphics::Scene::PhongBlinnMaterialData data;
+            auto& textures = Graphics::TextureManager::GetInstance();
+            data.Diffuse = textures.GetHandle(textures.FindOrCreate2d(
+                "res/textures/box_diffuse.jpg", Graphics::Scene::Scene::GetTextureUnitIdxByType(aiTextureType_DIFFUSE)));
+            data.Specular = textures.GetHandle(textures.FindOrCreate2d(
+                "res/textures/box_specular.jpg", Graphics::Scene::Scene::GetTextureUnitIdxByType(aiTextureType_SPECULAR)));
+
+            std::vector<GLuint> indices;
+            std::vector<std::array<float, 3>> positions;
+            std::vector<std::array<float, 3>> normals;
+            std::vector<std::array<float, 2>> texCoords;
+            BuildCube(indices, positions, normals, texCoords);
+
+            Graphics::Scene::MeshObjectBatch batch(std::make_shared<Graphics::Scene::PhongBlinnMaterial>());
+            for (size_t i = 0; i < objectAmount; ++i)
+            {
+                Graphics::Scene::MeshObject o;
+                o.Meshes.emplace_back(Graphics::Mesh(
+                    Graphics::Scene::PhongBlinnMaterial::MeshVertexLayout(), indices, positions, normals, texCoords));
+                o.Transformer.MoveTo(glm::vec3(
+                    (i % gridSize) * spacing - halfExtent,
+                    0.0f,
+                    (i / gridSize) * spacing - halfExtent));
+                o.MaterialData = data;
+                o.UpdateBounds();
+                batch.MeshObjects.emplace_back(std::move(o));
+            }
+            scene->MeshObjectBatches.emplace_back(std::move(batch));
+        }
+
+        void Tick(double deltaTimeInS) override
+        {
+            if (scene)
+                scene->Draw();
+        }
+    private:
+        static void BuildCube(
+            std::vector<GLuint>& indices,
+            std::vector<std::array<float, 3>>& positions,
+            std::vector<std::array<float, 3>>& normals,
+            std::vector<std::array<float, 2>>& texCoords)
+        {
+            // normal, u axis, v axis of every face
+            constexpr std::array<std::array<glm::vec3, 3>, 6> faces = {{
+                {{ { 0.f, 0.f, -1.f }, { -1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f } }},
+                {{ { 0.f, 0.f, 1.f }, { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f } }},
+                {{ { -1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 0.f, 1.f, 0.f } }},
+                {{ { 1.f, 0.f, 0.f }, { 0.f, 0.f, -1.f }, { 0.f, 1.f, 0.f } }},
+                {{ { 0.f, -1.f, 0.f }, { 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f } }},
+                {{ { 0.f, 1.f, 0.f }, { 1.f, 0.f, 0.f }, { 0.f, 0.f, -1.f } }}
+            }};
+            constexpr std::array<std::array<float, 2>, 4> corners = {{
+                { 0.f, 0.f }, { 1.f, 0.f }, { 1.f, 1.f }, { 0.f, 1.f }
+            }};
+
+            for (const auto& [n, u, v] : faces)
+            {
+                GLuint base = static_cast<GLuint>(positions.size());
+                for (const auto& c : corners)
+                {
+                    glm::vec3 p = 0.5f * n + (c[0] - 0.5f) * u + (c[1] - 0.5f) * v;
+                    positions.push_back({ p.x, p.y, p.z });
+                    normals.push_back({ n.x, n.y, n.z });
+                    texCoords.push_back(c);
+                }
+                indices.insert(indices.end(), { base, base + 1, base + 2, base + 2, base + 3, base });
+            }
+        }
+
+        size_t objectAmount = 0;
+        bool isMultiDraw = true;
+        std::unique_ptr<Graphics::Scene::Scene> scene;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,68 @@
+#ifndef __TIMEDPIPELINE_H__
+#define __TIMEDPIPELINE_H__
+
+#include <chrono>
+#include <vector>
+
+#include "app/render-pipeline/IRenderPipeline.h"
+
+namespace RyuRenderer::Bench
+{
+    // Wraps a pipeline and samples CPU times of its frames.
+    //     Frame time is the interval between two tick starts, so it covers clearing, ticking and presenting.
+    //     Tick time only covers the wrapped pipeline's Tick.
+    //     Frames before warmup amount are discarded, the run must tick one more frame than measured to close the last interval.
+    class TimedPipeline : public App::RenderPipeline::IRenderPipeline
+    {
+    public:
+        TimedPipeline(App::RenderPipeline::IRenderPipeline* p, unsigned long long warmupFrameAmount, unsigned long long measuredFrameAmount) :
+            pipeline(p),
+            warmupFrameAmount(warmupFrameAmount),
+            measuredFrameAmount(measuredFrameAmount)
+        {
+            FrameTimeSamplesInMs.reserve(measuredFrameAmount);
+            TickTimeSamplesInMs.reserve(measuredFrameAmount);
+        }
+
+        void Init() override
+        {
+            if (pipeline)
+                pipeline->Init();
+        }
+
+        void Tick(double deltaTimeInS) override
+        {
+            auto tickStart = Clock::now();
+            if (tickedFrameAmount > warmupFrameAmount && tickedFrameAmount <= warmupFrameAmount + measuredFrameAmount)
+                FrameTimeSamplesInMs.emplace_back(ToMs(tickStart - lastTickStart));
+
+            if (pipeline)
+                pipeline->Tick(deltaTimeInS);
+
+            auto tickEnd = Clock::now();
+            if (tickedFrameAmount >= warmupFrameAmount && tickedFrameAmount < warmupFrameAmount + measuredFrameAmount)
+                TickTimeSamplesInMs.emplace_back(ToMs(tickEnd - tickStart));
+
+            lastTickStart = tickStart;
+            ++tickedFrameAmount;
+        }
+
+        std::vector<double> FrameTimeSamplesInMs;
+        std::vector<double> TickTimeSamplesInMs;
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static double ToMs(Clock::duration d)
+        {
+            return std::chrono::duration<double, std::milli>(d).count();
+        }
+
+        App::RenderPipeline::IRenderPipeline* pipeline = nullptr;
+        unsigned long long warmupFrameAmount = 0;
+        unsigned long long measuredFrameAmount = 0;
+        unsigned long long tickedFrameAmount = 0;
+        Clock::time_point lastTickStart;
+    };
+}
+
+#endif
\ No newline at end of file
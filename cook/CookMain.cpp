@@ -0,0 +1,227 @@
+#include "graphics/BlockCompressor.h"
+#include "graphics/CompressedTextureFile.h"
+#include "graphics/scene/ModelImporter.h"
+#include "graphics/scene/RyuMeshFile.h"
+
+#include "assimp/material.h"
+#include "stb/stb_image.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace RyuRenderer;
+using namespace RyuRenderer::Graphics;
+using namespace RyuRenderer::Graphics::Scene;
+
+static void PrintUsage()
+{
+    std::cout <<
+        "Usage:\n"
+        "  ryu-cook <model file> [--output <file.ryumesh>] [--no-optimize] [--no-lod] [--compress-textures] [--threads <n>]\n"
+        "  ryu-cook --textures <file or directory>... [--format <bc1|bc3|bc4|bc5|bc7>] [--threads <n>]\n"
+        "The output defaults to the model file with the .ryumesh extension. Keep it in the model directory,\n"
+        "texture names are stored relative to it. --compress-textures writes the material textures as .ktx2 files\n"
+        "next to them and stores those names instead.\n"
+        "Textures are written as .ktx2 files next to the jpg and png files. Without --format diffuse textures use bc7,\n"
+        "files named *_specular or *_emission use bc1.\n";
+}
+
+// Diffuse textures keep their color and alpha, specular and emission maps are only sampled as RGB
+static BlockCompressor::Format GetFormatByUsage(aiTextureType t)
+{
+    return t == aiTextureType_DIFFUSE ? BlockCompressor::FORMAT_BC7 : BlockCompressor::FORMAT_BC1;
+}
+
+static BlockCompressor::Format GetFormatByName(const std::filesystem::path& filePath)
+{
+    const std::string stem = filePath.stem().string();
+    if (stem.ends_with("_specular"))
+        return GetFormatByUsage(aiTextureType_SPECULAR);
+    if (stem.ends_with("_emission"))
+        return GetFormatByUsage(aiTextureType_EMISSIVE);
+    return GetFormatByUsage(aiTextureType_DIFFUSE);
+}
+
+static bool IsImagePath(const std::filesystem::path& filePath)
+{
+    const auto extension = filePath.extension();
+    return extension == ".jpg" || extension == ".png";
+}
+
+// Writes the full mip chain of imageFilePath into outputFilePath, every level is compressed on all threads
+static bool CookTexture(const std::filesystem::path& imageFilePath, const std::filesystem::path& outputFilePath, BlockCompressor::Format f, size_t threadAmount)
+{
+    const auto start = std::chrono::steady_clock::now();
+    int width = 0;
+    int height = 0;
+    int channelAmount = 0;
+    // Bottom up like App has stbi load jpg and png files at runtime, WriteKtx2 marks the files so
+    stbi_set_flip_vertically_on_load(true);
+    unsigned char* data = stbi_load(imageFilePath.string().c_str(), &width, &height, &channelAmount, 4);
+    if (!data)
+    {
+        std::cerr << "Can not load texture file: " << imageFilePath.string() << "." << std::endl;
+        return false;
+    }
+    const auto levels = BlockCompressor::CompressMipChain(
+        std::span<const uint8_t>(data, static_cast<size_t>(width) * height * 4), width, height, f, threadAmount);
+    stbi_image_free(data);
+
+    if (!CompressedTextureFile::WriteKtx2(outputFilePath.string(), BlockCompressor::GetGLFormat(f), width, height, levels))
+        return false;
+
+    const double elapsedInS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Cooked " << imageFilePath.string() << " (" << width << "x" << height << ", " << levels.size() << " levels) into "
+        << outputFilePath.string() << " (" << std::filesystem::file_size(outputFilePath) << " bytes) in " << elapsedInS << " s." << std::endl;
+    return true;
+}
+
+static int CookTextures(const std::vector<std::string>& paths, const BlockCompressor::Format* format, size_t threadAmount)
+{
+    std::vector<std::filesystem::path> imageFilePaths;
+    for (const auto& path : paths)
+    {
+        if (std::filesystem::is_directory(path))
+        {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(path))
+            {
+                if (entry.is_regular_file() && IsImagePath(entry.path()))
+                    imageFilePaths.emplace_back(entry.path());
+            }
+        }
+        else if (IsImagePath(path))
+            imageFilePaths.emplace_back(path);
+        else
+        {
+            std::cerr << "The suffix of the image file should be jpg or png: " << path << "." << std::endl;
+            return 1;
+        }
+    }
+
+    // One file at a time, the blocks of each level already keep every thread busy
+    for (const auto& imageFilePath : imageFilePaths)
+    {
+        const auto f = format ? *format : GetFormatByName(imageFilePath);
+        auto outputFilePath = imageFilePath;
+        outputFilePath.replace_extension(CompressedTextureFile::Ktx2Extension);
+        if (!CookTexture(imageFilePath, outputFilePath, f, threadAmount))
+            return 1;
+    }
+    return 0;
+}
+
+// Compresses the textures named by the materials and renames them, a file missing next to the model keeps its name
+static void CookMaterialTextures(ImportedModel& model, const std::filesystem::path& textureFileRootPath, size_t threadAmount)
+{
+    std::unordered_map<std::string, std::string> cookedNames;
+    auto cook = [&](std::string& textureFileName, aiTextureType t)
+    {
+        if (textureFileName.empty() || !IsImagePath(textureFileName))
+            return;
+
+        auto [it, isAdded] = cookedNames.try_emplace(textureFileName, textureFileName);
+        if (isAdded)
+        {
+            const auto imageFilePath = textureFileRootPath / textureFileName;
+            auto cookedName = std::filesystem::path(textureFileName).replace_extension(CompressedTextureFile::Ktx2Extension);
+            if (std::filesystem::exists(imageFilePath) &&
+                CookTexture(imageFilePath, textureFileRootPath / cookedName, GetFormatByUsage(t), threadAmount))
+                it->second = cookedName.generic_string();
+        }
+        textureFileName = it->second;
+    };
+
+    for (auto& m : model.Materials)
+    {
+        cook(m.DiffuseTexture, aiTextureType_DIFFUSE);
+        cook(m.SpecularTexture, aiTextureType_SPECULAR);
+        cook(m.EmissionTexture, aiTextureType_EMISSIVE);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string modelFilePath;
+    std::string outputFilePath;
+    MeshOptimizationSettings optimization;
+    MeshLodSettings lod;
+    bool isCompressingTextures = false;
+    bool isCookingTextures = false;
+    std::vector<std::string> texturePaths;
+    BlockCompressor::Format textureFormat = BlockCompressor::FORMAT_BC7;
+    bool isTextureFormatSet = false;
+    size_t threadAmount = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "--output" && i + 1 < argc)
+            outputFilePath = argv[++i];
+        else if (arg == "--no-optimize")
+            optimization.IsEnabled = false;
+        else if (arg == "--no-lod")
+            lod.IsEnabled = false;
+        else if (arg == "--compress-textures")
+            isCompressingTextures = true;
+        else if (arg == "--textures")
+            isCookingTextures = true;
+        else if (arg == "--format" && i + 1 < argc && BlockCompressor::ParseFormat(argv[i + 1], textureFormat))
+        {
+            isTextureFormatSet = true;
+            ++i;
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+            threadAmount = std::strtoul(argv[++i], nullptr, 10);
+        else if (isCookingTextures && !arg.starts_with("--"))
+            texturePaths.emplace_back(arg);
+        else if (modelFilePath.empty() && !arg.starts_with("--"))
+            modelFilePath = arg;
+        else
+        {
+            PrintUsage();
+            return 1;
+        }
+    }
+    if (isCookingTextures)
+    {
+        if (texturePaths.empty() || !modelFilePath.empty())
+        {
+            PrintUsage();
+            return 1;
+        }
+        return CookTextures(texturePaths, isTextureFormatSet ? &textureFormat : nullptr, threadAmount);
+    }
+    if (modelFilePath.empty())
+    {
+        PrintUsage();
+        return 1;
+    }
+    if (outputFilePath.empty())
+        outputFilePath = std::filesystem::path(modelFilePath).replace_extension(RyuMeshFile::Extension).string();
+
+    const auto start = std::chrono::steady_clock::now();
+    ImportedModel model;
+    if (!ModelImporter::Import(modelFilePath, optimization, lod, model))
+    {
+        std::cerr << "Failed to import " << modelFilePath << "." << std::endl;
+        return 1;
+    }
+    if (isCompressingTextures)
+        CookMaterialTextures(model, std::filesystem::path(modelFilePath).parent_path(), threadAmount);
+    if (!RyuMeshFile::Write(model, outputFilePath))
+        return 1;
+
+    size_t levelAmount = 0;
+    for (const auto& im : model.Meshes)
+        levelAmount += im.Levels.size();
+    const double elapsedInS = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Cooked " << model.Meshes.size() << " meshes, " << levelAmount << " levels and "
+        << model.Materials.size() << " materials into " << outputFilePath << " ("
+        << std::filesystem::file_size(outputFilePath) << " bytes) in " << elapsedInS << " s." << std::endl;
+    return 0;
+}
\ No newline at end of file
@@ -7,7 +7,10 @@
 #include "app/render-pipeline/IRenderPipeline.h"
 #include "common/Publisher.h"
 #include "common/Singleton.h"
+#include "graphics/Frame.h"
+#include "graphics/Texture2d.h"
 
+#include <chrono>
 #include <iostream>
 
 namespace RyuRenderer::App
@@ -25,10 +28,24 @@ namespace RyuRenderer::App
 
         int GetWindowHeight() const;
 
+        bool IsHeadless() const;
+
         Common::Publisher EventPublisher;
     private:
         void Clear();
 
+        bool InitWindow(const AppSettings& settings, bool isVisible);
+
+        bool InitHeadlessContext(const AppSettings& settings);
+
+        bool InitOffscreenFrame(int width, int height);
+
+        void InitRenderStates();
+
+        bool ShouldClose(unsigned long long tickedFrameAmount) const;
+
+        double GetTimeInS() const;
+
         void SetWindowIcon(const std::string& iconPath);
 
         static void OnWindowSizeChanged(GLFWwindow* window, int width, int height);
@@ -51,6 +68,18 @@ namespace RyuRenderer::App
         int windowHeight = 0;
         double lastTickTimeInS = 0.0;
         bool IsFocused = true;
+
+        // Headless
+        AppSettings::BackendType backend = AppSettings::BackendType::BACKEND_WINDOW;
+        unsigned long long maxFrameAmount = 0;
+        double fixedDeltaTimeInS = 0.0;
+        Graphics::Texture2d offscreenTexture;
+        Graphics::Frame offscreenFrame;
+        // EGL handles, kept opaque so that EGL headers stay out of this header.
+        void* eglDisplay = nullptr;
+        void* eglContext = nullptr;
+        void* eglSurface = nullptr;
+        std::chrono::steady_clock::time_point initTime;
     };
 }
 
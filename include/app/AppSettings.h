@@ -7,6 +7,14 @@ namespace RyuRenderer::App
 {
     struct AppSettings
     {
+        enum BackendType
+        {
+            BACKEND_WINDOW,
+            // Render into an offscreen frame without any window, uses EGL when available (e.g. Mesa llvmpipe),
+            //     otherwise falls back to an invisible GLFW window.
+            BACKEND_HEADLESS
+        };
+
         std::string WindowName = "Ryu Renderer";
         std::string WindowIconPath = "res/icons/icon.png";
         int WindowWidth = 1920;
@@ -14,6 +22,12 @@ namespace RyuRenderer::App
         int VSyncInterval = 1;
         bool HideCursor = true;
         bool LockCursorToCenter = true;
+
+        BackendType Backend = BackendType::BACKEND_WINDOW;
+        // Run loop exits after this amount of frames, 0 means running until the window is closed.
+        unsigned long long MaxFrameAmount = 0;
+        // Delta time passed to every tick, 0 means using the real elapsed time.
+        double FixedDeltaTimeInS = 0.0;
     };
 }
 
@@ -14,10 +14,11 @@
 #include "app/events/KeyEvent.h"
 #include "app/render-pipeline/IRenderPipeline.h"
 #include "graphics/Frame.h"
+#include "graphics/InstanceBuffer.h"
 #include "graphics/Mesh.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderManager.h"
-#include "graphics/Texture2D.h"
+#include "graphics/Texture2d.h"
 #include "graphics/TextureManager.h"
 #include "graphics/scene/Camera.h"
 #include "graphics/scene/DirectionalLight.h"
@@ -61,7 +62,7 @@ namespace RyuRenderer::App::RenderPipeline
                 grass->Use();
 
             // init shader
-            texture2dShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/2d-texture.vert", "res/shaders/2d-texture.frag");
+            texture2dShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/2d-texture.vert", "res/shaders/2d-texture.frag");
             if (texture2dShader)
             {
                 texture2dShader->Use();
@@ -100,6 +101,12 @@ namespace RyuRenderer::App::RenderPipeline
             transformers.push_back(t3);
             transformers.push_back(t4);
             transformers.push_back(t5);
+            for (const auto& t : transformers)
+            {
+                Graphics::InstanceData data;
+                data.Model = t.GetMatrix();
+                grassInstances.Add(data);
+            }
 
             // Other settings
             App::GetInstance().EventPublisher.RegisterHandler(this, &BlendPipeline::OnWindowResize);
@@ -116,20 +123,14 @@ namespace RyuRenderer::App::RenderPipeline
             camera.OnTick(deltaTimeInS);
             view = camera.GetView();
 
-            // draw 5 grass
-            for (size_t i = 0; i < transformers.size(); ++i)
-            {
-                const auto m = transformers[i].GetMatrix();
+            // draw 5 grass with one instanced draw
+            texture2dShader->Use();
+            texture2dShader->SetUniform("view", view);
+            texture2dShader->SetUniform("projection", projection);
 
-                texture2dShader->Use();
-                texture2dShader->SetUniform("view", view);
-                texture2dShader->SetUniform("projection", projection);
-                texture2dShader->SetUniform("model", m);
-
-                for (size_t j = 0; j < quadMeshes.size(); ++j)
-                {
-                    quadMeshes[j].Draw();
-                }
+            for (size_t j = 0; j < quadMeshes.size(); ++j)
+            {
+                quadMeshes[j].DrawInstanced(grassInstances);
             }
         }
     private:
@@ -162,6 +163,7 @@ namespace RyuRenderer::App::RenderPipeline
         float boxShininess = 128.f;
 
         std::vector<Graphics::Scene::Transform> transformers;
+        Graphics::InstanceBuffer grassInstances;
 
         // camera
         glm::mat4 view = glm::identity<glm::mat4>();
@@ -6,6 +6,8 @@ namespace RyuRenderer::App::RenderPipeline
     class IRenderPipeline
     {
     public:
+        virtual ~IRenderPipeline() = default;
+
         virtual void Init() = 0;
         virtual void Tick(double deltaTimeInS) = 0;
     };
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 #include <utility>
 
@@ -0,0 +1,45 @@
+#ifndef __MAPPEDFILE_H__
+#define __MAPPEDFILE_H__
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace RyuRenderer::Common
+{
+    // Read only memory mapping of a whole file, pages are read in by the OS when they are first touched
+    //     and stay shared with the page cache, so nothing is copied until somebody reads them
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+
+        MappedFile(const MappedFile& other) = delete;
+
+        MappedFile(MappedFile&& other) noexcept;
+
+        ~MappedFile();
+
+        MappedFile& operator=(const MappedFile& other) = delete;
+
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        // Closes the mapping held before, false when the file cannot be opened or mapped
+        bool Open(const std::string& filePath);
+
+        void Close();
+
+        bool IsOpen() const;
+
+        std::span<const std::byte> GetBytes() const;
+    private:
+        const std::byte* data = nullptr;
+        std::size_t size = 0;
+#ifdef _WIN32
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+#endif
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,61 @@
+#ifndef __OFFSETALLOCATOR_H__
+#define __OFFSETALLOCATOR_H__
+
+#include <cstddef>
+#include <limits>
+#include <map>
+#include <unordered_map>
+
+namespace RyuRenderer::Common
+{
+    // Hands out ranges of [0, capacity) in abstract units, it never touches any memory itself.
+    //     Allocation is best fit, freed ranges are merged with their free neighbours right away.
+    class OffsetAllocator
+    {
+    public:
+        static constexpr size_t InvalidOffset = std::numeric_limits<size_t>::max();
+
+        OffsetAllocator() = default;
+
+        OffsetAllocator(size_t c);
+
+        // Returns InvalidOffset when no free range is large enough
+        size_t Allocate(size_t size);
+
+        bool Free(size_t offset);
+
+        // Forgets every allocation, the whole capacity is one free range again
+        void Reset();
+
+        size_t GetCapacity() const;
+
+        size_t GetUsedSize() const;
+
+        size_t GetFreeSize() const;
+
+        size_t GetLargestFreeSize() const;
+
+        size_t GetAllocationAmount() const;
+
+        size_t GetFreeRangeAmount() const;
+
+        // Share of the free space outside of the largest free range, 0 when the free space is in one piece
+        double GetFragmentation() const;
+    private:
+        void AddFreeRange(size_t offset, size_t size);
+
+        void RemoveFreeRange(std::map<size_t, size_t>::iterator it);
+
+        size_t capacity = 0;
+        size_t usedSize = 0;
+
+        // Offset to size, ordered by offset so neighbours are found for merging
+        std::map<size_t, size_t> freeRanges;
+        // Size to offset, ordered by size for the best fit search
+        std::multimap<size_t, size_t> freeRangesBySize;
+        // Offset to size of every live allocation
+        std::unordered_map<size_t, size_t> allocations;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,195 @@
+#ifndef __PROFILER_H__
+#define __PROFILER_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "common/Singleton.h"
+
+namespace RyuRenderer::Common
+{
+    namespace ProfilerImpl
+    {
+        // Single producer single consumer ring, the producer never blocks and drops elements when full
+        template <typename T, std::size_t Capacity>
+        requires ((Capacity & (Capacity - 1)) == 0)
+        class SpscRing
+        {
+        public:
+            SpscRing() :
+                elements(Capacity)
+            {
+            }
+
+            bool Push(const T& e)
+            {
+                const auto head = writeIdx.load(std::memory_order_relaxed);
+                const auto tail = readIdx.load(std::memory_order_acquire);
+                if (head - tail >= Capacity)
+                {
+                    droppedAmount.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+
+                elements[head & (Capacity - 1)] = e;
+                writeIdx.store(head + 1, std::memory_order_release);
+                return true;
+            }
+
+            template <typename F>
+            std::size_t Drain(F&& f)
+            {
+                auto tail = readIdx.load(std::memory_order_relaxed);
+                const auto head = writeIdx.load(std::memory_order_acquire);
+                const std::size_t amount = head - tail;
+                for (; tail != head; ++tail)
+                    f(elements[tail & (Capacity - 1)]);
+
+                readIdx.store(tail, std::memory_order_release);
+                return amount;
+            }
+
+            unsigned long long GetDroppedAmount() const
+            {
+                return droppedAmount.load(std::memory_order_relaxed);
+            }
+        private:
+            std::vector<T> elements;
+            std::atomic<unsigned long long> writeIdx = 0;
+            std::atomic<unsigned long long> readIdx = 0;
+            std::atomic<unsigned long long> droppedAmount = 0;
+        };
+    }
+
+    // Scoped CPU zones written into per-thread lock-free rings, drained once per frame (or on dump)
+    //     and exported as Chrome trace JSON (chrome://tracing, Perfetto).
+    //     Drained events are only kept while IsCapturing, in a window of the newest MaxCollectedEventAmount events.
+    //     Zone names must be string literals, only their pointers are stored.
+    class Profiler : public Singleton<Profiler>
+    {
+    public:
+        struct ZoneEvent
+        {
+            const char* Name = nullptr;
+            unsigned long long BeginInNs = 0;
+            unsigned long long EndInNs = 0;
+            unsigned int Depth = 0;
+        };
+
+        class ScopedZone
+        {
+        public:
+            ScopedZone(const char* name);
+
+            ~ScopedZone();
+
+            ScopedZone(const ScopedZone& other) = delete;
+
+            ScopedZone& operator=(const ScopedZone& other) = delete;
+        private:
+            const char* name = nullptr;
+            unsigned long long beginInNs = 0;
+        };
+
+        ~Profiler();
+
+        // Names the calling thread in the exported trace
+        void SetThreadName(const std::string& name);
+
+        // Moves events of all threads out of their rings, called by App::Run at the end of every frame
+        void Collect();
+
+        void Clear();
+
+        bool WriteChromeTrace(std::ostream& os);
+
+        bool DumpChromeTrace(const std::string& path);
+
+        // Trace is dumped to this path when the profiler is destroyed, empty means no dump. Starts capturing unless empty
+        void SetDumpPathAtExit(const std::string& path);
+
+        // Adds a track for events not measured by zones (e.g. GPU timers), returns its index
+        unsigned int CreateTrack(const std::string& name);
+
+        // Event times must be on the profiler clock, see GetTimeInNs
+        void AddTrackEvent(unsigned int trackIdx, const ZoneEvent& e);
+
+        size_t GetCollectedEventAmount();
+
+        // Events lost to full thread rings or pushed out of the window
+        unsigned long long GetDroppedEventAmount();
+
+        // Nanoseconds since profiler creation
+        unsigned long long GetTimeInNs() const;
+
+        std::atomic<bool> IsEnabled = true;
+
+        // Without a capture events are drained and thrown away, so memory stays flat however long the app runs
+        std::atomic<bool> IsCapturing = false;
+
+        // 512 KB per thread recording zones, rings are drained every frame
+        static constexpr std::size_t ThreadRingCapacity = 1 << 14;
+        // About 40 MB, the oldest events go first
+        static constexpr std::size_t MaxCollectedEventAmount = 1 << 20;
+    private:
+        friend class Singleton<Profiler>;
+
+        struct ThreadBuffer
+        {
+            ProfilerImpl::SpscRing<ZoneEvent, ThreadRingCapacity> Events;
+            unsigned int ThreadIdx = 0;
+            std::string ThreadName;
+            unsigned int Depth = 0;
+        };
+
+        struct CollectedEvent
+        {
+            unsigned int ThreadIdx = 0;
+            ZoneEvent Event;
+        };
+
+        struct Track
+        {
+            unsigned int Idx = 0;
+            std::string Name;
+        };
+
+        Profiler();
+
+        ThreadBuffer& GetThreadBuffer();
+
+        void CollectLocked();
+
+        std::chrono::steady_clock::time_point epoch;
+
+        // Guards buffer registration and collected events, never taken by zones once their thread is registered
+        std::mutex mutex;
+        std::list<std::unique_ptr<ThreadBuffer>> threadBuffers;
+        std::vector<Track> tracks;
+        // Threads and tracks share indices, they are both exported as trace threads
+        unsigned int nextTrackIdx = 0;
+        std::deque<CollectedEvent> collectedEvents;
+        unsigned long long overflowedEventAmount = 0;
+        std::string dumpPathAtExit;
+    };
+}
+
+#ifdef RYU_ENABLE_PROFILER
+#define RYU_PROFILE_CONCAT_IMPL(a, b) a##b
+#define RYU_PROFILE_CONCAT(a, b) RYU_PROFILE_CONCAT_IMPL(a, b)
+#define RYU_PROFILE_ZONE(name) RyuRenderer::Common::Profiler::ScopedZone RYU_PROFILE_CONCAT(ryuProfileZone, __LINE__)(name)
+#define RYU_PROFILE_COLLECT() RyuRenderer::Common::Profiler::GetInstance().Collect()
+#else
+#define RYU_PROFILE_ZONE(name)
+#define RYU_PROFILE_COLLECT()
+#endif
+
+#endif
\ No newline at end of file
@@ -0,0 +1,99 @@
+#ifndef __THREADPOOL_H__
+#define __THREADPOOL_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "common/Singleton.h"
+
+namespace RyuRenderer::Common
+{
+    // Worker threads for CPU side jobs, one less than the hardware threads so the main thread keeps a core.
+    //     Jobs must not touch GL objects, the context is only current on the main thread
+    class ThreadPool : public Singleton<ThreadPool>
+    {
+    public:
+        ~ThreadPool();
+
+        template <typename F>
+        std::future<std::invoke_result_t<F>> Submit(F&& job)
+        {
+            using ResultType = std::invoke_result_t<F>;
+
+            auto task = std::make_shared<std::packaged_task<ResultType()>>(std::forward<F>(job));
+            auto result = task->get_future();
+            Enqueue([task]() { (*task)(); });
+            return result;
+        }
+
+        // Calls job(i) for every i in [0, amount) and returns when all calls are done.
+        //     The calling thread takes indices as well, so it is safe to call from inside a job.
+        //     A non zero maxThreadAmount limits the threads taking indices including the caller, 1 runs every call on the caller
+        template <typename F>
+        void ParallelFor(std::size_t amount, F&& job, std::size_t maxThreadAmount = 0)
+        {
+            if (amount == 0)
+                return;
+
+            struct State
+            {
+                std::atomic<std::size_t> NextIdx = 0;
+                std::atomic<std::size_t> DoneAmount = 0;
+                std::mutex Mutex;
+                std::condition_variable Done;
+            };
+            // Helpers which start after the last index was taken only touch the shared state
+            auto state = std::make_shared<State>();
+            auto work = [state, amount, &job]()
+            {
+                for (std::size_t i = state->NextIdx.fetch_add(1); i < amount; i = state->NextIdx.fetch_add(1))
+                {
+                    job(i);
+                    if (state->DoneAmount.fetch_add(1) + 1 == amount)
+                    {
+                        std::lock_guard<std::mutex> lock(state->Mutex);
+                        state->Done.notify_all();
+                    }
+                }
+            };
+
+            std::size_t helperAmount = std::min(amount - 1, threads.size());
+            if (maxThreadAmount > 0)
+                helperAmount = std::min(helperAmount, maxThreadAmount - 1);
+            for (std::size_t i = 0; i < helperAmount; ++i)
+                Enqueue(work);
+            work();
+
+            std::unique_lock<std::mutex> lock(state->Mutex);
+            state->Done.wait(lock, [&state, amount]() { return state->DoneAmount.load() == amount; });
+        }
+
+        std::size_t GetThreadAmount() const;
+    private:
+        friend class Singleton<ThreadPool>;
+
+        ThreadPool();
+
+        void Enqueue(std::function<void()> job);
+
+        void Run();
+
+        std::vector<std::thread> threads;
+        std::deque<std::function<void()>> jobs;
+        std::mutex mutex;
+        std::condition_variable jobAdded;
+        bool isStopping = false;
+    };
+}
+
+#endif
\ No newline at end of file
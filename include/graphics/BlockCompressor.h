@@ -0,0 +1,51 @@
+#ifndef __BLOCKCOMPRESSOR_H__
+#define __BLOCKCOMPRESSOR_H__
+
+#include "glad/gl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace RyuRenderer::Graphics
+{
+    // CPU encoder of 8 bit RGBA images into BCn blocks, used by ryu-cook and never at runtime.
+    //     Endpoints start on the principal axis of the block colors and are refined by least squares against the chosen indices.
+    //     BC7 uses mode 6 only, one subset with RGBA endpoints and 16 weights, which is good for smooth color and alpha
+    namespace BlockCompressor
+    {
+        enum Format
+        {
+            // RGB, 8 bytes per block
+            FORMAT_BC1,
+            // BC1 color with a separate alpha block, 16 bytes
+            FORMAT_BC3,
+            // One channel from red, 8 bytes
+            FORMAT_BC4,
+            // Two channels from red and green, 16 bytes
+            FORMAT_BC5,
+            // RGBA, 16 bytes
+            FORMAT_BC7
+        };
+
+        GLenum GetGLFormat(Format f);
+
+        // "bc1", "bc3", "bc4", "bc5" or "bc7", false for anything else
+        bool ParseFormat(std::string_view name, Format& f);
+
+        // width * height texels, rows tightly packed. Blocks over the border repeat the last row and column.
+        //     Every block row is one job on Common::ThreadPool writing only its own bytes, so threadAmount does not change the result.
+        //     threadAmount limits the threads including the caller, 0 uses all
+        std::vector<std::byte> CompressLevel(std::span<const uint8_t> rgba, int width, int height, Format f, size_t threadAmount = 0);
+
+        // Half size by averaging 2x2 texels, sizes stop at 1 and odd sizes repeat the last row or column
+        std::vector<uint8_t> Downsample(std::span<const uint8_t> rgba, int width, int height);
+
+        // Full size down to 1x1, level i is width >> i by height >> i
+        std::vector<std::vector<std::byte>> CompressMipChain(std::span<const uint8_t> rgba, int width, int height, Format f, size_t threadAmount = 0);
+    }
+}
+
+#endif
\ No newline at end of file
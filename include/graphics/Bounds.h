@@ -0,0 +1,38 @@
+#ifndef __BOUNDS_H__
+#define __BOUNDS_H__
+
+#include "glm/glm.hpp"
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <span>
+
+namespace RyuRenderer::Graphics
+{
+    // Axis aligned box and bounding sphere of the same points, the sphere is centered on the box.
+    //     Default constructed bounds are empty, they contain nothing and merge into anything
+    struct Bounds
+    {
+        glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+        glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+        glm::vec3 Center = glm::vec3(0.f);
+        float Radius = 0.f;
+
+        bool IsValid() const;
+
+        bool operator==(const Bounds& other) const = default;
+
+        // Positions are the first 3 floats of every element, strideBytes apart
+        static Bounds FromPositions(const std::byte* data, std::size_t vertexAmount, std::size_t strideBytes);
+
+        static Bounds FromPositions(std::span<const std::array<float, 3>> positions);
+
+        void Merge(const Bounds& other);
+
+        // Box around the transformed box and sphere around the transformed sphere, scaled by the largest axis scale
+        Bounds Transform(const glm::mat4& m) const;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,82 @@
+#ifndef __COMPRESSEDTEXTUREFILE_H__
+#define __COMPRESSEDTEXTUREFILE_H__
+
+#include "glad/gl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/MappedFile.h"
+
+namespace RyuRenderer::Graphics
+{
+    // Block compressed 2D texture with its mip chain in a KTX2 or DDS file, read through a memory mapping.
+    //     BC1, BC3, BC4, BC5 and BC7 are understood. Cube maps, arrays, 3D textures and supercompressed KTX2 files are rejected.
+    //     Texture2d uploads the levels straight from the mapping, ryu-cook writes KTX2 files.
+    //     Rows go bottom up like the jpg and png files App has stbi flip on load, KTXorientation "ru". DDS files and KTX2 files
+    //     without it are top down, their levels are flipped into a copy. BC7 and heights that are not whole blocks can not be flipped,
+    //     those files keep their rows and IsTopDown(), so the sampler flips V instead
+    class CompressedTextureFile
+    {
+    public:
+        static constexpr std::string_view Ktx2Extension = ".ktx2";
+        static constexpr std::string_view DdsExtension = ".dds";
+        static constexpr std::string_view Ktx2OrientationKey = "KTXorientation";
+        static constexpr std::string_view Ktx2Orientation = "ru";
+
+        // Blocks of 4x4 texels row by row, the last row and column are padded up to whole blocks
+        struct Level
+        {
+            int Width = 0;
+            int Height = 0;
+            std::span<const std::byte> Bytes;
+        };
+
+        static bool IsCompressedTexturePath(const std::string& filePath);
+
+        // 8 or 16 bytes for the formats above, 0 for any other format
+        static size_t GetBlockBytes(GLenum format);
+
+        static size_t GetLevelBytes(GLenum format, int width, int height);
+
+        // levels[0] is the full size, every further level halves both sizes down to at least 1
+        static bool WriteKtx2(const std::string& filePath, GLenum format, int width, int height, const std::vector<std::vector<std::byte>>& levels);
+
+        // Closes the file held before, false with a message when it can not be read or has an unsupported layout
+        bool Open(const std::string& filePath);
+
+        void Close();
+
+        bool IsOpen() const;
+
+        GLenum GetFormat() const;
+
+        const std::vector<Level>& GetLevels() const;
+
+        // Rows of every level go top down, texture coordinates have to be sampled at 1 - v
+        bool IsTopDown() const;
+    private:
+        bool ReadKtx2();
+
+        bool ReadDds();
+
+        // Appends a level of the given size at offset, false when it does not fit into the file
+        bool AddLevel(uint64_t offset, int width, int height);
+
+        // Turns top down levels bottom up, marks them top down when the format or a level height does not allow moving blocks
+        void FlipLevels();
+
+        Common::MappedFile file;
+        GLenum format = GL_NONE;
+        std::vector<Level> levels;
+        bool isTopDown = false;
+        // Levels point here instead of into the mapping once flipped
+        std::vector<std::byte> flippedBytes;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -32,25 +32,29 @@ namespace RyuRenderer::Graphics
 
         bool Attach(Texture2d* t, GLint colorAttachmentIdx);
 
+        bool AttachDepthStencil(int width, int height);
+
         bool Use() const;
 
         static void Unuse();
 
+        // Frame bound by Unuse(), the window framebuffer is used if it is null.
+        static void SetDefault(const Frame* f);
+
         static GLint GetColorAttachmentId(GLint colorAttachmentIdx);
 
         static GLint GetColorAttachmentIdx(GLint colorAttachmentId);
-
-        inline static bool IsCleanMode = true;
     private:
         void Clear();
 
         static GLint GetMaxColorAttachmentAmount();
 
         GLuint id = 0;
+        GLuint depthStencilId = 0;
         bool frameCompleted = false;
 
         inline static GLint maxColorAttachmentAmount = -1;
-        inline static GLuint lastestUsedFrameId = 0;
+        inline static GLuint defaultFrameId = 0;
     };
 }
 
@@ -0,0 +1,28 @@
+#ifndef __FRUSTUM_H__
+#define __FRUSTUM_H__
+
+#include "glm/glm.hpp"
+
+#include <array>
+
+#include "graphics/Bounds.h"
+
+namespace RyuRenderer::Graphics
+{
+    // Six normalized planes pointing inward: left, right, bottom, top, near, far
+    struct Frustum
+    {
+        std::array<glm::vec4, 6> Planes = {};
+
+        // Gribb and Hartmann, the planes of projection * view are in world space
+        static Frustum FromMatrix(const glm::mat4& viewProjection);
+
+        // Conservative, bounds crossing a plane corner may pass. Invalid bounds are always visible
+        bool IsVisible(const Bounds& b) const;
+
+        // Same test for local bounds placed by model, the box is only transformed for spheres crossing a plane
+        bool IsVisible(const Bounds& localBounds, const glm::mat4& model) const;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,179 @@
+#ifndef __GEOMETRYPOOL_H__
+#define __GEOMETRYPOOL_H__
+
+#include "glad/gl.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/OffsetAllocator.h"
+#include "common/Singleton.h"
+#include "graphics/InstanceBuffer.h"
+#include "graphics/VertexArray.h"
+#include "graphics/VertexLayout.h"
+
+namespace RyuRenderer::Graphics
+{
+    // Layout of one command of glMultiDrawElementsIndirect, read by the GPU from GL_DRAW_INDIRECT_BUFFER
+    struct DrawElementsIndirectCommand
+    {
+        GLuint Count = 0;
+        GLuint InstanceCount = 0;
+        GLuint FirstIndex = 0;
+        GLint BaseVertex = 0;
+        GLuint BaseInstance = 0;
+    };
+
+    // Vertices and indices of every static mesh, sub-allocated from a few large immutable buffers.
+    //     Pages hold the vertices of one format, meshes in the same page share all buffer bindings
+    //     and are drawn with glDrawElementsBaseVertex. Compact() moves ranges, so meshes keep a handle
+    //     and read their range from the pool instead of caching offsets.
+    class GeometryPool : public Common::Singleton<GeometryPool>
+    {
+    public:
+        struct Handle
+        {
+            uint32_t Idx = UINT32_MAX;
+            uint32_t Generation = 0;
+
+            bool IsValid() const
+            {
+                return Idx != UINT32_MAX;
+            }
+        };
+
+        // Where the data of one mesh lives, in vertices and indices of its page
+        struct Range
+        {
+            uint32_t PageIdx = 0;
+            GLint BaseVertex = 0;
+            GLuint FirstIndex = 0;
+            GLsizei VertexAmount = 0;
+            GLsizei IndexAmount = 0;
+        };
+
+        struct Stats
+        {
+            size_t PageAmount = 0;
+            size_t AllocationAmount = 0;
+            size_t CapacityBytes = 0;
+            size_t UsedBytes = 0;
+            // Share of the free bytes outside of the largest free range of each page
+            double Fragmentation = 0.0;
+        };
+
+        // Binding strides of the format are the element bytes of the streams, in binding order.
+        //     Index type is GL_UNSIGNED_INT or GL_UNSIGNED_SHORT, pages hold indices of one type
+        Handle Allocate(
+            const VertexFormat& format, std::span<const GLsizei> bindingStrides,
+            GLsizei vertexAmount, GLsizei indexAmount, GLenum indexType = GL_UNSIGNED_INT);
+
+        void Free(Handle handle);
+
+        // Data holds the VertexAmount elements of one binding, tightly packed with its stride
+        bool UploadVertices(Handle handle, GLuint bindingIdx, const void* data);
+
+        // The index type has to match the one given to Allocate
+        bool UploadIndices(Handle handle, std::span<const GLuint> indexData);
+
+        bool UploadIndices(Handle handle, std::span<const GLushort> indexData);
+
+        // Part of a range copied on the GPU from another buffer, e.g. a StagingRing, so large meshes can be uploaded
+        //     over several frames. The read buffer holds the elements tightly packed from readOffset on
+        bool CopyVertices(
+            Handle handle, GLuint bindingIdx, GLuint readBufferId, GLintptr readOffset, GLsizei firstVertex, GLsizei vertexAmount);
+
+        bool CopyIndices(Handle handle, GLuint readBufferId, GLintptr readOffset, GLsizei firstIndex, GLsizei indexAmount);
+
+        // Binds the vertex array, vertex buffers and index buffer of the page of the handle
+        bool Bind(Handle handle) const;
+
+        bool Draw(Handle handle) const;
+
+        // Draws every instance of the buffer, the instances are read from the binding after the ones of the page
+        bool DrawInstanced(Handle handle, const InstanceBuffer& instances) const;
+
+        bool IsUsing(Handle handle) const;
+
+        // Null for stale handles
+        const Range* Find(Handle handle) const;
+
+        // Id of the vertex buffer of the page, meshes sorted by it share their bindings
+        GLuint GetPageId(Handle handle) const;
+
+        GLenum GetIndexType(Handle handle) const;
+
+        // Packs the live ranges of fragmented pages into new buffers and releases empty pages
+        void Compact();
+
+        // Releases every page, handles which are still around become stale.
+        //     Must be called before the device or context goes away
+        void Clear();
+
+        Stats GetStats() const;
+
+        // Capacity of new pages, larger meshes get a page of their own size
+        GLsizei PageVertexCapacity = 1 << 18;
+        GLsizei PageIndexCapacity = 1 << 20;
+    private:
+        friend class Common::Singleton<GeometryPool>;
+
+        struct VertexBufferBinding
+        {
+            GLintptr Offset = 0;
+            GLsizei Stride = 0;
+        };
+
+        struct Page
+        {
+            VertexFormat Format;
+            std::vector<GLsizei> BindingStrides;
+            std::shared_ptr<Graphics::VertexArray> SharedVertexArray;
+            // Format extended by the instance attributes, null when the format has no room for them
+            std::shared_ptr<Graphics::VertexArray> InstancedVertexArray;
+            GLuint VertexBufferId = 0;
+            GLuint IndexBufferId = 0;
+            GLenum IndexType = GL_UNSIGNED_INT;
+            // Binding i starts at the offset of its region, regions are VertexCapacity elements of their stride
+            std::vector<VertexBufferBinding> Bindings;
+            Common::OffsetAllocator Vertices;
+            Common::OffsetAllocator Indices;
+        };
+
+        struct Slot
+        {
+            Range MeshRange;
+            // Bumped whenever the slot is freed, handles of older generations are stale
+            uint32_t Generation = 0;
+            bool IsUsed = false;
+        };
+
+        GeometryPool() = default;
+
+        // Returns UINT32_MAX on failure
+        uint32_t CreatePage(
+            const VertexFormat& format, std::span<const GLsizei> bindingStrides,
+            GLsizei vertexCapacity, GLsizei indexCapacity, GLenum indexType);
+
+        bool CreatePageBuffers(Page& page, GLsizei vertexCapacity, GLsizei indexCapacity);
+
+        void BindPageBuffers(const Page& page) const;
+
+        bool UploadIndexBytes(Handle handle, const void* data, size_t indexAmount, GLenum indexType);
+
+        static size_t GetIndexBytes(GLenum indexType);
+
+        void ReleasePage(uint32_t pageIdx);
+
+        const Slot* FindSlot(Handle handle) const;
+
+        std::vector<std::unique_ptr<Page>> pages;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlotIdxs;
+    };
+}
+
+#endif
\ No newline at end of file
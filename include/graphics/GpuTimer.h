@@ -0,0 +1,104 @@
+#ifndef __GPUTIMER_H__
+#define __GPUTIMER_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "common/Singleton.h"
+
+namespace RyuRenderer::Graphics
+{
+    // GPU time of render passes through GL_TIME_ELAPSED queries. Queries of a frame are kept in a ring
+    //     and read back FrameLatency frames later, so measuring never waits for the GPU.
+    //     Passes can not be nested, a GL context only runs one elapsed time query at once.
+    class GpuTimer : public Common::Singleton<GpuTimer>
+    {
+    public:
+        struct PassTime
+        {
+            // String literal, only the pointer is stored
+            const char* Name = nullptr;
+            double TimeInMs = 0.0;
+            // Profiler clock time when the pass was submitted
+            unsigned long long SubmitTimeInNs = 0;
+        };
+
+        class ScopedPass
+        {
+        public:
+            ScopedPass(const char* name);
+
+            ~ScopedPass();
+
+            ScopedPass(const ScopedPass& other) = delete;
+
+            ScopedPass& operator=(const ScopedPass& other) = delete;
+        private:
+            bool isBegun = false;
+        };
+
+        // Called by App::Run before every frame, reads back the oldest frame in the ring
+        void BeginFrame();
+
+        bool BeginPass(const char* name);
+
+        void EndPass();
+
+        // Reads back every pending frame (waiting for the GPU) and releases all queries,
+        //     must be called before the device or context goes away
+        void Clear();
+
+        // Passes of the newest frame read back, it is FrameLatency frames behind the current one
+        const std::vector<PassTime>& GetLatestPassTimes() const;
+
+        unsigned long long GetLatestFrameIdx() const;
+
+        // Frames whose results were not ready when their slot got reused
+        unsigned long long GetDroppedFrameAmount() const;
+
+        bool IsEnabled = true;
+
+        static constexpr size_t FrameLatency = 3;
+    private:
+        friend class Common::Singleton<GpuTimer>;
+
+        struct FrameSlot
+        {
+            unsigned long long FrameIdx = 0;
+            bool IsPending = false;
+            // Query names are kept and reused by later frames of the slot
+            std::vector<GLuint> Queries;
+            std::vector<PassTime> Passes;
+        };
+
+        GpuTimer() = default;
+
+        bool ReadBack(FrameSlot& slot, bool isWaiting);
+
+        std::array<FrameSlot, FrameLatency> slots;
+        unsigned long long frameIdx = 0;
+        bool isPassBegun = false;
+
+        std::vector<PassTime> latestPassTimes;
+        unsigned long long latestFrameIdx = 0;
+        unsigned long long droppedFrameAmount = 0;
+
+        // Passes are laid one after another on the GPU track of the profiler
+        unsigned int trackIdx = 0;
+        bool isTrackCreated = false;
+        unsigned long long trackCursorInNs = 0;
+    };
+}
+
+#ifdef RYU_ENABLE_PROFILER
+#define RYU_PROFILE_GPU_PASS_CONCAT_IMPL(a, b) a##b
+#define RYU_PROFILE_GPU_PASS_CONCAT(a, b) RYU_PROFILE_GPU_PASS_CONCAT_IMPL(a, b)
+#define RYU_PROFILE_GPU_PASS(name) RyuRenderer::Graphics::GpuTimer::ScopedPass RYU_PROFILE_GPU_PASS_CONCAT(ryuProfileGpuPass, __LINE__)(name)
+#else
+#define RYU_PROFILE_GPU_PASS(name)
+#endif
+
+#endif
\ No newline at end of file
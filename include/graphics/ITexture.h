@@ -20,6 +20,9 @@ namespace RyuRenderer::Graphics
 
         virtual std::string GetSource() const = 0;
 
+        // Rows go top down instead of bottom up, materials sample it at 1 - v
+        virtual bool IsTopDown() const = 0;
+
         static GLint GetTextureUnitId(GLint unitIdx)
         {
             return GL_TEXTURE0 + unitIdx;
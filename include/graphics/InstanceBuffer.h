@@ -0,0 +1,105 @@
+#ifndef __INSTANCEBUFFER_H__
+#define __INSTANCEBUFFER_H__
+
+#include "glad/gl.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/VertexLayout.h"
+
+namespace RyuRenderer::Graphics
+{
+    // Per instance vertex attributes, shaders read them at fixed locations after the mesh attributes:
+    //     model columns at 8 to 11, color at 12 and params at 13
+    struct InstanceData
+    {
+        static constexpr GLuint FirstLocation = 8;
+        static constexpr GLuint LocationAmount = 6;
+
+        glm::mat4 Model = glm::identity<glm::mat4>();
+        glm::vec4 Color = { 1.f, 1.f, 1.f, 1.f };
+        // Free for the shader, e.g. a tint strength or an animation phase
+        glm::vec4 Params = { 0.f, 0.f, 0.f, 0.f };
+    };
+
+    static_assert(sizeof(InstanceData) == InstanceData::LocationAmount * sizeof(glm::vec4));
+
+    // Densely packed instance data drawn with glDrawElementsInstanced*, instances are added, removed and updated
+    //     through stable handles. Changes are gathered into one dirty range and uploaded with a single sub data
+    //     call when the buffer is used, the storage is only reallocated when it has to grow.
+    class InstanceBuffer
+    {
+    public:
+        struct Handle
+        {
+            uint32_t Idx = UINT32_MAX;
+            uint32_t Generation = 0;
+
+            bool IsValid() const
+            {
+                return Idx != UINT32_MAX;
+            }
+        };
+
+        InstanceBuffer() = default;
+
+        InstanceBuffer(const InstanceBuffer& other) = delete;
+
+        InstanceBuffer(InstanceBuffer&& other) noexcept;
+
+        ~InstanceBuffer();
+
+        InstanceBuffer& operator=(InstanceBuffer& other) = delete;
+
+        InstanceBuffer& operator=(InstanceBuffer&& other) noexcept;
+
+        Handle Add(const InstanceData& data);
+
+        // The last instance moves into the freed place, handles of other instances stay valid
+        bool Remove(Handle handle);
+
+        bool Update(Handle handle, const InstanceData& data);
+
+        // Null for stale handles
+        const InstanceData* Find(Handle handle) const;
+
+        // Removes every instance, the storage is kept for the next ones
+        void Reset();
+
+        GLsizei GetInstanceAmount() const;
+
+        // Uploads pending changes and binds the instances at bindingIdx
+        bool Use(GLuint bindingIdx) const;
+
+        // Vertex format of a mesh extended by the instance attributes read from bindingIdx.
+        //     Formats with attributes at the instance locations can not be extended, their attribute amount is 0
+        static VertexFormat MakeVertexFormat(const VertexFormat& meshFormat, GLuint bindingIdx);
+    private:
+        struct Slot
+        {
+            uint32_t DenseIdx = 0;
+            uint32_t Generation = 0;
+            bool IsUsed = false;
+        };
+
+        void MarkDirty(uint32_t denseIdx) const;
+
+        void Clear();
+
+        std::vector<InstanceData> instances;
+        std::vector<uint32_t> denseSlotIdxs;
+        std::vector<Slot> slots;
+        std::vector<uint32_t> freeSlotIdxs;
+
+        mutable GLuint id = 0;
+        mutable GLsizeiptr capacity = 0;
+        // Instances [dirtyBegin, dirtyEnd) differ from the GPU copy
+        mutable uint32_t dirtyBegin = UINT32_MAX;
+        mutable uint32_t dirtyEnd = 0;
+    };
+}
+
+#endif
\ No newline at end of file
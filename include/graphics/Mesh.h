@@ -2,173 +2,143 @@
 #define __MESH_H__
 
 #include "glad/gl.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
 
 #include <array>
-#include <bit>
 #include <cstddef>
 #include <iostream>
-#include <vector>
+#include <ranges>
+#include <span>
+#include <tuple>
 #include <type_traits>
-#include <utility>
+#include <vector>
 
 #include "common/Macros.h"
+#include "graphics/Bounds.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/VertexLayout.h"
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
 
 namespace RyuRenderer::Graphics
 {
     namespace MeshImpl
     {
         template <typename T>
-        struct IsStdVectorOfStdArraysImpl : std::false_type {};
+        struct IsStdArrayImpl : std::false_type {};
 
         template <typename T, std::size_t N>
-        requires (N > 0)
-        struct IsStdVectorOfStdArraysImpl<std::vector<std::array<T, N>>> : std::true_type {};
+        requires (N > 0 && N <= 4)
+        struct IsStdArrayImpl<std::array<T, N>> : std::true_type {};
 
+        // std::vector, std::span or any contiguous range of std::array, one array is one vertex attribute
         template <typename T>
-        concept IsStdVectorOfStdArrays = IsStdVectorOfStdArraysImpl<std::remove_cvref_t<T>>::value;
+        concept IsContiguousRangeOfStdArrays =
+            std::ranges::contiguous_range<T> &&
+            std::ranges::sized_range<T> &&
+            IsStdArrayImpl<std::remove_cvref_t<std::ranges::range_value_t<T>>>::value;
     }
 
+    // View of a vertex and index range in the GeometryPool, the mesh frees its range when destroyed
     class Mesh
     {
-        struct VertexAttribute
+    public:
+        // One vertex attribute stream, Data points at VertexAmount tightly packed elements of ElementBytes bytes
+        struct VertexStream
         {
-            VertexAttribute(GLenum dataType, unsigned long long dataStartBytesOffset, unsigned long long dataAmount)
-            {
-                DataType = dataType;
-                DataStartBytesOffset = dataStartBytesOffset;
-                DataAmount = dataAmount;
-            }
-
+            const std::byte* Data = nullptr;
+            std::size_t VertexAmount = 0;
+            std::size_t ElementBytes = 0;
             GLenum DataType = GL_NONE;
-            unsigned long long DataStartBytesOffset = 0;
-            unsigned long long DataAmount = 0;
+            GLint ComponentAmount = 0;
         };
-    public:
+
+        // How shaders turn quantized attributes back into object space values, the default decodes nothing
+        struct VertexDecode
+        {
+            glm::vec3 PositionOffset = { 0.f, 0.f, 0.f };
+            glm::vec3 PositionScale = { 1.f, 1.f, 1.f };
+            bool IsNormalOctahedral = false;
+
+            bool operator==(const VertexDecode& other) const = default;
+
+            // Object space position of a decoded attribute is PositionOffset + attribute * PositionScale
+            glm::mat4 GetPositionMatrix() const;
+
+            bool IsPositionDecoded() const;
+        };
+
+        enum VertexLayoutType
+        {
+            // Every attribute of a vertex next to each other, interleaved on the CPU
+            VERTEX_LAYOUT_INTERLEAVED,
+            // Each stream in its own region of the page, uploaded as it is without any CPU side copy
+            VERTEX_LAYOUT_SEPARATE
+        };
+
         Mesh() = default;
 
+        // Inputs are only read during construction, temporaries and moved vectors bind without copies
+        template<typename... Args>
+        requires (MeshImpl::IsContiguousRangeOfStdArrays<Args> && ...)
+        Mesh(std::span<const GLuint> indexData, const Args&... vertexDataArgs) :
+            Mesh(VERTEX_LAYOUT_INTERLEAVED, indexData, vertexDataArgs...)
+        {
+        }
+
         template<typename... Args>
-        requires (MeshImpl::IsStdVectorOfStdArrays<Args> && ...)
-        Mesh(std::vector<GLuint> indexData, Args&&... vertexDataArgs)
+        requires (MeshImpl::IsContiguousRangeOfStdArrays<Args> && ...)
+        Mesh(VertexLayoutType layout, std::span<const GLuint> indexData, const Args&... vertexDataArgs)
         {
             if constexpr (sizeof...(Args) <= 0)
                 return;
-            const std::size_t vectorSize = (std::forward<Args>(vertexDataArgs).size(), ...);
-            bool allSameSize = ((std::forward<Args>(vertexDataArgs).size() == vectorSize) && ...);
-            FAILTEST_RTN(allSameSize, "All vertex data in vector must have the same size.")
-
-            std::vector<std::byte> vertexData;
-            unsigned long long lastDataStartBytesOffset = 0;
-            std::vector<VertexAttribute> attributes;
-
-            bool isParseFailed = false;
-            for (std::size_t i = 0; i < vectorSize; ++i)
-            {
-                ([&] {
-                    auto& vec = vertexDataArgs;
-                    const auto& arr = vec[i];
-                    for (std::size_t j = 0; j < arr.size(); ++j)
-                    {
-                        const auto& element = arr[j];
-                        AppendToVertexData(vertexData, element);
-
-                        // Vertex Attribute Collection
-                        if (i == 0 && j == 0)
-                        {
-                            GLenum e = GL_NONE;
-                            if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, float>)
-                            {
-                                e = GL_FLOAT;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, double>)
-                            {
-                                e = GL_DOUBLE;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, int>)
-                            {
-                                e = GL_INT;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, unsigned int>)
-                            {
-                                e = GL_UNSIGNED_INT;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, char>)
-                            {
-                                e = GL_BYTE;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, unsigned char>)
-                            {
-                                e = GL_UNSIGNED_BYTE;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, std::byte>)
-                            {
-                                e = GL_UNSIGNED_BYTE;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, short>)
-                            {
-                                e = GL_SHORT;
-                            }
-                            else if constexpr (std::is_same_v<std::remove_cvref_t<decltype(element)>, unsigned short>)
-                            {
-                                e = GL_UNSIGNED_SHORT;
-                            }
-                            else
-                            {
-                                std::cerr << "Unsupported element type." << std::endl;
-                                isParseFailed = true;
-                                break;
-                            }
-                            auto dataAmount = arr.size();
-                            attributes.emplace_back(VertexAttribute(e, lastDataStartBytesOffset, dataAmount));
-
-                            auto arrBytes = sizeof(element) * dataAmount;
-                            lastDataStartBytesOffset += arrBytes;
-                        }
-                    }
-
-                    if (isParseFailed)
-                        return;
-                }(), ...);
-
-                if (isParseFailed)
-                    break;
-            }
-            if (isParseFailed)
-                return;
 
-            FAILTEST_RTN(attributes.size() < GetMaxAttributeAmount(), "Vertex attribute is oversize for OpenGL.")
-
-            // VBOs
-            glGenBuffers(1, &VBOId);
-            // VAOs
-            glGenVertexArrays(1, &VAOId);
-            // IBOs
-            glGenBuffers(1, &EBOId);
-
-            // Fill VBO
-            glBindBuffer(GL_ARRAY_BUFFER, VBOId);
-            glBufferData(GL_ARRAY_BUFFER, sizeof(std::byte) * vertexData.size(), vertexData.data(), GL_STATIC_DRAW);
-
-            // VAO Binding
-            glBindVertexArray(VAOId);
-            lastestUsedVAOId = VAOId;
-            
-            for (int i = 0; i < attributes.size(); ++i)
-            {
-                const auto& a = attributes[i];
-
-                glVertexAttribPointer(i, a.DataAmount, a.DataType, GL_FALSE, lastDataStartBytesOffset, (void*)a.DataStartBytesOffset);
-                glEnableVertexAttribArray(i);
-            }
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            elementSize = indexData.size();
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBOId);
-            glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * elementSize, indexData.data(), GL_STATIC_DRAW);
-
-            // Unbind
-            glBindVertexArray(0);
-            lastestUsedVAOId = 0;
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+            // Type dispatch happens once per stream, never per vertex
+            bool isTypeSupported = true;
+            const std::array<VertexStream, sizeof...(Args)> streams = { MakeVertexStream(vertexDataArgs, isTypeSupported)... };
+            FAILTEST_RTN(isTypeSupported, "Unsupported element type.")
+
+            Create(MakeVertexFormat(layout, streams), layout, MakeIndexStream(indexData), streams);
+        }
+
+        // Streams are checked against the layout at compile time, its format is never rebuilt at runtime
+        template<typename... AttributeTypes, typename... Args>
+        requires (MeshImpl::IsContiguousRangeOfStdArrays<Args> && ...)
+        Mesh(VertexLayout<AttributeTypes...> vertexLayout, std::span<const GLuint> indexData, const Args&... vertexDataArgs) :
+            Mesh(vertexLayout, VERTEX_LAYOUT_INTERLEAVED, indexData, vertexDataArgs...)
+        {
+        }
+
+        template<typename... AttributeTypes, typename... Args>
+        requires (MeshImpl::IsContiguousRangeOfStdArrays<Args> && ...)
+        Mesh(VertexLayout<AttributeTypes...> vertexLayout, VertexLayoutType layout, std::span<const GLuint> indexData, const Args&... vertexDataArgs)
+        {
+            CreateFromLayout(vertexLayout, layout, MakeIndexStream(indexData), vertexDataArgs...);
+        }
+
+        // 16 bit indices, for meshes with at most 65536 vertices
+        template<typename... AttributeTypes, typename... Args>
+        requires (MeshImpl::IsContiguousRangeOfStdArrays<Args> && ...)
+        Mesh(VertexLayout<AttributeTypes...> vertexLayout, std::span<const GLushort> indexData, const Args&... vertexDataArgs) :
+            Mesh(vertexLayout, VERTEX_LAYOUT_INTERLEAVED, indexData, vertexDataArgs...)
+        {
+        }
+
+        template<typename... AttributeTypes, typename... Args>
+        requires (MeshImpl::IsContiguousRangeOfStdArrays<Args> && ...)
+        Mesh(VertexLayout<AttributeTypes...> vertexLayout, VertexLayoutType layout, std::span<const GLushort> indexData, const Args&... vertexDataArgs)
+        {
+            CreateFromLayout(vertexLayout, layout, MakeIndexStream(indexData), vertexDataArgs...);
+        }
+
+        // Allocates the range only, streams of the separate layout and the indices are copied in later through
+        //     GeometryPool::CopyVertices and CopyIndices, e.g. by a streaming load. Bounds are set by the caller
+        template<typename... AttributeTypes>
+        Mesh(VertexLayout<AttributeTypes...>, GLsizei vertexAmount, GLsizei indexAmount, GLenum indexType)
+        {
+            const std::array<GLsizei, sizeof...(AttributeTypes)> bindingStrides = { static_cast<GLsizei>(AttributeTypes::Bytes)... };
+            Allocate(VertexLayout<AttributeTypes...>::SeparateFormat, bindingStrides, vertexAmount, indexAmount, indexType);
         }
 
         Mesh(const Mesh& other) = delete;
@@ -185,33 +155,112 @@ namespace RyuRenderer::Graphics
 
         bool IsUsing() const;
 
+        // Id of the pool page, meshes with equal ids share every buffer binding
+        GLuint GetId() const;
+
+        GLint GetBaseVertex() const;
+
+        GLuint GetFirstIndex() const;
+
+        GLsizei GetIndexAmount() const;
+
+        GLenum GetIndexType() const;
+
+        GeometryPool::Handle GetGeometry() const;
+
+        // Set by whoever quantized the vertex data, materials read it when drawing
+        void SetVertexDecode(const VertexDecode& decode);
+
+        const VertexDecode& GetVertexDecode() const;
+
+        // Object space bounds, computed on creation when the first stream holds float positions
+        void SetBounds(const Bounds& b);
+
+        const Bounds& GetBounds() const;
+
         void Draw() const;
 
-        inline static bool IsCleanMode = true;
+        // One draw of every instance, the instances stay owned by the caller
+        void DrawInstanced(const InstanceBuffer& instances) const;
+
+        // Binds the buffers of the page only, draws of the whole page are then issued by the caller
+        void Bind() const;
+
+        // Command drawing this mesh once, the base instance is free for the caller to index per draw data
+        DrawElementsIndirectCommand GetDrawCommand(GLuint baseInstance) const;
     private:
+        struct IndexStream
+        {
+            const void* Data = nullptr;
+            std::size_t IndexAmount = 0;
+            GLenum DataType = GL_UNSIGNED_INT;
+        };
+
         template <typename T>
-        requires std::is_trivially_copyable_v<T>
-        static void AppendToVertexData(std::vector<std::byte>& vertexData, const T& value)
+        static IndexStream MakeIndexStream(std::span<const T> indexData)
+        {
+            IndexStream stream;
+            stream.Data = indexData.data();
+            stream.IndexAmount = indexData.size();
+            stream.DataType = VertexLayoutImpl::GetDataType<T>();
+            return stream;
+        }
+
+        template<typename... AttributeTypes, typename... Args>
+        void CreateFromLayout(VertexLayout<AttributeTypes...>, VertexLayoutType layout, const IndexStream& indexStream, const Args&... vertexDataArgs)
         {
-            const std::byte* valueAsBytes = reinterpret_cast<const std::byte*>(&value);
+            static_assert(sizeof...(AttributeTypes) == sizeof...(Args), "Vertex data does not match the vertex layout.");
+            static_assert((std::is_same_v<std::remove_cvref_t<std::ranges::range_value_t<Args>>, typename AttributeTypes::ValueType> && ...),
+                "Vertex data does not match the vertex layout.");
 
-            for (int i = 0; i < sizeof(T); ++i)
-            {
-                vertexData.push_back(valueAsBytes[i]);
-            }
+            bool isTypeSupported = true;
+            const std::array<VertexStream, sizeof...(Args)> streams = { MakeVertexStream(vertexDataArgs, isTypeSupported)... };
+
+            using Layout = VertexLayout<AttributeTypes...>;
+            Create(layout == VERTEX_LAYOUT_INTERLEAVED ? Layout::InterleavedFormat : Layout::SeparateFormat, layout, indexStream, streams);
         }
 
+        template <typename T>
+        static VertexStream MakeVertexStream(const T& vertexData, bool& isTypeSupported)
+        {
+            using ArrayType = std::remove_cvref_t<std::ranges::range_value_t<T>>;
+            using ElementType = typename ArrayType::value_type;
+
+            constexpr GLenum dataType = VertexLayoutImpl::GetDataType<ElementType>();
+            if constexpr (dataType == GL_NONE)
+                isTypeSupported = false;
+
+            VertexStream stream;
+            stream.Data = reinterpret_cast<const std::byte*>(std::ranges::data(vertexData));
+            stream.VertexAmount = std::ranges::size(vertexData);
+            stream.ElementBytes = sizeof(ArrayType);
+            stream.DataType = dataType;
+            stream.ComponentAmount = static_cast<GLint>(std::tuple_size_v<ArrayType>);
+            return stream;
+        }
+
+        static VertexFormat MakeVertexFormat(VertexLayoutType layout, std::span<const VertexStream> streams);
+
+        bool Allocate(
+            const VertexFormat& format, std::span<const GLsizei> bindingStrides,
+            GLsizei vertexAmount, GLsizei indexAmount, GLenum indexType);
+
+        void Create(
+            const VertexFormat& format, VertexLayoutType layout,
+            const IndexStream& indexStream, std::span<const VertexStream> streams);
+
+        static void InterleaveStream(
+            std::byte* dst, std::size_t stride, std::size_t offset, const VertexStream& stream);
+
         void Clear();
 
         static GLint GetMaxAttributeAmount();
 
-        GLuint VAOId = 0;
-        size_t elementSize = 0;
-        GLuint VBOId = 0;
-        GLuint EBOId = 0;
+        GeometryPool::Handle geometry;
+        VertexDecode vertexDecode;
+        Bounds bounds;
 
         inline static GLint maxAttributeAmount = -1;
-        inline static GLuint lastestUsedVAOId = 0;
     };
 }
 
@@ -0,0 +1,71 @@
+#ifndef __MESHCOMPRESSION_H__
+#define __MESHCOMPRESSION_H__
+
+#include "glad/gl.h"
+#include "glm/glm.hpp"
+
+#include <array>
+#include <cstddef>
+#include <span>
+
+#include "graphics/Mesh.h"
+#include "graphics/VertexLayout.h"
+
+namespace RyuRenderer::Graphics
+{
+    struct MeshCompressionSettings
+    {
+        bool IsEnabled = false;
+        // Positions as 16 bit fractions of the mesh bounds, decoded with Mesh::VertexDecode
+        bool IsPositionQuantized = true;
+        // 16 bit indices for meshes with at most 65536 vertices
+        bool IsIndexNarrowed = true;
+    };
+
+    // Bytes of one mesh before and after compression, a full draw fetches the same share less
+    struct MeshCompressionStats
+    {
+        std::size_t SourceVertexBytes = 0;
+        std::size_t SourceIndexBytes = 0;
+        std::size_t VertexBytes = 0;
+        std::size_t IndexBytes = 0;
+
+        std::size_t GetSourceBytes() const;
+
+        std::size_t GetBytes() const;
+
+        std::size_t GetSavedBytes() const;
+
+        // Saved share of the source bytes, 0 to 1
+        double GetSavedRatio() const;
+
+        MeshCompressionStats& operator+=(const MeshCompressionStats& other);
+    };
+
+    // Import time compression of meshes with float positions, normals and texture coords.
+    //     Normals are octahedral encoded into two 16 bit snorm values, texture coords become half floats
+    //     and positions are optionally quantized to 16 bit unorm values relative to the mesh bounds.
+    namespace MeshCompression
+    {
+        // Attribute i stays at the location of the float layout, shaders decode them by Mesh::VertexDecode
+        using QuantizedVertexLayout = VertexLayout<Position4u16n, NormalOct2i16n, UV2h>;
+        using CompressedVertexLayout = VertexLayout<Position3f, NormalOct2i16n, UV2h>;
+
+        std::array<short, 2> EncodeOctahedral(const glm::vec3& normal);
+
+        glm::vec3 DecodeOctahedral(const std::array<short, 2>& encoded);
+
+        HalfFloat EncodeHalf(float value);
+
+        // Invalid mesh when the streams differ in length, stats are then left untouched
+        Mesh CreateMesh(
+            std::span<const GLuint> indices,
+            std::span<const std::array<float, 3>> positions,
+            std::span<const std::array<float, 3>> normals,
+            std::span<const std::array<float, 2>> texCoords,
+            const MeshCompressionSettings& settings,
+            MeshCompressionStats* stats = nullptr);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,23 @@
+#ifndef __MESHLODCHAIN_H__
+#define __MESHLODCHAIN_H__
+
+#include <cstddef>
+#include <vector>
+
+#include "graphics/Mesh.h"
+
+namespace RyuRenderer::Graphics
+{
+    // Levels of one mesh from full detail down, only one of them is drawn at a time
+    struct MeshLodChain
+    {
+        std::vector<Mesh> Levels;
+        // Object space error of each level against level 0, never decreasing
+        std::vector<float> Errors;
+
+        // Coarsest level with an error up to maxError, 0 when no coarser level is good enough
+        std::size_t SelectLevel(float maxError) const;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,131 @@
+#ifndef __MESHOPTIMIZER_H__
+#define __MESHOPTIMIZER_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <span>
+#include <vector>
+
+namespace RyuRenderer::Graphics
+{
+    struct MeshOptimizationSettings
+    {
+        bool IsEnabled = true;
+        // Entries of the simulated FIFO post-transform cache, also used for the reports
+        GLuint CacheSize = 16;
+        // Clusters are split for overdraw ordering while their ACMR stays below this factor of the mesh ACMR
+        float OverdrawThreshold = 1.05f;
+    };
+
+    // Post-transform cache efficiency of an index buffer, lower is better for both
+    struct VertexCacheStats
+    {
+        // Average cache miss ratio, transformed vertices per triangle, 0.5 to 3
+        double ACMR = 0.0;
+        // Average transform to vertex ratio, transformed vertices per referenced vertex, 1 at best
+        double ATVR = 0.0;
+    };
+
+    struct MeshOptimizationReport
+    {
+        std::size_t SourceVertexAmount = 0;
+        std::size_t VertexAmount = 0;
+        VertexCacheStats Before;
+        VertexCacheStats After;
+    };
+
+    // Reorders triangle lists for the GPU, every step is deterministic and keeps the rendered result.
+    //     Remaps map old vertex indices to new ones, InvalidIdx for vertices which are dropped
+    namespace MeshOptimizer
+    {
+        inline constexpr GLuint InvalidIdx = 0xffffffffu;
+
+        struct StreamView
+        {
+            const void* Data = nullptr;
+            std::size_t Stride = 0;
+        };
+
+        VertexCacheStats AnalyzeVertexCache(std::span<const GLuint> indices, std::size_t vertexAmount, GLuint cacheSize);
+
+        // Vertices with the same bytes in every stream share one index, returns the unique vertex amount
+        std::size_t GenerateWeldRemap(std::span<const StreamView> streams, std::size_t vertexAmount, std::vector<GLuint>& remap);
+
+        // Tipsify, Sander et al. 2007: fans around vertices which are still in the cache
+        void OptimizeVertexCache(std::span<GLuint> indices, std::size_t vertexAmount, GLuint cacheSize);
+
+        // Splits the cache optimized order into clusters and draws outward facing clusters first,
+        //     so they occlude the rest of the mesh. Costs at most threshold times the ACMR
+        void OptimizeOverdraw(
+            std::span<GLuint> indices, std::span<const std::array<float, 3>> positions, GLuint cacheSize, float threshold);
+
+        // Vertices in the order of their first use, unreferenced ones are dropped. Returns the new vertex amount
+        std::size_t GenerateFetchRemap(std::span<const GLuint> indices, std::size_t vertexAmount, std::vector<GLuint>& remap);
+
+        void RemapIndices(std::span<GLuint> indices, std::span<const GLuint> remap);
+
+        template <typename T>
+        void RemapVertices(std::vector<T>& vertices, std::span<const GLuint> remap, std::size_t newVertexAmount)
+        {
+            std::vector<T> remapped(newVertexAmount);
+            for (std::size_t i = 0; i < vertices.size(); ++i)
+            {
+                if (remap[i] != InvalidIdx)
+                    remapped[remap[i]] = vertices[i];
+            }
+            vertices.swap(remapped);
+        }
+
+        // Welds, optimizes for the vertex cache and overdraw and reorders the vertex fetch of one mesh.
+        //     Every stream is indexed like the positions and is remapped along with them
+        template <typename... Ts>
+        MeshOptimizationReport Optimize(
+            const MeshOptimizationSettings& settings,
+            std::vector<GLuint>& indices,
+            std::vector<std::array<float, 3>>& positions,
+            std::vector<Ts>&... otherStreams)
+        {
+            MeshOptimizationReport report;
+            report.SourceVertexAmount = positions.size();
+            report.VertexAmount = positions.size();
+            report.Before = AnalyzeVertexCache(indices, positions.size(), settings.CacheSize);
+            report.After = report.Before;
+            if (((otherStreams.size() != positions.size()) || ...))
+            {
+                std::cerr << "All vertex data in vector must have the same size." << std::endl;
+                return report;
+            }
+            if (indices.size() % 3 != 0)
+            {
+                std::cerr << "Index data is no triangle list." << std::endl;
+                return report;
+            }
+
+            std::vector<GLuint> remap;
+            const std::array<StreamView, 1 + sizeof...(Ts)> streams = {
+                StreamView{ positions.data(), sizeof(positions[0]) },
+                StreamView{ otherStreams.data(), sizeof(Ts) }... };
+            std::size_t vertexAmount = GenerateWeldRemap(streams, positions.size(), remap);
+            RemapIndices(indices, remap);
+            RemapVertices(positions, remap, vertexAmount);
+            (RemapVertices(otherStreams, remap, vertexAmount), ...);
+
+            OptimizeVertexCache(indices, vertexAmount, settings.CacheSize);
+            OptimizeOverdraw(indices, positions, settings.CacheSize, settings.OverdrawThreshold);
+
+            vertexAmount = GenerateFetchRemap(indices, vertexAmount, remap);
+            RemapIndices(indices, remap);
+            RemapVertices(positions, remap, vertexAmount);
+            (RemapVertices(otherStreams, remap, vertexAmount), ...);
+
+            report.VertexAmount = vertexAmount;
+            report.After = AnalyzeVertexCache(indices, vertexAmount, settings.CacheSize);
+            return report;
+        }
+    }
+}
+
+#endif
\ No newline at end of file
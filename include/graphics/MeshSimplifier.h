@@ -0,0 +1,42 @@
+#ifndef __MESHSIMPLIFIER_H__
+#define __MESHSIMPLIFIER_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <vector>
+
+namespace RyuRenderer::Graphics
+{
+    struct MeshLodLevelSettings
+    {
+        // Share of the triangles of the full detail mesh
+        float TriangleRatio = 0.5f;
+        // Largest allowed deviation as share of the mesh bounds diagonal, the level has more triangles when it is hit first
+        float MaxError = 0.01f;
+    };
+
+    struct MeshLodSettings
+    {
+        bool IsEnabled = true;
+        // Coarser levels after the full detail one, the chain stops at the first level which saves less than 10% triangles
+        std::vector<MeshLodLevelSettings> Levels = { { 0.5f, 0.005f }, { 0.25f, 0.01f }, { 0.125f, 0.02f } };
+    };
+
+    // Quadric error edge collapse (Garland and Heckbert 1997) onto existing vertices, so every level indexes the input vertices.
+    //     Vertices on open borders and on attribute seams (equal positions with different attributes) are never moved
+    namespace MeshSimplifier
+    {
+        // Returns the object space error of the result, an area weighted RMS distance to the source surface
+        float Simplify(
+            std::span<const GLuint> indices, std::span<const std::array<float, 3>> positions,
+            std::size_t targetIndexAmount, float maxError, std::vector<GLuint>& result);
+
+        // Diagonal of the bounds of the referenced positions, MeshLodLevelSettings::MaxError is relative to it
+        float GetExtent(std::span<const GLuint> indices, std::span<const std::array<float, 3>> positions);
+    }
+}
+
+#endif
\ No newline at end of file
@@ -5,14 +5,61 @@
 #include "glm/glm.hpp"
 
 #include <cstddef>
+#include <functional>
+#include <span>
 #include <string>
-#include <vector>
+#include <string_view>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "graphics/VertexLayout.h"
+#include "graphics/device/IDevice.h"
 
 namespace RyuRenderer::Graphics
 {
+    // Index into the uniform table of one shader
+    struct UniformHandle
+    {
+        GLint Idx = -1;
+
+        bool IsValid() const
+        {
+            return Idx >= 0;
+        }
+    };
+
     class Shader
     {
+        struct UniformInfo
+        {
+            std::string Name;
+            GLint Location = -1;
+            GLenum Type = GL_NONE;
+            GLint ArraySize = 0;
+            // Byte range of the value in uniformShadow, ShadowKnownSize bytes of it match the program
+            std::size_t ShadowOffset = 0;
+            std::size_t ShadowSize = 0;
+            std::size_t ShadowKnownSize = 0;
+        };
+
+        struct VertexInputInfo
+        {
+            std::string Name;
+            GLint Location = -1;
+            GLenum Type = GL_NONE;
+        };
+
+        struct UniformNameHash
+        {
+            using is_transparent = void;
+
+            std::size_t operator()(std::string_view name) const
+            {
+                return std::hash<std::string_view>{}(name);
+            }
+        };
     public:
         Shader() = default;
 
@@ -32,192 +79,109 @@ namespace RyuRenderer::Graphics
 
         bool Use() const;
 
-        bool SetUniform(const std::string& uniformName, const std::vector<bool>& bools);
+        // Resolves a uniform once, the handle stays valid for the lifetime of this shader
+        UniformHandle GetUniformHandle(std::string_view uniformName);
 
+        // Name based setters resolve the handle on every call, prefer handles on hot paths
         template<typename... Args>
-        std::enable_if_t<(std::is_same_v<Args, bool> && ...), bool>
-            SetUniform(const std::string& uniformName, Args... args)
+        bool SetUniform(std::string_view uniformName, Args&&... args)
         {
-            if (!IsUsing())
-                return false;
-
-            GLint loc = GetUniformLocation(uniformName);
-            if (loc == -1)
-                return false;
+            return SetUniform(GetUniformHandle(uniformName), std::forward<Args>(args)...);
+        }
 
+        template<typename... Args>
+        std::enable_if_t<(std::is_same_v<Args, bool> && ...), bool>
+            SetUniform(UniformHandle handle, Args... args)
+        {
             constexpr std::size_t numArgs = sizeof...(Args);
             static_assert(numArgs >= 1 && numArgs <= 4, "Error: Unsupported number of arguments in SetUniformWithBool.");
 
-            if constexpr (numArgs == 1)
-            {
-                glUniform1i(loc, args...);
-            }
-            else if constexpr (numArgs == 2)
-            {
-                glUniform2i(loc, args...);
-            }
-            else if constexpr (numArgs == 3)
-            {
-                glUniform3i(loc, args...);
-            }
-            else if constexpr (numArgs == 4)
-            {
-                glUniform4i(loc, args...);
-            }
-            return true;
+            const GLint values[] = { static_cast<GLint>(args)... };
+            return UploadUniform(handle, values, sizeof(values), [&](GLint loc) {
+                Device::IDevice::Current().Uniformiv(loc, static_cast<GLint>(numArgs), 1, values);
+            });
         }
 
-        bool SetUniform(const std::string& uniformName, const std::vector<int>& ints);
-
         template<typename... Args>
         std::enable_if_t<(std::is_same_v<Args, int> && ...), bool>
-            SetUniform(const std::string& uniformName, Args... args)
+            SetUniform(UniformHandle handle, Args... args)
         {
-            if (!IsUsing())
-                return false;
-
-            GLint loc = GetUniformLocation(uniformName);
-            if (loc == -1)
-                return false;
-
             constexpr std::size_t numArgs = sizeof...(Args);
             static_assert(numArgs >= 1 && numArgs <= 4, "Error: Unsupported number of arguments in SetUniformWithInt.");
 
-            if constexpr (numArgs == 1)
-            {
-                glUniform1i(loc, args...);
-            }
-            else if constexpr (numArgs == 2)
-            {
-                glUniform2i(loc, args...);
-            }
-            else if constexpr (numArgs == 3)
-            {
-                glUniform3i(loc, args...);
-            }
-            else if constexpr (numArgs == 4)
-            {
-                glUniform4i(loc, args...);
-            }
-            return true;
+            const GLint values[] = { static_cast<GLint>(args)... };
+            return UploadUniform(handle, values, sizeof(values), [&](GLint loc) {
+                Device::IDevice::Current().Uniformiv(loc, static_cast<GLint>(numArgs), 1, values);
+            });
         }
 
-        bool SetUniform(const std::string& uniformName, const std::vector<unsigned int>& uints);
-
         template<typename... Args>
         std::enable_if_t<(std::is_same_v<Args, unsigned int> && ...), bool>
-            SetUniform(const std::string& uniformName, Args... args)
+            SetUniform(UniformHandle handle, Args... args)
         {
-            if (!IsUsing())
-                return false;
-
-            GLint loc = GetUniformLocation(uniformName);
-            if (loc == -1)
-                return false;
-
             constexpr std::size_t numArgs = sizeof...(Args);
             static_assert(numArgs >= 1 && numArgs <= 4, "Error: Unsupported number of arguments in SetUniformWithUInt.");
 
-            if constexpr (numArgs == 1)
-            {
-                glUniform1ui(loc, args...);
-            }
-            else if constexpr (numArgs == 2)
-            {
-                glUniform2ui(loc, args...);
-            }
-            else if constexpr (numArgs == 3)
-            {
-                glUniform3ui(loc, args...);
-            }
-            else if constexpr (numArgs == 4)
-            {
-                glUniform4ui(loc, args...);
-            }
-            return true;
+            const GLuint values[] = { static_cast<GLuint>(args)... };
+            return UploadUniform(handle, values, sizeof(values), [&](GLint loc) {
+                Device::IDevice::Current().Uniformuiv(loc, static_cast<GLint>(numArgs), 1, values);
+            });
         }
 
-        bool SetUniform(const std::string& uniformName, const glm::vec2& floats);
-
-        bool SetUniform(const std::string& uniformName, const glm::vec3& floats);
-
-        bool SetUniform(const std::string& uniformName, const glm::vec4& floats);
-
-        bool SetUniform(const std::string& uniformName, const std::vector<float>& floats);
-
         template<typename... Args>
         std::enable_if_t<(std::is_same_v<Args, float> && ...), bool>
-            SetUniform(const std::string& uniformName, Args... args)
+            SetUniform(UniformHandle handle, Args... args)
         {
-            if (!IsUsing())
-                return false;
-
-            GLint loc = GetUniformLocation(uniformName);
-            if (loc == -1)
-                return false;
-
             constexpr std::size_t numArgs = sizeof...(Args);
             static_assert(numArgs >= 1 && numArgs <= 4, "Error: Unsupported number of arguments in SetUniformWithFloat.");
 
-            if constexpr (numArgs == 1)
-            {
-                glUniform1f(loc, args...);
-            }
-            else if constexpr (numArgs == 2)
-            {
-                glUniform2f(loc, args...);
-            }
-            else if constexpr (numArgs == 3)
-            {
-                glUniform3f(loc, args...);
-            }
-            else if constexpr (numArgs == 4)
-            {
-                glUniform4f(loc, args...);
-            }
-            return true;
+            const GLfloat values[] = { static_cast<GLfloat>(args)... };
+            return UploadUniform(handle, values, sizeof(values), [&](GLint loc) {
+                Device::IDevice::Current().Uniformfv(loc, static_cast<GLint>(numArgs), 1, values);
+            });
         }
 
-        bool SetUniform(const std::string& uniformName, const std::vector<double>& doubles);
-
         template<typename... Args>
         std::enable_if_t<(std::is_same_v<Args, double> && ...), bool>
-            SetUniform(const std::string& uniformName, Args... args)
+            SetUniform(UniformHandle handle, Args... args)
         {
-            if (!IsUsing())
-                return false;
-
-            GLint loc = GetUniformLocation(uniformName);
-            if (loc == -1)
-                return false;
-
             constexpr std::size_t numArgs = sizeof...(Args);
             static_assert(numArgs >= 1 && numArgs <= 4, "Error: Unsupported number of arguments in SetUniformWithDouble.");
 
-            if constexpr (numArgs == 1)
-            {
-                glUniform1d(loc, args...);
-            }
-            else if constexpr (numArgs == 2)
-            {
-                glUniform2d(loc, args...);
-            }
-            else if constexpr (numArgs == 3)
-            {
-                glUniform3d(loc, args...);
-            }
-            else if constexpr (numArgs == 4)
-            {
-                glUniform4d(loc, args...);
-            }
-            return true;
+            const GLdouble values[] = { static_cast<GLdouble>(args)... };
+            return UploadUniform(handle, values, sizeof(values), [&](GLint loc) {
+                Device::IDevice::Current().Uniformdv(loc, static_cast<GLint>(numArgs), 1, values);
+            });
         }
 
-        bool SetUniform(const std::string& uniformName, const glm::mat2& mat);
+        bool SetUniform(UniformHandle handle, const glm::vec2& floats);
 
-        bool SetUniform(const std::string& uniformName, const glm::mat3& mat);
+        bool SetUniform(UniformHandle handle, const glm::vec3& floats);
 
-        bool SetUniform(const std::string& uniformName, const glm::mat4& mat);
+        bool SetUniform(UniformHandle handle, const glm::vec4& floats);
+
+        bool SetUniform(UniformHandle handle, const glm::mat2& mat);
+
+        bool SetUniform(UniformHandle handle, const glm::mat3& mat);
+
+        bool SetUniform(UniformHandle handle, const glm::mat4& mat);
+
+        // Array setters, components is the vector size of one element, values.size() / components elements are uploaded
+        bool SetUniform(UniformHandle handle, std::span<const GLint> values, GLint components = 1);
+
+        bool SetUniform(UniformHandle handle, std::span<const GLuint> values, GLint components = 1);
+
+        bool SetUniform(UniformHandle handle, std::span<const GLfloat> values, GLint components = 1);
+
+        bool SetUniform(UniformHandle handle, std::span<const GLdouble> values, GLint components = 1);
+
+        bool SetUniform(UniformHandle handle, std::span<const glm::vec2> values);
+
+        bool SetUniform(UniformHandle handle, std::span<const glm::vec3> values);
+
+        bool SetUniform(UniformHandle handle, std::span<const glm::vec4> values);
+
+        bool SetUniform(UniformHandle handle, std::span<const glm::mat4> values);
 
         bool SaveLocalGPUBinaryToFile(const std::string& localGPUBinaryFilePath) const;
 
@@ -225,11 +189,15 @@ namespace RyuRenderer::Graphics
 
         bool IsUsing() const;
 
+        // Logs every vertex shader input the format does not feed with a matching type.
+        //     The shader can not know its format, ShaderManager runs it when given one, other callers have to after linking
+        bool CheckVertexFormat(const VertexFormat& format) const;
+
+        GLuint GetId() const;
+
         const std::string& GetVertexSource() const;
         const std::string& GetFragmentSource() const;
         const std::string& GetBinarySource() const;
-        
-        inline static bool IsCleanMode = true;
     private:
         void Clear();
 
@@ -249,16 +217,55 @@ namespace RyuRenderer::Graphics
             GLuint& shaderProgram
         );
 
-        GLint GetUniformLocation(const std::string& uniformName);
+        static void DowngradeVersionDirective(std::string& shaderSourceCode);
+
+        void ReflectUniforms();
+
+        void ReflectVertexInputs();
+
+        GLint AddUniform(UniformInfo&& uniform);
+
+        // Returns false when the shadow copy already holds the same value, so the upload can be skipped
+        bool UpdateUniformShadow(UniformInfo& uniform, const void* data, std::size_t dataSize);
+
+        template<typename F>
+        bool UploadUniform(UniformHandle handle, const void* data, std::size_t dataSize, F&& upload)
+        {
+            if (!IsUsing())
+                return false;
+
+            if (!handle.IsValid() || static_cast<std::size_t>(handle.Idx) >= uniforms.size())
+                return false;
+
+            auto& u = uniforms[handle.Idx];
+            if (u.Location == -1)
+                return false;
+
+            if (UpdateUniformShadow(u, data, dataSize))
+                upload(u.Location);
+            return true;
+        }
+
+        static std::size_t GetUniformTypeSize(GLenum type);
+
+        // Zero for inputs which can not be fed by glVertexAttribFormat
+        static GLint GetVertexInputComponentAmount(GLenum type);
 
         GLuint programId = 0;
-        std::unordered_map<std::string, GLint> uniformLocations;
+
+        // Flat table of every uniform outside of uniform blocks, handles index into it
+        std::vector<UniformInfo> uniforms;
+        std::unordered_map<std::string, GLint, UniformNameHash, std::equal_to<>> uniformIdxs;
+        std::vector<std::byte> uniformShadow;
+
+        // Active inputs of the vertex stage, built-in inputs are not included
+        std::vector<VertexInputInfo> vertexInputs;
 
         std::string vertexSource;
         std::string fragmentSource;
         std::string binarySource;
 
-        inline static GLuint lastestUsedProgramId = 0;
+        inline static GLint maxGLSLVersion = -1;
     };
 }
 
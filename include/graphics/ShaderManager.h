@@ -21,6 +21,13 @@ namespace RyuRenderer::Graphics
                 const std::string& localGPUBinaryFilePath
             );
 
+            // Runs Shader::CheckVertexFormat against the format the shader is drawn with, once right after linking
+            std::shared_ptr<Shader> FindOrCreate(
+                const std::string& vertexShaderFilePath,
+                const std::string& fragmentShaderFilePath,
+                const VertexFormat& expectedFormat
+            );
+
             bool BeforeCreate(const std::string& vertexShaderFilePath, const std::string& fragmentShaderFilePath);
 
             bool BeforeCreate(const std::string& localGPUBinaryFilePath);
@@ -0,0 +1,83 @@
+#ifndef __STAGINGRING_H__
+#define __STAGINGRING_H__
+
+#include "glad/gl.h"
+
+#include <cstddef>
+#include <deque>
+
+namespace RyuRenderer::Graphics
+{
+    // Persistently mapped upload buffer, the CPU writes into it and GPU copies read from it into other buffers and textures.
+    //     Space is handed out front to back and wraps around, one fence per frame tells when the GPU has read a frame's bytes.
+    //     Writers never wait for the GPU, Allocate() fails instead while the ring is full
+    class StagingRing
+    {
+    public:
+        struct Allocation
+        {
+            // Read offset of the copy commands, the ring is bound to GL_COPY_READ_BUFFER or GL_PIXEL_UNPACK_BUFFER by the caller
+            GLintptr Offset = 0;
+            std::byte* Data = nullptr;
+
+            bool IsValid() const
+            {
+                return Data != nullptr;
+            }
+        };
+
+        StagingRing() = default;
+
+        StagingRing(GLsizeiptr c);
+
+        StagingRing(const StagingRing& other) = delete;
+
+        StagingRing(StagingRing&& other) noexcept;
+
+        ~StagingRing();
+
+        StagingRing& operator=(StagingRing& other) = delete;
+
+        StagingRing& operator=(StagingRing&& other) noexcept;
+
+        // Invalid when the GPU may still read the bytes in the way, alignment is a power of two
+        Allocation Allocate(GLsizeiptr bytes, GLsizeiptr alignment = 4);
+
+        // Room for as many elements as fit, up to maxElementAmount. Copies split into pieces of whole elements this way,
+        //     e.g. vertices or texture rows
+        Allocation AllocateElements(GLsizeiptr elementBytes, size_t maxElementAmount, size_t& elementAmount);
+
+        // Fences everything allocated since the last call, once per frame after the copies reading it were issued
+        void EndFrame();
+
+        bool IsValid() const;
+
+        GLuint GetId() const;
+
+        GLsizeiptr GetCapacity() const;
+
+        // Bytes the GPU has not released yet, alignment and wrap around waste included
+        GLsizeiptr GetUsedBytes() const;
+    private:
+        struct Region
+        {
+            GLsync Fence = nullptr;
+            GLsizeiptr Bytes = 0;
+        };
+
+        // Releases the regions of frames the GPU has finished, oldest first
+        void Retire();
+
+        void Clear();
+
+        GLuint id = 0;
+        std::byte* data = nullptr;
+        GLsizeiptr capacity = 0;
+        GLintptr head = 0;
+        GLsizeiptr usedBytes = 0;
+        GLsizeiptr frameBytes = 0;
+        std::deque<Region> regions;
+    };
+}
+
+#endif
\ No newline at end of file
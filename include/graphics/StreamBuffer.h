@@ -0,0 +1,59 @@
+#ifndef __STREAMBUFFER_H__
+#define __STREAMBUFFER_H__
+
+#include "glad/gl.h"
+
+#include <span>
+#include <type_traits>
+
+namespace RyuRenderer::Graphics
+{
+    // Buffer whose whole content is rewritten every frame, like per draw storage and indirect commands.
+    //     Storage grows to the largest upload and is orphaned on every update, so frames in flight never stall it.
+    //     Uniform and shader storage targets are bound at bindingIdx, other targets at their generic binding.
+    class StreamBuffer
+    {
+    public:
+        StreamBuffer() = default;
+
+        StreamBuffer(GLenum t, GLuint bIdx = 0);
+
+        StreamBuffer(const StreamBuffer& other) = delete;
+
+        StreamBuffer(StreamBuffer&& other) noexcept;
+
+        ~StreamBuffer();
+
+        StreamBuffer& operator=(StreamBuffer& other) = delete;
+
+        StreamBuffer& operator=(StreamBuffer&& other) noexcept;
+
+        bool Update(const void* data, GLsizeiptr dataSize);
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        bool Update(std::span<const T> elements)
+        {
+            return Update(elements.data(), static_cast<GLsizeiptr>(elements.size_bytes()));
+        }
+
+        bool Use() const;
+
+        bool IsValid() const;
+
+        bool IsUsing() const;
+
+        GLuint GetId() const;
+    private:
+        bool IsIndexedTarget() const;
+
+        void Clear();
+
+        GLuint id = 0;
+        GLenum target = GL_NONE;
+        GLuint bindingIdx = 0;
+        GLsizeiptr capacity = 0;
+    };
+}
+
+#endif
\ No newline at end of file
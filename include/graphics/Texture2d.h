@@ -4,7 +4,6 @@
 #include "glad/gl.h"
 
 #include <string>
-#include <unordered_map>
 
 #include "graphics/ITexture.h"
 
@@ -17,8 +16,12 @@ namespace RyuRenderer::Graphics
 
         Texture2d(GLenum f, GLint uIdx, int w, int h);
         
+        // jpg and png files are decoded and get generated mip levels, KTX2 and DDS files are uploaded with the block compressed levels they hold
         Texture2d(const std::string& textureFilePath, GLint unitIdx = 0, GLenum sWrapping = GL_REPEAT, GLenum tWrapping = GL_REPEAT);
 
+        // Storage of level 0 only under the given source, filled by UploadRows and completed by GenerateMipmap
+        Texture2d(const std::string& textureSource, GLenum f, int w, int h, GLint unitIdx, GLenum sWrapping = GL_REPEAT, GLenum tWrapping = GL_REPEAT);
+
         Texture2d(const Texture2d& other) = delete;
 
         Texture2d(Texture2d&& other) noexcept;
@@ -29,6 +32,19 @@ namespace RyuRenderer::Graphics
 
         Texture2d& operator=(Texture2d&& other) noexcept;
 
+        // Pixels of the texture format with 4 byte aligned rows, an offset when a GL_PIXEL_UNPACK_BUFFER is bound.
+        //     Rows of compressed formats are rows of 4x4 blocks
+        bool UploadRows(GLint firstRow, GLsizei rowAmount, const void* pixels, GLint level = 0);
+
+        // Compressed textures bring their levels, nothing is generated for them
+        void GenerateMipmap();
+
+        // Empty levels of another format and size, e.g. a placeholder growing into the real image. Name and unit stay, so users keep it.
+        //     Uncompressed formats get their lower levels from GenerateMipmap(), compressed ones sample only levelAmount levels
+        bool Reallocate(GLenum f, int w, int h, GLint levelAmount = 1, bool isTopDownRows = false);
+
+        bool IsCompressed() const;
+
         bool Use() const override;
 
         bool IsValid() const override;
@@ -39,8 +55,11 @@ namespace RyuRenderer::Graphics
 
         std::string GetSource() const override;
 
-        inline static bool IsCleanMode = true;
+        // Only compressed files which could not be flipped on load are top down
+        bool IsTopDown() const override;
     private:
+        void LoadCompressed(const std::string& textureFilePath, GLint unitIdx, GLenum sWrapping, GLenum tWrapping);
+
         void Clear();
 
         static GLint GetMaxTextureAmount();
@@ -50,10 +69,10 @@ namespace RyuRenderer::Graphics
         GLenum format = GL_NONE;
         int width = 0;
         int height = 0;
+        bool isTopDown = false;
         std::string source;
 
         inline static GLint maxTextureAmount = -1;
-        inline static std::unordered_map<GLint, GLuint> lastestUsedTexture2dIds;
     };
 }
 
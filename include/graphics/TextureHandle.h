@@ -0,0 +1,25 @@
+#ifndef __TEXTUREHANDLE_H__
+#define __TEXTUREHANDLE_H__
+
+#include <cstdint>
+
+namespace RyuRenderer::Graphics
+{
+    // Slot of a texture registered in TextureManager, resolved by TextureManager::Resolve.
+    //     Holds no reference, so copying it costs nothing. Once the texture is removed the slot generation moves on
+    //     and the handle resolves to nullptr instead of a freed texture
+    struct TextureHandle
+    {
+        int32_t SlotIdx = -1;
+        uint32_t Generation = 0;
+
+        bool IsValid() const
+        {
+            return SlotIdx >= 0;
+        }
+
+        bool operator==(const TextureHandle& other) const = default;
+    };
+}
+
+#endif
\ No newline at end of file
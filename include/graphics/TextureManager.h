@@ -3,11 +3,18 @@
 
 #include "glad/gl.h"
 
+#include <future>
+#include <list>
 #include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "common/Factory.h"
 #include "common/Singleton.h"
+#include "graphics/StagingRing.h"
 #include "graphics/Texture2d.h"
+#include "graphics/TextureHandle.h"
 
 namespace RyuRenderer::Graphics
 {
@@ -20,6 +27,25 @@ namespace RyuRenderer::Graphics
 
             std::shared_ptr<Texture2d> Create2d(const std::string& source, GLint unitIdx = 0, GLenum sWrapping = GL_REPEAT, GLenum tWrapping = GL_REPEAT);
 
+            // Returns at once. An unknown file gets a black 1x1 placeholder under its source, which is decoded on Common::ThreadPool
+            //     and filled in by UpdateUploads(). Requests for the same source while it decodes share the placeholder.
+            //     KTX2 and DDS files are only read on the worker and stream their blocks level by level. Render thread only
+            std::shared_ptr<Texture2d> FindOrCreate2dAsync(const std::string& source, GLint unitIdx = 0, GLenum sWrapping = GL_REPEAT, GLenum tWrapping = GL_REPEAT);
+
+            // Uploads decoded images through a pixel unpack staging ring, at most UploadBytesPerFrame. Once per frame, never waits
+            void UpdateUploads();
+
+            // Decoding or uploading
+            size_t GetPendingAmount() const;
+
+            size_t GetLastFrameUploadedBytes() const;
+
+            // Drops pending uploads too, their placeholders stay black. Every handle turns stale
+            void Clear();
+
+            // Registers a texture created elsewhere, e.g. streamed in by Scene::LoadAsync. A known texture of the same source wins
+            std::shared_ptr<Texture2d> Add2d(const std::shared_ptr<Texture2d>& texture);
+
             bool BeforeCreate(const std::string& source);
 
             std::shared_ptr<ITexture> Find(const std::string& source) const;
@@ -29,13 +55,78 @@ namespace RyuRenderer::Graphics
             bool Remove(const std::string& source);
 
             size_t RemoveAll(const std::string& source);
+
+            // Invalid handle for nullptr or a texture this manager does not hold
+            TextureHandle GetHandle(const std::shared_ptr<ITexture>& texture) const;
+
+            // nullptr once the texture was removed. Render thread only, takes no lock
+            const ITexture* Resolve(TextureHandle handle) const;
+
+            // Shared by all pending textures. The staging ring holds three frames of it
+            size_t UploadBytesPerFrame = 4 << 20;
         private:
+            // Tightly packed rows, a row of a compressed level is one row of 4x4 blocks
+            struct DecodedLevel
+            {
+                int Width = 0;
+                int Height = 0;
+                size_t RowBytes = 0;
+                int RowAmount = 0;
+                std::vector<unsigned char> Pixels;
+            };
+
+            // Only level 0 for images, which get their mipmaps generated after the upload
+            struct DecodedImage
+            {
+                GLenum Format = GL_NONE;
+                std::vector<DecodedLevel> Levels;
+                bool IsTopDown = false;
+            };
+
+            struct PendingUpload
+            {
+                std::shared_ptr<Texture2d> Target;
+                std::future<DecodedImage> Decoded;
+                bool IsDecoded = false;
+                DecodedImage Image;
+                size_t LevelIdx = 0;
+                int RowIdx = 0;
+            };
+
+            // Runs on a worker thread, touches no GL object. No levels when the file can not be read.
+            //     format and channelAmount are only used for jpg and png files
+            static DecodedImage Decode(const std::string& source, GLenum format, int channelAmount);
+
+            // False when the budget or the ring ran out before the last row
+            bool UploadRows(PendingUpload& pu, size_t& budgetBytes);
+
+            struct TextureSlot
+            {
+                const ITexture* Texture = nullptr;
+                uint32_t Generation = 0;
+            };
+
+            // Every registered texture gets a slot, the only way textures are added
+            void AfterCreate(const std::shared_ptr<ITexture>& p) noexcept override;
+
+            // Moves the slot generation on, so handles to the texture resolve to nullptr
+            void ReleaseSlot(const ITexture* texture);
+
             static bool CompareTextureBySource(
                 const std::shared_ptr<ITexture>& p,
                 const std::string& source
             );
 
             using base = Common::Factory<ITexture, TextureManagerImpl>;
+
+            // In request order, textures still decoding are passed over
+            std::list<PendingUpload> pendingUploads;
+            StagingRing uploadRing;
+            size_t lastFrameUploadedBytes = 0;
+
+            std::vector<TextureSlot> slots;
+            std::vector<int32_t> freeSlotIdxs;
+            std::unordered_map<const ITexture*, int32_t> slotIdxsByTexture;
         };
     }
 
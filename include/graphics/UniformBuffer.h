@@ -0,0 +1,55 @@
+#ifndef __UNIFORMBUFFER_H__
+#define __UNIFORMBUFFER_H__
+
+#include "glad/gl.h"
+
+#include <type_traits>
+
+namespace RyuRenderer::Graphics
+{
+    // Uniform block storage bound at a fixed binding point, shaders declare the block with
+    //     "layout (std140, binding = N)" and the CPU side struct must follow std140 layout.
+    class UniformBuffer
+    {
+    public:
+        UniformBuffer() = default;
+
+        UniformBuffer(GLsizeiptr s, GLuint bIdx);
+
+        UniformBuffer(const UniformBuffer& other) = delete;
+
+        UniformBuffer(UniformBuffer&& other) noexcept;
+
+        ~UniformBuffer();
+
+        UniformBuffer& operator=(UniformBuffer& other) = delete;
+
+        UniformBuffer& operator=(UniformBuffer&& other) noexcept;
+
+        // Replaces the whole content, the old storage is orphaned so frames still in flight never stall the upload
+        bool Update(const void* data, GLsizeiptr dataSize) const;
+
+        template <typename T>
+        requires std::is_trivially_copyable_v<T>
+        bool Update(const T& block) const
+        {
+            return Update(&block, sizeof(T));
+        }
+
+        bool Use() const;
+
+        bool IsValid() const;
+
+        bool IsUsing() const;
+
+        GLuint GetBindingIdx() const;
+    private:
+        void Clear();
+
+        GLuint id = 0;
+        GLsizeiptr size = 0;
+        GLuint bindingIdx = 0;
+    };
+}
+
+#endif
\ No newline at end of file
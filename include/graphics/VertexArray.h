@@ -0,0 +1,46 @@
+#ifndef __VERTEXARRAY_H__
+#define __VERTEXARRAY_H__
+
+#include "glad/gl.h"
+
+#include "graphics/VertexLayout.h"
+
+namespace RyuRenderer::Graphics
+{
+    // Vertex array holding only attribute formats, the vertex buffers are bound per draw with glBindVertexBuffer.
+    //     Get it from VertexArrayManager so every mesh of a format shares one.
+    class VertexArray
+    {
+    public:
+        VertexArray() = default;
+
+        VertexArray(const VertexFormat& f);
+
+        VertexArray(const VertexArray& other) = delete;
+
+        VertexArray(VertexArray&& other) noexcept;
+
+        ~VertexArray();
+
+        VertexArray& operator=(VertexArray& other) = delete;
+
+        VertexArray& operator=(VertexArray&& other) noexcept;
+
+        bool Use() const;
+
+        bool IsValid() const;
+
+        bool IsUsing() const;
+
+        GLuint GetId() const;
+
+        const VertexFormat& GetFormat() const;
+    private:
+        void Clear();
+
+        GLuint id = 0;
+        VertexFormat format;
+    };
+}
+
+#endif
\ No newline at end of file
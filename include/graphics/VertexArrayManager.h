@@ -0,0 +1,35 @@
+#ifndef __VERTEXARRAYMANAGER_H__
+#define __VERTEXARRAYMANAGER_H__
+
+#include "common/Factory.h"
+#include "common/Singleton.h"
+#include "graphics/VertexArray.h"
+
+namespace RyuRenderer::Graphics
+{
+    namespace VertexArrayManagerImpl
+    {
+        class VertexArrayManagerImpl : public Common::Factory<VertexArray, VertexArrayManagerImpl>
+        {
+        public:
+            std::shared_ptr<VertexArray> FindOrCreate(const VertexFormat& format);
+
+            bool BeforeCreate(const VertexFormat& format);
+
+            std::shared_ptr<VertexArray> Find(const VertexFormat& format) const;
+
+            bool Remove(const VertexFormat& format);
+        private:
+            static bool CompareVertexArrayByFormat(
+                const std::shared_ptr<VertexArray>& p,
+                const VertexFormat& format
+            );
+
+            using base = Common::Factory<VertexArray, VertexArrayManagerImpl>;
+        };
+    }
+
+    class VertexArrayManager : public Common::Singleton<VertexArrayManagerImpl::VertexArrayManagerImpl>{};
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,159 @@
+#ifndef __VERTEXLAYOUT_H__
+#define __VERTEXLAYOUT_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace RyuRenderer::Graphics
+{
+    // Bits of an IEEE 754 half float, a distinct type so vertex data of it maps to GL_HALF_FLOAT
+    struct HalfFloat
+    {
+        uint16_t Bits = 0;
+
+        bool operator==(const HalfFloat& other) const = default;
+    };
+
+    namespace VertexLayoutImpl
+    {
+        template <typename T>
+        constexpr GLenum GetDataType()
+        {
+            if constexpr (std::is_same_v<T, float>)
+                return GL_FLOAT;
+            else if constexpr (std::is_same_v<T, double>)
+                return GL_DOUBLE;
+            else if constexpr (std::is_same_v<T, int>)
+                return GL_INT;
+            else if constexpr (std::is_same_v<T, unsigned int>)
+                return GL_UNSIGNED_INT;
+            else if constexpr (std::is_same_v<T, char>)
+                return GL_BYTE;
+            else if constexpr (std::is_same_v<T, unsigned char> || std::is_same_v<T, std::byte>)
+                return GL_UNSIGNED_BYTE;
+            else if constexpr (std::is_same_v<T, short>)
+                return GL_SHORT;
+            else if constexpr (std::is_same_v<T, unsigned short>)
+                return GL_UNSIGNED_SHORT;
+            else if constexpr (std::is_same_v<T, HalfFloat>)
+                return GL_HALF_FLOAT;
+            else
+                return GL_NONE;
+        }
+    }
+
+    // Runtime description of the attribute formats of a vertex array, meshes with equal formats share one vertex array.
+    //     Buffer strides are not part of it, they are given when a vertex buffer is bound.
+    //     Attributes without components are unused locations, they are left disabled.
+    struct VertexFormat
+    {
+        struct Attribute
+        {
+            GLenum DataType = GL_NONE;
+            GLint ComponentAmount = 0;
+            GLuint RelativeOffset = 0;
+            GLuint BindingIdx = 0;
+            // Integer data is mapped to [0, 1] or [-1, 1] instead of converted as it is
+            GLboolean IsNormalized = GL_FALSE;
+
+            bool operator==(const Attribute& other) const = default;
+        };
+
+        // Minimum of GL_MAX_VERTEX_ATTRIBS every implementation supports
+        static constexpr std::size_t MaxAttributeAmount = 16;
+
+        std::array<Attribute, MaxAttributeAmount> Attributes = {};
+        GLuint AttributeAmount = 0;
+        // Bindings with a non zero divisor advance once per that many instances instead of once per vertex
+        std::array<GLuint, MaxAttributeAmount> BindingDivisors = {};
+
+        bool operator==(const VertexFormat& other) const = default;
+    };
+
+    template <typename T, GLint N, bool Normalized = false>
+    requires (N > 0 && N <= 4)
+    struct VertexAttribute
+    {
+        using ElementType = T;
+        using ValueType = std::array<T, N>;
+
+        static constexpr GLenum DataType = VertexLayoutImpl::GetDataType<T>();
+        static constexpr GLint ComponentAmount = N;
+        static constexpr std::size_t Bytes = sizeof(ValueType);
+        static constexpr GLboolean IsNormalized = Normalized ? GL_TRUE : GL_FALSE;
+
+        static_assert(DataType != GL_NONE, "Unsupported element type.");
+    };
+
+    struct Position3f : VertexAttribute<float, 3> {};
+    struct Normal3f : VertexAttribute<float, 3> {};
+    struct Tangent3f : VertexAttribute<float, 3> {};
+    struct UV2f : VertexAttribute<float, 2> {};
+    struct Color4f : VertexAttribute<float, 4> {};
+
+    // Quantized attributes, see MeshCompression. The 4th position component only pads the vertex to 4 byte alignment
+    struct Position4u16n : VertexAttribute<unsigned short, 4, true> {};
+    struct NormalOct2i16n : VertexAttribute<short, 2, true> {};
+    struct UV2h : VertexAttribute<HalfFloat, 2> {};
+
+    // Attribute i is shader input location i, offsets and stride are known at compile time
+    template <typename... AttributeTypes>
+    struct VertexLayout
+    {
+        static_assert(sizeof...(AttributeTypes) > 0 && sizeof...(AttributeTypes) <= VertexFormat::MaxAttributeAmount,
+            "Vertex attribute is oversize for OpenGL.");
+
+        static constexpr std::size_t AttributeAmount = sizeof...(AttributeTypes);
+        static constexpr std::array<std::size_t, AttributeAmount> Bytes = { AttributeTypes::Bytes... };
+        static constexpr std::array<GLenum, AttributeAmount> DataTypes = { AttributeTypes::DataType... };
+        static constexpr std::array<GLint, AttributeAmount> ComponentAmounts = { AttributeTypes::ComponentAmount... };
+        static constexpr std::array<GLboolean, AttributeAmount> NormalizedFlags = { AttributeTypes::IsNormalized... };
+        static constexpr std::size_t Stride = (AttributeTypes::Bytes + ...);
+
+    private:
+        static constexpr std::array<std::size_t, AttributeAmount> MakeOffsets()
+        {
+            std::array<std::size_t, AttributeAmount> offsets = {};
+            std::size_t offset = 0;
+            for (std::size_t i = 0; i < AttributeAmount; ++i)
+            {
+                offsets[i] = offset;
+                offset += Bytes[i];
+            }
+            return offsets;
+        }
+
+        static constexpr VertexFormat MakeFormat(bool isInterleaved)
+        {
+            const auto offsets = MakeOffsets();
+
+            VertexFormat format;
+            format.AttributeAmount = static_cast<GLuint>(AttributeAmount);
+            for (std::size_t i = 0; i < AttributeAmount; ++i)
+            {
+                auto& a = format.Attributes[i];
+                a.DataType = DataTypes[i];
+                a.ComponentAmount = ComponentAmounts[i];
+                a.IsNormalized = NormalizedFlags[i];
+                a.RelativeOffset = isInterleaved ? static_cast<GLuint>(offsets[i]) : 0;
+                a.BindingIdx = isInterleaved ? 0 : static_cast<GLuint>(i);
+            }
+            return format;
+        }
+
+    public:
+        static constexpr std::array<std::size_t, AttributeAmount> Offsets = MakeOffsets();
+
+        // Every attribute read from binding 0 at its offset inside the vertex
+        static constexpr VertexFormat InterleavedFormat = MakeFormat(true);
+
+        // Attribute i read from binding i, each binding points at its own tightly packed stream
+        static constexpr VertexFormat SeparateFormat = MakeFormat(false);
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,124 @@
+#ifndef __GLDEVICE_H__
+#define __GLDEVICE_H__
+
+#include "graphics/device/IDevice.h"
+
+namespace RyuRenderer::Graphics::Device
+{
+    // Forwards every call to the current GL context
+    class GLDevice : public IDevice
+    {
+    public:
+        // States
+        void GetIntegerv(GLenum pname, GLint* data) override;
+        void Enable(GLenum cap) override;
+        void Disable(GLenum cap) override;
+        void BlendFunc(GLenum sfactor, GLenum dfactor) override;
+        void StencilFunc(GLenum func, GLint ref, GLuint mask) override;
+        void StencilMask(GLuint mask) override;
+        void StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) override;
+        void DepthFunc(GLenum func) override;
+        void DepthMask(GLboolean flag) override;
+        void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+        void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) override;
+        void Clear(GLbitfield mask) override;
+        void Flush() override;
+        void Finish() override;
+
+        // Buffers
+        void GenBuffers(GLsizei n, GLuint* buffers) override;
+        void DeleteBuffers(GLsizei n, const GLuint* buffers) override;
+        void BindBuffer(GLenum target, GLuint buffer) override;
+        void BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+        void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+        void BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) override;
+        void CopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) override;
+        void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+        void* MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override;
+        GLboolean UnmapBuffer(GLenum target) override;
+
+        // Vertex arrays
+        void GenVertexArrays(GLsizei n, GLuint* arrays) override;
+        void DeleteVertexArrays(GLsizei n, const GLuint* arrays) override;
+        void BindVertexArray(GLuint array) override;
+        void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) override;
+        void EnableVertexAttribArray(GLuint index) override;
+        void VertexAttribFormat(GLuint attribIdx, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset) override;
+        void VertexAttribBinding(GLuint attribIdx, GLuint bindingIdx) override;
+        void BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride) override;
+        void VertexBindingDivisor(GLuint bindingIdx, GLuint divisor) override;
+        void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override;
+        void DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex) override;
+        void DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex) override;
+        void MultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) override;
+
+        // Textures
+        void GenTextures(GLsizei n, GLuint* textures) override;
+        void DeleteTextures(GLsizei n, const GLuint* textures) override;
+        void BindTexture(GLenum target, GLuint texture) override;
+        void ActiveTexture(GLenum texture) override;
+        void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) override;
+        void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) override;
+        void CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) override;
+        void CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data) override;
+        void TexParameteri(GLenum target, GLenum pname, GLint param) override;
+        void GenerateMipmap(GLenum target) override;
+
+        // Frames
+        void GenFramebuffers(GLsizei n, GLuint* framebuffers) override;
+        void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers) override;
+        void BindFramebuffer(GLenum target, GLuint framebuffer) override;
+        void FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) override;
+        GLenum CheckFramebufferStatus(GLenum target) override;
+        void GenRenderbuffers(GLsizei n, GLuint* renderbuffers) override;
+        void DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) override;
+        void BindRenderbuffer(GLenum target, GLuint renderbuffer) override;
+        void RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) override;
+        void FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) override;
+
+        // Queries
+        void GenQueries(GLsizei n, GLuint* ids) override;
+        void DeleteQueries(GLsizei n, const GLuint* ids) override;
+        void BeginQuery(GLenum target, GLuint id) override;
+        void EndQuery(GLenum target) override;
+        void GetQueryObjectiv(GLuint id, GLenum pname, GLint* params) override;
+        void GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) override;
+
+        // Syncs
+        GLsync FenceSync(GLenum condition, GLbitfield flags) override;
+        GLenum ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) override;
+        void DeleteSync(GLsync sync) override;
+
+        // Shaders
+        GLuint CreateShader(GLenum type) override;
+        void DeleteShader(GLuint shader) override;
+        void ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) override;
+        void CompileShader(GLuint shader) override;
+        void ShaderBinary(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length) override;
+        void SpecializeShader(GLuint shader, const GLchar* pEntryPoint, GLuint numSpecializationConstants, const GLuint* pConstantIndex, const GLuint* pConstantValue) override;
+        void GetShaderiv(GLuint shader, GLenum pname, GLint* params) override;
+        void GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) override;
+        GLuint CreateProgram() override;
+        void DeleteProgram(GLuint program) override;
+        void AttachShader(GLuint program, GLuint shader) override;
+        void LinkProgram(GLuint program) override;
+        void UseProgram(GLuint program) override;
+        void GetProgramiv(GLuint program, GLenum pname, GLint* params) override;
+        void GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) override;
+        void ProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) override;
+        void GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) override;
+        GLint GetUniformLocation(GLuint program, const GLchar* name) override;
+        void GetProgramInterfaceiv(GLuint program, GLenum programInterface, GLenum pname, GLint* params) override;
+        void GetProgramResourceiv(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params) override;
+        void GetProgramResourceName(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) override;
+
+        // Uniforms
+        void Uniformiv(GLint location, GLint components, GLsizei count, const GLint* value) override;
+        void Uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value) override;
+        void Uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value) override;
+        void Uniformdv(GLint location, GLint components, GLsizei count, const GLdouble* value) override;
+        void UniformMatrixfv(GLint location, GLint dimension, GLsizei count, GLboolean transpose, const GLfloat* value) override;
+    };
+}
+
+#endif
\ No newline at end of file
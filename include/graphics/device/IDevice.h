@@ -0,0 +1,143 @@
+#ifndef __IDEVICE_H__
+#define __IDEVICE_H__
+
+#include "glad/gl.h"
+
+#include <memory>
+
+namespace RyuRenderer::Graphics::Device
+{
+    // Thin layer between graphics resources and the driver, functions mirror the GL ones without "gl" prefix.
+    //     Uniforms are collapsed into typed vector setters, components is the vector size of one element.
+    class IDevice
+    {
+    public:
+        virtual ~IDevice() = default;
+
+        // States
+        virtual void GetIntegerv(GLenum pname, GLint* data) = 0;
+        virtual void Enable(GLenum cap) = 0;
+        virtual void Disable(GLenum cap) = 0;
+        virtual void BlendFunc(GLenum sfactor, GLenum dfactor) = 0;
+        virtual void StencilFunc(GLenum func, GLint ref, GLuint mask) = 0;
+        virtual void StencilMask(GLuint mask) = 0;
+        virtual void StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) = 0;
+        virtual void DepthFunc(GLenum func) = 0;
+        virtual void DepthMask(GLboolean flag) = 0;
+        virtual void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) = 0;
+        virtual void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) = 0;
+        virtual void Clear(GLbitfield mask) = 0;
+        virtual void Flush() = 0;
+        virtual void Finish() = 0;
+
+        // Buffers
+        virtual void GenBuffers(GLsizei n, GLuint* buffers) = 0;
+        virtual void DeleteBuffers(GLsizei n, const GLuint* buffers) = 0;
+        virtual void BindBuffer(GLenum target, GLuint buffer) = 0;
+        virtual void BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) = 0;
+        virtual void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) = 0;
+        virtual void BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) = 0;
+        virtual void CopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) = 0;
+        virtual void BindBufferBase(GLenum target, GLuint index, GLuint buffer) = 0;
+        virtual void* MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) = 0;
+        virtual GLboolean UnmapBuffer(GLenum target) = 0;
+
+        // Vertex arrays
+        virtual void GenVertexArrays(GLsizei n, GLuint* arrays) = 0;
+        virtual void DeleteVertexArrays(GLsizei n, const GLuint* arrays) = 0;
+        virtual void BindVertexArray(GLuint array) = 0;
+        virtual void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) = 0;
+        virtual void EnableVertexAttribArray(GLuint index) = 0;
+        virtual void VertexAttribFormat(GLuint attribIdx, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset) = 0;
+        virtual void VertexAttribBinding(GLuint attribIdx, GLuint bindingIdx) = 0;
+        virtual void BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride) = 0;
+        virtual void VertexBindingDivisor(GLuint bindingIdx, GLuint divisor) = 0;
+        virtual void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) = 0;
+        virtual void DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex) = 0;
+        virtual void DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex) = 0;
+        virtual void MultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) = 0;
+
+        // Textures
+        virtual void GenTextures(GLsizei n, GLuint* textures) = 0;
+        virtual void DeleteTextures(GLsizei n, const GLuint* textures) = 0;
+        virtual void BindTexture(GLenum target, GLuint texture) = 0;
+        virtual void ActiveTexture(GLenum texture) = 0;
+        virtual void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) = 0;
+        virtual void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) = 0;
+        virtual void CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) = 0;
+        virtual void CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data) = 0;
+        virtual void TexParameteri(GLenum target, GLenum pname, GLint param) = 0;
+        virtual void GenerateMipmap(GLenum target) = 0;
+
+        // Frames
+        virtual void GenFramebuffers(GLsizei n, GLuint* framebuffers) = 0;
+        virtual void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers) = 0;
+        virtual void BindFramebuffer(GLenum target, GLuint framebuffer) = 0;
+        virtual void FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) = 0;
+        virtual GLenum CheckFramebufferStatus(GLenum target) = 0;
+        virtual void GenRenderbuffers(GLsizei n, GLuint* renderbuffers) = 0;
+        virtual void DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) = 0;
+        virtual void BindRenderbuffer(GLenum target, GLuint renderbuffer) = 0;
+        virtual void RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) = 0;
+        virtual void FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) = 0;
+
+        // Queries
+        virtual void GenQueries(GLsizei n, GLuint* ids) = 0;
+        virtual void DeleteQueries(GLsizei n, const GLuint* ids) = 0;
+        virtual void BeginQuery(GLenum target, GLuint id) = 0;
+        virtual void EndQuery(GLenum target) = 0;
+        virtual void GetQueryObjectiv(GLuint id, GLenum pname, GLint* params) = 0;
+        virtual void GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) = 0;
+
+        // Syncs
+        virtual GLsync FenceSync(GLenum condition, GLbitfield flags) = 0;
+        virtual GLenum ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) = 0;
+        virtual void DeleteSync(GLsync sync) = 0;
+
+        // Shaders
+        virtual GLuint CreateShader(GLenum type) = 0;
+        virtual void DeleteShader(GLuint shader) = 0;
+        virtual void ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) = 0;
+        virtual void CompileShader(GLuint shader) = 0;
+        virtual void ShaderBinary(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length) = 0;
+        virtual void SpecializeShader(GLuint shader, const GLchar* pEntryPoint, GLuint numSpecializationConstants, const GLuint* pConstantIndex, const GLuint* pConstantValue) = 0;
+        virtual void GetShaderiv(GLuint shader, GLenum pname, GLint* params) = 0;
+        virtual void GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) = 0;
+        virtual GLuint CreateProgram() = 0;
+        virtual void DeleteProgram(GLuint program) = 0;
+        virtual void AttachShader(GLuint program, GLuint shader) = 0;
+        virtual void LinkProgram(GLuint program) = 0;
+        virtual void UseProgram(GLuint program) = 0;
+        virtual void GetProgramiv(GLuint program, GLenum pname, GLint* params) = 0;
+        virtual void GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) = 0;
+        virtual void ProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) = 0;
+        virtual void GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) = 0;
+        virtual GLint GetUniformLocation(GLuint program, const GLchar* name) = 0;
+        virtual void GetProgramInterfaceiv(GLuint program, GLenum programInterface, GLenum pname, GLint* params) = 0;
+        virtual void GetProgramResourceiv(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params) = 0;
+        virtual void GetProgramResourceName(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) = 0;
+
+        // Uniforms
+        virtual void Uniformiv(GLint location, GLint components, GLsizei count, const GLint* value) = 0;
+        virtual void Uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value) = 0;
+        virtual void Uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value) = 0;
+        virtual void Uniformdv(GLint location, GLint components, GLsizei count, const GLdouble* value) = 0;
+        // Square matrices only, dimension is 2, 3 or 4
+        virtual void UniformMatrixfv(GLint location, GLint dimension, GLsizei count, GLboolean transpose, const GLfloat* value) = 0;
+
+        // Device used by all graphics resources, a real GL device is used when none is set.
+        //     Resources must be created, used and released under the same device.
+        static IDevice& Current()
+        {
+            return current ? *current : GetDefault();
+        }
+
+        static void SetCurrent(std::shared_ptr<IDevice> d);
+    private:
+        static IDevice& GetDefault();
+
+        inline static std::shared_ptr<IDevice> current = nullptr;
+    };
+}
+
+#endif
\ No newline at end of file
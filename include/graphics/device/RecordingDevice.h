@@ -0,0 +1,282 @@
+#ifndef __RECORDINGDEVICE_H__
+#define __RECORDINGDEVICE_H__
+
+#include <array>
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "graphics/device/IDevice.h"
+
+namespace RyuRenderer::Graphics::Device
+{
+    // Null device, which never touches a driver. It only counts commands and optionally records them,
+    //     so CPU submission cost can be measured (and renderer logic exercised) without any GL context.
+    //     Generated names are fake but unique, queries answer from a minimal tracked binding state,
+    //     and compiling, linking and frame completeness checks always succeed.
+    class RecordingDevice : public IDevice
+    {
+    public:
+        struct Command
+        {
+            enum CommandType
+            {
+                COMMAND_GET_INTEGERV,
+                COMMAND_ENABLE,
+                COMMAND_DISABLE,
+                COMMAND_BLEND_FUNC,
+                COMMAND_STENCIL_FUNC,
+                COMMAND_STENCIL_MASK,
+                COMMAND_STENCIL_OP,
+                COMMAND_DEPTH_FUNC,
+                COMMAND_DEPTH_MASK,
+                COMMAND_VIEWPORT,
+                COMMAND_CLEAR_COLOR,
+                COMMAND_CLEAR,
+                COMMAND_FLUSH,
+                COMMAND_FINISH,
+                COMMAND_GEN_BUFFERS,
+                COMMAND_DELETE_BUFFERS,
+                COMMAND_BIND_BUFFER,
+                COMMAND_BUFFER_DATA,
+                COMMAND_BUFFER_SUB_DATA,
+                COMMAND_BUFFER_STORAGE,
+                COMMAND_COPY_BUFFER_SUB_DATA,
+                COMMAND_BIND_BUFFER_BASE,
+                COMMAND_MAP_BUFFER_RANGE,
+                COMMAND_UNMAP_BUFFER,
+                COMMAND_GEN_VERTEX_ARRAYS,
+                COMMAND_DELETE_VERTEX_ARRAYS,
+                COMMAND_BIND_VERTEX_ARRAY,
+                COMMAND_VERTEX_ATTRIB_POINTER,
+                COMMAND_ENABLE_VERTEX_ATTRIB_ARRAY,
+                COMMAND_VERTEX_ATTRIB_FORMAT,
+                COMMAND_VERTEX_ATTRIB_BINDING,
+                COMMAND_BIND_VERTEX_BUFFER,
+                COMMAND_VERTEX_BINDING_DIVISOR,
+                COMMAND_DRAW_ELEMENTS,
+                COMMAND_DRAW_ELEMENTS_BASE_VERTEX,
+                COMMAND_DRAW_ELEMENTS_INSTANCED_BASE_VERTEX,
+                COMMAND_MULTI_DRAW_ELEMENTS_INDIRECT,
+                COMMAND_GEN_TEXTURES,
+                COMMAND_DELETE_TEXTURES,
+                COMMAND_BIND_TEXTURE,
+                COMMAND_ACTIVE_TEXTURE,
+                COMMAND_TEX_IMAGE_2D,
+                COMMAND_TEX_SUB_IMAGE_2D,
+                COMMAND_COMPRESSED_TEX_IMAGE_2D,
+                COMMAND_COMPRESSED_TEX_SUB_IMAGE_2D,
+                COMMAND_TEX_PARAMETERI,
+                COMMAND_GENERATE_MIPMAP,
+                COMMAND_GEN_FRAMEBUFFERS,
+                COMMAND_DELETE_FRAMEBUFFERS,
+                COMMAND_BIND_FRAMEBUFFER,
+                COMMAND_FRAMEBUFFER_TEXTURE_2D,
+                COMMAND_CHECK_FRAMEBUFFER_STATUS,
+                COMMAND_GEN_RENDERBUFFERS,
+                COMMAND_DELETE_RENDERBUFFERS,
+                COMMAND_BIND_RENDERBUFFER,
+                COMMAND_RENDERBUFFER_STORAGE,
+                COMMAND_FRAMEBUFFER_RENDERBUFFER,
+                COMMAND_GEN_QUERIES,
+                COMMAND_DELETE_QUERIES,
+                COMMAND_BEGIN_QUERY,
+                COMMAND_END_QUERY,
+                COMMAND_GET_QUERY_OBJECTIV,
+                COMMAND_GET_QUERY_OBJECTUI64V,
+                COMMAND_FENCE_SYNC,
+                COMMAND_CLIENT_WAIT_SYNC,
+                COMMAND_DELETE_SYNC,
+                COMMAND_CREATE_SHADER,
+                COMMAND_DELETE_SHADER,
+                COMMAND_SHADER_SOURCE,
+                COMMAND_COMPILE_SHADER,
+                COMMAND_SHADER_BINARY,
+                COMMAND_SPECIALIZE_SHADER,
+                COMMAND_GET_SHADERIV,
+                COMMAND_GET_SHADER_INFO_LOG,
+                COMMAND_CREATE_PROGRAM,
+                COMMAND_DELETE_PROGRAM,
+                COMMAND_ATTACH_SHADER,
+                COMMAND_LINK_PROGRAM,
+                COMMAND_USE_PROGRAM,
+                COMMAND_GET_PROGRAMIV,
+                COMMAND_GET_PROGRAM_INFO_LOG,
+                COMMAND_PROGRAM_BINARY,
+                COMMAND_GET_PROGRAM_BINARY,
+                COMMAND_GET_UNIFORM_LOCATION,
+                COMMAND_GET_PROGRAM_INTERFACEIV,
+                COMMAND_GET_PROGRAM_RESOURCEIV,
+                COMMAND_GET_PROGRAM_RESOURCE_NAME,
+                COMMAND_UNIFORMIV,
+                COMMAND_UNIFORMUIV,
+                COMMAND_UNIFORMFV,
+                COMMAND_UNIFORMDV,
+                COMMAND_UNIFORM_MATRIXFV,
+                COMMAND_TYPE_AMOUNT
+            };
+
+            CommandType Type = COMMAND_TYPE_AMOUNT;
+            // Target, capability, mode or other enum argument
+            GLenum Target = GL_NONE;
+            // Object name or uniform location
+            GLint Id = 0;
+            // Element count, byte size or uniform array size
+            GLsizeiptr Amount = 0;
+        };
+
+        RecordingDevice(bool isRecording = false);
+
+        // States
+        void GetIntegerv(GLenum pname, GLint* data) override;
+        void Enable(GLenum cap) override;
+        void Disable(GLenum cap) override;
+        void BlendFunc(GLenum sfactor, GLenum dfactor) override;
+        void StencilFunc(GLenum func, GLint ref, GLuint mask) override;
+        void StencilMask(GLuint mask) override;
+        void StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass) override;
+        void DepthFunc(GLenum func) override;
+        void DepthMask(GLboolean flag) override;
+        void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) override;
+        void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) override;
+        void Clear(GLbitfield mask) override;
+        void Flush() override;
+        void Finish() override;
+
+        // Buffers
+        void GenBuffers(GLsizei n, GLuint* buffers) override;
+        void DeleteBuffers(GLsizei n, const GLuint* buffers) override;
+        void BindBuffer(GLenum target, GLuint buffer) override;
+        void BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) override;
+        void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) override;
+        void BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags) override;
+        void CopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) override;
+        void BindBufferBase(GLenum target, GLuint index, GLuint buffer) override;
+        void* MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access) override;
+        GLboolean UnmapBuffer(GLenum target) override;
+
+        // Vertex arrays
+        void GenVertexArrays(GLsizei n, GLuint* arrays) override;
+        void DeleteVertexArrays(GLsizei n, const GLuint* arrays) override;
+        void BindVertexArray(GLuint array) override;
+        void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) override;
+        void EnableVertexAttribArray(GLuint index) override;
+        void VertexAttribFormat(GLuint attribIdx, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset) override;
+        void VertexAttribBinding(GLuint attribIdx, GLuint bindingIdx) override;
+        void BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride) override;
+        void VertexBindingDivisor(GLuint bindingIdx, GLuint divisor) override;
+        void DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices) override;
+        void DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex) override;
+        void DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex) override;
+        void MultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride) override;
+
+        // Textures
+        void GenTextures(GLsizei n, GLuint* textures) override;
+        void DeleteTextures(GLsizei n, const GLuint* textures) override;
+        void BindTexture(GLenum target, GLuint texture) override;
+        void ActiveTexture(GLenum texture) override;
+        void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) override;
+        void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels) override;
+        void CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data) override;
+        void CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data) override;
+        void TexParameteri(GLenum target, GLenum pname, GLint param) override;
+        void GenerateMipmap(GLenum target) override;
+
+        // Frames
+        void GenFramebuffers(GLsizei n, GLuint* framebuffers) override;
+        void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers) override;
+        void BindFramebuffer(GLenum target, GLuint framebuffer) override;
+        void FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level) override;
+        GLenum CheckFramebufferStatus(GLenum target) override;
+        void GenRenderbuffers(GLsizei n, GLuint* renderbuffers) override;
+        void DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers) override;
+        void BindRenderbuffer(GLenum target, GLuint renderbuffer) override;
+        void RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height) override;
+        void FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer) override;
+
+        // Queries
+        void GenQueries(GLsizei n, GLuint* ids) override;
+        void DeleteQueries(GLsizei n, const GLuint* ids) override;
+        void BeginQuery(GLenum target, GLuint id) override;
+        void EndQuery(GLenum target) override;
+        void GetQueryObjectiv(GLuint id, GLenum pname, GLint* params) override;
+        void GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params) override;
+
+        // Syncs
+        GLsync FenceSync(GLenum condition, GLbitfield flags) override;
+        GLenum ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout) override;
+        void DeleteSync(GLsync sync) override;
+
+        // Shaders
+        GLuint CreateShader(GLenum type) override;
+        void DeleteShader(GLuint shader) override;
+        void ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length) override;
+        void CompileShader(GLuint shader) override;
+        void ShaderBinary(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length) override;
+        void SpecializeShader(GLuint shader, const GLchar* pEntryPoint, GLuint numSpecializationConstants, const GLuint* pConstantIndex, const GLuint* pConstantValue) override;
+        void GetShaderiv(GLuint shader, GLenum pname, GLint* params) override;
+        void GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) override;
+        GLuint CreateProgram() override;
+        void DeleteProgram(GLuint program) override;
+        void AttachShader(GLuint program, GLuint shader) override;
+        void LinkProgram(GLuint program) override;
+        void UseProgram(GLuint program) override;
+        void GetProgramiv(GLuint program, GLenum pname, GLint* params) override;
+        void GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) override;
+        void ProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length) override;
+        void GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary) override;
+        GLint GetUniformLocation(GLuint program, const GLchar* name) override;
+        void GetProgramInterfaceiv(GLuint program, GLenum programInterface, GLenum pname, GLint* params) override;
+        void GetProgramResourceiv(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params) override;
+        void GetProgramResourceName(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name) override;
+
+        // Uniforms
+        void Uniformiv(GLint location, GLint components, GLsizei count, const GLint* value) override;
+        void Uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value) override;
+        void Uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value) override;
+        void Uniformdv(GLint location, GLint components, GLsizei count, const GLdouble* value) override;
+        void UniformMatrixfv(GLint location, GLint dimension, GLsizei count, GLboolean transpose, const GLfloat* value) override;
+
+        void Reset();
+
+        unsigned long long GetCommandAmount(Command::CommandType t) const;
+
+        unsigned long long GetTotalCommandAmount() const;
+
+        unsigned long long GetDrawCallAmount() const;
+
+        // Binds, enables and other pipeline state changes
+        unsigned long long GetStateChangeAmount() const;
+
+        unsigned long long GetUniformUploadAmount() const;
+
+        const std::vector<Command>& GetCommands() const;
+
+        static const char* GetCommandName(Command::CommandType t);
+
+        // Recorded command list is only kept when recording, counters are always updated
+        bool IsRecording = false;
+    private:
+        void Record(Command::CommandType t, GLenum target = GL_NONE, GLint id = 0, GLsizeiptr amount = 0);
+
+        void GenNames(GLsizei n, GLuint* names);
+
+        std::array<unsigned long long, Command::COMMAND_TYPE_AMOUNT> commandAmounts = {};
+        std::vector<Command> commands;
+
+        GLuint nextName = 1;
+        GLuint boundVertexArray = 0;
+        GLuint boundProgram = 0;
+        GLuint boundFramebuffer = 0;
+        GLuint boundRenderbuffer = 0;
+        GLenum activeTexture = GL_TEXTURE0;
+        std::unordered_map<GLenum, GLuint> boundBuffers;
+        std::unordered_map<GLenum, GLuint> boundTexture2ds;
+        std::unordered_map<GLuint, std::unordered_map<std::string, GLint>> uniformLocations;
+        // Host memory behind mapped buffers, kept until the buffer is deleted like a persistent mapping
+        std::unordered_map<GLuint, std::vector<std::byte>> mappedBuffers;
+    };
+}
+
+#endif
\ No newline at end of file
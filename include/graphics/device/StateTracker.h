@@ -0,0 +1,147 @@
+#ifndef __STATETRACKER_H__
+#define __STATETRACKER_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "common/Singleton.h"
+
+namespace RyuRenderer::Graphics::Device
+{
+    // Shadow of the bindings and fixed function states of the current device, calls which would not change
+    //     anything are skipped. Every binding or state change of graphics resources must go through it,
+    //     after touching the device directly call Invalidate() so the next calls are issued again.
+    //     It is invalidated by IDevice::SetCurrent, states are never queried back from the device.
+    class StateTracker : public Common::Singleton<StateTracker>
+    {
+    public:
+        // Bindings
+        void UseProgram(GLuint program);
+        void BindVertexArray(GLuint array);
+        void BindBuffer(GLenum target, GLuint buffer);
+        // Vertex buffer binding points belong to the vertex array, they are forgotten when it changes
+        void BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride);
+        // Uniform and shader storage binding points, the generic binding of the target is changed too
+        void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+        // Active texture unit is only switched when the binding of that unit changes
+        void BindTexture(GLint unitIdx, GLenum target, GLuint texture);
+        void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+        bool IsProgramUsing(GLuint program) const;
+        bool IsVertexArrayBound(GLuint array) const;
+        bool IsBufferBound(GLenum target, GLuint buffer) const;
+        bool IsVertexBufferBound(GLuint bindingIdx, GLuint buffer) const;
+        bool IsBufferBaseBound(GLenum target, GLuint index, GLuint buffer) const;
+        bool IsTextureBound(GLint unitIdx, GLenum target, GLuint texture) const;
+        bool IsFramebufferBound(GLenum target, GLuint framebuffer) const;
+
+        // Deleting objects through the tracker keeps the bindings GL reverts to 0 in sync
+        void DeleteProgram(GLuint program);
+        void DeleteVertexArrays(GLsizei n, const GLuint* arrays);
+        void DeleteBuffers(GLsizei n, const GLuint* buffers);
+        void DeleteTextures(GLsizei n, const GLuint* textures);
+        void DeleteFramebuffers(GLsizei n, const GLuint* framebuffers);
+
+        // States
+        void Enable(GLenum cap);
+        void Disable(GLenum cap);
+        void BlendFunc(GLenum sfactor, GLenum dfactor);
+        void DepthFunc(GLenum func);
+        void DepthMask(GLboolean flag);
+        void StencilFunc(GLenum func, GLint ref, GLuint mask);
+        void StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass);
+        void StencilMask(GLuint mask);
+        void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+        // Forgets everything, the next call of each kind is always issued
+        void Invalidate();
+
+        void ResetCallAmounts();
+
+        unsigned long long GetIssuedCallAmount() const;
+
+        unsigned long long GetElidedCallAmount() const;
+    private:
+        friend class Common::Singleton<StateTracker>;
+
+        template <typename T>
+        struct Tracked
+        {
+            T Value = {};
+            bool IsKnown = false;
+
+            bool Is(const T& v) const
+            {
+                return IsKnown && Value == v;
+            }
+        };
+
+        enum TextureTargetType
+        {
+            TEXTURE_TARGET_2D,
+            TEXTURE_TARGET_CUBE_MAP,
+            TEXTURE_TARGET_2D_ARRAY,
+            TEXTURE_TARGET_3D,
+            TEXTURE_TARGET_TYPE_AMOUNT
+        };
+
+        StateTracker() = default;
+
+        // Returns true if the call has to be issued
+        template <typename T>
+        bool Change(Tracked<T>& t, const T& v)
+        {
+            if (t.Is(v))
+            {
+                ++elidedCallAmount;
+                return false;
+            }
+
+            t.Value = v;
+            t.IsKnown = true;
+            ++issuedCallAmount;
+            return true;
+        }
+
+        // Null for targets which are not tracked
+        Tracked<GLuint>* FindBuffer(GLenum target);
+        const Tracked<GLuint>* FindBuffer(GLenum target) const;
+        Tracked<GLuint>* FindBufferBase(GLenum target, GLuint index);
+        const Tracked<GLuint>* FindBufferBase(GLenum target, GLuint index) const;
+        Tracked<GLuint>* FindTexture(GLint unitIdx, GLenum target);
+        const Tracked<GLuint>* FindTexture(GLint unitIdx, GLenum target) const;
+
+        void SetEnabled(GLenum cap, bool isEnabled);
+
+        Tracked<GLuint> program;
+        Tracked<GLuint> vertexArray;
+        // Buffer, offset and stride of each vertex buffer binding point of the bound vertex array
+        std::vector<Tracked<std::tuple<GLuint, GLintptr, GLsizei>>> vertexBuffers;
+        // Array, element array, uniform, shader storage, draw indirect, copy read, copy write and pixel unpack buffers
+        std::array<Tracked<GLuint>, 8> buffers;
+        // Uniform and shader storage binding points
+        std::array<std::vector<Tracked<GLuint>>, 2> bufferBases;
+        Tracked<GLint> activeTextureUnitIdx;
+        std::vector<std::array<Tracked<GLuint>, TEXTURE_TARGET_TYPE_AMOUNT>> textures;
+        Tracked<GLuint> drawFramebuffer;
+        Tracked<GLuint> readFramebuffer;
+
+        std::unordered_map<GLenum, Tracked<bool>> enables;
+        Tracked<std::tuple<GLenum, GLenum>> blendFunc;
+        Tracked<GLenum> depthFunc;
+        Tracked<GLboolean> depthMask;
+        Tracked<std::tuple<GLenum, GLint, GLuint>> stencilFunc;
+        Tracked<std::tuple<GLenum, GLenum, GLenum>> stencilOp;
+        Tracked<GLuint> stencilMask;
+        Tracked<std::tuple<GLint, GLint, GLsizei, GLsizei>> viewport;
+
+        unsigned long long issuedCallAmount = 0;
+        unsigned long long elidedCallAmount = 0;
+    };
+}
+
+#endif
\ No newline at end of file
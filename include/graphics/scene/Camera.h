@@ -93,6 +93,9 @@ namespace RyuRenderer::Graphics::Scene
         bool GetIsAspectRatioPriority();
     
         float GetAspectRatio() const;
+
+        // Share of the screen height covered by one world unit at the view distance
+        float GetScreenSizeScale(float viewDis) const;
     
         bool GetIsVFOVPriority();
     
@@ -5,14 +5,14 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
-#include <any>
+#include <cstdint>
 #include <memory>
 #include <string>
 
+#include "graphics/Mesh.h"
 #include "graphics/Shader.h"
-#include "graphics/scene/DirectionalLight.h"
-#include "graphics/scene/PointLight.h"
-#include "graphics/scene/SpotLight.h"
+#include "graphics/scene/MaterialInstance.h"
+#include "graphics/scene/SceneUniformBlocks.h"
 
 namespace RyuRenderer::Graphics::Scene
 {
@@ -21,10 +21,42 @@ namespace RyuRenderer::Graphics::Scene
     public:
         virtual void Use() const;
 
-        virtual void SetData(const std::any& d) = 0;
+        // Binds the parameter block and textures of one instance, false when the instance belongs to another material type
+        virtual bool Bind(const MaterialInstance& instance) const = 0;
+
+        virtual void SetTransform(const glm::mat4& model, const glm::mat4& view) const = 0;
+
+        // Instanced materials read per instance transforms from Graphics::InstanceData attributes,
+        //     the transform set by SetTransform is applied before each of them
+        virtual bool IsInstancingSupported() const;
+
+        virtual void SetInstanced(bool isInstanced) const;
+
+        // Decode of quantized vertex data for the following single and instanced draws,
+        //     multi draws carry it in their draw records instead
+        virtual void SetVertexDecode(const Mesh::VertexDecode& decode) const;
+
+        // Identifies the texture set of an instance in render queue sort keys, equal instances must return equal ids
+        virtual uint32_t GetInstanceSortId(const MaterialInstance& instance) const;
+
+        virtual bool IsTranslucent() const;
+
+        // Multi draw materials read transforms and instance values from the draw and material records,
+        //     so one glMultiDrawElementsIndirect covers every draw of compatible instances
+        virtual bool IsMultiDrawSupported() const;
+
+        // Binds what the records can not carry, like textures, and switches the shader to the records
+        virtual bool BindMultiDraw(const MaterialInstance& instance) const;
+
+        // Instances sharing one multi draw, they may only differ in values written to their material records
+        virtual bool IsMultiDrawCompatible(const MaterialInstance& a, const MaterialInstance& b) const;
+
+        virtual void WriteMaterialRecord(const MaterialInstance& instance, MaterialRecord& record) const;
 
         virtual bool IsVaild() const;
 
+        GLuint GetShaderId() const;
+
         std::string GetName() const;
     protected:
         // Material basic info
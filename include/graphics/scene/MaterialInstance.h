@@ -0,0 +1,18 @@
+#ifndef __MATERIALINSTANCE_H__
+#define __MATERIALINSTANCE_H__
+
+#include <type_traits>
+#include <variant>
+
+#include "graphics/scene/PhongBlinnMaterialData.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    // Per object material parameters, one alternative per material type.
+    //     Stored by value in MeshObject and bound by reference, so drawing never copies or allocates.
+    using MaterialInstance = std::variant<std::monostate, PhongBlinnMaterialData>;
+
+    static_assert(std::is_trivially_copyable_v<MaterialInstance>);
+}
+
+#endif
\ No newline at end of file
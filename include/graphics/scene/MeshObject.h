@@ -1,10 +1,13 @@
 #ifndef __MESHOBJECT_H__
 #define __MESHOBJECT_H__
 
-#include <any>
 #include <list>
 
+#include "graphics/Bounds.h"
+#include "graphics/InstanceBuffer.h"
 #include "graphics/Mesh.h"
+#include "graphics/MeshLodChain.h"
+#include "graphics/scene/MaterialInstance.h"
 #include "graphics/scene/Transform.h"
 
 namespace RyuRenderer::Graphics::Scene
@@ -12,8 +15,26 @@ namespace RyuRenderer::Graphics::Scene
     struct MeshObject
     {
         std::list<Mesh> Meshes;
+        // One level of each chain is drawn, picked by MeshObjectBatch::Submit
+        std::list<MeshLodChain> LodMeshes;
         Transform Transformer;
-        std::any MaterialData;
+        MaterialInstance MaterialData;
+        // Object space bounds of every mesh, objects with invalid bounds are never culled
+        Bounds LocalBounds;
+
+        // Recomputes LocalBounds, call it after changing the meshes
+        void UpdateBounds();
+
+        Bounds GetWorldBounds() const;
+    };
+
+    // Meshes repeated at every instance, drawn with one instanced draw per mesh
+    struct InstancedMeshObject
+    {
+        std::list<Mesh> Meshes;
+        Transform Transformer;
+        MaterialInstance MaterialData;
+        Graphics::InstanceBuffer Instances;
     };
 }
 
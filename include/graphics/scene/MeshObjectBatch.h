@@ -5,27 +5,50 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
+#include <cstdint>
 #include <list>
 #include <memory>
+#include <typeinfo>
+#include <vector>
 
+#include "graphics/scene/Camera.h"
 #include "graphics/scene/MeshObject.h"
 #include "graphics/scene/IMaterial.h"
+#include "graphics/scene/RenderQueue.h"
 
 namespace RyuRenderer::Graphics::Scene
 {
+    // Levels of LOD chains are picked by their error projected onto the screen
+    struct LodSelector
+    {
+        const Camera* ViewCamera = nullptr;
+        // Largest allowed error of a drawn level as share of the screen height, about a pixel at 1080p
+        float MaxScreenError = 1.f / 1080.f;
+    };
+
     class MeshObjectBatch
     {
     public:
         MeshObjectBatch(std::shared_ptr<IMaterial> material);
 
-        void Draw(const glm::mat4& view, const glm::mat4& projection) const;
+        // Pushes one draw item per mesh, model matrices are referenced until the queue executes.
+        //     Instanced objects are skipped when the material does not support instancing.
+        //     LOD chains are drawn at full detail without a selector. With visibleFlags, MeshObjects[i] is skipped when flag i is 0,
+        //     see SceneBvh::CullFrustum
+        void Submit(
+            RenderQueue& queue, const glm::mat4& view, uint8_t passIdx = 0,
+            const LodSelector* lodSelector = nullptr, const uint8_t* visibleFlags = nullptr) const;
 
-        bool Match(const type_info& materialType) const;
+        bool Match(const std::type_info& materialType) const;
 
         bool IsVaild() const;
 
         std::list<MeshObject> MeshObjects;
+        std::list<InstancedMeshObject> InstancedMeshObjects;
         std::shared_ptr<IMaterial> Material = nullptr;
+    private:
+        // Model matrices of MeshObjects and then InstancedMeshObjects in order, kept between draws so it only allocates when the batch grows
+        mutable std::vector<glm::mat4> modelStream;
     };
 }
 
@@ -0,0 +1,87 @@
+#ifndef __MODELIMPORTER_H__
+#define __MODELIMPORTER_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "graphics/MeshOptimizer.h"
+#include "graphics/MeshSimplifier.h"
+
+struct aiScene;
+
+namespace RyuRenderer::Graphics::Scene
+{
+    struct ImportedMeshLevel
+    {
+        std::vector<GLuint> Indices;
+        std::vector<std::array<float, 3>> Positions;
+        std::vector<std::array<float, 3>> Normals;
+        std::vector<std::array<float, 2>> TexCoords;
+        // Object space error against level 0
+        float Error = 0.f;
+    };
+
+    // Vertex data of one mesh between import and upload, Levels[0] is the full detail mesh
+    struct ImportedMesh
+    {
+        std::string Name;
+        uint32_t MaterialIdx = 0;
+        std::vector<ImportedMeshLevel> Levels;
+        MeshOptimizationReport OptimizationReport;
+        // FNV-1a of the indices and vertex streams of every level, equal imports give equal hashes
+        uint64_t ContentHash = 0;
+    };
+
+    // Texture file names as the model file gives them, relative to its directory. Empty when the material has none
+    struct ImportedMaterial
+    {
+        std::string DiffuseTexture;
+        std::string SpecularTexture;
+        std::string EmissionTexture;
+    };
+
+    struct ImportedModel
+    {
+        std::vector<ImportedMesh> Meshes;
+        std::vector<ImportedMaterial> Materials;
+    };
+
+    struct ModelImportStats
+    {
+        // Assimp reading and post processing the file, always on the calling thread
+        double ReadTimeInMs = 0.0;
+        // Converting, optimizing and hashing the meshes
+        double ProcessTimeInMs = 0.0;
+        size_t ThreadAmount = 0;
+    };
+
+    // Reads model files through Assimp into plain vectors and optimizes them, it never touches GL objects.
+    //     Shared by Scene::Load and the ryu-cook tool
+    namespace ModelImporter
+    {
+        // Meshes without normals or texture coords are skipped with a message, the per mesh results are logged.
+        //     threadAmount limits the threads of the mesh stage including the caller, 0 uses all of Common::ThreadPool
+        bool Import(
+            const std::string& modelFilePath,
+            const MeshOptimizationSettings& optimization,
+            const MeshLodSettings& lod,
+            ImportedModel& model,
+            size_t threadAmount = 0,
+            ModelImportStats* stats = nullptr);
+
+        // Mesh stage of Import for a scene Assimp has read already. Every mesh is one job which only writes its own
+        //     slot of model.Meshes, so the result is the same for every thread amount and keeps the order of the scene
+        bool Convert(
+            const aiScene& scene,
+            const MeshOptimizationSettings& optimization,
+            const MeshLodSettings& lod,
+            ImportedModel& model,
+            size_t threadAmount = 0);
+    }
+}
+
+#endif
\ No newline at end of file
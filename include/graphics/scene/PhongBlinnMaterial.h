@@ -1,23 +1,82 @@
 #ifndef __PHONGBLINNMATERIAL_H__
 #define __PHONGBLINNMATERIAL_H__
 
-#include <any>
+#include <array>
+#include <cstddef>
+#include <unordered_map>
 
-#include "graphics/scene/PhongBlinnMaterialData.h"
+#include "graphics/InstanceBuffer.h"
+#include "graphics/VertexLayout.h"
 #include "graphics/scene/IMaterial.h"
+#include "graphics/scene/MaterialInstance.h"
+#include "graphics/scene/PhongBlinnMaterialData.h"
 
 namespace RyuRenderer::Graphics::Scene
 {
     class PhongBlinnMaterial : public IMaterial
     {
+        struct UniformHandles
+        {
+            UniformHandle Model;
+            UniformHandle ViewNormalMatrix;
+            UniformHandle Ambient;
+            UniformHandle HasDiffuse;
+            UniformHandle Diffuse;
+            UniformHandle IsDiffuseTopDown;
+            UniformHandle HasSpecular;
+            UniformHandle Specular;
+            UniformHandle IsSpecularTopDown;
+            UniformHandle HasEmission;
+            UniformHandle Emission;
+            UniformHandle IsEmissionTopDown;
+            UniformHandle Shininess;
+            UniformHandle IsMultiDraw;
+            UniformHandle IsInstanced;
+            UniformHandle PositionDecodeOffset;
+            UniformHandle PositionDecodeScale;
+            UniformHandle IsNormalOctahedral;
+        };
     public:
+        // Vertex inputs of the shader, meshes drawn with this material must be built with it
+        using MeshVertexLayout = VertexLayout<Position3f, Normal3f, UV2f>;
+
         PhongBlinnMaterial();
 
-        void SetData(const std::any& d) override;
+        bool Bind(const MaterialInstance& instance) const override;
+
+        void SetTransform(const glm::mat4& model, const glm::mat4& view) const override;
+
+        uint32_t GetInstanceSortId(const MaterialInstance& instance) const override;
+
+        bool IsInstancingSupported() const override;
+
+        void SetInstanced(bool isInstanced) const override;
 
-        void Use() const override;
+        void SetVertexDecode(const Mesh::VertexDecode& decode) const override;
+
+        bool IsMultiDrawSupported() const override;
+
+        bool BindMultiDraw(const MaterialInstance& instance) const override;
+
+        // Ambient and shininess go through the material record, only the texture set has to match
+        bool IsMultiDrawCompatible(const MaterialInstance& a, const MaterialInstance& b) const override;
+
+        // Values[0] is the ambient color and the shininess
+        void WriteMaterialRecord(const MaterialInstance& instance, MaterialRecord& record) const override;
     private:
-        PhongBlinnMaterialData data;
+        // Diffuse, specular and emission
+        using TextureSet = std::array<TextureHandle, 3>;
+
+        struct TextureSetHash
+        {
+            size_t operator()(const TextureSet& s) const;
+        };
+
+        void BindTextures(const PhongBlinnMaterialData& data) const;
+
+        UniformHandles handles;
+        // Dense sort ids from 1, in the order texture sets are first seen
+        mutable std::unordered_map<TextureSet, uint32_t, TextureSetHash> textureSetIds;
     };
 }
 
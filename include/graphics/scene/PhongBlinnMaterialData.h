@@ -1,47 +1,25 @@
 #ifndef __PHONGBLINNMATERIALDATA_H__
 #define __PHONGBLINNMATERIALDATA_H__
 
-#include <memory>
+#include "glm/glm.hpp"
 
-#include "graphics/Texture2d.h"
-#include "graphics/scene/DirectionalLight.h"
-#include "graphics/scene/PointLight.h"
-#include "graphics/scene/SpotLight.h"
+#include "graphics/TextureHandle.h"
 
 namespace RyuRenderer::Graphics::Scene
 {
+    // Parameter block of one Phong-Blinn material instance, textures are not owned, they live in TextureManager.
+    //     A texture removed from TextureManager is drawn as no texture
     struct PhongBlinnMaterialData
     {
         PhongBlinnMaterialData() = default;
 
-        bool operator==(const PhongBlinnMaterialData& other) const
-        {
-            return Model == other.Model &&
-                   View == other.View &&
-                   Projection == other.Projection &&
-                   DirectionLight == other.DirectionLight &&
-                   PointLights == other.PointLights &&
-                   SpotLights == other.SpotLights &&
-                   Ambient == other.Ambient &&
-                   Diffuse == other.Diffuse &&
-                   Specular == other.Specular &&
-                   Shininess == other.Shininess &&
-                   Emission == other.Emission;
-        }
-
-        glm::mat4 Model = glm::identity<glm::mat4>();
-        glm::mat4 View = glm::identity<glm::mat4>();
-        glm::mat4 Projection = glm::identity<glm::mat4>();
-
-        const DirectionalLight* DirectionLight = nullptr;
-        const std::vector<PointLight>* PointLights = nullptr;
-        const std::vector<SpotLight>* SpotLights = nullptr;
+        bool operator==(const PhongBlinnMaterialData& other) const = default;
 
         glm::vec3 Ambient = { 0.2f, 0.2f, 0.2f };
-        std::shared_ptr<const Graphics::Texture2d> Diffuse = nullptr;
-        std::shared_ptr<const Graphics::Texture2d> Specular = nullptr;
+        Graphics::TextureHandle Diffuse;
+        Graphics::TextureHandle Specular;
         float Shininess = 128.f;
-        std::shared_ptr<const Graphics::Texture2d> Emission = nullptr;
+        Graphics::TextureHandle Emission;
     };
 }
 
@@ -0,0 +1,133 @@
+#ifndef __RENDERQUEUE_H__
+#define __RENDERQUEUE_H__
+
+#include "glad/gl.h"
+#include "glm/glm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/Singleton.h"
+#include "graphics/InstanceBuffer.h"
+#include "graphics/Mesh.h"
+#include "graphics/StreamBuffer.h"
+#include "graphics/scene/IMaterial.h"
+#include "graphics/scene/MaterialInstance.h"
+#include "graphics/scene/SceneUniformBlocks.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    // Draw items are submitted with a 64 bit sort key, radix sorted on Execute and drawn in key order,
+    //     so draws sharing a program and material instance end up next to each other whatever the submit order is.
+    //     Key layout from the highest bit:
+    //         opaque:      pass(4) | 0 | shader(12) | material(16) | mesh(16) | depth(15), front to back
+    //         translucent: pass(4) | 1 | inverted depth(24) | shader(12) | material(12) | mesh(11), back to front
+    //     Sorted runs of one multi draw material, one pool page and compatible instances are drawn with a single
+    //     glMultiDrawElementsIndirect, transforms and instance values are read from per frame draw and material records.
+    class RenderQueue : public Common::Singleton<RenderQueue>
+    {
+    public:
+        // Everything is referenced, not owned, it must outlive the next Execute
+        struct DrawItem
+        {
+            uint64_t Key = 0;
+            const IMaterial* Material = nullptr;
+            const MaterialInstance* Instance = nullptr;
+            const Graphics::Mesh* Mesh = nullptr;
+            const glm::mat4* Model = nullptr;
+            // Draws every instance with one call when set, Model is applied before each instance transform
+            const Graphics::InstanceBuffer* Instances = nullptr;
+        };
+
+        void Submit(const DrawItem& item);
+
+        // Sorts and draws every submitted item, then empties the queue
+        void Execute(const glm::mat4& view);
+
+        void Clear();
+
+        // Frees the record and command buffers, must be called before the device or context goes away
+        void ReleaseBuffers();
+
+        // View distances mapped onto the depth bits, logarithmic so near objects keep precision
+        void SetDepthRange(float nearDis, float farDis);
+
+        uint64_t MakeKey(
+            uint8_t passIdx,
+            bool isTranslucent,
+            uint32_t shaderId,
+            uint32_t materialId,
+            uint32_t meshId,
+            float viewDis
+        ) const;
+
+        size_t GetItemAmount() const;
+
+        // Program and material instance binds of the sorted order compared with the submit order, summed over executes
+        void ResetCallAmounts();
+        unsigned long long GetIssuedStateChangeAmount() const;
+        unsigned long long GetSavedStateChangeAmount() const;
+
+        // Objects which passed and failed frustum culling before submission, summed like the state changes
+        void CountCulling(size_t visibleAmount, size_t culledAmount);
+        unsigned long long GetVisibleObjectAmount() const;
+        unsigned long long GetCulledObjectAmount() const;
+
+        static constexpr uint8_t MaxPassAmount = 16;
+
+        // Off draws every item on its own, like materials without multi draw support
+        bool IsMultiDrawEnabled = true;
+    private:
+        friend class Common::Singleton<RenderQueue>;
+
+        struct SortEntry
+        {
+            uint64_t Key = 0;
+            uint32_t ItemIdx = 0;
+        };
+
+        // Sorted entries [FirstEntryIdx, FirstEntryIdx + EntryAmount), multi draw runs own the same range of commands
+        struct DrawRun
+        {
+            uint32_t FirstEntryIdx = 0;
+            uint32_t EntryAmount = 0;
+            uint32_t FirstCommandIdx = 0;
+            bool IsMultiDraw = false;
+        };
+
+        RenderQueue() = default;
+
+        void Sort();
+
+        // Splits the sorted entries into runs and fills the records and commands of the multi draw runs
+        void BuildRuns(const glm::mat4& view);
+
+        void UploadRuns();
+
+        template <typename F>
+        static unsigned long long CountStateChanges(size_t itemAmount, F&& getItem);
+
+        std::vector<DrawItem> items;
+        std::vector<SortEntry> sortEntries;
+        std::vector<SortEntry> sortScratch;
+
+        std::vector<DrawRun> runs;
+        std::vector<DrawRecord> drawRecords;
+        std::vector<MaterialRecord> materialRecords;
+        std::vector<DrawElementsIndirectCommand> commands;
+        Graphics::StreamBuffer drawRecordBuffer;
+        Graphics::StreamBuffer materialRecordBuffer;
+        Graphics::StreamBuffer commandBuffer;
+
+        float depthNearDis = 0.01f;
+        float depthFarDis = 1000000.f;
+
+        unsigned long long issuedStateChangeAmount = 0;
+        unsigned long long savedStateChangeAmount = 0;
+        unsigned long long visibleObjectAmount = 0;
+        unsigned long long culledObjectAmount = 0;
+    };
+}
+
+#endif
\ No newline at end of file
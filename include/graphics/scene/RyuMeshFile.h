@@ -0,0 +1,136 @@
+#ifndef __RYUMESHFILE_H__
+#define __RYUMESHFILE_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "common/MappedFile.h"
+#include "graphics/Bounds.h"
+#include "graphics/scene/ModelImporter.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    // Cooked model, written by ryu-cook from what ModelImporter produced and read back through a memory mapping.
+    //     Tables of fixed size records follow the header, the vertex and index blobs start on page boundaries
+    //     and hold exactly what a separate layout PhongBlinnMaterial::MeshVertexLayout mesh uploads, so loading
+    //     hands pointers into the mapping to the GeometryPool without any parsing or copying.
+    //     All values are little endian, readers reject other versions instead of converting them
+    class RyuMeshFile
+    {
+    public:
+        static constexpr std::string_view Extension = ".ryumesh";
+        static constexpr uint32_t Magic = 0x4D555952; // "RYUM"
+        static constexpr uint32_t Version = 1;
+        static constexpr uint64_t BlobAlignment = 4096;
+
+        struct BlobRange
+        {
+            uint64_t Offset = 0;
+            uint64_t Bytes = 0;
+        };
+
+        // Characters in the string table, not null terminated
+        struct StringRange
+        {
+            uint32_t Offset = 0;
+            uint32_t Length = 0;
+        };
+
+        struct Header
+        {
+            uint32_t Magic = 0;
+            uint32_t Version = 0;
+            uint32_t MeshAmount = 0;
+            uint32_t LevelAmount = 0;
+            uint32_t MaterialAmount = 0;
+            uint32_t StringBytes = 0;
+            uint64_t MeshTableOffset = 0;
+            uint64_t LevelTableOffset = 0;
+            uint64_t MaterialTableOffset = 0;
+            uint64_t StringTableOffset = 0;
+            uint64_t FileBytes = 0;
+        };
+
+        struct MeshRecord
+        {
+            StringRange Name;
+            uint32_t MaterialIdx = 0;
+            uint32_t FirstLevelIdx = 0;
+            uint32_t LevelAmount = 0;
+            uint32_t Padding = 0;
+        };
+
+        struct LevelRecord
+        {
+            uint32_t VertexAmount = 0;
+            uint32_t IndexAmount = 0;
+            // GL_UNSIGNED_SHORT for levels with at most 65536 vertices, GL_UNSIGNED_INT otherwise
+            uint32_t IndexType = GL_UNSIGNED_INT;
+            float Error = 0.f;
+            std::array<float, 3> BoundsMin = {};
+            std::array<float, 3> BoundsMax = {};
+            std::array<float, 3> BoundsCenter = {};
+            float BoundsRadius = 0.f;
+            BlobRange Indices;
+            BlobRange Positions;
+            BlobRange Normals;
+            BlobRange TexCoords;
+
+            Bounds GetBounds() const;
+        };
+
+        // Texture file names relative to the directory of the cooked file, empty ranges for none
+        struct MaterialRecord
+        {
+            StringRange DiffuseTexture;
+            StringRange SpecularTexture;
+            StringRange EmissionTexture;
+        };
+
+        // Texture names are written as the model gives them, keep the cooked file next to the model file
+        static bool Write(const ImportedModel& model, const std::string& filePath);
+
+        // Maps the file and checks every table and blob range against its size
+        bool Open(const std::string& filePath);
+
+        void Close();
+
+        bool IsOpen() const;
+
+        std::span<const MeshRecord> GetMeshes() const;
+
+        std::span<const LevelRecord> GetLevels(const MeshRecord& mesh) const;
+
+        std::span<const MaterialRecord> GetMaterials() const;
+
+        std::string_view GetString(const StringRange& range) const;
+
+        // Views into the mapping, valid until the file is closed
+        std::span<const std::array<float, 3>> GetPositions(const LevelRecord& level) const;
+        std::span<const std::array<float, 3>> GetNormals(const LevelRecord& level) const;
+        std::span<const std::array<float, 2>> GetTexCoords(const LevelRecord& level) const;
+        std::span<const GLushort> GetShortIndices(const LevelRecord& level) const;
+        std::span<const GLuint> GetIndices(const LevelRecord& level) const;
+    private:
+        template <typename T>
+        std::span<const T> GetBlob(const BlobRange& range) const
+        {
+            return std::span<const T>(reinterpret_cast<const T*>(file.GetBytes().data() + range.Offset), range.Bytes / sizeof(T));
+        }
+
+        bool IsInside(uint64_t offset, uint64_t bytes) const;
+
+        bool Validate() const;
+
+        Common::MappedFile file;
+        const Header* header = nullptr;
+    };
+}
+
+#endif
\ No newline at end of file
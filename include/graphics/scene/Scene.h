@@ -15,13 +15,23 @@
 #include "app/events/MouseEvent.h"
 #include "app/events/KeyEvent.h"
 #include "graphics/Mesh.h"
+#include "graphics/MeshCompression.h"
+#include "graphics/MeshLodChain.h"
+#include "graphics/MeshOptimizer.h"
+#include "graphics/MeshSimplifier.h"
 #include "graphics/Shader.h"
+#include "graphics/StagingRing.h"
+#include "graphics/InstanceBuffer.h"
 #include "graphics/Texture2d.h"
+#include "graphics/UniformBuffer.h"
 #include "graphics/scene/Camera.h"
 #include "graphics/scene/DirectionalLight.h"
 #include "graphics/scene/PointLight.h"
 #include "graphics/scene/SpotLight.h"
 #include "graphics/scene/MeshObjectBatch.h"
+#include "graphics/scene/ModelImporter.h"
+#include "graphics/scene/SceneBvh.h"
+#include "graphics/scene/SceneLoad.h"
 
 namespace RyuRenderer::Graphics::Scene
 {
@@ -30,12 +40,36 @@ namespace RyuRenderer::Graphics::Scene
     public:
         Scene();
 
+        // Model files go through Assimp and the import settings below, .ryumesh files cooked by ryu-cook are mapped and uploaded as they are
         bool Load(const std::string& modelFilePath);
 
+        // Returns at once, the file is read and decoded on Common::ThreadPool and uploaded by OnTick() within
+        //     StreamingBytesPerFrame. Each mesh is drawn as soon as its levels and textures are resident.
+        //     A path which can not be loaded gives a failed handle
+        std::shared_ptr<SceneLoad> LoadAsync(const std::string& modelFilePath);
+
+        // Advances the running loads by one frame, called by OnTick(). Never waits for a worker or the GPU
+        void UpdateLoads();
+
+        // Bytes copied through the staging ring by the last UpdateLoads()
+        size_t GetLastFrameStreamedBytes() const;
+
         void Draw() const;
 
+        // Running loads are dropped too, meshes they did not hand over yet never show up
         void ClearObjects();
 
+        // Summed over every mesh loaded with compression since the last ClearObjects()
+        const MeshCompressionStats& GetMeshCompressionStats() const;
+
+        // Hierarchy over the MeshObjects of every batch, brought up to date with their transforms first.
+        //     For range queries of other systems, e.g. which objects a light reaches
+        const SceneBvh& GetObjectBvh() const;
+
+        // Nearest object under a point of the screen, (0, 0) is the top left and (1, 1) the bottom right corner.
+        //     Hits are against the world boxes of the objects, not their triangles
+        SceneBvh::RayHit Pick(const glm::vec2& screenPos) const;
+
         void OnTick(double deltaTimeInS);
 
         void OnWindowResize(float aspectRatio);
@@ -70,18 +104,65 @@ namespace RyuRenderer::Graphics::Scene
 
         static GLint GetTextureUnitIdxByType(aiTextureType t);
 
-        Camera Camera;
+        Graphics::Scene::Camera Camera;
         DirectionalLight DirectionLight;
         std::vector<PointLight> PointLights;
         std::vector<SpotLight> SpotLights;
 
         std::list<MeshObjectBatch> MeshObjectBatches;
+
+        // Applied by Load() to the meshes of the model file, the per mesh results are logged.
+        //     Conversion, optimization and LOD generation run first, on the worker threads of Common::ThreadPool,
+        //     then GL upload and batch merging follow on the calling thread in mesh order.
+        //     Cooked files were optimized when they were cooked, compression does not apply to them
+        MeshOptimizationSettings MeshImportOptimization;
+        MeshLodSettings MeshImportLod;
+        MeshCompressionSettings MeshImportCompression;
+        // Threads of the CPU stage of Load() including the caller, 0 uses all. The loaded meshes do not depend on it
+        size_t MeshImportThreadAmount = 0;
+        // Textures of Load() are decoded on Common::ThreadPool and show black until TextureManager::UpdateUploads() filled them in.
+        //     Off, Load() decodes and uploads them before it returns
+        bool IsTextureLoadingAsync = true;
+
+        // Upload budget of LoadAsync() per frame, shared by all running loads. The staging ring holds three frames of it
+        size_t StreamingBytesPerFrame = 4 << 20;
+
+        // Screen space error budget of LOD selection, see LodSelector
+        float LodMaxScreenError = 1.f / 1080.f;
+
+        // Objects outside the camera frustum are not submitted, found by walking the object BVH. RenderQueue counts both kinds
+        bool IsFrustumCulling = true;
     private:
+        bool LoadCooked(const std::string& cookedFilePath, const std::string& textureFileRootPath);
+
+        // Puts the chain into the object of the batch matching its material, or into a new one
+        void AddLodChain(MeshLodChain&& chain, const ImportedMaterial& material, const std::string& textureFileRootPath);
+
         std::shared_ptr<Graphics::Texture2d> GetTexture(
-            const aiMaterial* mat, aiTextureType t, const std::string& textureFileRootPath) const;
+            const std::string& textureFileName, aiTextureType t, const std::string& textureFileRootPath) const;
+
+        // Refreshes one light gizmo instance per point and spot light
+        void UpdateLightInstances() const;
+
+        MeshCompressionStats meshCompressionStats;
+
+        std::list<std::shared_ptr<SceneLoad>> loads;
+        // Created by the first LoadAsync() upload, sized by StreamingBytesPerFrame at that time
+        Graphics::StagingRing stagingRing;
+        size_t lastFrameStreamedBytes = 0;
+
+        // Refit or rebuilt on use, so objects may be moved between frames without telling the scene
+        mutable SceneBvh objectBvh;
+        mutable std::vector<uint8_t> objectVisibleFlags;
 
         std::list<Graphics::Mesh> lightMeshes;
         std::shared_ptr<Graphics::Shader> lightShader;
+        // Kept between draws, instances are only added or removed when the light amount changes
+        mutable Graphics::InstanceBuffer lightInstances;
+        mutable std::vector<Graphics::InstanceBuffer::Handle> lightInstanceHandles;
+
+        Graphics::UniformBuffer frameUniformBuffer;
+        Graphics::UniformBuffer lightsUniformBuffer;
 
         inline static std::unordered_map<aiTextureType, GLint> textureTypeUnitIdxMap = {
             { aiTextureType_DIFFUSE, 0 },
@@ -0,0 +1,141 @@
+#ifndef __SCENEBVH_H__
+#define __SCENEBVH_H__
+
+#include "glm/glm.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <list>
+#include <vector>
+
+#include "graphics/Bounds.h"
+#include "graphics/Frustum.h"
+#include "graphics/scene/MeshObject.h"
+#include "graphics/scene/MeshObjectBatch.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    // Bounding volume hierarchy over the world bounds of every MeshObject of a scene.
+    //     Objects are numbered in batch order and then in MeshObjects order, that is the order of the flags CullFrustum() writes.
+    //     Built top down with binned SAH splits, the two halves of large ranges are built on Common::ThreadPool.
+    //     Moved objects only refit the boxes above them, the tree is rebuilt once refitting made it too expensive to traverse.
+    //     Objects with invalid bounds are kept out of the tree, they are always visible and never hit by queries
+    class SceneBvh
+    {
+    public:
+        struct Ray
+        {
+            glm::vec3 Origin = glm::vec3(0.f);
+            // Need not be normalized, hit distances are in multiples of it
+            glm::vec3 Direction = glm::vec3(0.f, 0.f, -1.f);
+        };
+
+        struct RayHit
+        {
+            const MeshObject* Object = nullptr;
+            // Along the ray to where it enters the box of the object, 0 when it starts inside
+            float Distance = std::numeric_limits<float>::max();
+
+            bool IsHit() const
+            {
+                return Object != nullptr;
+            }
+        };
+
+        struct Stats
+        {
+            size_t ObjectAmount = 0;
+            size_t NodeAmount = 0;
+            size_t BuildAmount = 0;
+            size_t RefitAmount = 0;
+            // SAH cost of the tree now and right after its last build
+            float Cost = 0.f;
+            float BuildCost = 0.f;
+        };
+
+        // Rebuilds when objects were added, removed or reordered, otherwise refits the objects whose transform or bounds changed
+        void Update(const std::list<MeshObjectBatch>& batches);
+
+        // Builds from scratch regardless of what changed
+        void Build(const std::list<MeshObjectBatch>& batches);
+
+        void Clear();
+
+        // Sets visibleFlags[i] to 1 for every object i inside or crossing the frustum and to 0 for the others,
+        //     subtrees fully inside the frustum are taken without testing their objects. Returns the visible amount
+        size_t CullFrustum(const Frustum& frustum, std::vector<uint8_t>& visibleFlags) const;
+
+        // Nearest object whose box the ray enters within maxDistance
+        RayHit RayCast(const Ray& ray, float maxDistance = std::numeric_limits<float>::max()) const;
+
+        // Appends every object whose box overlaps the box or the sphere
+        void QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<const MeshObject*>& result) const;
+        void QuerySphere(const glm::vec3& center, float radius, std::vector<const MeshObject*>& result) const;
+
+        Stats GetStats() const;
+
+        // Refitting past this multiple of the build cost triggers a rebuild
+        float RebuildCostRatio = 1.5f;
+        // Ranges of at least this many objects build their two halves in parallel
+        size_t ParallelBuildObjectAmount = 4096;
+    private:
+        // Leaves have no children, inner nodes own the objects of both children, so every subtree is one range of objectIdxs
+        struct Node
+        {
+            glm::vec3 Min = glm::vec3(0.f);
+            // Right child is LeftChildIdx + 1, 0 for leaves since the root is nobody's child
+            uint32_t LeftChildIdx = 0;
+            glm::vec3 Max = glm::vec3(0.f);
+            uint32_t ParentIdx = UINT32_MAX;
+            uint32_t FirstObject = 0;
+            uint32_t ObjectAmount = 0;
+
+            bool IsLeaf() const
+            {
+                return LeftChildIdx == 0;
+            }
+        };
+
+        struct Object
+        {
+            const MeshObject* Source = nullptr;
+            Bounds LocalBounds;
+            Bounds WorldBounds;
+            uint32_t TransformVersion = 0;
+            uint32_t LeafIdx = UINT32_MAX;
+        };
+
+        static constexpr uint32_t BinAmount = 16;
+        static constexpr uint32_t MaxLeafObjectAmount = 8;
+
+        // Children are taken in pairs from nextNodeIdx, the halves of large ranges run on other threads
+        void BuildNode(uint32_t nodeIdx, uint32_t firstObject, uint32_t objectAmount, std::atomic<uint32_t>& nextNodeIdx);
+
+        // Box of the objects of a leaf or of both children of an inner node
+        void FitNode(Node& node) const;
+
+        // Surface area weighted node and object tests, relative to the root
+        float ComputeCost() const;
+
+        void MarkSubtreeVisible(const Node& node, std::vector<uint8_t>& visibleFlags) const;
+
+        std::vector<Object> objects;
+        // Objects of the tree in leaf order, subtrees index a range of it
+        std::vector<uint32_t> objectIdxs;
+        std::vector<uint32_t> unboundedObjectIdxs;
+        // Box centers of the objects at the last build, only read while building
+        std::vector<glm::vec3> centroids;
+        // Sized for the worst case at build, the first nodeAmount are used
+        std::vector<Node> nodes;
+        std::vector<uint32_t> dirtyLeafIdxs;
+        size_t nodeAmount = 0;
+        size_t buildAmount = 0;
+        size_t refitAmount = 0;
+        float cost = 0.f;
+        float buildCost = 0.f;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,171 @@
+#ifndef __SCENELOAD_H__
+#define __SCENELOAD_H__
+
+#include "glad/gl.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "graphics/Bounds.h"
+#include "graphics/Mesh.h"
+#include "graphics/MeshLodChain.h"
+#include "graphics/StagingRing.h"
+#include "graphics/Texture2d.h"
+#include "graphics/scene/ModelImporter.h"
+#include "graphics/scene/RyuMeshFile.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    // Handle of one Scene::LoadAsync. A job on Common::ThreadPool reads and converts the model and decodes its textures,
+    //     then the scene copies a few streams and texture rows per frame through its staging ring and takes every mesh
+    //     whose levels and textures are resident. Read it on the thread which ticks the scene
+    class SceneLoad
+    {
+    public:
+        enum State
+        {
+            STATE_DECODING,
+            STATE_UPLOADING,
+            STATE_DONE,
+            STATE_FAILED
+        };
+
+        // Settings are copied, later changes of the scene do not affect a running load
+        SceneLoad(
+            const std::string& modelFilePath,
+            const MeshOptimizationSettings& optimization,
+            const MeshLodSettings& lod,
+            size_t threadAmount);
+
+        State GetState() const;
+
+        // Done or failed, nothing changes afterwards
+        bool IsFinished() const;
+
+        // Share of the bytes to upload which were copied to the GPU, 0 while decoding
+        float GetProgress() const;
+
+        size_t GetUploadedBytes() const;
+
+        // Known once decoding is done, 0 before
+        size_t GetTotalBytes() const;
+
+        size_t GetMeshAmount() const;
+
+        // Meshes handed to the scene so far, they are drawn from then on
+        size_t GetReadyMeshAmount() const;
+
+        const std::string& GetSource() const;
+    private:
+        friend class Scene;
+
+        // Index or vertex stream of one level, copied in pieces of whole elements
+        struct StreamSource
+        {
+            std::span<const std::byte> Bytes;
+            size_t ElementBytes = 0;
+        };
+
+        struct PendingLevel
+        {
+            GLsizei VertexAmount = 0;
+            GLsizei IndexAmount = 0;
+            GLenum IndexType = GL_UNSIGNED_INT;
+            // Indices, then the separate layout streams of PhongBlinnMaterial::MeshVertexLayout in binding order
+            std::array<StreamSource, 4> Streams;
+            Bounds LevelBounds;
+            float Error = 0.f;
+            // Allocated when its first bytes are copied
+            Mesh Target;
+        };
+
+        struct PendingMesh
+        {
+            uint32_t MaterialIdx = 0;
+            // Imported mesh holding the bytes, released once the mesh is resident
+            size_t SourceIdx = 0;
+            std::vector<PendingLevel> Levels;
+            size_t LevelIdx = 0;
+            size_t StreamIdx = 0;
+            size_t ElementIdx = 0;
+        };
+
+        // Tightly packed rows, a row of a compressed level is one row of 4x4 blocks
+        struct PendingTextureLevel
+        {
+            int Width = 0;
+            int Height = 0;
+            size_t RowBytes = 0;
+            int RowAmount = 0;
+            std::vector<unsigned char> Pixels;
+        };
+
+        // Only level 0 for images, whose mip levels are generated on the GPU after the last row.
+        //     KTX2 and DDS files bring every level as blocks
+        struct PendingTexture
+        {
+            std::string Path;
+            GLint UnitIdx = 0;
+            GLenum Format = GL_NONE;
+            bool IsTopDown = false;
+            std::vector<PendingTextureLevel> Levels;
+            size_t LevelIdx = 0;
+            int RowIdx = 0;
+            std::shared_ptr<Texture2d> Target;
+            bool IsFinished = false;
+        };
+
+        // Runs on a worker thread, touches no GL object
+        bool Decode();
+
+        void AddCookedMeshes();
+
+        void AddImportedMeshes();
+
+        void DecodeTextures();
+
+        // Copies until the budget or the free space of the ring runs out
+        void Upload(StagingRing& ring, size_t& budgetBytes);
+
+        // True when the texture is resident or failed, false when it has to continue next frame
+        bool UploadTexture(PendingTexture& pt, StagingRing& ring, size_t& budgetBytes);
+
+        bool UploadMesh(PendingMesh& pm, StagingRing& ring, size_t& budgetBytes);
+
+        void Release();
+
+        std::string source;
+        std::string textureFileRootPath;
+        MeshOptimizationSettings optimizationSettings;
+        MeshLodSettings lodSettings;
+        size_t importThreadAmount = 0;
+
+        State state = STATE_DECODING;
+        std::future<bool> decoded;
+
+        ImportedModel model;
+        RyuMeshFile cookedFile;
+        std::vector<PendingMesh> meshes;
+        std::vector<PendingTexture> textures;
+        // Diffuse, specular and emission texture of each material, -1 for none
+        std::vector<std::array<int, 3>> materialTextureIdxs;
+
+        size_t meshAmount = 0;
+        size_t nextMeshIdx = 0;
+        // Resident chains waiting to be taken by the scene, with the material of each
+        std::vector<MeshLodChain> readyChains;
+        std::vector<uint32_t> readyMaterialIdxs;
+        size_t readyMeshAmount = 0;
+
+        size_t uploadedBytes = 0;
+        size_t totalBytes = 0;
+    };
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,119 @@
+#ifndef __SCENEUNIFORMBLOCKS_H__
+#define __SCENEUNIFORMBLOCKS_H__
+
+#include "glad/gl.h"
+#include "glm/glm.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "graphics/scene/DirectionalLight.h"
+#include "graphics/scene/PointLight.h"
+#include "graphics/scene/SpotLight.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    // CPU mirrors of the std140 blocks declared in 3d-blinn-phong-material.vert/.frag,
+    //     member order and padding must stay in sync with the shader side.
+    struct FrameUniformBlock
+    {
+        static constexpr GLuint BindingIdx = 0;
+
+        glm::mat4 View = glm::identity<glm::mat4>();
+        glm::mat4 Projection = glm::identity<glm::mat4>();
+    };
+
+    struct LightsUniformBlock
+    {
+        static constexpr GLuint BindingIdx = 1;
+        static constexpr size_t MaxPointLightAmount = 32;
+        static constexpr size_t MaxSpotLightAmount = 32;
+
+        struct DirectionalLightData
+        {
+            glm::vec3 Color = { 0.f, 0.f, 0.f };
+            float Padding0 = 0.f;
+            glm::vec3 ViewDirection = { 0.f, 0.f, 0.f };
+            float Padding1 = 0.f;
+        };
+
+        struct PointLightData
+        {
+            glm::vec3 Color = { 0.f, 0.f, 0.f };
+            float AttenuationConstant = 1.f;
+            glm::vec3 ViewPos = { 0.f, 0.f, 0.f };
+            float AttenuationLinear = 0.f;
+            float AttenuationQuadratic = 0.f;
+            float Padding[3] = {};
+        };
+
+        struct SpotLightData
+        {
+            glm::vec3 Color = { 0.f, 0.f, 0.f };
+            float AttenuationConstant = 1.f;
+            glm::vec3 ViewPos = { 0.f, 0.f, 0.f };
+            float AttenuationLinear = 0.f;
+            glm::vec3 ViewDirection = { 0.f, 0.f, 0.f };
+            float AttenuationQuadratic = 0.f;
+            float InnerCutOffCos = 0.f;
+            float OuterCutOffCos = 0.f;
+            float Padding[2] = {};
+        };
+
+        // Fills the block with view space lights, lights over the max amount are dropped
+        void Set(
+            const glm::mat4& view,
+            const DirectionalLight& directionLight,
+            const std::vector<PointLight>& pointLights,
+            const std::vector<SpotLight>& spotLights
+        );
+
+        DirectionalLightData DirectionLight;
+        GLint ActivePointLightAmount = 0;
+        GLint ActiveSpotLightAmount = 0;
+        GLint Padding[2] = {};
+        PointLightData PointLights[MaxPointLightAmount];
+        SpotLightData SpotLights[MaxSpotLightAmount];
+    };
+
+    // CPU mirrors of the std430 storage blocks read by multi draw materials, indexed by the base instance of each draw
+    struct DrawRecord
+    {
+        static constexpr GLuint BindingIdx = 2;
+
+        glm::mat4 Model = glm::identity<glm::mat4>();
+        // mat3 columns padded to vec4, the last column is unused
+        glm::mat4 ViewNormalMatrix = glm::identity<glm::mat4>();
+        uint32_t MaterialIdx = 0;
+        // VERTEX_FLAG_* of the mesh, its position decode is folded into Model
+        uint32_t VertexFlags = 0;
+        uint32_t Padding[2] = {};
+
+        enum VertexFlag : uint32_t
+        {
+            VERTEX_FLAG_NORMAL_OCTAHEDRAL = 1u << 0
+        };
+    };
+
+    // Per instance values of a material, each material decides what its slots hold
+    struct MaterialRecord
+    {
+        static constexpr GLuint BindingIdx = 3;
+
+        glm::vec4 Values[2] = {};
+    };
+
+    static_assert(sizeof(FrameUniformBlock) == 128);
+    static_assert(sizeof(LightsUniformBlock::DirectionalLightData) == 32);
+    static_assert(sizeof(LightsUniformBlock::PointLightData) == 48);
+    static_assert(sizeof(LightsUniformBlock::SpotLightData) == 64);
+    static_assert(offsetof(LightsUniformBlock, ActivePointLightAmount) == 32);
+    static_assert(offsetof(LightsUniformBlock, PointLights) == 48);
+    static_assert(offsetof(LightsUniformBlock, SpotLights) == 48 + 48 * LightsUniformBlock::MaxPointLightAmount);
+    static_assert(sizeof(DrawRecord) == 144);
+    static_assert(sizeof(MaterialRecord) == 32);
+}
+
+#endif
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
+#include <cstdint>
+
 namespace RyuRenderer::Graphics::Scene
 {
     class Transform
@@ -63,10 +65,14 @@ namespace RyuRenderer::Graphics::Scene
         glm::vec3 GetUpDirection() const;
 
         glm::vec3 GetDownDirection() const;
+
+        // Changes with every call that may move, rotate or scale, so caches of the matrix can tell when they are stale
+        uint32_t GetVersion() const;
     private:
         glm::vec3 position = glm::zero<glm::vec3>();
         glm::quat rotation = glm::identity<glm::quat>();
         glm::vec3 scale = glm::vec3(1.f);
+        uint32_t version = 0;
     };
 }
 
@@ -3,7 +3,12 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
 
-uniform mat4 model;
+// Per instance attributes, see Graphics::InstanceData
+layout (location = 8) in vec4 instanceModel0;
+layout (location = 9) in vec4 instanceModel1;
+layout (location = 10) in vec4 instanceModel2;
+layout (location = 11) in vec4 instanceModel3;
+
 uniform mat4 view;
 uniform mat4 projection;
 
@@ -11,6 +16,7 @@ out vec2 TexCoord;
 
 void main()
 {
+    mat4 model = mat4(instanceModel0, instanceModel1, instanceModel2, instanceModel3);
     gl_Position = projection * view * model * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
 }
\ No newline at end of file
@@ -10,22 +10,22 @@ struct DirectionalLight {
 
 struct PointLight {
     vec3 color;
-    vec3 viewPos;
     float attenuationConstant;
+    vec3 viewPos;
     float attenuationLinear;
     float attenuationQuadratic;
 };
 
 struct SpotLight {
     vec3 color;
+    float attenuationConstant;
     vec3 viewPos;
+    float attenuationLinear;
     vec3 viewDirection;
+    float attenuationQuadratic;
     float innerCutOffCos;
     float outerCutOffCos;
-    float attenuationConstant;
-    float attenuationLinear;
-    float attenuationQuadratic;
-}; 
+};
 
 struct Material {
     vec3 ambient;
@@ -38,20 +38,43 @@ struct Material {
 in vec3 vViewPos;
 in vec3 vViewNormal;
 in vec2 vTexCoords;
+flat in uint vMaterialIdx;
 
 uniform Material material;
-uniform DirectionalLight directionalLight;
-uniform int activePointLightCount = 0;
-uniform PointLight pointLights[MAX_POINT_LIGHTS];
-uniform int activeSpotLightCount = 0;
-uniform SpotLight spotLights[MAX_SPOT_LIGHTS];
+
+struct MaterialRecord {
+    vec4 ambientShininess;
+    vec4 padding;
+};
+
+// Filled by the render queue for multi draws, replaces the ambient and shininess uniforms
+layout (std430, binding = 3) readonly buffer MaterialBlock {
+    MaterialRecord materials[];
+};
+
+layout (std140, binding = 1) uniform LightsBlock {
+    DirectionalLight directionalLight;
+    int activePointLightCount;
+    int activeSpotLightCount;
+    PointLight pointLights[MAX_POINT_LIGHTS];
+    SpotLight spotLights[MAX_SPOT_LIGHTS];
+};
 
 uniform bool hasDiffuse = false;
 uniform bool hasSpecular = false;
 uniform bool hasEmission = false;
+// Set for textures whose rows could not be flipped bottom up on load
+uniform bool isDiffuseTopDown = false;
+uniform bool isSpecularTopDown = false;
+uniform bool isEmissionTopDown = false;
+uniform bool isMultiDraw = false;
+
+vec3 materialAmbient;
+float materialShininess;
 
 out vec4 FragColor;
 
+vec2 GetTexCoords(bool isTopDown);
 vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 diffuseTexture, vec3 specularTexture);
 vec3 CalcPointLight(PointLight light, vec3 normal, vec3 viewPos, vec3 viewDir, vec3 diffuseTexture, vec3 specularTexture);
 vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 viewPos, vec3 viewDir, vec3 diffuseTexture, vec3 specularTexture);
@@ -62,15 +85,23 @@ void main()
     vec3 normal = vViewNormal;
     vec3 viewDir = normalize(-vViewPos);
 
+    materialAmbient = material.ambient;
+    materialShininess = material.shininess;
+    if (isMultiDraw)
+    {
+        materialAmbient = materials[vMaterialIdx].ambientShininess.xyz;
+        materialShininess = materials[vMaterialIdx].ambientShininess.w;
+    }
+
     vec3 diffuseTexture = vec3(0.0);
     if (hasDiffuse)
-        diffuseTexture = vec3(texture(material.diffuse, vTexCoords));
+        diffuseTexture = vec3(texture(material.diffuse, GetTexCoords(isDiffuseTopDown)));
     vec3 specularTexture = vec3(0.0);
     if (hasSpecular)
-        specularTexture = vec3(texture(material.specular, vTexCoords));
+        specularTexture = vec3(texture(material.specular, GetTexCoords(isSpecularTopDown)));
     vec3 emissionTexture = vec3(0.0);
     if (hasEmission)
-        emissionTexture = vec3(texture(material.emission, vTexCoords));
+        emissionTexture = vec3(texture(material.emission, GetTexCoords(isEmissionTopDown)));
 
     vec3 result = vec3(0.0);
     
@@ -94,17 +125,22 @@ void main()
     FragColor = vec4(result, 1.0);
 }
 
+vec2 GetTexCoords(bool isTopDown)
+{
+    return isTopDown ? vec2(vTexCoords.x, 1.0 - vTexCoords.y) : vTexCoords;
+}
+
 vec3 CalcDirectionalLight(DirectionalLight light, vec3 normal, vec3 viewDir, vec3 diffuseTexture, vec3 specularTexture)
 {
     vec3 lightDir = normalize(-light.viewDirection);
 
-    vec3 ambient = material.ambient * diffuseTexture;
+    vec3 ambient = materialAmbient * diffuseTexture;
 
     float diff = max(dot(normal, lightDir), 0.0);
     vec3 diffuse = light.color * diff * diffuseTexture;
 
     vec3 halfwayDir = normalize(lightDir + viewDir);
-    float spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), materialShininess);
     vec3 specular = light.color * spec * specularTexture;
 
     return ambient + diffuse + specular;
@@ -118,13 +154,13 @@ vec3 CalcPointLight(PointLight light, vec3 normal, vec3 viewPos, vec3 viewDir, v
     float dis = length(posToLight);
     float attenuation = 1.0 / (light.attenuationConstant + light.attenuationLinear * dis + light.attenuationQuadratic * (dis * dis));
 
-    vec3 ambient = attenuation * material.ambient * diffuseTexture;
+    vec3 ambient = attenuation * materialAmbient * diffuseTexture;
 
     float diff = max(dot(normal, lightDir), 0.0);
     vec3 diffuse = attenuation * light.color * diff * diffuseTexture;
 
     vec3 halfwayDir = normalize(lightDir + viewDir);
-    float spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
+    float spec = pow(max(dot(normal, halfwayDir), 0.0), materialShininess);
     vec3 specular = attenuation * light.color * spec * specularTexture;
 
     return ambient + diffuse + specular;
@@ -140,7 +176,7 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 viewPos, vec3 viewDir, vec
 
     float theta = dot(lightDir, normalize(-light.viewDirection));
 
-    vec3 ambient = attenuation * material.ambient * diffuseTexture;
+    vec3 ambient = attenuation * materialAmbient * diffuseTexture;
     if (theta <= light.outerCutOffCos) 
     {
         return ambient;
@@ -154,7 +190,7 @@ vec3 CalcSpotLight(SpotLight light, vec3 normal, vec3 viewPos, vec3 viewDir, vec
         vec3 diffuse = attenuation * intensity * light.color * diff * diffuseTexture;
 
         vec3 halfwayDir = normalize(lightDir + viewDir);
-        float spec = pow(max(dot(normal, halfwayDir), 0.0), material.shininess);
+        float spec = pow(max(dot(normal, halfwayDir), 0.0), materialShininess);
         vec3 specular = attenuation * intensity * light.color * spec * specularTexture;
 
         return ambient + diffuse + specular;
@@ -1,22 +1,86 @@
 #version 460 core
+#if __VERSION__ >= 460
+#define BASE_INSTANCE gl_BaseInstance
+#else
+#extension GL_ARB_shader_draw_parameters : require
+#define BASE_INSTANCE gl_BaseInstanceARB
+#endif
 layout (location = 0) in vec3 pos;
 layout (location = 1) in vec3 normal;
 layout (location = 2) in vec2 texCoords;
 
+// Per instance attributes, see Graphics::InstanceData
+layout (location = 8) in vec4 instanceModel0;
+layout (location = 9) in vec4 instanceModel1;
+layout (location = 10) in vec4 instanceModel2;
+layout (location = 11) in vec4 instanceModel3;
+
+layout (std140, binding = 0) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+};
+
+struct DrawRecord {
+    mat4 model;
+    mat4 viewNormalMatrix;
+    uint materialIdx;
+    // Bit 0: normal is octahedral encoded, the position decode is folded into model
+    uint vertexFlags;
+};
+
+// Filled by the render queue for multi draws, one record per draw at its base instance
+layout (std430, binding = 2) readonly buffer DrawBlock {
+    DrawRecord draws[];
+};
+
+uniform bool isMultiDraw = false;
+// Instance transforms are applied after the object transform in model
+uniform bool isInstanced = false;
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 uniform mat3 viewNormalMatrix;
+// Mesh::VertexDecode of single and instanced draws
+uniform vec3 positionDecodeOffset = vec3(0.0);
+uniform vec3 positionDecodeScale = vec3(1.0);
+uniform bool isNormalOctahedral = false;
 
 out vec3 vViewPos;
 out vec3 vViewNormal;
 out vec2 vTexCoords;
+flat out uint vMaterialIdx;
+
+vec3 DecodeOctahedral(vec2 e)
+{
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+    return normalize(n);
+}
 
 void main()
 {
-    vec4 viewPos = view * model * vec4(pos, 1.0);
+    vec3 localPos = positionDecodeOffset + pos * positionDecodeScale;
+    bool isOctahedral = isNormalOctahedral;
+    mat4 drawModel = model;
+    mat3 drawViewNormalMatrix = viewNormalMatrix;
+    vMaterialIdx = 0u;
+    if (isMultiDraw)
+    {
+        drawModel = draws[BASE_INSTANCE].model;
+        drawViewNormalMatrix = mat3(draws[BASE_INSTANCE].viewNormalMatrix);
+        vMaterialIdx = draws[BASE_INSTANCE].materialIdx;
+        localPos = pos;
+        isOctahedral = (draws[BASE_INSTANCE].vertexFlags & 1u) != 0u;
+    }
+    else if (isInstanced)
+    {
+        drawModel = model * mat4(instanceModel0, instanceModel1, instanceModel2, instanceModel3);
+        drawViewNormalMatrix = transpose(inverse(mat3(view * drawModel)));
+    }
+
+    vec3 localNormal = isOctahedral ? DecodeOctahedral(normal.xy) : normal;
+    vec4 viewPos = view * drawModel * vec4(localPos, 1.0);
     vViewPos = viewPos.xyz;
-    vViewNormal = normalize(viewNormalMatrix * normal);
+    vViewNormal = normalize(drawViewNormalMatrix * localNormal);
     vTexCoords = texCoords;
     gl_Position = projection * viewPos;
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 460 core
+
+in vec4 vColor;
+
+out vec4 FragColor;
+
+void main()
+{
+    FragColor = vec4(vColor.rgb, 1.0);
+}
\ No newline at end of file
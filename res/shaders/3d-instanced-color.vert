@@ -0,0 +1,23 @@
+#version 460 core
+layout (location = 0) in vec3 aPos;
+
+// Per instance attributes, see Graphics::InstanceData
+layout (location = 8) in vec4 instanceModel0;
+layout (location = 9) in vec4 instanceModel1;
+layout (location = 10) in vec4 instanceModel2;
+layout (location = 11) in vec4 instanceModel3;
+layout (location = 12) in vec4 instanceColor;
+
+layout (std140, binding = 0) uniform FrameBlock {
+    mat4 view;
+    mat4 projection;
+};
+
+out vec4 vColor;
+
+void main()
+{
+    mat4 model = mat4(instanceModel0, instanceModel1, instanceModel2, instanceModel3);
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    vColor = instanceColor;
+}
\ No newline at end of file
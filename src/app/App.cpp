@@ -1,3 +1,9 @@
+#ifdef RYU_ENABLE_EGL
+// Must precede glad, its bundled khrplatform.h lacks KHRONOS_APIENTRY used by EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
 #include "app/App.h"
 
 #include "glad/gl.h"
@@ -6,6 +12,11 @@
 #include "app/events/KeyEvent.h"
 #include "app/events/MouseEvent.h"
 #include "app/events/WindowEvent.h"
+#include "common/Profiler.h"
+#include "graphics/GpuTimer.h"
+#include "graphics/TextureManager.h"
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
 
 namespace RyuRenderer::App
 {
@@ -18,6 +29,170 @@ namespace RyuRenderer::App
     {
         Clear();
 
+        backend = settings.Backend;
+        maxFrameAmount = settings.MaxFrameAmount;
+        fixedDeltaTimeInS = settings.FixedDeltaTimeInS;
+        initTime = std::chrono::steady_clock::now();
+
+        if (backend == AppSettings::BackendType::BACKEND_HEADLESS)
+        {
+            if (!InitHeadlessContext(settings))
+            {
+                std::clog << "EGL headless context is unavailable, fall back to an invisible window." << std::endl;
+                if (!InitWindow(settings, false))
+                    return false;
+            }
+
+            if (!InitOffscreenFrame(settings.WindowWidth, settings.WindowHeight))
+            {
+                std::cerr << "Failed to create headless offscreen frame" << std::endl;
+                Clear();
+                return false;
+            }
+        }
+        else
+        {
+            if (!InitWindow(settings, true))
+                return false;
+        }
+
+        return true;
+    }
+
+    void App::Run(RyuRenderer::App::RenderPipeline::IRenderPipeline* p)
+    {
+        RYU_PROFILE_ZONE("App::Run");
+
+        auto& device = Graphics::Device::IDevice::Current();
+
+        if (!window && !eglContext)
+        {
+            std::cerr << "App initialization incorrect, unable to run." << std::endl;
+            return;
+        }
+
+        if (!p)
+        {
+            std::cerr << "App pipeline incorrect, unable to run." << std::endl;
+            return;
+        }
+
+        // Every run starts from the same states, so pipelines can be run one after another
+        InitRenderStates();
+
+        renderPipeline = p;
+        renderPipeline->Init();
+
+        // main loop
+        unsigned long long tickedFrameAmount = 0;
+        lastTickTimeInS = GetTimeInS();
+        while (!ShouldClose(tickedFrameAmount))
+        {
+            RYU_PROFILE_ZONE("Frame");
+            Graphics::GpuTimer::GetInstance().BeginFrame();
+
+            // handle input events
+            if (window)
+                glfwPollEvents();
+
+            // render into the offscreen frame instead of the default framebuffer
+            if (IsHeadless())
+                offscreenFrame.Use();
+
+            // clear canvas
+            device.ClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            device.Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+            double currentTimeInS = GetTimeInS();
+            double deltaTime = currentTimeInS - lastTickTimeInS;
+            lastTickTimeInS = currentTimeInS;
+            if (fixedDeltaTimeInS > 0.0)
+                deltaTime = fixedDeltaTimeInS;
+
+            // Textures decoded by workers since the last frame, within their upload budget
+            Graphics::TextureManager::GetInstance().UpdateUploads();
+
+            // render
+            {
+                RYU_PROFILE_ZONE("IRenderPipeline::Tick");
+                renderPipeline->Tick(deltaTime);
+            }
+
+            // show render result
+            {
+                RYU_PROFILE_ZONE("App::Present");
+                if (IsHeadless())
+                    device.Flush();
+                else
+                    glfwSwapBuffers(window);
+            }
+
+            ++tickedFrameAmount;
+
+            // Zones of this frame leave the thread rings, so they never fill up in long runs
+            RYU_PROFILE_COLLECT();
+        }
+
+        // Make sure all headless frames are really rendered before leaving
+        if (IsHeadless())
+            device.Finish();
+
+        // Pending GPU times are read back while their context is still alive
+        Graphics::GpuTimer::GetInstance().Clear();
+        RYU_PROFILE_COLLECT();
+    }
+
+    int App::GetWindowWidth() const
+    {
+        return windowWidth;
+    }
+
+    int App::GetWindowHeight() const
+    {
+        return windowHeight;
+    }
+
+    bool App::IsHeadless() const
+    {
+        return backend == AppSettings::BackendType::BACKEND_HEADLESS;
+    }
+
+    void App::Clear()
+    {
+        // GL objects must be released before their context
+        if (offscreenFrame.IsValid())
+        {
+            Graphics::Frame::SetDefault(nullptr);
+            offscreenFrame = Graphics::Frame();
+        }
+        if (offscreenTexture.IsValid())
+            offscreenTexture = Graphics::Texture2d();
+
+        if (window)
+            glfwTerminate();
+
+#ifdef RYU_ENABLE_EGL
+        if (eglDisplay)
+        {
+            eglMakeCurrent(eglDisplay, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            if (eglSurface)
+                eglDestroySurface(eglDisplay, eglSurface);
+            if (eglContext)
+                eglDestroyContext(eglDisplay, eglContext);
+            eglTerminate(eglDisplay);
+        }
+#endif
+
+        windowWidth = 0;
+        windowHeight = 0;
+        window = nullptr;
+        eglDisplay = nullptr;
+        eglContext = nullptr;
+        eglSurface = nullptr;
+    }
+
+    bool App::InitWindow(const AppSettings& settings, bool isVisible)
+    {
         // init glfw
         glfwInit();
 
@@ -25,6 +200,7 @@ namespace RyuRenderer::App
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        glfwWindowHint(GLFW_VISIBLE, isVisible ? GLFW_TRUE : GLFW_FALSE);
 
         window = glfwCreateWindow(settings.WindowWidth, settings.WindowHeight, settings.WindowName.c_str(), NULL, NULL);
         if (window == nullptr)
@@ -49,12 +225,6 @@ namespace RyuRenderer::App
             return false;
         }
 
-        // other settings
-        glEnable(GL_DEPTH_TEST);
-        glEnable(GL_STENCIL_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
         glfwSwapInterval(settings.VSyncInterval);
 
         // Window state
@@ -76,68 +246,158 @@ namespace RyuRenderer::App
         glfwSetCursorEnterCallback(window, OnMouseEnter);
         glfwSetKeyCallback(window, OnKeyEvent);
 
-        stbi_set_flip_vertically_on_load(true);
-
         return true;
     }
 
-    void App::Run(RyuRenderer::App::RenderPipeline::IRenderPipeline* p)
+    bool App::InitHeadlessContext(const AppSettings& settings)
     {
-        if (!window)
+#ifdef RYU_ENABLE_EGL
+        // Prefer the surfaceless platform, it needs neither a display server nor a GPU
+        EGLDisplay display = EGL_NO_DISPLAY;
+        auto getPlatformDisplay =
+            reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay)
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL);
+        if (display == EGL_NO_DISPLAY)
+            display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (display == EGL_NO_DISPLAY)
+            return false;
+
+        EGLint eglMajor = 0;
+        EGLint eglMinor = 0;
+        if (!eglInitialize(display, &eglMajor, &eglMinor))
+            return false;
+        eglDisplay = display;
+
+        if (!eglBindAPI(EGL_OPENGL_API))
         {
-            std::cerr << "App initialization incorrect, unable to run." << std::endl;
-            return;
+            Clear();
+            return false;
         }
 
-        if (!p)
+        const EGLint configAttribs[] = {
+            EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+            EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+            EGL_RED_SIZE, 8,
+            EGL_GREEN_SIZE, 8,
+            EGL_BLUE_SIZE, 8,
+            EGL_ALPHA_SIZE, 8,
+            EGL_NONE
+        };
+        EGLConfig config = EGL_NO_CONFIG_KHR;
+        EGLint configAmount = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &configAmount) || configAmount <= 0)
+            config = EGL_NO_CONFIG_KHR; // Configless context, rendering only goes into FBOs anyway
+
+        // Mesa llvmpipe tops out at 4.5, so accept it when 4.6 is unavailable
+        constexpr EGLint contextMinorVersions[] = { 6, 5 };
+        EGLContext context = EGL_NO_CONTEXT;
+        for (EGLint minor : contextMinorVersions)
         {
-            std::cerr << "App pipeline incorrect, unable to run." << std::endl;
-            return;
+            const EGLint contextAttribs[] = {
+                EGL_CONTEXT_MAJOR_VERSION, 4,
+                EGL_CONTEXT_MINOR_VERSION, minor,
+                EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                EGL_NONE
+            };
+            context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+            if (context != EGL_NO_CONTEXT)
+                break;
+        }
+        if (context == EGL_NO_CONTEXT)
+        {
+            Clear();
+            return false;
         }
+        eglContext = context;
 
-        renderPipeline = p;
-        renderPipeline->Init();
+        const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+        bool isSurfaceless = extensions && std::string(extensions).find("EGL_KHR_surfaceless_context") != std::string::npos;
+        if (!isSurfaceless && config != EGL_NO_CONFIG_KHR)
+        {
+            const EGLint pbufferAttribs[] = {
+                EGL_WIDTH, settings.WindowWidth,
+                EGL_HEIGHT, settings.WindowHeight,
+                EGL_NONE
+            };
+            eglSurface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+            if (eglSurface == EGL_NO_SURFACE)
+            {
+                eglSurface = nullptr;
+                Clear();
+                return false;
+            }
+        }
 
-        // main loop
-        while (!glfwWindowShouldClose(window))
+        EGLSurface surface = eglSurface ? eglSurface : EGL_NO_SURFACE;
+        if (!eglMakeCurrent(display, surface, surface, context))
         {
-            // handle input events
-            glfwPollEvents();
+            Clear();
+            return false;
+        }
 
-            // clear canvas
-            glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+        // init glad
+        if (!gladLoadGL(reinterpret_cast<GLADloadfunc>(eglGetProcAddress)))
+        {
+            std::cerr << "Failed to initialize GLAD" << std::endl;
+            Clear();
+            return false;
+        }
 
-            double currentTimeInS = glfwGetTime();
-            double deltaTime = currentTimeInS - lastTickTimeInS;
-            lastTickTimeInS = currentTimeInS;
+        windowWidth = settings.WindowWidth;
+        windowHeight = settings.WindowHeight;
+        return true;
+#else
+        return false;
+#endif
+    }
 
-            // render
-            renderPipeline->Tick(deltaTime);
+    bool App::InitOffscreenFrame(int width, int height)
+    {
+        offscreenTexture = Graphics::Texture2d(GL_RGBA, 0, width, height);
+        if (!offscreenTexture.IsValid())
+            return false;
 
-            // show render result
-            glfwSwapBuffers(window);
-        }
+        offscreenFrame = Graphics::Frame(&offscreenTexture);
+        if (!offscreenFrame.AttachDepthStencil(width, height))
+            return false;
+
+        // Pipelines go back to this frame instead of the default framebuffer
+        Graphics::Frame::SetDefault(&offscreenFrame);
+        offscreenFrame.Use();
+        Graphics::Device::StateTracker::GetInstance().Viewport(0, 0, width, height);
+        return true;
     }
 
-    int App::GetWindowWidth() const
+    void App::InitRenderStates()
     {
-        return windowWidth;
+        auto& states = Graphics::Device::StateTracker::GetInstance();
+
+        states.Enable(GL_DEPTH_TEST);
+        states.Enable(GL_STENCIL_TEST);
+        states.Enable(GL_BLEND);
+        states.BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+        stbi_set_flip_vertically_on_load(true);
     }
 
-    int App::GetWindowHeight() const
+    bool App::ShouldClose(unsigned long long tickedFrameAmount) const
     {
-        return windowHeight;
+        if (maxFrameAmount > 0 && tickedFrameAmount >= maxFrameAmount)
+            return true;
+
+        if (window)
+            return glfwWindowShouldClose(window);
+
+        return false;
     }
 
-    void App::Clear()
+    double App::GetTimeInS() const
     {
         if (window)
-            glfwTerminate();
+            return glfwGetTime();
 
-        windowWidth = 0;
-        windowHeight = 0;
-        window = nullptr;
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - initTime).count();
     }
 
     void App::SetWindowIcon(const std::string& iconPath)
@@ -165,7 +425,7 @@ namespace RyuRenderer::App
         if (window != App::GetInstance().window)
             return;
 
-        glViewport(0, 0, width, height);
+        Graphics::Device::StateTracker::GetInstance().Viewport(0, 0, width, height);
         App::GetInstance().windowWidth = width;
         App::GetInstance().windowHeight = height;
 
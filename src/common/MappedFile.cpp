@@ -0,0 +1,135 @@
+#include "common/MappedFile.h"
+
+#include <iostream>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RyuRenderer::Common
+{
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    MappedFile::~MappedFile()
+    {
+        Close();
+    }
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Close();
+        data = std::exchange(other.data, nullptr);
+        size = std::exchange(other.size, 0);
+#ifdef _WIN32
+        fileHandle = std::exchange(other.fileHandle, nullptr);
+        mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#endif
+        return *this;
+    }
+
+    bool MappedFile::Open(const std::string& filePath)
+    {
+        Close();
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(
+            filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+        {
+            std::cerr << "Failed to open file " << filePath << "." << std::endl;
+            return false;
+        }
+        LARGE_INTEGER fileSize = {};
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0)
+        {
+            std::cerr << "Failed to map empty file " << filePath << "." << std::endl;
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view)
+        {
+            std::cerr << "Failed to map file " << filePath << "." << std::endl;
+            if (mapping)
+                CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        fileHandle = file;
+        mappingHandle = mapping;
+        data = static_cast<const std::byte*>(view);
+        size = static_cast<std::size_t>(fileSize.QuadPart);
+#else
+        const int file = open(filePath.c_str(), O_RDONLY);
+        if (file < 0)
+        {
+            std::cerr << "Failed to open file " << filePath << "." << std::endl;
+            return false;
+        }
+        struct stat fileStat = {};
+        if (fstat(file, &fileStat) != 0 || fileStat.st_size <= 0)
+        {
+            std::cerr << "Failed to map empty file " << filePath << "." << std::endl;
+            close(file);
+            return false;
+        }
+        void* view = mmap(nullptr, static_cast<std::size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+        // The mapping keeps its own reference to the file
+        close(file);
+        if (view == MAP_FAILED)
+        {
+            std::cerr << "Failed to map file " << filePath << "." << std::endl;
+            return false;
+        }
+        // Uploads walk the blobs front to back, let the kernel read ahead
+        madvise(view, static_cast<std::size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+        data = static_cast<const std::byte*>(view);
+        size = static_cast<std::size_t>(fileStat.st_size);
+#endif
+        return true;
+    }
+
+    void MappedFile::Close()
+    {
+        if (!data)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+        CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        fileHandle = nullptr;
+        mappingHandle = nullptr;
+#else
+        munmap(const_cast<std::byte*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+    bool MappedFile::IsOpen() const
+    {
+        return data != nullptr;
+    }
+
+    std::span<const std::byte> MappedFile::GetBytes() const
+    {
+        return std::span<const std::byte>(data, size);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "common/OffsetAllocator.h"
+
+namespace RyuRenderer::Common
+{
+    OffsetAllocator::OffsetAllocator(size_t c) :
+        capacity(c)
+    {
+        Reset();
+    }
+
+    size_t OffsetAllocator::Allocate(size_t size)
+    {
+        if (size == 0)
+            return InvalidOffset;
+
+        auto bySizeIt = freeRangesBySize.lower_bound(size);
+        if (bySizeIt == freeRangesBySize.end())
+            return InvalidOffset;
+
+        const size_t offset = bySizeIt->second;
+        const size_t rangeSize = bySizeIt->first;
+        RemoveFreeRange(freeRanges.find(offset));
+
+        // The rest of the range stays free
+        if (rangeSize > size)
+            AddFreeRange(offset + size, rangeSize - size);
+
+        allocations.emplace(offset, size);
+        usedSize += size;
+        return offset;
+    }
+
+    bool OffsetAllocator::Free(size_t offset)
+    {
+        auto allocationIt = allocations.find(offset);
+        if (allocationIt == allocations.end())
+            return false;
+
+        size_t size = allocationIt->second;
+        allocations.erase(allocationIt);
+        usedSize -= size;
+
+        // Merge with the free range right after it
+        auto nextIt = freeRanges.find(offset + size);
+        if (nextIt != freeRanges.end())
+        {
+            size += nextIt->second;
+            RemoveFreeRange(nextIt);
+        }
+
+        // Merge with the free range right before it
+        auto prevIt = freeRanges.lower_bound(offset);
+        if (prevIt != freeRanges.begin())
+        {
+            --prevIt;
+            if (prevIt->first + prevIt->second == offset)
+            {
+                offset = prevIt->first;
+                size += prevIt->second;
+                RemoveFreeRange(prevIt);
+            }
+        }
+
+        AddFreeRange(offset, size);
+        return true;
+    }
+
+    void OffsetAllocator::Reset()
+    {
+        freeRanges.clear();
+        freeRangesBySize.clear();
+        allocations.clear();
+        usedSize = 0;
+
+        if (capacity > 0)
+            AddFreeRange(0, capacity);
+    }
+
+    size_t OffsetAllocator::GetCapacity() const
+    {
+        return capacity;
+    }
+
+    size_t OffsetAllocator::GetUsedSize() const
+    {
+        return usedSize;
+    }
+
+    size_t OffsetAllocator::GetFreeSize() const
+    {
+        return capacity - usedSize;
+    }
+
+    size_t OffsetAllocator::GetLargestFreeSize() const
+    {
+        return freeRangesBySize.empty() ? 0 : freeRangesBySize.rbegin()->first;
+    }
+
+    size_t OffsetAllocator::GetAllocationAmount() const
+    {
+        return allocations.size();
+    }
+
+    size_t OffsetAllocator::GetFreeRangeAmount() const
+    {
+        return freeRanges.size();
+    }
+
+    double OffsetAllocator::GetFragmentation() const
+    {
+        const size_t freeSize = GetFreeSize();
+        if (freeSize == 0)
+            return 0.0;
+
+        return 1.0 - static_cast<double>(GetLargestFreeSize()) / static_cast<double>(freeSize);
+    }
+
+    void OffsetAllocator::AddFreeRange(size_t offset, size_t size)
+    {
+        freeRanges.emplace(offset, size);
+        freeRangesBySize.emplace(size, offset);
+    }
+
+    void OffsetAllocator::RemoveFreeRange(std::map<size_t, size_t>::iterator it)
+    {
+        // Ranges of the same size are told apart by their offset
+        auto [first, last] = freeRangesBySize.equal_range(it->second);
+        for (auto bySizeIt = first; bySizeIt != last; ++bySizeIt)
+        {
+            if (bySizeIt->second == it->first)
+            {
+                freeRangesBySize.erase(bySizeIt);
+                break;
+            }
+        }
+        freeRanges.erase(it);
+    }
+}
\ No newline at end of file
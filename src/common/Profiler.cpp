@@ -0,0 +1,223 @@
+#include "common/Profiler.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+namespace RyuRenderer::Common
+{
+    Profiler::ScopedZone::ScopedZone(const char* name)
+    {
+        auto& profiler = Profiler::GetInstance();
+        if (!profiler.IsEnabled.load(std::memory_order_relaxed))
+            return;
+
+        this->name = name;
+        ++profiler.GetThreadBuffer().Depth;
+        beginInNs = profiler.GetTimeInNs();
+    }
+
+    Profiler::ScopedZone::~ScopedZone()
+    {
+        if (!name)
+            return;
+
+        auto& profiler = Profiler::GetInstance();
+        unsigned long long endInNs = profiler.GetTimeInNs();
+
+        auto& buffer = profiler.GetThreadBuffer();
+        --buffer.Depth;
+        buffer.Events.Push(ZoneEvent{ name, beginInNs, endInNs, buffer.Depth });
+    }
+
+    Profiler::Profiler()
+    {
+        epoch = std::chrono::steady_clock::now();
+    }
+
+    Profiler::~Profiler()
+    {
+        if (!dumpPathAtExit.empty())
+            DumpChromeTrace(dumpPathAtExit);
+    }
+
+    void Profiler::SetThreadName(const std::string& name)
+    {
+        auto& buffer = GetThreadBuffer();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        buffer.ThreadName = name;
+    }
+
+    void Profiler::Collect()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CollectLocked();
+    }
+
+    void Profiler::Clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CollectLocked();
+        collectedEvents.clear();
+        overflowedEventAmount = 0;
+    }
+
+    bool Profiler::WriteChromeTrace(std::ostream& os)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        CollectLocked();
+
+        auto writeString =
+            [&os](const std::string& str)
+            {
+                os << '"';
+                for (char c : str)
+                {
+                    if (c == '"' || c == '\\')
+                        os << '\\';
+                    os << c;
+                }
+                os << '"';
+            };
+
+        auto oldFlags = os.flags();
+        auto oldPrecision = os.precision();
+        os << std::fixed << std::setprecision(3);
+
+        os << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool isFirst = true;
+        for (const auto& b : threadBuffers)
+        {
+            os << (isFirst ? "" : ",\n");
+            isFirst = false;
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->ThreadIdx << ",\"args\":{\"name\":";
+            writeString(b->ThreadName.empty() ? "Thread " + std::to_string(b->ThreadIdx) : b->ThreadName);
+            os << "}}";
+        }
+        for (const auto& t : tracks)
+        {
+            os << (isFirst ? "" : ",\n");
+            isFirst = false;
+            os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t.Idx << ",\"args\":{\"name\":";
+            writeString(t.Name);
+            os << "}}";
+        }
+        for (const auto& e : collectedEvents)
+        {
+            os << (isFirst ? "" : ",\n");
+            isFirst = false;
+            os << "{\"name\":";
+            writeString(e.Event.Name ? e.Event.Name : "");
+            os << ",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":1,\"tid\":" << e.ThreadIdx
+               << ",\"ts\":" << e.Event.BeginInNs / 1000.0
+               << ",\"dur\":" << (e.Event.EndInNs - e.Event.BeginInNs) / 1000.0
+               << ",\"args\":{\"depth\":" << e.Event.Depth << "}}";
+        }
+        os << "\n]}\n";
+
+        os.flags(oldFlags);
+        os.precision(oldPrecision);
+        return os.good();
+    }
+
+    bool Profiler::DumpChromeTrace(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::out | std::ios::trunc);
+        if (!file.is_open())
+        {
+            std::cerr << "Failed to open profiler trace file: " << path << std::endl;
+            return false;
+        }
+
+        return WriteChromeTrace(file);
+    }
+
+    void Profiler::SetDumpPathAtExit(const std::string& path)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        dumpPathAtExit = path;
+        if (!path.empty())
+            IsCapturing = true;
+    }
+
+    unsigned int Profiler::CreateTrack(const std::string& name)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tracks.emplace_back(Track{ nextTrackIdx++, name });
+        return tracks.back().Idx;
+    }
+
+    void Profiler::AddTrackEvent(unsigned int trackIdx, const ZoneEvent& e)
+    {
+        if (!IsEnabled.load(std::memory_order_relaxed) || !IsCapturing.load(std::memory_order_relaxed))
+            return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (collectedEvents.size() >= MaxCollectedEventAmount)
+        {
+            collectedEvents.pop_front();
+            ++overflowedEventAmount;
+        }
+        collectedEvents.emplace_back(CollectedEvent{ trackIdx, e });
+    }
+
+    size_t Profiler::GetCollectedEventAmount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return collectedEvents.size();
+    }
+
+    unsigned long long Profiler::GetDroppedEventAmount()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        unsigned long long amount = overflowedEventAmount;
+        for (const auto& b : threadBuffers)
+            amount += b->Events.GetDroppedAmount();
+        return amount;
+    }
+
+    unsigned long long Profiler::GetTimeInNs() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+    {
+        thread_local ThreadBuffer* buffer = nullptr;
+        if (buffer)
+            return *buffer;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        auto newBuffer = std::make_unique<ThreadBuffer>();
+        newBuffer->ThreadIdx = nextTrackIdx++;
+        buffer = newBuffer.get();
+        threadBuffers.emplace_back(std::move(newBuffer));
+        return *buffer;
+    }
+
+    void Profiler::CollectLocked()
+    {
+        const bool isCapturing = IsCapturing.load(std::memory_order_relaxed);
+        for (auto& b : threadBuffers)
+        {
+            const unsigned int threadIdx = b->ThreadIdx;
+            b->Events.Drain(
+                [&](const ZoneEvent& e)
+                {
+                    if (!isCapturing)
+                        return;
+
+                    // A dump late in a long session shows its end, not its start
+                    if (collectedEvents.size() >= MaxCollectedEventAmount)
+                    {
+                        collectedEvents.pop_front();
+                        ++overflowedEventAmount;
+                    }
+                    collectedEvents.emplace_back(CollectedEvent{ threadIdx, e });
+                }
+            );
+        }
+    }
+}
\ No newline at end of file
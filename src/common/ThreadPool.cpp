@@ -0,0 +1,59 @@
+#include "common/ThreadPool.h"
+
+#include <algorithm>
+
+namespace RyuRenderer::Common
+{
+    ThreadPool::ThreadPool()
+    {
+        const unsigned int hardwareThreadAmount = std::thread::hardware_concurrency();
+        const std::size_t threadAmount = hardwareThreadAmount > 1 ? hardwareThreadAmount - 1 : 1;
+        threads.reserve(threadAmount);
+        for (std::size_t i = 0; i < threadAmount; ++i)
+            threads.emplace_back(&ThreadPool::Run, this);
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            isStopping = true;
+        }
+        jobAdded.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    std::size_t ThreadPool::GetThreadAmount() const
+    {
+        return threads.size();
+    }
+
+    void ThreadPool::Enqueue(std::function<void()> job)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            jobs.emplace_back(std::move(job));
+        }
+        jobAdded.notify_one();
+    }
+
+    void ThreadPool::Run()
+    {
+        while (true)
+        {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                jobAdded.wait(lock, [this]() { return isStopping || !jobs.empty(); });
+                // Queued jobs are finished before the pool goes away
+                if (jobs.empty())
+                    return;
+
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            job();
+        }
+    }
+}
\ No newline at end of file
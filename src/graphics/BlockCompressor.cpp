@@ -0,0 +1,532 @@
+#include "graphics/BlockCompressor.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+#include "graphics/CompressedTextureFile.h"
+
+namespace RyuRenderer::Graphics::BlockCompressor
+{
+    namespace
+    {
+        // 4x4 texels in row order
+        using Block = std::array<std::array<uint8_t, 4>, 16>;
+
+        struct BitWriter
+        {
+            uint8_t* Data = nullptr;
+            size_t BitIdx = 0;
+
+            void Write(uint32_t value, size_t bitAmount)
+            {
+                for (size_t i = 0; i < bitAmount; ++i, ++BitIdx)
+                {
+                    if (value >> i & 1)
+                        Data[BitIdx / 8] |= static_cast<uint8_t>(1 << (BitIdx % 8));
+                }
+            }
+        };
+
+        Block FetchBlock(std::span<const uint8_t> rgba, int width, int height, int blockX, int blockY)
+        {
+            Block block;
+            for (int y = 0; y < 4; ++y)
+            {
+                const int sy = std::min(blockY * 4 + y, height - 1);
+                for (int x = 0; x < 4; ++x)
+                {
+                    const int sx = std::min(blockX * 4 + x, width - 1);
+                    std::memcpy(block[y * 4 + x].data(), rgba.data() + (static_cast<size_t>(sy) * width + sx) * 4, 4);
+                }
+            }
+            return block;
+        }
+
+        // Unit direction of the largest spread of the first N channels, zero when all texels are equal
+        template<size_t N>
+        std::array<float, N> PrincipalAxis(const Block& block, std::array<float, N>& mean)
+        {
+            mean = {};
+            for (const auto& t : block)
+            {
+                for (size_t c = 0; c < N; ++c)
+                    mean[c] += t[c] / 16.f;
+            }
+
+            std::array<std::array<float, N>, N> covariance = {};
+            for (const auto& t : block)
+            {
+                for (size_t i = 0; i < N; ++i)
+                {
+                    for (size_t j = 0; j < N; ++j)
+                        covariance[i][j] += (t[i] - mean[i]) * (t[j] - mean[j]);
+                }
+            }
+
+            // Power iteration from the diagonal, enough steps for 8 bit colors
+            std::array<float, N> axis;
+            for (size_t c = 0; c < N; ++c)
+                axis[c] = covariance[c][c] + 1e-3f * (c + 1);
+            for (int step = 0; step < 8; ++step)
+            {
+                std::array<float, N> next = {};
+                for (size_t i = 0; i < N; ++i)
+                {
+                    for (size_t j = 0; j < N; ++j)
+                        next[i] += covariance[i][j] * axis[j];
+                }
+                float length = 0.f;
+                for (float v : next)
+                    length += v * v;
+                length = std::sqrt(length);
+                if (length < 1e-6f)
+                    return {};
+                for (size_t c = 0; c < N; ++c)
+                    axis[c] = next[c] / length;
+            }
+            return axis;
+        }
+
+        // Endpoints at the extremes of the texels projected onto the principal axis
+        template<size_t N>
+        void FitEndpoints(const Block& block, std::array<float, N>& e0, std::array<float, N>& e1)
+        {
+            std::array<float, N> mean;
+            const auto axis = PrincipalAxis<N>(block, mean);
+            float minT = 0.f;
+            float maxT = 0.f;
+            for (const auto& t : block)
+            {
+                float d = 0.f;
+                for (size_t c = 0; c < N; ++c)
+                    d += (t[c] - mean[c]) * axis[c];
+                minT = std::min(minT, d);
+                maxT = std::max(maxT, d);
+            }
+            for (size_t c = 0; c < N; ++c)
+            {
+                e0[c] = std::clamp(mean[c] + axis[c] * minT, 0.f, 255.f);
+                e1[c] = std::clamp(mean[c] + axis[c] * maxT, 0.f, 255.f);
+            }
+        }
+
+        // Endpoints minimizing the squared error for fixed indices, weight[i] is the share of e1 in texel i. False when singular
+        template<size_t N>
+        bool SolveEndpoints(const Block& block, const std::array<float, 16>& weights, std::array<float, N>& e0, std::array<float, N>& e1)
+        {
+            float aa = 0.f;
+            float bb = 0.f;
+            float ab = 0.f;
+            std::array<float, N> ax = {};
+            std::array<float, N> bx = {};
+            for (size_t i = 0; i < 16; ++i)
+            {
+                const float b = weights[i];
+                const float a = 1.f - b;
+                aa += a * a;
+                bb += b * b;
+                ab += a * b;
+                for (size_t c = 0; c < N; ++c)
+                {
+                    ax[c] += a * block[i][c];
+                    bx[c] += b * block[i][c];
+                }
+            }
+            const float det = aa * bb - ab * ab;
+            if (std::abs(det) < 1e-4f)
+                return false;
+            for (size_t c = 0; c < N; ++c)
+            {
+                e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.f, 255.f);
+                e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.f, 255.f);
+            }
+            return true;
+        }
+
+        uint16_t To565(const std::array<float, 3>& c)
+        {
+            const auto r = static_cast<uint16_t>(std::lround(c[0] * 31.f / 255.f));
+            const auto g = static_cast<uint16_t>(std::lround(c[1] * 63.f / 255.f));
+            const auto b = static_cast<uint16_t>(std::lround(c[2] * 31.f / 255.f));
+            return static_cast<uint16_t>(r << 11 | g << 5 | b);
+        }
+
+        std::array<int, 3> From565(uint16_t c)
+        {
+            const int r = c >> 11 & 31;
+            const int g = c >> 5 & 63;
+            const int b = c & 31;
+            return { r << 3 | r >> 2, g << 2 | g >> 4, b << 3 | b >> 2 };
+        }
+
+        // Four color mode, c0 > c1. Returns the squared error and writes the 2 bit index of every texel
+        int EvaluateColorBlock(const Block& block, uint16_t c0, uint16_t c1, std::array<uint8_t, 16>& indices)
+        {
+            const auto p0 = From565(c0);
+            const auto p1 = From565(c1);
+            std::array<std::array<int, 3>, 4> palette = { p0, p1 };
+            for (int c = 0; c < 3; ++c)
+            {
+                palette[2][c] = (2 * p0[c] + p1[c]) / 3;
+                palette[3][c] = (p0[c] + 2 * p1[c]) / 3;
+            }
+
+            int error = 0;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                int bestError = std::numeric_limits<int>::max();
+                for (uint8_t p = 0; p < (c0 == c1 ? 1 : 4); ++p)
+                {
+                    int e = 0;
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        const int d = block[i][c] - palette[p][c];
+                        e += d * d;
+                    }
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        indices[i] = p;
+                    }
+                }
+                error += bestError;
+            }
+            return error;
+        }
+
+        void EncodeColorBlock(const Block& block, uint8_t* out)
+        {
+            // Share of c1 in each palette entry
+            constexpr std::array<float, 4> indexWeights = { 0.f, 1.f, 1.f / 3.f, 2.f / 3.f };
+
+            std::array<float, 3> e0;
+            std::array<float, 3> e1;
+            FitEndpoints<3>(block, e0, e1);
+
+            uint16_t bestC0 = 0;
+            uint16_t bestC1 = 0;
+            std::array<uint8_t, 16> bestIndices = {};
+            int bestError = std::numeric_limits<int>::max();
+            for (int iteration = 0; iteration < 3; ++iteration)
+            {
+                uint16_t c0 = To565(e0);
+                uint16_t c1 = To565(e1);
+                if (c0 < c1)
+                    std::swap(c0, c1);
+                std::array<uint8_t, 16> indices = {};
+                const int error = EvaluateColorBlock(block, c0, c1, indices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    bestC0 = c0;
+                    bestC1 = c1;
+                    bestIndices = indices;
+                }
+                if (error == 0 || c0 == c1)
+                    break;
+
+                std::array<float, 16> weights;
+                for (size_t i = 0; i < 16; ++i)
+                    weights[i] = indexWeights[indices[i]];
+                if (!SolveEndpoints<3>(block, weights, e0, e1))
+                    break;
+            }
+
+            uint32_t indexBits = 0;
+            for (size_t i = 0; i < 16; ++i)
+                indexBits |= static_cast<uint32_t>(bestIndices[i]) << (2 * i);
+            std::memcpy(out, &bestC0, 2);
+            std::memcpy(out + 2, &bestC1, 2);
+            std::memcpy(out + 4, &indexBits, 4);
+        }
+
+        // BC4 block of one channel in eight value mode, also the alpha half of BC3 and both halves of BC5
+        void EncodeChannelBlock(const Block& block, size_t channel, uint8_t* out)
+        {
+            uint8_t minValue = 255;
+            uint8_t maxValue = 0;
+            for (const auto& t : block)
+            {
+                minValue = std::min(minValue, t[channel]);
+                maxValue = std::max(maxValue, t[channel]);
+            }
+
+            std::array<int, 8> palette = { maxValue, minValue };
+            for (int i = 2; i < 8; ++i)
+                palette[i] = ((8 - i) * maxValue + (i - 1) * minValue) / 7;
+
+            uint64_t bits = static_cast<uint64_t>(maxValue) | static_cast<uint64_t>(minValue) << 8;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                uint64_t bestIdx = 0;
+                int bestError = std::numeric_limits<int>::max();
+                for (uint64_t p = 0; p < (minValue == maxValue ? 1 : 8); ++p)
+                {
+                    const int e = std::abs(block[i][channel] - palette[p]);
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        bestIdx = p;
+                    }
+                }
+                bits |= bestIdx << (16 + 3 * i);
+            }
+            std::memcpy(out, &bits, 8);
+        }
+
+        // Mode 6 endpoint, 7 bits per channel plus a p-bit shared by the channels
+        struct Bc7Endpoint
+        {
+            std::array<uint8_t, 4> Bits = {};
+            uint8_t PBit = 0;
+
+            int Get(size_t c) const
+            {
+                return Bits[c] << 1 | PBit;
+            }
+        };
+
+        Bc7Endpoint QuantizeBc7Endpoint(const std::array<float, 4>& e)
+        {
+            Bc7Endpoint best;
+            float bestError = std::numeric_limits<float>::max();
+            for (uint8_t p = 0; p < 2; ++p)
+            {
+                Bc7Endpoint q;
+                q.PBit = p;
+                float error = 0.f;
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    q.Bits[c] = static_cast<uint8_t>(std::clamp<long>(std::lround((e[c] - p) / 2.f), 0, 127));
+                    const float d = q.Get(c) - e[c];
+                    error += d * d;
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best = q;
+                }
+            }
+            return best;
+        }
+
+        constexpr std::array<int, 16> bc7Weights = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        int EvaluateBc7Block(const Block& block, const Bc7Endpoint& q0, const Bc7Endpoint& q1, std::array<uint8_t, 16>& indices)
+        {
+            std::array<std::array<int, 4>, 16> palette;
+            for (size_t w = 0; w < 16; ++w)
+            {
+                for (size_t c = 0; c < 4; ++c)
+                    palette[w][c] = ((64 - bc7Weights[w]) * q0.Get(c) + bc7Weights[w] * q1.Get(c) + 32) >> 6;
+            }
+
+            int error = 0;
+            for (size_t i = 0; i < 16; ++i)
+            {
+                int bestError = std::numeric_limits<int>::max();
+                for (uint8_t w = 0; w < 16; ++w)
+                {
+                    int e = 0;
+                    for (size_t c = 0; c < 4; ++c)
+                    {
+                        const int d = block[i][c] - palette[w][c];
+                        e += d * d;
+                    }
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        indices[i] = w;
+                    }
+                }
+                error += bestError;
+            }
+            return error;
+        }
+
+        void EncodeBc7Block(const Block& block, uint8_t* out)
+        {
+            std::array<float, 4> e0;
+            std::array<float, 4> e1;
+            FitEndpoints<4>(block, e0, e1);
+
+            Bc7Endpoint best0;
+            Bc7Endpoint best1;
+            std::array<uint8_t, 16> bestIndices = {};
+            int bestError = std::numeric_limits<int>::max();
+            for (int iteration = 0; iteration < 3; ++iteration)
+            {
+                const Bc7Endpoint q0 = QuantizeBc7Endpoint(e0);
+                const Bc7Endpoint q1 = QuantizeBc7Endpoint(e1);
+                std::array<uint8_t, 16> indices = {};
+                const int error = EvaluateBc7Block(block, q0, q1, indices);
+                if (error < bestError)
+                {
+                    bestError = error;
+                    best0 = q0;
+                    best1 = q1;
+                    bestIndices = indices;
+                }
+                if (error == 0)
+                    break;
+
+                std::array<float, 16> weights;
+                for (size_t i = 0; i < 16; ++i)
+                    weights[i] = bc7Weights[indices[i]] / 64.f;
+                if (!SolveEndpoints<4>(block, weights, e0, e1))
+                    break;
+            }
+
+            // The top bit of the first index is implied 0, swapping the endpoints mirrors the indices to get there
+            if (bestIndices[0] >= 8)
+            {
+                std::swap(best0, best1);
+                for (auto& idx : bestIndices)
+                    idx = static_cast<uint8_t>(15 - idx);
+            }
+
+            std::memset(out, 0, 16);
+            BitWriter writer{ out };
+            writer.Write(1 << 6, 7);
+            for (size_t c = 0; c < 4; ++c)
+            {
+                writer.Write(best0.Bits[c], 7);
+                writer.Write(best1.Bits[c], 7);
+            }
+            writer.Write(best0.PBit, 1);
+            writer.Write(best1.PBit, 1);
+            writer.Write(bestIndices[0], 3);
+            for (size_t i = 1; i < 16; ++i)
+                writer.Write(bestIndices[i], 4);
+        }
+
+        void EncodeBlock(const Block& block, Format f, uint8_t* out)
+        {
+            switch (f)
+            {
+            case FORMAT_BC1:
+                EncodeColorBlock(block, out);
+                break;
+            case FORMAT_BC3:
+                EncodeChannelBlock(block, 3, out);
+                EncodeColorBlock(block, out + 8);
+                break;
+            case FORMAT_BC4:
+                EncodeChannelBlock(block, 0, out);
+                break;
+            case FORMAT_BC5:
+                EncodeChannelBlock(block, 0, out);
+                EncodeChannelBlock(block, 1, out + 8);
+                break;
+            case FORMAT_BC7:
+                EncodeBc7Block(block, out);
+                break;
+            }
+        }
+    }
+
+    GLenum GetGLFormat(Format f)
+    {
+        switch (f)
+        {
+        case FORMAT_BC1:
+            return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case FORMAT_BC3:
+            return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+        case FORMAT_BC4:
+            return GL_COMPRESSED_RED_RGTC1;
+        case FORMAT_BC5:
+            return GL_COMPRESSED_RG_RGTC2;
+        case FORMAT_BC7:
+            return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        }
+        return GL_NONE;
+    }
+
+    bool ParseFormat(std::string_view name, Format& f)
+    {
+        constexpr std::array<std::pair<std::string_view, Format>, 5> names = { {
+            { "bc1", FORMAT_BC1 }, { "bc3", FORMAT_BC3 }, { "bc4", FORMAT_BC4 }, { "bc5", FORMAT_BC5 }, { "bc7", FORMAT_BC7 }
+        } };
+        for (const auto& [n, format] : names)
+        {
+            if (n == name)
+            {
+                f = format;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::vector<std::byte> CompressLevel(std::span<const uint8_t> rgba, int width, int height, Format f, size_t threadAmount)
+    {
+        RYU_PROFILE_ZONE("BlockCompressor::CompressLevel");
+
+        if (width <= 0 || height <= 0 || rgba.size() < static_cast<size_t>(width) * height * 4)
+            return {};
+
+        const GLenum format = GetGLFormat(f);
+        const size_t blockBytes = CompressedTextureFile::GetBlockBytes(format);
+        const int blockColumnAmount = (width + 3) / 4;
+        const int blockRowAmount = (height + 3) / 4;
+        std::vector<std::byte> blocks(CompressedTextureFile::GetLevelBytes(format, width, height));
+        Common::ThreadPool::GetInstance().ParallelFor(static_cast<size_t>(blockRowAmount), [&](size_t blockY)
+        {
+            auto* row = reinterpret_cast<uint8_t*>(blocks.data()) + blockY * blockColumnAmount * blockBytes;
+            for (int blockX = 0; blockX < blockColumnAmount; ++blockX)
+                EncodeBlock(FetchBlock(rgba, width, height, blockX, static_cast<int>(blockY)), f, row + blockX * blockBytes);
+        }, threadAmount);
+        return blocks;
+    }
+
+    std::vector<uint8_t> Downsample(std::span<const uint8_t> rgba, int width, int height)
+    {
+        const int w = std::max(width / 2, 1);
+        const int h = std::max(height / 2, 1);
+        std::vector<uint8_t> result(static_cast<size_t>(w) * h * 4);
+        auto at = [&rgba, width, height](int x, int y, int c)
+        {
+            return static_cast<int>(rgba[(static_cast<size_t>(std::min(y, height - 1)) * width + std::min(x, width - 1)) * 4 + c]);
+        };
+        for (int y = 0; y < h; ++y)
+        {
+            for (int x = 0; x < w; ++x)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    const int sum = at(2 * x, 2 * y, c) + at(2 * x + 1, 2 * y, c) + at(2 * x, 2 * y + 1, c) + at(2 * x + 1, 2 * y + 1, c);
+                    result[(static_cast<size_t>(y) * w + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+        return result;
+    }
+
+    std::vector<std::vector<std::byte>> CompressMipChain(std::span<const uint8_t> rgba, int width, int height, Format f, size_t threadAmount)
+    {
+        RYU_PROFILE_ZONE("BlockCompressor::CompressMipChain");
+
+        std::vector<std::vector<std::byte>> levels;
+        if (width <= 0 || height <= 0)
+            return levels;
+
+        levels.emplace_back(CompressLevel(rgba, width, height, f, threadAmount));
+        std::vector<uint8_t> level;
+        std::span<const uint8_t> source = rgba;
+        while (width > 1 || height > 1)
+        {
+            level = Downsample(source, width, height);
+            source = level;
+            width = std::max(width / 2, 1);
+            height = std::max(height / 2, 1);
+            levels.emplace_back(CompressLevel(source, width, height, f, threadAmount));
+        }
+        return levels;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#include "graphics/Bounds.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace RyuRenderer::Graphics
+{
+    bool Bounds::IsValid() const
+    {
+        return Min.x <= Max.x && Min.y <= Max.y && Min.z <= Max.z;
+    }
+
+    Bounds Bounds::FromPositions(const std::byte* data, std::size_t vertexAmount, std::size_t strideBytes)
+    {
+        Bounds b;
+        if (!data || vertexAmount == 0)
+            return b;
+
+        auto readPosition = [data, strideBytes](std::size_t i)
+        {
+            glm::vec3 p;
+            std::memcpy(&p, data + i * strideBytes, sizeof(p));
+            return p;
+        };
+
+        for (std::size_t i = 0; i < vertexAmount; ++i)
+        {
+            const glm::vec3 p = readPosition(i);
+            b.Min = glm::min(b.Min, p);
+            b.Max = glm::max(b.Max, p);
+        }
+
+        // Tighter than half the box diagonal for round shapes
+        b.Center = (b.Min + b.Max) * 0.5f;
+        float radiusSquared = 0.f;
+        for (std::size_t i = 0; i < vertexAmount; ++i)
+        {
+            const glm::vec3 d = readPosition(i) - b.Center;
+            radiusSquared = std::max(radiusSquared, glm::dot(d, d));
+        }
+        b.Radius = std::sqrt(radiusSquared);
+        return b;
+    }
+
+    Bounds Bounds::FromPositions(std::span<const std::array<float, 3>> positions)
+    {
+        return FromPositions(reinterpret_cast<const std::byte*>(positions.data()), positions.size(), sizeof(positions[0]));
+    }
+
+    void Bounds::Merge(const Bounds& other)
+    {
+        if (!other.IsValid())
+            return;
+        if (!IsValid())
+        {
+            *this = other;
+            return;
+        }
+
+        Min = glm::min(Min, other.Min);
+        Max = glm::max(Max, other.Max);
+
+        // Smallest sphere around both spheres, then moved onto the merged box center
+        const glm::vec3 newCenter = (Min + Max) * 0.5f;
+        Radius = std::max(glm::length(Center - newCenter) + Radius, glm::length(other.Center - newCenter) + other.Radius);
+        Center = newCenter;
+    }
+
+    Bounds Bounds::Transform(const glm::mat4& m) const
+    {
+        if (!IsValid())
+            return *this;
+
+        // Arvo 1990, each output axis takes the smaller and larger product of every matrix entry
+        Bounds b;
+        b.Min = glm::vec3(m[3]);
+        b.Max = glm::vec3(m[3]);
+        for (int c = 0; c < 3; ++c)
+        {
+            for (int r = 0; r < 3; ++r)
+            {
+                const float e = m[c][r] * Min[c];
+                const float f = m[c][r] * Max[c];
+                b.Min[r] += std::min(e, f);
+                b.Max[r] += std::max(e, f);
+            }
+        }
+
+        const float scale = std::max({ glm::length(glm::vec3(m[0])), glm::length(glm::vec3(m[1])), glm::length(glm::vec3(m[2])) });
+        b.Center = glm::vec3(m * glm::vec4(Center, 1.f));
+        b.Radius = Radius * scale;
+        return b;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,529 @@
+#include "graphics/CompressedTextureFile.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "common/Profiler.h"
+
+namespace RyuRenderer::Graphics
+{
+    namespace
+    {
+        struct FormatInfo
+        {
+            GLenum Format = GL_NONE;
+            uint32_t VkFormat = 0;
+            // 0 when DDS files never map to it
+            uint32_t DxgiFormat = 0;
+            // Khronos data format color model, BC1 is 128 up to BC7 at 134
+            uint8_t ColorModel = 0;
+            bool IsSrgb = false;
+        };
+
+        constexpr std::array<FormatInfo, 10> formatInfos = { {
+            { GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 131, 0, 128, false },
+            { GL_COMPRESSED_SRGB_S3TC_DXT1_EXT, 132, 0, 128, true },
+            { GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 133, 71, 128, false },
+            { GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT, 134, 72, 128, true },
+            { GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 137, 77, 130, false },
+            { GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT, 138, 78, 130, true },
+            { GL_COMPRESSED_RED_RGTC1, 139, 80, 131, false },
+            { GL_COMPRESSED_RG_RGTC2, 141, 83, 132, false },
+            { GL_COMPRESSED_RGBA_BPTC_UNORM, 145, 98, 134, false },
+            { GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM, 146, 99, 134, true }
+        } };
+
+        template<typename Pred>
+        const FormatInfo* FindFormatInfo(Pred pred)
+        {
+            auto it = std::find_if(formatInfos.begin(), formatInfos.end(), pred);
+            return it != formatInfos.end() ? &*it : nullptr;
+        }
+
+        constexpr std::array<uint8_t, 12> ktx2Identifier = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+        // Identifier, header and index, the level index follows
+        constexpr uint64_t ktx2LevelIndexOffset = 80;
+        constexpr uint64_t ktx2LevelIndexEntryBytes = 24;
+
+        constexpr uint32_t ddsMagic = 0x20534444; // "DDS "
+        constexpr uint64_t ddsHeaderBytes = 128;
+        constexpr uint64_t ddsDx10HeaderBytes = 20;
+
+        constexpr uint32_t MakeFourCc(char a, char b, char c, char d)
+        {
+            return static_cast<uint32_t>(a) | static_cast<uint32_t>(b) << 8 | static_cast<uint32_t>(c) << 16 | static_cast<uint32_t>(d) << 24;
+        }
+
+        // Files are little endian like every platform this builds for, memcpy because nothing is aligned
+        template<typename T>
+        T ReadAt(std::span<const std::byte> bytes, uint64_t offset)
+        {
+            T value{};
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+            return value;
+        }
+
+        template<typename T>
+        void WriteAt(std::vector<std::byte>& bytes, uint64_t offset, T value)
+        {
+            std::memcpy(bytes.data() + offset, &value, sizeof(T));
+        }
+
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        // Levels of a full chain down to 1x1, floor(log2(max(width, height))) + 1
+        uint32_t GetFullLevelAmount(uint32_t width, uint32_t height)
+        {
+            return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+        }
+
+        // Index rows are one byte each
+        void FlipBc1Block(std::byte* block, int rowAmount)
+        {
+            std::reverse(block + 4, block + 4 + rowAmount);
+        }
+
+        // Index rows are 12 bits each, after the two endpoints
+        void FlipBc4Block(std::byte* block, int rowAmount)
+        {
+            uint64_t bits = 0;
+            std::memcpy(&bits, block + 2, 6);
+            uint64_t flippedBits = bits;
+            for (int y = 0; y < rowAmount; ++y)
+            {
+                const int flippedY = rowAmount - 1 - y;
+                flippedBits &= ~(0xFFFull << (12 * flippedY));
+                flippedBits |= ((bits >> (12 * y)) & 0xFFF) << (12 * flippedY);
+            }
+            std::memcpy(block + 2, &flippedBits, 6);
+        }
+    }
+
+    bool CompressedTextureFile::IsCompressedTexturePath(const std::string& filePath)
+    {
+        const auto extension = std::filesystem::path(filePath).extension();
+        return extension == Ktx2Extension || extension == DdsExtension;
+    }
+
+    size_t CompressedTextureFile::GetBlockBytes(GLenum format)
+    {
+        switch (format)
+        {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RED_RGTC1:
+            return 8;
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+        case GL_COMPRESSED_RG_RGTC2:
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+            return 16;
+        default:
+            return 0;
+        }
+    }
+
+    size_t CompressedTextureFile::GetLevelBytes(GLenum format, int width, int height)
+    {
+        const size_t blockColumnAmount = (static_cast<size_t>(std::max(width, 1)) + 3) / 4;
+        const size_t blockRowAmount = (static_cast<size_t>(std::max(height, 1)) + 3) / 4;
+        return blockColumnAmount * blockRowAmount * GetBlockBytes(format);
+    }
+
+    bool CompressedTextureFile::WriteKtx2(
+        const std::string& filePath, GLenum format, int width, int height, const std::vector<std::vector<std::byte>>& levels)
+    {
+        RYU_PROFILE_ZONE("CompressedTextureFile::WriteKtx2");
+
+        const FormatInfo* info = FindFormatInfo([format](const FormatInfo& i) { return i.Format == format; });
+        if (!info || width <= 0 || height <= 0 || levels.empty())
+        {
+            std::cerr << "Can not write " << filePath << ", the texture format or size is not supported." << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            if (levels[i].size() != GetLevelBytes(format, width >> i, height >> i))
+            {
+                std::cerr << "Can not write " << filePath << ", level " << i << " has the wrong size." << std::endl;
+                return false;
+            }
+        }
+
+        // Data format descriptor, one basic block with a sample per 64 bit half the block decodes on its own
+        struct Sample
+        {
+            uint16_t BitOffset = 0;
+            uint8_t ChannelType = 0;
+        };
+        std::vector<Sample> samples;
+        switch (info->ColorModel)
+        {
+        case 128:
+            samples = { { 0, static_cast<uint8_t>(format == GL_COMPRESSED_RGB_S3TC_DXT1_EXT || format == GL_COMPRESSED_SRGB_S3TC_DXT1_EXT ? 0 : 1) } };
+            break;
+        case 130:
+            // Alpha is stored linear in sRGB files too
+            samples = { { 0, static_cast<uint8_t>(15 | (info->IsSrgb ? 0x10 : 0)) }, { 64, 0 } };
+            break;
+        case 132:
+            samples = { { 0, 0 }, { 64, 1 } };
+            break;
+        default:
+            samples = { { 0, 0 } };
+            break;
+        }
+        const size_t blockBytes = GetBlockBytes(format);
+        const uint32_t dfdBytes = static_cast<uint32_t>(4 + 24 + 16 * samples.size());
+        // One entry, key and value both end with 0
+        const uint32_t kvdEntryBytes = static_cast<uint32_t>(Ktx2OrientationKey.size() + 1 + Ktx2Orientation.size() + 1);
+        const uint32_t kvdBytes = static_cast<uint32_t>(AlignUp(4 + kvdEntryBytes, 4));
+
+        const uint64_t dfdOffset = ktx2LevelIndexOffset + ktx2LevelIndexEntryBytes * levels.size();
+        const uint64_t kvdOffset = dfdOffset + dfdBytes;
+        // Smallest level first as the format asks, each on a whole block
+        std::vector<uint64_t> levelOffsets(levels.size());
+        uint64_t fileBytes = kvdOffset + kvdBytes;
+        for (size_t i = levels.size(); i-- > 0;)
+        {
+            levelOffsets[i] = AlignUp(fileBytes, blockBytes);
+            fileBytes = levelOffsets[i] + levels[i].size();
+        }
+
+        std::vector<std::byte> bytes(fileBytes);
+        std::memcpy(bytes.data(), ktx2Identifier.data(), ktx2Identifier.size());
+        WriteAt<uint32_t>(bytes, 12, info->VkFormat);
+        WriteAt<uint32_t>(bytes, 16, 1); // typeSize
+        WriteAt<uint32_t>(bytes, 20, static_cast<uint32_t>(width));
+        WriteAt<uint32_t>(bytes, 24, static_cast<uint32_t>(height));
+        WriteAt<uint32_t>(bytes, 28, 0); // pixelDepth
+        WriteAt<uint32_t>(bytes, 32, 0); // layerCount
+        WriteAt<uint32_t>(bytes, 36, 1); // faceCount
+        WriteAt<uint32_t>(bytes, 40, static_cast<uint32_t>(levels.size()));
+        WriteAt<uint32_t>(bytes, 44, 0); // supercompressionScheme
+        WriteAt<uint32_t>(bytes, 48, static_cast<uint32_t>(dfdOffset));
+        WriteAt<uint32_t>(bytes, 52, dfdBytes);
+        WriteAt<uint32_t>(bytes, 56, static_cast<uint32_t>(kvdOffset));
+        WriteAt<uint32_t>(bytes, 60, kvdBytes);
+        for (size_t i = 0; i < levels.size(); ++i)
+        {
+            const uint64_t entry = ktx2LevelIndexOffset + ktx2LevelIndexEntryBytes * i;
+            WriteAt<uint64_t>(bytes, entry, levelOffsets[i]);
+            WriteAt<uint64_t>(bytes, entry + 8, levels[i].size());
+            WriteAt<uint64_t>(bytes, entry + 16, levels[i].size());
+            std::memcpy(bytes.data() + levelOffsets[i], levels[i].data(), levels[i].size());
+        }
+
+        WriteAt<uint32_t>(bytes, dfdOffset, dfdBytes);
+        const uint64_t block = dfdOffset + 4;
+        WriteAt<uint32_t>(bytes, block, 0); // Khronos vendor, basic descriptor type
+        WriteAt<uint16_t>(bytes, block + 4, 2); // version
+        WriteAt<uint16_t>(bytes, block + 6, static_cast<uint16_t>(dfdBytes - 4));
+        WriteAt<uint8_t>(bytes, block + 8, info->ColorModel);
+        WriteAt<uint8_t>(bytes, block + 9, 1); // BT.709 primaries
+        WriteAt<uint8_t>(bytes, block + 10, info->IsSrgb ? 2 : 1);
+        WriteAt<uint8_t>(bytes, block + 11, 0); // straight alpha
+        WriteAt<uint8_t>(bytes, block + 12, 3); // 4x4 texel blocks
+        WriteAt<uint8_t>(bytes, block + 13, 3);
+        WriteAt<uint8_t>(bytes, block + 16, static_cast<uint8_t>(blockBytes));
+        for (size_t i = 0; i < samples.size(); ++i)
+        {
+            const uint64_t sample = block + 24 + 16 * i;
+            WriteAt<uint16_t>(bytes, sample, samples[i].BitOffset);
+            WriteAt<uint8_t>(bytes, sample + 2, static_cast<uint8_t>(samples.size() == 1 ? blockBytes * 8 - 1 : 63));
+            WriteAt<uint8_t>(bytes, sample + 3, samples[i].ChannelType);
+            WriteAt<uint32_t>(bytes, sample + 8, 0);
+            WriteAt<uint32_t>(bytes, sample + 12, 0xFFFFFFFF);
+        }
+
+        WriteAt<uint32_t>(bytes, kvdOffset, kvdEntryBytes);
+        std::memcpy(bytes.data() + kvdOffset + 4, Ktx2OrientationKey.data(), Ktx2OrientationKey.size());
+        std::memcpy(bytes.data() + kvdOffset + 4 + Ktx2OrientationKey.size() + 1, Ktx2Orientation.data(), Ktx2Orientation.size());
+
+        std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            std::cerr << "Failed to open " << filePath << " for writing." << std::endl;
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << filePath << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool CompressedTextureFile::Open(const std::string& filePath)
+    {
+        RYU_PROFILE_ZONE("CompressedTextureFile::Open");
+
+        Close();
+        if (!file.Open(filePath))
+        {
+            std::cerr << "Can not load texture file: " << filePath << "." << std::endl;
+            return false;
+        }
+
+        const auto bytes = file.GetBytes();
+        bool isRead = false;
+        if (bytes.size() >= ktx2LevelIndexOffset && std::memcmp(bytes.data(), ktx2Identifier.data(), ktx2Identifier.size()) == 0)
+            isRead = ReadKtx2();
+        else if (bytes.size() >= ddsHeaderBytes && ReadAt<uint32_t>(bytes, 0) == ddsMagic)
+            isRead = ReadDds();
+        if (!isRead)
+        {
+            std::cerr << "Texture file " << filePath << " is no 2D KTX2 or DDS texture of a supported block compressed format." << std::endl;
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void CompressedTextureFile::Close()
+    {
+        file.Close();
+        format = GL_NONE;
+        levels.clear();
+        isTopDown = false;
+        flippedBytes.clear();
+    }
+
+    bool CompressedTextureFile::IsOpen() const
+    {
+        return format != GL_NONE;
+    }
+
+    GLenum CompressedTextureFile::GetFormat() const
+    {
+        return format;
+    }
+
+    const std::vector<CompressedTextureFile::Level>& CompressedTextureFile::GetLevels() const
+    {
+        return levels;
+    }
+
+    bool CompressedTextureFile::IsTopDown() const
+    {
+        return isTopDown;
+    }
+
+    bool CompressedTextureFile::ReadKtx2()
+    {
+        const auto bytes = file.GetBytes();
+        const uint32_t vkFormat = ReadAt<uint32_t>(bytes, 12);
+        const uint32_t width = ReadAt<uint32_t>(bytes, 20);
+        const uint32_t height = ReadAt<uint32_t>(bytes, 24);
+        const uint32_t depth = ReadAt<uint32_t>(bytes, 28);
+        const uint32_t layerAmount = ReadAt<uint32_t>(bytes, 32);
+        const uint32_t faceAmount = ReadAt<uint32_t>(bytes, 36);
+        // 0 asks the loader to generate the levels, which block compressed formats can not do on the GPU
+        const uint32_t levelAmount = std::max(ReadAt<uint32_t>(bytes, 40), 1u);
+        const uint32_t supercompressionScheme = ReadAt<uint32_t>(bytes, 44);
+        const uint32_t kvdOffset = ReadAt<uint32_t>(bytes, 56);
+        const uint32_t kvdBytes = ReadAt<uint32_t>(bytes, 60);
+
+        const FormatInfo* info = FindFormatInfo([vkFormat](const FormatInfo& i) { return i.VkFormat == vkFormat; });
+        if (!info || width == 0 || height == 0 || width > 1u << 16 || height > 1u << 16 ||
+            depth != 0 || layerAmount > 1 || faceAmount != 1 || supercompressionScheme != 0 ||
+            levelAmount > GetFullLevelAmount(width, height) ||
+            bytes.size() < ktx2LevelIndexOffset + ktx2LevelIndexEntryBytes * levelAmount) {
+            return false;
+        }
+
+        format = info->Format;
+        for (uint32_t i = 0; i < levelAmount; ++i)
+        {
+            const uint64_t entry = ktx2LevelIndexOffset + ktx2LevelIndexEntryBytes * i;
+            const int levelWidth = std::max(static_cast<int>(width >> i), 1);
+            const int levelHeight = std::max(static_cast<int>(height >> i), 1);
+            if (ReadAt<uint64_t>(bytes, entry + 8) != GetLevelBytes(format, levelWidth, levelHeight) ||
+                !AddLevel(ReadAt<uint64_t>(bytes, entry), levelWidth, levelHeight)) {
+                return false;
+            }
+        }
+
+        // Without the key the file is top down, the KTX2 default
+        std::string_view orientation;
+        if (kvdOffset <= bytes.size() && kvdBytes <= bytes.size() - kvdOffset)
+        {
+            const auto kvd = bytes.subspan(kvdOffset, kvdBytes);
+            for (uint64_t entry = 0; entry + 4 <= kvd.size();)
+            {
+                const uint32_t entryBytes = ReadAt<uint32_t>(kvd, entry);
+                if (entryBytes > kvd.size() - entry - 4)
+                    break;
+
+                const std::string_view keyAndValue(reinterpret_cast<const char*>(kvd.data() + entry + 4), entryBytes);
+                const size_t keyEnd = keyAndValue.find('\0');
+                if (keyEnd != std::string_view::npos && keyAndValue.substr(0, keyEnd) == Ktx2OrientationKey)
+                {
+                    orientation = keyAndValue.substr(keyEnd + 1);
+                    orientation = orientation.substr(0, orientation.find('\0'));
+                    break;
+                }
+                entry += AlignUp(4 + entryBytes, 4);
+            }
+        }
+        if (orientation.size() < 2 || orientation[1] != 'u')
+            FlipLevels();
+        return true;
+    }
+
+    bool CompressedTextureFile::ReadDds()
+    {
+        const auto bytes = file.GetBytes();
+        const uint32_t headerBytes = ReadAt<uint32_t>(bytes, 4);
+        const uint32_t height = ReadAt<uint32_t>(bytes, 12);
+        const uint32_t width = ReadAt<uint32_t>(bytes, 16);
+        const uint32_t flags = ReadAt<uint32_t>(bytes, 8);
+        const uint32_t pixelFormatFlags = ReadAt<uint32_t>(bytes, 80);
+        const uint32_t fourCc = ReadAt<uint32_t>(bytes, 84);
+        const uint32_t caps2 = ReadAt<uint32_t>(bytes, 112);
+
+        // The mip count is only meaningful with its flag, writers leave garbage in it otherwise
+        constexpr uint32_t mipMapCountFlag = 0x20000;
+        const uint32_t levelAmount = (flags & mipMapCountFlag) ? std::max(ReadAt<uint32_t>(bytes, 28), 1u) : 1u;
+
+        constexpr uint32_t alphaPixelsFlag = 0x1;
+        constexpr uint32_t fourCcFlag = 0x4;
+        constexpr uint32_t cubeMapOrVolumeCaps = 0x200 | 0x200000;
+        if (headerBytes != 124 || !(pixelFormatFlags & fourCcFlag) || (caps2 & cubeMapOrVolumeCaps) ||
+            width == 0 || height == 0 || width > 1u << 16 || height > 1u << 16 || levelAmount > GetFullLevelAmount(width, height)) {
+            return false;
+        }
+
+        uint64_t dataOffset = ddsHeaderBytes;
+        switch (fourCc)
+        {
+        case MakeFourCc('D', 'X', 'T', '1'):
+            format = (pixelFormatFlags & alphaPixelsFlag) ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+            break;
+        case MakeFourCc('D', 'X', 'T', '5'):
+            format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+            break;
+        case MakeFourCc('A', 'T', 'I', '1'):
+        case MakeFourCc('B', 'C', '4', 'U'):
+            format = GL_COMPRESSED_RED_RGTC1;
+            break;
+        case MakeFourCc('A', 'T', 'I', '2'):
+        case MakeFourCc('B', 'C', '5', 'U'):
+            format = GL_COMPRESSED_RG_RGTC2;
+            break;
+        case MakeFourCc('D', 'X', '1', '0'):
+        {
+            if (bytes.size() < ddsHeaderBytes + ddsDx10HeaderBytes)
+                return false;
+            const uint32_t dxgiFormat = ReadAt<uint32_t>(bytes, ddsHeaderBytes);
+            const uint32_t resourceDimension = ReadAt<uint32_t>(bytes, ddsHeaderBytes + 4);
+            const uint32_t miscFlags = ReadAt<uint32_t>(bytes, ddsHeaderBytes + 8);
+            const uint32_t arraySize = ReadAt<uint32_t>(bytes, ddsHeaderBytes + 12);
+            constexpr uint32_t texture2dDimension = 3;
+            constexpr uint32_t cubeMapFlag = 0x4;
+            const FormatInfo* info = FindFormatInfo([dxgiFormat](const FormatInfo& i) { return i.DxgiFormat != 0 && i.DxgiFormat == dxgiFormat; });
+            if (!info || resourceDimension != texture2dDimension || (miscFlags & cubeMapFlag) || arraySize > 1)
+                return false;
+            format = info->Format;
+            dataOffset += ddsDx10HeaderBytes;
+            break;
+        }
+        default:
+            return false;
+        }
+
+        // Levels follow each other without padding
+        for (uint32_t i = 0; i < levelAmount; ++i)
+        {
+            const int levelWidth = std::max(static_cast<int>(width >> i), 1);
+            const int levelHeight = std::max(static_cast<int>(height >> i), 1);
+            if (!AddLevel(dataOffset, levelWidth, levelHeight))
+                return false;
+            dataOffset += levels.back().Bytes.size();
+        }
+        // Direct3D has no other order than top down
+        FlipLevels();
+        return true;
+    }
+
+    bool CompressedTextureFile::AddLevel(uint64_t offset, int width, int height)
+    {
+        const auto bytes = file.GetBytes();
+        const uint64_t levelBytes = GetLevelBytes(format, width, height);
+        if (offset > bytes.size() || levelBytes > bytes.size() - offset)
+            return false;
+
+        Level& level = levels.emplace_back();
+        level.Width = width;
+        level.Height = height;
+        level.Bytes = bytes.subspan(offset, levelBytes);
+        return true;
+    }
+
+    void CompressedTextureFile::FlipLevels()
+    {
+        RYU_PROFILE_ZONE("CompressedTextureFile::FlipLevels");
+
+        // A block row only moves as a whole when no texel row has to cross into the next one
+        const bool isFlippable = std::all_of(levels.begin(), levels.end(), [](const Level& l) { return l.Height % 4 == 0 || l.Height < 4; });
+        if (!isFlippable || format == GL_COMPRESSED_RGBA_BPTC_UNORM || format == GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM)
+        {
+            isTopDown = true;
+            return;
+        }
+
+        size_t totalBytes = 0;
+        for (const auto& l : levels)
+            totalBytes += l.Bytes.size();
+        flippedBytes.resize(totalBytes);
+
+        const size_t blockBytes = GetBlockBytes(format);
+        size_t offset = 0;
+        for (auto& l : levels)
+        {
+            const size_t rowBytes = (static_cast<size_t>(l.Width) + 3) / 4 * blockBytes;
+            const size_t rowAmount = l.Bytes.size() / rowBytes;
+            const int texelRowAmount = std::min(l.Height, 4);
+            std::byte* flipped = flippedBytes.data() + offset;
+            for (size_t r = 0; r < rowAmount; ++r)
+                std::memcpy(flipped + (rowAmount - 1 - r) * rowBytes, l.Bytes.data() + r * rowBytes, rowBytes);
+
+            for (std::byte* block = flipped; block != flipped + l.Bytes.size(); block += blockBytes)
+            {
+                switch (format)
+                {
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+                case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT:
+                    FlipBc4Block(block, texelRowAmount);
+                    FlipBc1Block(block + 8, texelRowAmount);
+                    break;
+                case GL_COMPRESSED_RED_RGTC1:
+                    FlipBc4Block(block, texelRowAmount);
+                    break;
+                case GL_COMPRESSED_RG_RGTC2:
+                    FlipBc4Block(block, texelRowAmount);
+                    FlipBc4Block(block + 8, texelRowAmount);
+                    break;
+                default:
+                    FlipBc1Block(block, texelRowAmount);
+                    break;
+                }
+            }
+
+            l.Bytes = std::span<const std::byte>(flipped, l.Bytes.size());
+            offset += l.Bytes.size();
+        }
+    }
+}
\ No newline at end of file
@@ -2,11 +2,14 @@
 
 #include <iostream>
 
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
 namespace RyuRenderer::Graphics
 {
     Frame::Frame(Texture2d* initTexture, GLint initColorAttachmentIdx)
     {
-        glGenFramebuffers(1, &id);
+        Device::IDevice::Current().GenFramebuffers(1, &id);
         Attach(initTexture, initColorAttachmentIdx);
     }
 
@@ -14,8 +17,10 @@ namespace RyuRenderer::Graphics
     {
         Clear();
         id = other.id;
+        depthStencilId = other.depthStencilId;
         frameCompleted = other.frameCompleted;
         other.id = 0;
+        other.depthStencilId = 0;
         other.frameCompleted = false;
     }
 
@@ -31,8 +36,10 @@ namespace RyuRenderer::Graphics
 
         Clear();
         id = other.id;
+        depthStencilId = other.depthStencilId;
         frameCompleted = other.frameCompleted;
         other.id = 0;
+        other.depthStencilId = 0;
         other.frameCompleted = false;
         return *this;
     }
@@ -54,22 +61,14 @@ namespace RyuRenderer::Graphics
         if (id == 0)
             return false;
 
-        if (IsCleanMode)
-        {
-            if (lastestUsedFrameId == 0)
-                return false;
-            return lastestUsedFrameId == id;
-        }
-
-        GLint fboId = 0;
-        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &fboId);
-        if (fboId == 0)
-            return false;
-        return fboId == id;
+        return Device::StateTracker::GetInstance().IsFramebufferBound(GL_FRAMEBUFFER, id);
     }
 
     bool Frame::Attach(Texture2d* t, GLint colorAttachmentIdx)
     {
+        auto& device = Device::IDevice::Current();
+        auto& states = Device::StateTracker::GetInstance();
+
         if (!t || !t->IsValid())
             return false;
         if (colorAttachmentIdx < 0 ||
@@ -78,14 +77,43 @@ namespace RyuRenderer::Graphics
 
         frameCompleted = false;
 
-        glBindFramebuffer(GL_FRAMEBUFFER, id);
-        lastestUsedFrameId = id;
+        states.BindFramebuffer(GL_FRAMEBUFFER, id);
+
+        device.FramebufferTexture2D(GL_FRAMEBUFFER, GetColorAttachmentId(colorAttachmentIdx), GL_TEXTURE_2D, t->GetId(), 0);
+
+        frameCompleted = device.CheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        states.BindFramebuffer(GL_FRAMEBUFFER, defaultFrameId);
+
+        if (!frameCompleted)
+        {
+            std::cerr << "frame buffer status error." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool Frame::AttachDepthStencil(int width, int height)
+    {
+        auto& device = Device::IDevice::Current();
+        auto& states = Device::StateTracker::GetInstance();
+
+        if (!IsValid())
+            return false;
+        if (width <= 0 || height <= 0)
+            return false;
+
+        if (depthStencilId == 0)
+            device.GenRenderbuffers(1, &depthStencilId);
+        device.BindRenderbuffer(GL_RENDERBUFFER, depthStencilId);
+        device.RenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        device.BindRenderbuffer(GL_RENDERBUFFER, 0);
 
-        glFramebufferTexture2D(GL_FRAMEBUFFER, GetColorAttachmentId(colorAttachmentIdx), GL_TEXTURE_2D, t->GetId(), 0);
+        states.BindFramebuffer(GL_FRAMEBUFFER, id);
 
-        frameCompleted = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        lastestUsedFrameId = 0;
+        device.FramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthStencilId);
+
+        frameCompleted = device.CheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        states.BindFramebuffer(GL_FRAMEBUFFER, defaultFrameId);
 
         if (!frameCompleted)
         {
@@ -100,31 +128,18 @@ namespace RyuRenderer::Graphics
         if (!IsCompleted())
             return false;
 
-        if (IsUsing())
-            return true;
-
-        glBindFramebuffer(GL_FRAMEBUFFER, id);
-        lastestUsedFrameId = id;
+        Device::StateTracker::GetInstance().BindFramebuffer(GL_FRAMEBUFFER, id);
         return true;
     }
 
     void Frame::Unuse()
     {
-        if (IsCleanMode)
-        {
-            if (lastestUsedFrameId == 0)
-                return;
-        }
-        else
-        {
-            GLint fboId = 0;
-            glGetIntegerv(GL_FRAMEBUFFER_BINDING, &fboId);
-            if (fboId == 0)
-                return;
-        }
+        Device::StateTracker::GetInstance().BindFramebuffer(GL_FRAMEBUFFER, defaultFrameId);
+    }
 
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        lastestUsedFrameId = 0;
+    void Frame::SetDefault(const Frame* f)
+    {
+        defaultFrameId = f ? f->id : 0;
     }
 
     GLint Frame::GetColorAttachmentId(GLint colorAttachmentIdx)
@@ -139,24 +154,32 @@ namespace RyuRenderer::Graphics
 
     void Frame::Clear()
     {
+        auto& states = Device::StateTracker::GetInstance();
+
+        if (id != 0 && defaultFrameId == id)
+            defaultFrameId = 0;
+
         if (IsUsing())
-        {
-            glBindFramebuffer(GL_FRAMEBUFFER, 0);
-            lastestUsedFrameId = 0;
-        }
+            states.BindFramebuffer(GL_FRAMEBUFFER, defaultFrameId);
 
         if (id != 0)
         {
-            glDeleteFramebuffers(1, &id);
+            states.DeleteFramebuffers(1, &id);
             id = 0;
         }
+
+        if (depthStencilId != 0)
+        {
+            Device::IDevice::Current().DeleteRenderbuffers(1, &depthStencilId);
+            depthStencilId = 0;
+        }
     }
 
     GLint Frame::GetMaxColorAttachmentAmount()
     {
         if (maxColorAttachmentAmount < 0)
         {
-            glGetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &maxColorAttachmentAmount);
+            Device::IDevice::Current().GetIntegerv(GL_MAX_COLOR_ATTACHMENTS, &maxColorAttachmentAmount);
         }
 
         return maxColorAttachmentAmount;
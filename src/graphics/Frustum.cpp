@@ -0,0 +1,73 @@
+#include "graphics/Frustum.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace RyuRenderer::Graphics
+{
+    Frustum Frustum::FromMatrix(const glm::mat4& viewProjection)
+    {
+        const glm::mat4 t = glm::transpose(viewProjection);
+
+        Frustum f;
+        f.Planes[0] = t[3] + t[0];
+        f.Planes[1] = t[3] - t[0];
+        f.Planes[2] = t[3] + t[1];
+        f.Planes[3] = t[3] - t[1];
+        f.Planes[4] = t[3] + t[2];
+        f.Planes[5] = t[3] - t[2];
+        for (auto& p : f.Planes)
+        {
+            const float length = glm::length(glm::vec3(p));
+            if (length > 0.f)
+                p /= length;
+        }
+        return f;
+    }
+
+    bool Frustum::IsVisible(const Bounds& b) const
+    {
+        if (!b.IsValid())
+            return true;
+
+        // The sphere rejects most objects with one dot product per plane, the box only runs for the ones it lets through
+        for (const auto& p : Planes)
+        {
+            if (glm::dot(glm::vec3(p), b.Center) + p.w < -b.Radius)
+                return false;
+        }
+        for (const auto& p : Planes)
+        {
+            const glm::vec3 positiveVertex(
+                p.x >= 0.f ? b.Max.x : b.Min.x,
+                p.y >= 0.f ? b.Max.y : b.Min.y,
+                p.z >= 0.f ? b.Max.z : b.Min.z);
+            if (glm::dot(glm::vec3(p), positiveVertex) + p.w < 0.f)
+                return false;
+        }
+        return true;
+    }
+
+    bool Frustum::IsVisible(const Bounds& localBounds, const glm::mat4& model) const
+    {
+        if (!localBounds.IsValid())
+            return true;
+
+        const float scaleSquared = std::max({
+            glm::dot(glm::vec3(model[0]), glm::vec3(model[0])),
+            glm::dot(glm::vec3(model[1]), glm::vec3(model[1])),
+            glm::dot(glm::vec3(model[2]), glm::vec3(model[2])) });
+        const glm::vec3 center = glm::vec3(model * glm::vec4(localBounds.Center, 1.f));
+        const float radius = localBounds.Radius * std::sqrt(scaleSquared);
+
+        bool isInside = true;
+        for (const auto& p : Planes)
+        {
+            const float distance = glm::dot(glm::vec3(p), center) + p.w;
+            if (distance < -radius)
+                return false;
+            isInside = isInside && distance >= radius;
+        }
+        return isInside || IsVisible(localBounds.Transform(model));
+    }
+}
\ No newline at end of file
@@ -0,0 +1,525 @@
+#include "graphics/GeometryPool.h"
+
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+
+#include "graphics/VertexArrayManager.h"
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics
+{
+    GeometryPool::Handle GeometryPool::Allocate(
+        const VertexFormat& format, std::span<const GLsizei> bindingStrides,
+        GLsizei vertexAmount, GLsizei indexAmount, GLenum indexType)
+    {
+        if (vertexAmount <= 0 || indexAmount <= 0 || bindingStrides.empty() || GetIndexBytes(indexType) == 0)
+            return {};
+
+        uint32_t pageIdx = UINT32_MAX;
+        size_t vertexOffset = Common::OffsetAllocator::InvalidOffset;
+        size_t indexOffset = Common::OffsetAllocator::InvalidOffset;
+        for (uint32_t i = 0; i < pages.size(); ++i)
+        {
+            Page* page = pages[i].get();
+            if (!page || page->Format != format || page->IndexType != indexType ||
+                !std::ranges::equal(page->BindingStrides, bindingStrides))
+                continue;
+
+            vertexOffset = page->Vertices.Allocate(vertexAmount);
+            if (vertexOffset == Common::OffsetAllocator::InvalidOffset)
+                continue;
+            indexOffset = page->Indices.Allocate(indexAmount);
+            if (indexOffset == Common::OffsetAllocator::InvalidOffset)
+            {
+                page->Vertices.Free(vertexOffset);
+                continue;
+            }
+
+            pageIdx = i;
+            break;
+        }
+
+        if (pageIdx == UINT32_MAX)
+        {
+            pageIdx = CreatePage(
+                format, bindingStrides,
+                std::max(PageVertexCapacity, vertexAmount),
+                std::max(PageIndexCapacity, indexAmount),
+                indexType);
+            if (pageIdx == UINT32_MAX)
+                return {};
+
+            vertexOffset = pages[pageIdx]->Vertices.Allocate(vertexAmount);
+            indexOffset = pages[pageIdx]->Indices.Allocate(indexAmount);
+        }
+
+        uint32_t slotIdx = 0;
+        if (!freeSlotIdxs.empty())
+        {
+            slotIdx = freeSlotIdxs.back();
+            freeSlotIdxs.pop_back();
+        }
+        else
+        {
+            slotIdx = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        auto& slot = slots[slotIdx];
+        slot.MeshRange.PageIdx = pageIdx;
+        slot.MeshRange.BaseVertex = static_cast<GLint>(vertexOffset);
+        slot.MeshRange.FirstIndex = static_cast<GLuint>(indexOffset);
+        slot.MeshRange.VertexAmount = vertexAmount;
+        slot.MeshRange.IndexAmount = indexAmount;
+        slot.IsUsed = true;
+        return { slotIdx, slot.Generation };
+    }
+
+    void GeometryPool::Free(Handle handle)
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s)
+            return;
+
+        auto& slot = slots[handle.Idx];
+        Page& page = *pages[slot.MeshRange.PageIdx];
+        page.Vertices.Free(slot.MeshRange.BaseVertex);
+        page.Indices.Free(slot.MeshRange.FirstIndex);
+
+        // Empty pages stay around for later meshes, Compact() releases them.
+        //     Old handles of this slot become stale once it is reused
+        slot.MeshRange = {};
+        slot.IsUsed = false;
+        ++slot.Generation;
+        freeSlotIdxs.emplace_back(handle.Idx);
+    }
+
+    bool GeometryPool::UploadVertices(Handle handle, GLuint bindingIdx, const void* data)
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s || !data)
+            return false;
+
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        if (bindingIdx >= page.Bindings.size())
+            return false;
+
+        const auto& b = page.Bindings[bindingIdx];
+        Device::StateTracker::GetInstance().BindBuffer(GL_ARRAY_BUFFER, page.VertexBufferId);
+        Device::IDevice::Current().BufferSubData(
+            GL_ARRAY_BUFFER,
+            b.Offset + static_cast<GLintptr>(s->MeshRange.BaseVertex) * b.Stride,
+            static_cast<GLsizeiptr>(s->MeshRange.VertexAmount) * b.Stride,
+            data);
+        return true;
+    }
+
+    bool GeometryPool::UploadIndices(Handle handle, std::span<const GLuint> indexData)
+    {
+        return UploadIndexBytes(handle, indexData.data(), indexData.size(), GL_UNSIGNED_INT);
+    }
+
+    bool GeometryPool::UploadIndices(Handle handle, std::span<const GLushort> indexData)
+    {
+        return UploadIndexBytes(handle, indexData.data(), indexData.size(), GL_UNSIGNED_SHORT);
+    }
+
+    bool GeometryPool::CopyVertices(
+        Handle handle, GLuint bindingIdx, GLuint readBufferId, GLintptr readOffset, GLsizei firstVertex, GLsizei vertexAmount)
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s || readBufferId == 0 || firstVertex < 0 || vertexAmount <= 0 ||
+            firstVertex + vertexAmount > s->MeshRange.VertexAmount)
+            return false;
+
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        if (bindingIdx >= page.Bindings.size())
+            return false;
+
+        const auto& b = page.Bindings[bindingIdx];
+        auto& states = Device::StateTracker::GetInstance();
+        states.BindBuffer(GL_COPY_READ_BUFFER, readBufferId);
+        states.BindBuffer(GL_COPY_WRITE_BUFFER, page.VertexBufferId);
+        Device::IDevice::Current().CopyBufferSubData(
+            GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            readOffset,
+            b.Offset + static_cast<GLintptr>(s->MeshRange.BaseVertex + firstVertex) * b.Stride,
+            static_cast<GLsizeiptr>(vertexAmount) * b.Stride);
+        return true;
+    }
+
+    bool GeometryPool::CopyIndices(Handle handle, GLuint readBufferId, GLintptr readOffset, GLsizei firstIndex, GLsizei indexAmount)
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s || readBufferId == 0 || firstIndex < 0 || indexAmount <= 0 ||
+            firstIndex + indexAmount > s->MeshRange.IndexAmount)
+            return false;
+
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        const size_t indexBytes = GetIndexBytes(page.IndexType);
+        auto& states = Device::StateTracker::GetInstance();
+        states.BindBuffer(GL_COPY_READ_BUFFER, readBufferId);
+        states.BindBuffer(GL_COPY_WRITE_BUFFER, page.IndexBufferId);
+        Device::IDevice::Current().CopyBufferSubData(
+            GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            readOffset,
+            static_cast<GLintptr>((s->MeshRange.FirstIndex + firstIndex) * indexBytes),
+            static_cast<GLsizeiptr>(indexAmount * indexBytes));
+        return true;
+    }
+
+    bool GeometryPool::Bind(Handle handle) const
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s)
+            return false;
+
+        // Every binding is shared by the meshes of the page, only the first draw of a page issues them
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        page.SharedVertexArray->Use();
+        BindPageBuffers(page);
+        return true;
+    }
+
+    bool GeometryPool::Draw(Handle handle) const
+    {
+        if (!Bind(handle))
+            return false;
+
+        const Slot* s = FindSlot(handle);
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        Device::IDevice::Current().DrawElementsBaseVertex(
+            GL_TRIANGLES,
+            s->MeshRange.IndexAmount,
+            page.IndexType,
+            reinterpret_cast<const void*>(s->MeshRange.FirstIndex * GetIndexBytes(page.IndexType)),
+            s->MeshRange.BaseVertex);
+        return true;
+    }
+
+    bool GeometryPool::DrawInstanced(Handle handle, const InstanceBuffer& instances) const
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s)
+            return false;
+
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        if (!page.InstancedVertexArray || instances.GetInstanceAmount() <= 0)
+            return false;
+
+        page.InstancedVertexArray->Use();
+        BindPageBuffers(page);
+        if (!instances.Use(static_cast<GLuint>(page.Bindings.size())))
+            return false;
+
+        Device::IDevice::Current().DrawElementsInstancedBaseVertex(
+            GL_TRIANGLES,
+            s->MeshRange.IndexAmount,
+            page.IndexType,
+            reinterpret_cast<const void*>(s->MeshRange.FirstIndex * GetIndexBytes(page.IndexType)),
+            instances.GetInstanceAmount(),
+            s->MeshRange.BaseVertex);
+        return true;
+    }
+
+    bool GeometryPool::IsUsing(Handle handle) const
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s)
+            return false;
+
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        return page.SharedVertexArray->IsUsing() &&
+            Device::StateTracker::GetInstance().IsVertexBufferBound(0, page.VertexBufferId);
+    }
+
+    const GeometryPool::Range* GeometryPool::Find(Handle handle) const
+    {
+        const Slot* s = FindSlot(handle);
+        return s ? &s->MeshRange : nullptr;
+    }
+
+    GLuint GeometryPool::GetPageId(Handle handle) const
+    {
+        const Slot* s = FindSlot(handle);
+        return s ? pages[s->MeshRange.PageIdx]->VertexBufferId : 0;
+    }
+
+    GLenum GeometryPool::GetIndexType(Handle handle) const
+    {
+        const Slot* s = FindSlot(handle);
+        return s ? pages[s->MeshRange.PageIdx]->IndexType : GL_NONE;
+    }
+
+    void GeometryPool::Compact()
+    {
+        auto& device = Device::IDevice::Current();
+        auto& states = Device::StateTracker::GetInstance();
+
+        for (uint32_t pageIdx = 0; pageIdx < pages.size(); ++pageIdx)
+        {
+            Page* page = pages[pageIdx].get();
+            if (!page)
+                continue;
+
+            if (page->Vertices.GetAllocationAmount() == 0)
+            {
+                ReleasePage(pageIdx);
+                continue;
+            }
+
+            if (page->Vertices.GetFreeRangeAmount() <= 1 && page->Indices.GetFreeRangeAmount() <= 1)
+                continue;
+
+            // Live ranges keep their order, so the copies never overlap inside a buffer
+            std::vector<uint32_t> slotIdxs;
+            for (uint32_t i = 0; i < slots.size(); ++i)
+            {
+                if (slots[i].IsUsed && slots[i].MeshRange.PageIdx == pageIdx)
+                    slotIdxs.emplace_back(i);
+            }
+            std::ranges::sort(slotIdxs, {}, [&](uint32_t i) { return slots[i].MeshRange.BaseVertex; });
+
+            const GLuint oldVertexBufferId = page->VertexBufferId;
+            const GLuint oldIndexBufferId = page->IndexBufferId;
+            const GLsizei vertexCapacity = static_cast<GLsizei>(page->Vertices.GetCapacity());
+            const GLsizei indexCapacity = static_cast<GLsizei>(page->Indices.GetCapacity());
+            if (!CreatePageBuffers(*page, vertexCapacity, indexCapacity))
+            {
+                page->VertexBufferId = oldVertexBufferId;
+                page->IndexBufferId = oldIndexBufferId;
+                continue;
+            }
+
+            std::vector<Range> oldRanges;
+            oldRanges.reserve(slotIdxs.size());
+            for (uint32_t i : slotIdxs)
+            {
+                auto& r = slots[i].MeshRange;
+                oldRanges.emplace_back(r);
+                // Allocating in order from empty allocators packs the ranges
+                r.BaseVertex = static_cast<GLint>(page->Vertices.Allocate(r.VertexAmount));
+                r.FirstIndex = static_cast<GLuint>(page->Indices.Allocate(r.IndexAmount));
+            }
+
+            states.BindBuffer(GL_COPY_READ_BUFFER, oldVertexBufferId);
+            states.BindBuffer(GL_COPY_WRITE_BUFFER, page->VertexBufferId);
+            for (size_t i = 0; i < slotIdxs.size(); ++i)
+            {
+                const auto& oldRange = oldRanges[i];
+                const auto& newRange = slots[slotIdxs[i]].MeshRange;
+                for (const auto& b : page->Bindings)
+                {
+                    device.CopyBufferSubData(
+                        GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                        b.Offset + static_cast<GLintptr>(oldRange.BaseVertex) * b.Stride,
+                        b.Offset + static_cast<GLintptr>(newRange.BaseVertex) * b.Stride,
+                        static_cast<GLsizeiptr>(oldRange.VertexAmount) * b.Stride);
+                }
+            }
+
+            const size_t indexBytes = GetIndexBytes(page->IndexType);
+            states.BindBuffer(GL_COPY_READ_BUFFER, oldIndexBufferId);
+            states.BindBuffer(GL_COPY_WRITE_BUFFER, page->IndexBufferId);
+            for (size_t i = 0; i < slotIdxs.size(); ++i)
+            {
+                const auto& oldRange = oldRanges[i];
+                const auto& newRange = slots[slotIdxs[i]].MeshRange;
+                device.CopyBufferSubData(
+                    GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+                    static_cast<GLintptr>(oldRange.FirstIndex * indexBytes),
+                    static_cast<GLintptr>(newRange.FirstIndex * indexBytes),
+                    static_cast<GLsizeiptr>(oldRange.IndexAmount * indexBytes));
+            }
+
+            states.DeleteBuffers(1, &oldVertexBufferId);
+            states.DeleteBuffers(1, &oldIndexBufferId);
+        }
+    }
+
+    void GeometryPool::Clear()
+    {
+        for (uint32_t i = 0; i < pages.size(); ++i)
+            ReleasePage(i);
+        pages.clear();
+
+        // Slots stay around with a new generation, so handles from before never match a reused slot
+        freeSlotIdxs.clear();
+        for (uint32_t i = 0; i < slots.size(); ++i)
+        {
+            auto& slot = slots[i];
+            if (slot.IsUsed)
+            {
+                slot.MeshRange = {};
+                slot.IsUsed = false;
+                ++slot.Generation;
+            }
+            freeSlotIdxs.emplace_back(i);
+        }
+    }
+
+    GeometryPool::Stats GeometryPool::GetStats() const
+    {
+        Stats stats;
+        size_t freeBytes = 0;
+        size_t fragmentedBytes = 0;
+        for (const auto& page : pages)
+        {
+            if (!page)
+                continue;
+
+            const size_t vertexBytes = std::accumulate(page->BindingStrides.begin(), page->BindingStrides.end(), size_t(0));
+            const size_t indexBytes = GetIndexBytes(page->IndexType);
+
+            ++stats.PageAmount;
+            stats.AllocationAmount += page->Vertices.GetAllocationAmount();
+            stats.CapacityBytes += page->Vertices.GetCapacity() * vertexBytes + page->Indices.GetCapacity() * indexBytes;
+            stats.UsedBytes += page->Vertices.GetUsedSize() * vertexBytes + page->Indices.GetUsedSize() * indexBytes;
+            freeBytes += page->Vertices.GetFreeSize() * vertexBytes + page->Indices.GetFreeSize() * indexBytes;
+            fragmentedBytes +=
+                (page->Vertices.GetFreeSize() - page->Vertices.GetLargestFreeSize()) * vertexBytes +
+                (page->Indices.GetFreeSize() - page->Indices.GetLargestFreeSize()) * indexBytes;
+        }
+
+        stats.Fragmentation = freeBytes > 0 ? static_cast<double>(fragmentedBytes) / freeBytes : 0.0;
+        return stats;
+    }
+
+    uint32_t GeometryPool::CreatePage(
+        const VertexFormat& format, std::span<const GLsizei> bindingStrides,
+        GLsizei vertexCapacity, GLsizei indexCapacity, GLenum indexType)
+    {
+        auto page = std::make_unique<Page>();
+        page->Format = format;
+        page->IndexType = indexType;
+        page->BindingStrides.assign(bindingStrides.begin(), bindingStrides.end());
+        page->SharedVertexArray = VertexArrayManager::GetInstance().FindOrCreate(format);
+        if (!page->SharedVertexArray)
+        {
+            std::cerr << "Failed to create vertex array for geometry page." << std::endl;
+            return UINT32_MAX;
+        }
+
+        // Pages are shared by every draw of their format, so the instanced variant is created up front as well
+        const VertexFormat instancedFormat = InstanceBuffer::MakeVertexFormat(format, static_cast<GLuint>(bindingStrides.size()));
+        if (instancedFormat.AttributeAmount > 0)
+            page->InstancedVertexArray = VertexArrayManager::GetInstance().FindOrCreate(instancedFormat);
+
+        if (!CreatePageBuffers(*page, vertexCapacity, indexCapacity))
+            return UINT32_MAX;
+
+        // Slots of released pages are reused, page indices held by ranges stay stable
+        auto it = std::ranges::find_if(pages, [](const std::unique_ptr<Page>& p) { return !p; });
+        if (it != pages.end())
+        {
+            *it = std::move(page);
+            return static_cast<uint32_t>(it - pages.begin());
+        }
+
+        pages.emplace_back(std::move(page));
+        return static_cast<uint32_t>(pages.size() - 1);
+    }
+
+    bool GeometryPool::CreatePageBuffers(Page& page, GLsizei vertexCapacity, GLsizei indexCapacity)
+    {
+        auto& device = Device::IDevice::Current();
+        auto& states = Device::StateTracker::GetInstance();
+
+        if (vertexCapacity <= 0 || indexCapacity <= 0)
+            return false;
+
+        // Binding i reads its own region, the interleaved layout has a single one
+        page.Bindings.clear();
+        GLintptr vertexBufferSize = 0;
+        for (GLsizei stride : page.BindingStrides)
+        {
+            page.Bindings.push_back({ vertexBufferSize, stride });
+            vertexBufferSize += static_cast<GLintptr>(vertexCapacity) * stride;
+        }
+
+        page.VertexBufferId = 0;
+        page.IndexBufferId = 0;
+        device.GenBuffers(1, &page.VertexBufferId);
+        device.GenBuffers(1, &page.IndexBufferId);
+
+        // Immutable storage, the size never changes and data only arrives through sub data uploads and copies
+        states.BindBuffer(GL_ARRAY_BUFFER, page.VertexBufferId);
+        device.BufferStorage(GL_ARRAY_BUFFER, vertexBufferSize, nullptr, GL_DYNAMIC_STORAGE_BIT);
+        states.BindBuffer(GL_COPY_WRITE_BUFFER, page.IndexBufferId);
+        device.BufferStorage(
+            GL_COPY_WRITE_BUFFER,
+            static_cast<GLsizeiptr>(indexCapacity * GetIndexBytes(page.IndexType)),
+            nullptr,
+            GL_DYNAMIC_STORAGE_BIT);
+
+        page.Vertices = Common::OffsetAllocator(vertexCapacity);
+        page.Indices = Common::OffsetAllocator(indexCapacity);
+        return true;
+    }
+
+    void GeometryPool::BindPageBuffers(const Page& page) const
+    {
+        auto& states = Device::StateTracker::GetInstance();
+        for (GLuint i = 0; i < page.Bindings.size(); ++i)
+            states.BindVertexBuffer(i, page.VertexBufferId, page.Bindings[i].Offset, page.Bindings[i].Stride);
+        states.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, page.IndexBufferId);
+    }
+
+    bool GeometryPool::UploadIndexBytes(Handle handle, const void* data, size_t indexAmount, GLenum indexType)
+    {
+        const Slot* s = FindSlot(handle);
+        if (!s || !data || indexAmount != static_cast<size_t>(s->MeshRange.IndexAmount))
+            return false;
+
+        const Page& page = *pages[s->MeshRange.PageIdx];
+        if (page.IndexType != indexType)
+            return false;
+
+        // Element array buffer binding belongs to a vertex array, uploads go through the copy target
+        const size_t indexBytes = GetIndexBytes(indexType);
+        Device::StateTracker::GetInstance().BindBuffer(GL_COPY_WRITE_BUFFER, page.IndexBufferId);
+        Device::IDevice::Current().BufferSubData(
+            GL_COPY_WRITE_BUFFER,
+            static_cast<GLintptr>(s->MeshRange.FirstIndex * indexBytes),
+            static_cast<GLsizeiptr>(indexAmount * indexBytes),
+            data);
+        return true;
+    }
+
+    size_t GeometryPool::GetIndexBytes(GLenum indexType)
+    {
+        switch (indexType)
+        {
+        case GL_UNSIGNED_INT: return sizeof(GLuint);
+        case GL_UNSIGNED_SHORT: return sizeof(GLushort);
+        default: return 0;
+        }
+    }
+
+    void GeometryPool::ReleasePage(uint32_t pageIdx)
+    {
+        if (pageIdx >= pages.size() || !pages[pageIdx])
+            return;
+
+        // Deleted objects are unbound by GL, the tracker follows
+        auto& states = Device::StateTracker::GetInstance();
+        Page& page = *pages[pageIdx];
+        if (page.VertexBufferId != 0)
+            states.DeleteBuffers(1, &page.VertexBufferId);
+        if (page.IndexBufferId != 0)
+            states.DeleteBuffers(1, &page.IndexBufferId);
+
+        pages[pageIdx] = nullptr;
+    }
+
+    const GeometryPool::Slot* GeometryPool::FindSlot(Handle handle) const
+    {
+        if (!handle.IsValid() || handle.Idx >= slots.size())
+            return nullptr;
+
+        const auto& slot = slots[handle.Idx];
+        return slot.IsUsed && slot.Generation == handle.Generation ? &slot : nullptr;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "graphics/GpuTimer.h"
+
+#include <algorithm>
+
+#include "common/Profiler.h"
+#include "graphics/device/IDevice.h"
+
+namespace RyuRenderer::Graphics
+{
+    GpuTimer::ScopedPass::ScopedPass(const char* name)
+    {
+        isBegun = GpuTimer::GetInstance().BeginPass(name);
+    }
+
+    GpuTimer::ScopedPass::~ScopedPass()
+    {
+        if (isBegun)
+            GpuTimer::GetInstance().EndPass();
+    }
+
+    void GpuTimer::BeginFrame()
+    {
+        if (isPassBegun)
+            EndPass();
+
+        ++frameIdx;
+
+        auto& slot = slots[frameIdx % FrameLatency];
+        if (slot.IsPending && !ReadBack(slot, false))
+        {
+            ++droppedFrameAmount;
+            slot.IsPending = false;
+        }
+
+        slot.FrameIdx = frameIdx;
+        slot.Passes.clear();
+    }
+
+    bool GpuTimer::BeginPass(const char* name)
+    {
+        if (!IsEnabled || isPassBegun)
+            return false;
+
+        auto& slot = slots[frameIdx % FrameLatency];
+        auto& device = Device::IDevice::Current();
+        if (slot.Passes.size() == slot.Queries.size())
+        {
+            GLuint query = 0;
+            device.GenQueries(1, &query);
+            slot.Queries.emplace_back(query);
+        }
+
+        device.BeginQuery(GL_TIME_ELAPSED, slot.Queries[slot.Passes.size()]);
+        slot.Passes.emplace_back(PassTime{ name, 0.0, Common::Profiler::GetInstance().GetTimeInNs() });
+        slot.IsPending = true;
+        isPassBegun = true;
+        return true;
+    }
+
+    void GpuTimer::EndPass()
+    {
+        if (!isPassBegun)
+            return;
+
+        Device::IDevice::Current().EndQuery(GL_TIME_ELAPSED);
+        isPassBegun = false;
+    }
+
+    void GpuTimer::Clear()
+    {
+        if (isPassBegun)
+            EndPass();
+
+        // Read back in frame order, so the GPU track stays sorted
+        std::array<FrameSlot*, FrameLatency> pendingSlots = {};
+        for (size_t i = 0; i < FrameLatency; ++i)
+            pendingSlots[i] = &slots[i];
+        std::sort(pendingSlots.begin(), pendingSlots.end(),
+            [](const FrameSlot* a, const FrameSlot* b) { return a->FrameIdx < b->FrameIdx; });
+
+        auto& device = Device::IDevice::Current();
+        for (FrameSlot* s : pendingSlots)
+        {
+            if (s->IsPending)
+                ReadBack(*s, true);
+
+            if (!s->Queries.empty())
+                device.DeleteQueries(static_cast<GLsizei>(s->Queries.size()), s->Queries.data());
+            *s = FrameSlot();
+        }
+    }
+
+    const std::vector<GpuTimer::PassTime>& GpuTimer::GetLatestPassTimes() const
+    {
+        return latestPassTimes;
+    }
+
+    unsigned long long GpuTimer::GetLatestFrameIdx() const
+    {
+        return latestFrameIdx;
+    }
+
+    unsigned long long GpuTimer::GetDroppedFrameAmount() const
+    {
+        return droppedFrameAmount;
+    }
+
+    bool GpuTimer::ReadBack(FrameSlot& slot, bool isWaiting)
+    {
+        auto& device = Device::IDevice::Current();
+
+        // Queries complete in order, the last one being ready means the whole frame is ready
+        if (!isWaiting && !slot.Passes.empty())
+        {
+            GLint isAvailable = GL_FALSE;
+            device.GetQueryObjectiv(slot.Queries[slot.Passes.size() - 1], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+            if (isAvailable != GL_TRUE)
+                return false;
+        }
+
+        auto& profiler = Common::Profiler::GetInstance();
+        if (!isTrackCreated && !slot.Passes.empty())
+        {
+            trackIdx = profiler.CreateTrack("GPU");
+            isTrackCreated = true;
+        }
+
+        for (size_t i = 0; i < slot.Passes.size(); ++i)
+        {
+            GLuint64 elapsedInNs = 0;
+            device.GetQueryObjectui64v(slot.Queries[i], GL_QUERY_RESULT, &elapsedInNs);
+
+            auto& pass = slot.Passes[i];
+            pass.TimeInMs = elapsedInNs / 1000000.0;
+
+            // The GPU never starts a pass before it is submitted, nor before the previous pass ends
+            unsigned long long beginInNs = std::max(trackCursorInNs, pass.SubmitTimeInNs);
+            trackCursorInNs = beginInNs + elapsedInNs;
+            profiler.AddTrackEvent(trackIdx, Common::Profiler::ZoneEvent{ pass.Name, beginInNs, trackCursorInNs, 0 });
+        }
+
+        latestPassTimes = slot.Passes;
+        latestFrameIdx = slot.FrameIdx;
+        slot.IsPending = false;
+        return true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "graphics/InstanceBuffer.h"
+
+#include <algorithm>
+
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics
+{
+    InstanceBuffer::InstanceBuffer(InstanceBuffer&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    InstanceBuffer::~InstanceBuffer()
+    {
+        Clear();
+    }
+
+    InstanceBuffer& InstanceBuffer::operator=(InstanceBuffer&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        instances = std::move(other.instances);
+        denseSlotIdxs = std::move(other.denseSlotIdxs);
+        slots = std::move(other.slots);
+        freeSlotIdxs = std::move(other.freeSlotIdxs);
+        id = other.id;
+        capacity = other.capacity;
+        dirtyBegin = other.dirtyBegin;
+        dirtyEnd = other.dirtyEnd;
+        other.id = 0;
+        other.capacity = 0;
+        other.dirtyBegin = UINT32_MAX;
+        other.dirtyEnd = 0;
+        return *this;
+    }
+
+    InstanceBuffer::Handle InstanceBuffer::Add(const InstanceData& data)
+    {
+        uint32_t slotIdx = 0;
+        if (!freeSlotIdxs.empty())
+        {
+            slotIdx = freeSlotIdxs.back();
+            freeSlotIdxs.pop_back();
+        }
+        else
+        {
+            slotIdx = static_cast<uint32_t>(slots.size());
+            slots.emplace_back();
+        }
+
+        auto& slot = slots[slotIdx];
+        slot.DenseIdx = static_cast<uint32_t>(instances.size());
+        slot.IsUsed = true;
+        instances.emplace_back(data);
+        denseSlotIdxs.emplace_back(slotIdx);
+        MarkDirty(slot.DenseIdx);
+
+        return { slotIdx, slot.Generation };
+    }
+
+    bool InstanceBuffer::Remove(Handle handle)
+    {
+        if (!Find(handle))
+            return false;
+
+        auto& slot = slots[handle.Idx];
+        const uint32_t lastIdx = static_cast<uint32_t>(instances.size() - 1);
+        if (slot.DenseIdx != lastIdx)
+        {
+            instances[slot.DenseIdx] = instances[lastIdx];
+            denseSlotIdxs[slot.DenseIdx] = denseSlotIdxs[lastIdx];
+            slots[denseSlotIdxs[slot.DenseIdx]].DenseIdx = slot.DenseIdx;
+            MarkDirty(slot.DenseIdx);
+        }
+        instances.pop_back();
+        denseSlotIdxs.pop_back();
+
+        // Old handles of this slot become stale once it is reused
+        slot.IsUsed = false;
+        ++slot.Generation;
+        freeSlotIdxs.emplace_back(handle.Idx);
+        return true;
+    }
+
+    bool InstanceBuffer::Update(Handle handle, const InstanceData& data)
+    {
+        if (!Find(handle))
+            return false;
+
+        const uint32_t denseIdx = slots[handle.Idx].DenseIdx;
+        instances[denseIdx] = data;
+        MarkDirty(denseIdx);
+        return true;
+    }
+
+    const InstanceData* InstanceBuffer::Find(Handle handle) const
+    {
+        if (!handle.IsValid() || handle.Idx >= slots.size())
+            return nullptr;
+
+        const auto& slot = slots[handle.Idx];
+        if (!slot.IsUsed || slot.Generation != handle.Generation)
+            return nullptr;
+        return &instances[slot.DenseIdx];
+    }
+
+    void InstanceBuffer::Reset()
+    {
+        for (uint32_t slotIdx : denseSlotIdxs)
+        {
+            slots[slotIdx].IsUsed = false;
+            ++slots[slotIdx].Generation;
+            freeSlotIdxs.emplace_back(slotIdx);
+        }
+        instances.clear();
+        denseSlotIdxs.clear();
+        dirtyBegin = UINT32_MAX;
+        dirtyEnd = 0;
+    }
+
+    GLsizei InstanceBuffer::GetInstanceAmount() const
+    {
+        return static_cast<GLsizei>(instances.size());
+    }
+
+    bool InstanceBuffer::Use(GLuint bindingIdx) const
+    {
+        if (instances.empty())
+            return false;
+
+        auto& device = Device::IDevice::Current();
+        auto& states = Device::StateTracker::GetInstance();
+
+        if (id == 0)
+            device.GenBuffers(1, &id);
+
+        const GLsizeiptr size = static_cast<GLsizeiptr>(instances.size() * sizeof(InstanceData));
+        if (size > capacity)
+        {
+            // Grows by half again, the whole content is uploaded with the new storage
+            capacity = std::max(size, capacity + capacity / 2);
+            states.BindBuffer(GL_ARRAY_BUFFER, id);
+            device.BufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+            device.BufferSubData(GL_ARRAY_BUFFER, 0, size, instances.data());
+        }
+        else if (dirtyBegin < dirtyEnd)
+        {
+            const uint32_t end = std::min(dirtyEnd, static_cast<uint32_t>(instances.size()));
+            if (dirtyBegin < end)
+            {
+                states.BindBuffer(GL_ARRAY_BUFFER, id);
+                device.BufferSubData(
+                    GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>(dirtyBegin * sizeof(InstanceData)),
+                    static_cast<GLsizeiptr>((end - dirtyBegin) * sizeof(InstanceData)),
+                    &instances[dirtyBegin]);
+            }
+        }
+        dirtyBegin = UINT32_MAX;
+        dirtyEnd = 0;
+
+        states.BindVertexBuffer(bindingIdx, id, 0, sizeof(InstanceData));
+        return true;
+    }
+
+    VertexFormat InstanceBuffer::MakeVertexFormat(const VertexFormat& meshFormat, GLuint bindingIdx)
+    {
+        if (meshFormat.AttributeAmount > InstanceData::FirstLocation || bindingIdx >= VertexFormat::MaxAttributeAmount)
+            return {};
+
+        VertexFormat format = meshFormat;
+        format.AttributeAmount = InstanceData::FirstLocation + InstanceData::LocationAmount;
+        for (GLuint i = 0; i < InstanceData::LocationAmount; ++i)
+        {
+            // Model columns, color and params are all vec4, one after another
+            auto& a = format.Attributes[InstanceData::FirstLocation + i];
+            a.DataType = GL_FLOAT;
+            a.ComponentAmount = 4;
+            a.RelativeOffset = static_cast<GLuint>(i * sizeof(glm::vec4));
+            a.BindingIdx = bindingIdx;
+        }
+        format.BindingDivisors[bindingIdx] = 1;
+        return format;
+    }
+
+    void InstanceBuffer::MarkDirty(uint32_t denseIdx) const
+    {
+        dirtyBegin = std::min(dirtyBegin, denseIdx);
+        dirtyEnd = std::max(dirtyEnd, denseIdx + 1);
+    }
+
+    void InstanceBuffer::Clear()
+    {
+        if (id != 0)
+        {
+            Device::StateTracker::GetInstance().DeleteBuffers(1, &id);
+            id = 0;
+        }
+
+        capacity = 0;
+        dirtyBegin = UINT32_MAX;
+        dirtyEnd = 0;
+    }
+}
\ No newline at end of file
@@ -1,18 +1,20 @@
 #include "graphics/Mesh.h"
 
+#include <cstring>
+#include <iostream>
+#include <memory>
+
 namespace RyuRenderer::Graphics
 {
     Mesh::Mesh(Mesh&& other) noexcept
     {
         Clear();
-        VAOId = other.VAOId;
-        elementSize = other.elementSize;
-        VBOId = other.VBOId;
-        EBOId = other.EBOId;
-        other.VAOId = 0;
-        other.elementSize = 0;
-        other.VBOId = 0;
-        other.EBOId = 0;
+        geometry = other.geometry;
+        vertexDecode = other.vertexDecode;
+        bounds = other.bounds;
+        other.geometry = {};
+        other.vertexDecode = {};
+        other.bounds = {};
     }
 
     Mesh::~Mesh()
@@ -26,105 +28,279 @@ namespace RyuRenderer::Graphics
             return *this;
 
         Clear();
-        VAOId = other.VAOId;
-        elementSize = other.elementSize;
-        VBOId = other.VBOId;
-        EBOId = other.EBOId;
-        other.VAOId = 0;
-        other.elementSize = 0;
-        other.VBOId = 0;
-        other.EBOId = 0;
+        geometry = other.geometry;
+        vertexDecode = other.vertexDecode;
+        bounds = other.bounds;
+        other.geometry = {};
+        other.vertexDecode = {};
+        other.bounds = {};
         return *this;
     }
 
     bool Mesh::IsValid() const
     {
-        return VAOId != 0 &&
-            elementSize != 0 &&
-            VBOId != 0 &&
-            EBOId != 0;
+        return GeometryPool::GetInstance().Find(geometry) != nullptr;
     }
 
     bool Mesh::IsUsing() const
     {
-        if (VAOId == 0)
-            return false;
+        return GeometryPool::GetInstance().IsUsing(geometry);
+    }
 
-        if (IsCleanMode)
-        {
-            if (lastestUsedVAOId == 0)
-                return false;
+    GLuint Mesh::GetId() const
+    {
+        return GeometryPool::GetInstance().GetPageId(geometry);
+    }
 
-            return lastestUsedVAOId == VAOId;
-        }
+    GLint Mesh::GetBaseVertex() const
+    {
+        const auto* r = GeometryPool::GetInstance().Find(geometry);
+        return r ? r->BaseVertex : 0;
+    }
+
+    GLuint Mesh::GetFirstIndex() const
+    {
+        const auto* r = GeometryPool::GetInstance().Find(geometry);
+        return r ? r->FirstIndex : 0;
+    }
+
+    GLsizei Mesh::GetIndexAmount() const
+    {
+        const auto* r = GeometryPool::GetInstance().Find(geometry);
+        return r ? r->IndexAmount : 0;
+    }
 
-        GLint currentVAO;
-        glGetIntegerv(GL_VERTEX_ARRAY_BINDING, &currentVAO);
-        return currentVAO == VAOId;
+    GLenum Mesh::GetIndexType() const
+    {
+        return GeometryPool::GetInstance().GetIndexType(geometry);
+    }
+
+    GeometryPool::Handle Mesh::GetGeometry() const
+    {
+        return geometry;
+    }
+
+    void Mesh::SetVertexDecode(const VertexDecode& decode)
+    {
+        vertexDecode = decode;
+    }
+
+    const Mesh::VertexDecode& Mesh::GetVertexDecode() const
+    {
+        return vertexDecode;
+    }
+
+    void Mesh::SetBounds(const Bounds& b)
+    {
+        bounds = b;
+    }
+
+    const Bounds& Mesh::GetBounds() const
+    {
+        return bounds;
+    }
+
+    glm::mat4 Mesh::VertexDecode::GetPositionMatrix() const
+    {
+        glm::mat4 m = glm::identity<glm::mat4>();
+        m[0][0] = PositionScale.x;
+        m[1][1] = PositionScale.y;
+        m[2][2] = PositionScale.z;
+        m[3] = glm::vec4(PositionOffset, 1.f);
+        return m;
+    }
+
+    bool Mesh::VertexDecode::IsPositionDecoded() const
+    {
+        return PositionOffset != glm::vec3(0.f) || PositionScale != glm::vec3(1.f);
     }
 
     void Mesh::Draw() const
     {
-        if (!IsValid())
-            return;
+        GeometryPool::GetInstance().Draw(geometry);
+    }
 
-        if (!IsUsing())
-        {
-            glBindVertexArray(VAOId);
-            lastestUsedVAOId = VAOId;
-        }
+    void Mesh::DrawInstanced(const InstanceBuffer& instances) const
+    {
+        GeometryPool::GetInstance().DrawInstanced(geometry, instances);
+    }
 
-        glDrawElements(GL_TRIANGLES, elementSize, GL_UNSIGNED_INT, 0);
+    void Mesh::Bind() const
+    {
+        GeometryPool::GetInstance().Bind(geometry);
     }
 
-    void Mesh::Clear()
+    DrawElementsIndirectCommand Mesh::GetDrawCommand(GLuint baseInstance) const
+    {
+        DrawElementsIndirectCommand cmd;
+        const auto* r = GeometryPool::GetInstance().Find(geometry);
+        if (!r)
+            return cmd;
+
+        cmd.Count = static_cast<GLuint>(r->IndexAmount);
+        cmd.InstanceCount = 1;
+        cmd.FirstIndex = r->FirstIndex;
+        cmd.BaseVertex = r->BaseVertex;
+        cmd.BaseInstance = baseInstance;
+        return cmd;
+    }
+
+    VertexFormat Mesh::MakeVertexFormat(VertexLayoutType layout, std::span<const VertexStream> streams)
     {
-        elementSize = 0;
+        VertexFormat format;
+        if (streams.size() > VertexFormat::MaxAttributeAmount)
+            return format;
 
-        if (VAOId != 0)
+        GLuint offset = 0;
+        for (const auto& s : streams)
+        {
+            auto& a = format.Attributes[format.AttributeAmount];
+            a.DataType = s.DataType;
+            a.ComponentAmount = s.ComponentAmount;
+            a.RelativeOffset = layout == VERTEX_LAYOUT_INTERLEAVED ? offset : 0;
+            a.BindingIdx = layout == VERTEX_LAYOUT_INTERLEAVED ? 0 : format.AttributeAmount;
+            offset += static_cast<GLuint>(s.ElementBytes);
+            ++format.AttributeAmount;
+        }
+        return format;
+    }
+
+    void Mesh::Create(
+        const VertexFormat& format, VertexLayoutType layout,
+        const IndexStream& indexStream, std::span<const VertexStream> streams)
+    {
+        if (streams.empty())
+            return;
+        const std::size_t vertexAmount = streams.front().VertexAmount;
+        for (const auto& s : streams)
         {
-            if (IsUsing())
+            if (s.VertexAmount != vertexAmount)
             {
-                glBindVertexArray(0);
-                lastestUsedVAOId = 0;
+                std::cerr << "All vertex data in vector must have the same size." << std::endl;
+                return;
             }
+        }
+        if (static_cast<GLint>(streams.size()) >= GetMaxAttributeAmount() ||
+            streams.size() > VertexFormat::MaxAttributeAmount)
+        {
+            std::cerr << "Vertex attribute is oversize for OpenGL." << std::endl;
+            return;
+        }
+
+        // Stride and offsets are computed once for the whole mesh
+        std::size_t stride = 0;
+        for (const auto& s : streams)
+            stride += s.ElementBytes;
 
-            glDeleteVertexArrays(1, &VAOId);
-            VAOId = 0;
+        // The interleaved layout reads one binding, the separate layout one binding per stream
+        std::array<GLsizei, VertexFormat::MaxAttributeAmount> bindingStrides = {};
+        std::size_t bindingAmount = 0;
+        if (layout == VERTEX_LAYOUT_INTERLEAVED)
+        {
+            bindingStrides[bindingAmount++] = static_cast<GLsizei>(stride);
+        }
+        else
+        {
+            for (const auto& s : streams)
+                bindingStrides[bindingAmount++] = static_cast<GLsizei>(s.ElementBytes);
         }
 
-        if (VBOId != 0)
+        if (!Allocate(
+            format, std::span<const GLsizei>(bindingStrides.data(), bindingAmount),
+            static_cast<GLsizei>(vertexAmount), static_cast<GLsizei>(indexStream.IndexAmount), indexStream.DataType))
+            return;
+
+        auto& pool = GeometryPool::GetInstance();
+
+        if (layout == VERTEX_LAYOUT_INTERLEAVED)
         {
-            GLint currentVBO;
-            glGetIntegerv(GL_ARRAY_BUFFER_BINDING, &currentVBO);
-            if (currentVBO == VBOId)
+            auto vertexData = std::make_unique_for_overwrite<std::byte[]>(stride * vertexAmount);
+            std::size_t offset = 0;
+            for (const auto& s : streams)
             {
-                glBindBuffer(GL_ARRAY_BUFFER, 0);
+                InterleaveStream(vertexData.get(), stride, offset, s);
+                offset += s.ElementBytes;
             }
+            pool.UploadVertices(geometry, 0, vertexData.get());
+        }
+        else
+        {
+            // Streams are uploaded as they are without any CPU side copy
+            for (GLuint i = 0; i < streams.size(); ++i)
+                pool.UploadVertices(geometry, i, streams[i].Data);
+        }
+
+        const auto& positions = streams.front();
+        if (positions.DataType == GL_FLOAT && positions.ComponentAmount >= 3)
+            bounds = Bounds::FromPositions(positions.Data, positions.VertexAmount, positions.ElementBytes);
 
-            glDeleteBuffers(1, &VBOId);
-            VBOId = 0;
+        if (indexStream.DataType == GL_UNSIGNED_SHORT)
+            pool.UploadIndices(geometry, std::span(static_cast<const GLushort*>(indexStream.Data), indexStream.IndexAmount));
+        else
+            pool.UploadIndices(geometry, std::span(static_cast<const GLuint*>(indexStream.Data), indexStream.IndexAmount));
+    }
+
+    bool Mesh::Allocate(
+        const VertexFormat& format, std::span<const GLsizei> bindingStrides,
+        GLsizei vertexAmount, GLsizei indexAmount, GLenum indexType)
+    {
+        geometry = GeometryPool::GetInstance().Allocate(format, bindingStrides, vertexAmount, indexAmount, indexType);
+        if (!geometry.IsValid())
+        {
+            std::cerr << "Failed to allocate mesh geometry." << std::endl;
+            return false;
         }
+        return true;
+    }
 
-        if (EBOId != 0)
+    void Mesh::InterleaveStream(
+        std::byte* dst, std::size_t stride, std::size_t offset, const VertexStream& stream)
+    {
+        // Fixed size copies compile to plain register moves, the common attribute sizes get their own loop
+        auto copyElements = [&]<std::size_t N>(std::integral_constant<std::size_t, N>)
         {
-            GLint currentEBO;
-            glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &currentEBO);
-            if (currentEBO == EBOId)
-            {
-                glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-            }
+            const std::byte* src = stream.Data;
+            std::byte* d = dst + offset;
+            for (std::size_t i = 0; i < stream.VertexAmount; ++i, src += N, d += stride)
+                std::memcpy(d, src, N);
+        };
 
-            glDeleteBuffers(1, &EBOId);
-            EBOId = 0;
+        switch (stream.ElementBytes)
+        {
+        case 4:
+            copyElements(std::integral_constant<std::size_t, 4>());
+            break;
+        case 8:
+            copyElements(std::integral_constant<std::size_t, 8>());
+            break;
+        case 12:
+            copyElements(std::integral_constant<std::size_t, 12>());
+            break;
+        case 16:
+            copyElements(std::integral_constant<std::size_t, 16>());
+            break;
+        default:
+        {
+            const std::byte* src = stream.Data;
+            std::byte* d = dst + offset;
+            for (std::size_t i = 0; i < stream.VertexAmount; ++i, src += stream.ElementBytes, d += stride)
+                std::memcpy(d, src, stream.ElementBytes);
+            break;
         }
+        }
+    }
+
+    void Mesh::Clear()
+    {
+        GeometryPool::GetInstance().Free(geometry);
+        geometry = {};
     }
 
     GLint Mesh::GetMaxAttributeAmount()
     {
         if (maxAttributeAmount < 0)
         {
-            glGetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributeAmount);
+            Device::IDevice::Current().GetIntegerv(GL_MAX_VERTEX_ATTRIBS, &maxAttributeAmount);
         }
 
         return maxAttributeAmount;
@@ -0,0 +1,181 @@
+#include "graphics/MeshCompression.h"
+
+#include "glm/gtc/packing.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+namespace RyuRenderer::Graphics
+{
+    std::size_t MeshCompressionStats::GetSourceBytes() const
+    {
+        return SourceVertexBytes + SourceIndexBytes;
+    }
+
+    std::size_t MeshCompressionStats::GetBytes() const
+    {
+        return VertexBytes + IndexBytes;
+    }
+
+    std::size_t MeshCompressionStats::GetSavedBytes() const
+    {
+        return GetSourceBytes() > GetBytes() ? GetSourceBytes() - GetBytes() : 0;
+    }
+
+    double MeshCompressionStats::GetSavedRatio() const
+    {
+        return GetSourceBytes() > 0 ? static_cast<double>(GetSavedBytes()) / GetSourceBytes() : 0.0;
+    }
+
+    MeshCompressionStats& MeshCompressionStats::operator+=(const MeshCompressionStats& other)
+    {
+        SourceVertexBytes += other.SourceVertexBytes;
+        SourceIndexBytes += other.SourceIndexBytes;
+        VertexBytes += other.VertexBytes;
+        IndexBytes += other.IndexBytes;
+        return *this;
+    }
+
+    namespace MeshCompression
+    {
+        static short EncodeSnorm16(float value)
+        {
+            return static_cast<short>(glm::packSnorm1x16(value));
+        }
+
+        static float DecodeSnorm16(short value)
+        {
+            return glm::unpackSnorm1x16(static_cast<glm::uint16>(value));
+        }
+
+        static float SignNotZero(float value)
+        {
+            return value >= 0.f ? 1.f : -1.f;
+        }
+
+        std::array<short, 2> EncodeOctahedral(const glm::vec3& normal)
+        {
+            // Project onto the octahedron, then fold the lower half over the diagonals
+            const float l1 = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+            if (l1 <= 0.f)
+                return { 0, 0 };
+
+            glm::vec2 e = glm::vec2(normal.x, normal.y) / l1;
+            if (normal.z < 0.f)
+            {
+                e = glm::vec2(
+                    (1.f - std::abs(e.y)) * SignNotZero(e.x),
+                    (1.f - std::abs(e.x)) * SignNotZero(e.y));
+            }
+            return { EncodeSnorm16(e.x), EncodeSnorm16(e.y) };
+        }
+
+        glm::vec3 DecodeOctahedral(const std::array<short, 2>& encoded)
+        {
+            // Same steps as DecodeOctahedral in 3d-blinn-phong-material.vert
+            glm::vec3 n(DecodeSnorm16(encoded[0]), DecodeSnorm16(encoded[1]), 0.f);
+            n.z = 1.f - std::abs(n.x) - std::abs(n.y);
+            const float t = std::max(-n.z, 0.f);
+            n.x += n.x >= 0.f ? -t : t;
+            n.y += n.y >= 0.f ? -t : t;
+            return glm::normalize(n);
+        }
+
+        HalfFloat EncodeHalf(float value)
+        {
+            return { glm::packHalf1x16(value) };
+        }
+
+        Mesh CreateMesh(
+            std::span<const GLuint> indices,
+            std::span<const std::array<float, 3>> positions,
+            std::span<const std::array<float, 3>> normals,
+            std::span<const std::array<float, 2>> texCoords,
+            const MeshCompressionSettings& settings,
+            MeshCompressionStats* stats)
+        {
+            const std::size_t vertexAmount = positions.size();
+            if (normals.size() != vertexAmount || texCoords.size() != vertexAmount)
+            {
+                std::cerr << "All vertex data in vector must have the same size." << std::endl;
+                return Mesh();
+            }
+
+            std::vector<std::array<short, 2>> encodedNormals(vertexAmount);
+            std::vector<std::array<HalfFloat, 2>> encodedTexCoords(vertexAmount);
+            for (std::size_t i = 0; i < vertexAmount; ++i)
+            {
+                encodedNormals[i] = EncodeOctahedral(glm::vec3(normals[i][0], normals[i][1], normals[i][2]));
+                encodedTexCoords[i] = { EncodeHalf(texCoords[i][0]), EncodeHalf(texCoords[i][1]) };
+            }
+
+            // Indices which fit are narrowed once, both widths share the rest of the path
+            const bool isIndexNarrowed =
+                settings.IsIndexNarrowed && vertexAmount <= static_cast<std::size_t>(std::numeric_limits<GLushort>::max()) + 1;
+            std::vector<GLushort> narrowIndices;
+            if (isIndexNarrowed)
+                narrowIndices.assign(indices.begin(), indices.end());
+
+            auto createMesh = [&](auto vertexLayout, const auto& encodedPositions) -> Mesh
+            {
+                if (isIndexNarrowed)
+                    return Mesh(vertexLayout, std::span<const GLushort>(narrowIndices), encodedPositions, encodedNormals, encodedTexCoords);
+                return Mesh(vertexLayout, indices, encodedPositions, encodedNormals, encodedTexCoords);
+            };
+
+            Mesh mesh;
+            Mesh::VertexDecode decode;
+            decode.IsNormalOctahedral = true;
+            std::size_t vertexBytes = 0;
+            if (settings.IsPositionQuantized)
+            {
+                glm::vec3 minPos(std::numeric_limits<float>::max());
+                glm::vec3 maxPos(std::numeric_limits<float>::lowest());
+                for (const auto& p : positions)
+                {
+                    minPos = glm::min(minPos, glm::vec3(p[0], p[1], p[2]));
+                    maxPos = glm::max(maxPos, glm::vec3(p[0], p[1], p[2]));
+                }
+
+                // Flat axes keep a unit extent, their only value maps to 0
+                glm::vec3 extent = maxPos - minPos;
+                extent = glm::vec3(
+                    extent.x > 0.f ? extent.x : 1.f,
+                    extent.y > 0.f ? extent.y : 1.f,
+                    extent.z > 0.f ? extent.z : 1.f);
+
+                std::vector<std::array<unsigned short, 4>> quantizedPositions(vertexAmount);
+                for (std::size_t i = 0; i < vertexAmount; ++i)
+                {
+                    const glm::vec3 t = (glm::vec3(positions[i][0], positions[i][1], positions[i][2]) - minPos) / extent;
+                    quantizedPositions[i] = {
+                        glm::packUnorm1x16(t.x), glm::packUnorm1x16(t.y), glm::packUnorm1x16(t.z), 0 };
+                }
+
+                decode.PositionOffset = minPos;
+                decode.PositionScale = extent;
+                mesh = createMesh(QuantizedVertexLayout(), quantizedPositions);
+                vertexBytes = QuantizedVertexLayout::Stride;
+            }
+            else
+            {
+                mesh = createMesh(CompressedVertexLayout(), positions);
+                vertexBytes = CompressedVertexLayout::Stride;
+            }
+            mesh.SetVertexDecode(decode);
+            mesh.SetBounds(Bounds::FromPositions(positions));
+
+            if (stats)
+            {
+                stats->SourceVertexBytes = vertexAmount * (sizeof(std::array<float, 3>) * 2 + sizeof(std::array<float, 2>));
+                stats->SourceIndexBytes = indices.size() * sizeof(GLuint);
+                stats->VertexBytes = vertexAmount * vertexBytes;
+                stats->IndexBytes = indices.size() * (isIndexNarrowed ? sizeof(GLushort) : sizeof(GLuint));
+            }
+            return mesh;
+        }
+    }
+}
\ No newline at end of file
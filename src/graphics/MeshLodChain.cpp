@@ -0,0 +1,12 @@
+#include "graphics/MeshLodChain.h"
+
+namespace RyuRenderer::Graphics
+{
+    std::size_t MeshLodChain::SelectLevel(float maxError) const
+    {
+        std::size_t levelIdx = 0;
+        while (levelIdx + 1 < Levels.size() && levelIdx + 1 < Errors.size() && Errors[levelIdx + 1] <= maxError)
+            ++levelIdx;
+        return levelIdx;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,335 @@
+#include "graphics/MeshOptimizer.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+
+namespace RyuRenderer::Graphics::MeshOptimizer
+{
+    // FIFO cache of vertex transforms: a vertex is cached while less than cacheSize misses happened since its own
+    class CacheSimulation
+    {
+    public:
+        CacheSimulation(std::size_t vertexAmount, GLuint cacheSize) :
+            insertTimes(vertexAmount, 0),
+            timestamp(cacheSize + 1),
+            cacheSize(cacheSize)
+        {
+        }
+
+        // True on a miss, the vertex is transformed and enters the cache
+        bool Access(GLuint v)
+        {
+            if (timestamp - insertTimes[v] <= cacheSize)
+                return false;
+
+            insertTimes[v] = timestamp++;
+            return true;
+        }
+
+        void Flush()
+        {
+            timestamp += cacheSize + 1;
+        }
+
+        GLuint GetAge(GLuint v) const
+        {
+            return timestamp - insertTimes[v];
+        }
+    private:
+        std::vector<GLuint> insertTimes;
+        GLuint timestamp = 0;
+        GLuint cacheSize = 0;
+    };
+
+    VertexCacheStats AnalyzeVertexCache(std::span<const GLuint> indices, std::size_t vertexAmount, GLuint cacheSize)
+    {
+        VertexCacheStats stats;
+        if (indices.size() < 3 || vertexAmount == 0)
+            return stats;
+
+        CacheSimulation cache(vertexAmount, cacheSize);
+        std::vector<bool> isReferenced(vertexAmount, false);
+        std::size_t referencedAmount = 0;
+        std::size_t missAmount = 0;
+        for (const GLuint v : indices)
+        {
+            if (cache.Access(v))
+                ++missAmount;
+            if (!isReferenced[v])
+            {
+                isReferenced[v] = true;
+                ++referencedAmount;
+            }
+        }
+
+        stats.ACMR = static_cast<double>(missAmount) / (indices.size() / 3);
+        stats.ATVR = static_cast<double>(missAmount) / referencedAmount;
+        return stats;
+    }
+
+    std::size_t GenerateWeldRemap(std::span<const StreamView> streams, std::size_t vertexAmount, std::vector<GLuint>& remap)
+    {
+        remap.assign(vertexAmount, InvalidIdx);
+
+        auto hashVertex = [&streams](std::size_t v)
+        {
+            // FNV-1a over the bytes of the vertex in every stream
+            uint64_t hash = 14695981039346656037ull;
+            for (const auto& s : streams)
+            {
+                const auto* bytes = static_cast<const unsigned char*>(s.Data) + v * s.Stride;
+                for (std::size_t i = 0; i < s.Stride; ++i)
+                    hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+            return hash;
+        };
+        auto isEqual = [&streams](std::size_t a, std::size_t b)
+        {
+            for (const auto& s : streams)
+            {
+                const auto* bytes = static_cast<const unsigned char*>(s.Data);
+                if (std::memcmp(bytes + a * s.Stride, bytes + b * s.Stride, s.Stride) != 0)
+                    return false;
+            }
+            return true;
+        };
+
+        // Open addressing with linear probing, at most half full
+        std::size_t tableSize = 16;
+        while (tableSize < vertexAmount * 2)
+            tableSize *= 2;
+        std::vector<GLuint> table(tableSize, InvalidIdx);
+
+        std::size_t uniqueAmount = 0;
+        for (std::size_t v = 0; v < vertexAmount; ++v)
+        {
+            std::size_t slot = hashVertex(v) & (tableSize - 1);
+            while (table[slot] != InvalidIdx && !isEqual(table[slot], v))
+                slot = (slot + 1) & (tableSize - 1);
+
+            if (table[slot] == InvalidIdx)
+            {
+                table[slot] = static_cast<GLuint>(v);
+                remap[v] = static_cast<GLuint>(uniqueAmount++);
+            }
+            else
+            {
+                remap[v] = remap[table[slot]];
+            }
+        }
+        return uniqueAmount;
+    }
+
+    void OptimizeVertexCache(std::span<GLuint> indices, std::size_t vertexAmount, GLuint cacheSize)
+    {
+        const std::size_t triangleAmount = indices.size() / 3;
+        if (triangleAmount == 0 || vertexAmount == 0)
+            return;
+
+        // Triangles around each vertex, liveAmounts counts the ones not emitted yet
+        std::vector<GLuint> liveAmounts(vertexAmount, 0);
+        for (const GLuint v : indices)
+            ++liveAmounts[v];
+        std::vector<std::size_t> adjacencyOffsets(vertexAmount + 1, 0);
+        std::inclusive_scan(liveAmounts.begin(), liveAmounts.end(), adjacencyOffsets.begin() + 1, std::plus<>(), std::size_t(0));
+        std::vector<GLuint> adjacency(indices.size());
+        {
+            std::vector<std::size_t> cursors(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (std::size_t i = 0; i < indices.size(); ++i)
+                adjacency[cursors[indices[i]]++] = static_cast<GLuint>(i / 3);
+        }
+
+        CacheSimulation cache(vertexAmount, cacheSize);
+        std::vector<bool> isEmitted(triangleAmount, false);
+        std::vector<GLuint> deadEndStack;
+        deadEndStack.reserve(indices.size());
+        std::vector<GLuint> candidates;
+        std::vector<GLuint> result;
+        result.reserve(indices.size());
+
+        std::size_t scanCursor = 0;
+        auto skipDeadEnd = [&]() -> GLuint
+        {
+            // Recently used vertices first, then the next vertex in input order with triangles left
+            while (!deadEndStack.empty())
+            {
+                const GLuint v = deadEndStack.back();
+                deadEndStack.pop_back();
+                if (liveAmounts[v] > 0)
+                    return v;
+            }
+            for (; scanCursor < vertexAmount; ++scanCursor)
+            {
+                if (liveAmounts[scanCursor] > 0)
+                    return static_cast<GLuint>(scanCursor);
+            }
+            return InvalidIdx;
+        };
+
+        GLuint fanningVertex = skipDeadEnd();
+        while (fanningVertex != InvalidIdx)
+        {
+            candidates.clear();
+            for (std::size_t i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; ++i)
+            {
+                const GLuint t = adjacency[i];
+                if (isEmitted[t])
+                    continue;
+
+                isEmitted[t] = true;
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    const GLuint v = indices[t * 3 + j];
+                    result.emplace_back(v);
+                    deadEndStack.emplace_back(v);
+                    candidates.emplace_back(v);
+                    --liveAmounts[v];
+                    cache.Access(v);
+                }
+            }
+
+            // Oldest candidate which stays in the cache while its remaining triangles are fanned
+            GLuint next = InvalidIdx;
+            long long nextPriority = -1;
+            for (const GLuint v : candidates)
+            {
+                if (liveAmounts[v] == 0)
+                    continue;
+
+                long long priority = 0;
+                if (cache.GetAge(v) + 2ull * liveAmounts[v] <= cacheSize)
+                    priority = cache.GetAge(v);
+                if (priority > nextPriority)
+                {
+                    next = v;
+                    nextPriority = priority;
+                }
+            }
+            fanningVertex = next != InvalidIdx ? next : skipDeadEnd();
+        }
+
+        std::copy(result.begin(), result.end(), indices.begin());
+    }
+
+    void OptimizeOverdraw(
+        std::span<GLuint> indices, std::span<const std::array<float, 3>> positions, GLuint cacheSize, float threshold)
+    {
+        const std::size_t triangleAmount = indices.size() / 3;
+        if (triangleAmount == 0 || positions.empty())
+            return;
+
+        // Hard boundaries at triangles missing all vertices, nothing before them is reused there
+        CacheSimulation cache(positions.size(), cacheSize);
+        std::vector<std::size_t> hardStarts;
+        std::size_t missAmount = 0;
+        for (std::size_t t = 0; t < triangleAmount; ++t)
+        {
+            std::size_t triangleMissAmount = 0;
+            for (std::size_t j = 0; j < 3; ++j)
+                triangleMissAmount += cache.Access(indices[t * 3 + j]) ? 1 : 0;
+            if (t == 0 || triangleMissAmount == 3)
+                hardStarts.emplace_back(t);
+            missAmount += triangleMissAmount;
+        }
+        hardStarts.emplace_back(triangleAmount);
+        const double meshAcmr = static_cast<double>(missAmount) / triangleAmount;
+
+        // Soft boundaries once a cluster is cheap enough on its own, each cluster starts with an empty cache
+        std::vector<std::size_t> clusterStarts;
+        for (std::size_t c = 0; c + 1 < hardStarts.size(); ++c)
+        {
+            const std::size_t end = hardStarts[c + 1];
+            cache.Flush();
+            clusterStarts.emplace_back(hardStarts[c]);
+            std::size_t clusterMissAmount = 0;
+            std::size_t clusterTriangleAmount = 0;
+            for (std::size_t t = hardStarts[c]; t < end; ++t)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                    clusterMissAmount += cache.Access(indices[t * 3 + j]) ? 1 : 0;
+                ++clusterTriangleAmount;
+
+                if (t + 1 < end && clusterMissAmount <= threshold * meshAcmr * clusterTriangleAmount)
+                {
+                    cache.Flush();
+                    clusterStarts.emplace_back(t + 1);
+                    clusterMissAmount = 0;
+                    clusterTriangleAmount = 0;
+                }
+            }
+        }
+        clusterStarts.emplace_back(triangleAmount);
+
+        // Area weighted centroid and normal of every cluster and of the whole mesh
+        const std::size_t clusterAmount = clusterStarts.size() - 1;
+        std::vector<glm::vec3> clusterCentroids(clusterAmount, glm::vec3(0.f));
+        std::vector<glm::vec3> clusterNormals(clusterAmount, glm::vec3(0.f));
+        glm::vec3 meshCentroid(0.f);
+        float meshArea = 0.f;
+        for (std::size_t c = 0; c < clusterAmount; ++c)
+        {
+            float clusterArea = 0.f;
+            for (std::size_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t)
+            {
+                const auto& a = positions[indices[t * 3]];
+                const auto& b = positions[indices[t * 3 + 1]];
+                const auto& d = positions[indices[t * 3 + 2]];
+                const glm::vec3 p0(a[0], a[1], a[2]);
+                const glm::vec3 p1(b[0], b[1], b[2]);
+                const glm::vec3 p2(d[0], d[1], d[2]);
+                const glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+                const float area = glm::length(n);
+                clusterCentroids[c] += (p0 + p1 + p2) * (area / 3.f);
+                clusterNormals[c] += n;
+                clusterArea += area;
+            }
+            meshCentroid += clusterCentroids[c];
+            meshArea += clusterArea;
+            if (clusterArea > 0.f)
+                clusterCentroids[c] /= clusterArea;
+        }
+        if (meshArea > 0.f)
+            meshCentroid /= meshArea;
+
+        // Clusters facing away from the mesh center are in front of the rest from most directions
+        std::vector<float> sortKeys(clusterAmount, 0.f);
+        for (std::size_t c = 0; c < clusterAmount; ++c)
+        {
+            const float normalLength = glm::length(clusterNormals[c]);
+            if (normalLength > 0.f)
+                sortKeys[c] = glm::dot(clusterCentroids[c] - meshCentroid, clusterNormals[c] / normalLength);
+        }
+        std::vector<std::size_t> clusterOrder(clusterAmount);
+        std::iota(clusterOrder.begin(), clusterOrder.end(), std::size_t(0));
+        std::stable_sort(clusterOrder.begin(), clusterOrder.end(),
+            [&sortKeys](std::size_t a, std::size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+        std::vector<GLuint> result;
+        result.reserve(indices.size());
+        for (const std::size_t c : clusterOrder)
+            result.insert(result.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+        std::copy(result.begin(), result.end(), indices.begin());
+    }
+
+    std::size_t GenerateFetchRemap(std::span<const GLuint> indices, std::size_t vertexAmount, std::vector<GLuint>& remap)
+    {
+        remap.assign(vertexAmount, InvalidIdx);
+        std::size_t usedAmount = 0;
+        for (const GLuint v : indices)
+        {
+            if (remap[v] == InvalidIdx)
+                remap[v] = static_cast<GLuint>(usedAmount++);
+        }
+        return usedAmount;
+    }
+
+    void RemapIndices(std::span<GLuint> indices, std::span<const GLuint> remap)
+    {
+        for (auto& v : indices)
+            v = remap[v];
+    }
+}
\ No newline at end of file
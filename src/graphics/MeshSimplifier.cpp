@@ -0,0 +1,313 @@
+#include "graphics/MeshSimplifier.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+
+#include "graphics/MeshOptimizer.h"
+
+namespace RyuRenderer::Graphics::MeshSimplifier
+{
+    // Area weighted sum of squared distances to triangle planes, Q(p) = p^T A p + 2 B p + C
+    struct Quadric
+    {
+        double A00 = 0.0, A01 = 0.0, A02 = 0.0, A11 = 0.0, A12 = 0.0, A22 = 0.0;
+        double B0 = 0.0, B1 = 0.0, B2 = 0.0;
+        double C = 0.0;
+        double Weight = 0.0;
+
+        void AddPlane(const glm::dvec3& n, double d, double weight)
+        {
+            A00 += weight * n.x * n.x;
+            A01 += weight * n.x * n.y;
+            A02 += weight * n.x * n.z;
+            A11 += weight * n.y * n.y;
+            A12 += weight * n.y * n.z;
+            A22 += weight * n.z * n.z;
+            B0 += weight * n.x * d;
+            B1 += weight * n.y * d;
+            B2 += weight * n.z * d;
+            C += weight * d * d;
+            Weight += weight;
+        }
+
+        Quadric& operator+=(const Quadric& other)
+        {
+            A00 += other.A00;
+            A01 += other.A01;
+            A02 += other.A02;
+            A11 += other.A11;
+            A12 += other.A12;
+            A22 += other.A22;
+            B0 += other.B0;
+            B1 += other.B1;
+            B2 += other.B2;
+            C += other.C;
+            Weight += other.Weight;
+            return *this;
+        }
+
+        // Mean squared distance, so errors of large and small meshes compare in object space units
+        double Evaluate(const glm::dvec3& p) const
+        {
+            if (Weight <= 0.0)
+                return 0.0;
+
+            const double e =
+                A00 * p.x * p.x + A11 * p.y * p.y + A22 * p.z * p.z +
+                2.0 * (A01 * p.x * p.y + A02 * p.x * p.z + A12 * p.y * p.z) +
+                2.0 * (B0 * p.x + B1 * p.y + B2 * p.z) + C;
+            return std::max(e, 0.0) / Weight;
+        }
+    };
+
+    struct Collapse
+    {
+        double Cost = 0.0;
+        GLuint From = 0;
+        GLuint To = 0;
+        uint32_t FromVersion = 0;
+        uint32_t ToVersion = 0;
+
+        // Ties are broken by the vertex indices, so the order never depends on the heap internals
+        bool operator>(const Collapse& other) const
+        {
+            if (Cost != other.Cost)
+                return Cost > other.Cost;
+            if (From != other.From)
+                return From > other.From;
+            return To > other.To;
+        }
+    };
+
+    static glm::dvec3 ToDVec3(const std::array<float, 3>& p)
+    {
+        return glm::dvec3(p[0], p[1], p[2]);
+    }
+
+    float GetExtent(std::span<const GLuint> indices, std::span<const std::array<float, 3>> positions)
+    {
+        if (indices.empty())
+            return 0.f;
+
+        glm::vec3 minPos(std::numeric_limits<float>::max());
+        glm::vec3 maxPos(std::numeric_limits<float>::lowest());
+        for (const GLuint v : indices)
+        {
+            const glm::vec3 p(positions[v][0], positions[v][1], positions[v][2]);
+            minPos = glm::min(minPos, p);
+            maxPos = glm::max(maxPos, p);
+        }
+        return glm::length(maxPos - minPos);
+    }
+
+    float Simplify(
+        std::span<const GLuint> indices, std::span<const std::array<float, 3>> positions,
+        std::size_t targetIndexAmount, float maxError, std::vector<GLuint>& result)
+    {
+        result.assign(indices.begin(), indices.end());
+        const std::size_t vertexAmount = positions.size();
+        const std::size_t triangleAmount = indices.size() / 3;
+        if (triangleAmount == 0 || targetIndexAmount >= indices.size())
+            return 0.f;
+
+        // Vertices sharing a position are one point of the surface, the others only differ in attributes
+        std::vector<GLuint> pointIdxs;
+        const MeshOptimizer::StreamView positionStream{ positions.data(), sizeof(positions[0]) };
+        const std::size_t pointAmount = MeshOptimizer::GenerateWeldRemap(
+            std::span<const MeshOptimizer::StreamView>(&positionStream, 1), vertexAmount, pointIdxs);
+
+        // Points on seams, open borders and non-manifold edges keep their place
+        std::vector<GLuint> pointVertexAmounts(pointAmount, 0);
+        {
+            std::vector<bool> isVertexCounted(vertexAmount, false);
+            for (const GLuint v : indices)
+            {
+                if (isVertexCounted[v])
+                    continue;
+                isVertexCounted[v] = true;
+                ++pointVertexAmounts[pointIdxs[v]];
+            }
+        }
+        std::vector<bool> isPointLocked(pointAmount, false);
+        for (std::size_t p = 0; p < pointAmount; ++p)
+            isPointLocked[p] = pointVertexAmounts[p] > 1;
+        {
+            std::unordered_map<uint64_t, GLuint> edgeUseAmounts;
+            edgeUseAmounts.reserve(indices.size());
+            for (std::size_t t = 0; t < triangleAmount; ++t)
+            {
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    const GLuint a = pointIdxs[indices[t * 3 + j]];
+                    const GLuint b = pointIdxs[indices[t * 3 + (j + 1) % 3]];
+                    ++edgeUseAmounts[(static_cast<uint64_t>(std::min(a, b)) << 32) | std::max(a, b)];
+                }
+            }
+            for (const auto& [edge, useAmount] : edgeUseAmounts)
+            {
+                if (useAmount == 2)
+                    continue;
+                isPointLocked[static_cast<GLuint>(edge >> 32)] = true;
+                isPointLocked[static_cast<GLuint>(edge & 0xffffffffu)] = true;
+            }
+        }
+        auto isLocked = [&](GLuint v) { return isPointLocked[pointIdxs[v]]; };
+
+        std::vector<Quadric> quadrics(vertexAmount);
+        std::vector<std::vector<GLuint>> vertexTriangles(vertexAmount);
+        for (std::size_t t = 0; t < triangleAmount; ++t)
+        {
+            const GLuint* tri = &result[t * 3];
+            const glm::dvec3 p0 = ToDVec3(positions[tri[0]]);
+            const glm::dvec3 n = glm::cross(ToDVec3(positions[tri[1]]) - p0, ToDVec3(positions[tri[2]]) - p0);
+            const double length = glm::length(n);
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                vertexTriangles[tri[j]].emplace_back(static_cast<GLuint>(t));
+                if (length > 0.0)
+                    quadrics[tri[j]].AddPlane(n / length, -glm::dot(n / length, p0), length * 0.5);
+            }
+        }
+
+        std::vector<bool> isTriangleRemoved(triangleAmount, false);
+        std::vector<uint32_t> versions(vertexAmount, 0);
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+        auto pushCollapse = [&](GLuint from, GLuint to)
+        {
+            if (isLocked(from))
+                return;
+
+            Quadric q = quadrics[from];
+            q += quadrics[to];
+            collapses.push({ q.Evaluate(ToDVec3(positions[to])), from, to, versions[from], versions[to] });
+        };
+        for (std::size_t t = 0; t < triangleAmount; ++t)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+                pushCollapse(result[t * 3 + j], result[t * 3 + (j + 1) % 3]);
+        }
+
+        // Neighbours of a vertex through its live triangles, sorted and unique
+        auto gatherNeighbours = [&](GLuint v, std::vector<GLuint>& neighbours)
+        {
+            neighbours.clear();
+            for (const GLuint t : vertexTriangles[v])
+            {
+                if (isTriangleRemoved[t])
+                    continue;
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    if (result[t * 3 + j] != v)
+                        neighbours.emplace_back(result[t * 3 + j]);
+                }
+            }
+            std::sort(neighbours.begin(), neighbours.end());
+            neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        };
+
+        const double maxCost = static_cast<double>(maxError) * maxError;
+        double resultCost = 0.0;
+        std::size_t liveTriangleAmount = triangleAmount;
+        std::vector<GLuint> fromNeighbours;
+        std::vector<GLuint> toNeighbours;
+        std::vector<GLuint> commonNeighbours;
+        while (liveTriangleAmount * 3 > targetIndexAmount && !collapses.empty())
+        {
+            const Collapse c = collapses.top();
+            collapses.pop();
+            if (versions[c.From] != c.FromVersion || versions[c.To] != c.ToVersion)
+                continue;
+            if (c.Cost > maxCost)
+                break;
+
+            // Link condition, an interior edge shares exactly its two opposite vertices, anything else would fold the surface
+            gatherNeighbours(c.From, fromNeighbours);
+            gatherNeighbours(c.To, toNeighbours);
+            commonNeighbours.clear();
+            std::set_intersection(
+                fromNeighbours.begin(), fromNeighbours.end(), toNeighbours.begin(), toNeighbours.end(),
+                std::back_inserter(commonNeighbours));
+            if (!std::binary_search(fromNeighbours.begin(), fromNeighbours.end(), c.To) || commonNeighbours.size() != 2)
+                continue;
+
+            // Triangles which stay must not flip
+            bool isFlipping = false;
+            const glm::dvec3 toPos = ToDVec3(positions[c.To]);
+            for (const GLuint t : vertexTriangles[c.From])
+            {
+                const GLuint* tri = &result[t * 3];
+                if (isTriangleRemoved[t] || tri[0] == c.To || tri[1] == c.To || tri[2] == c.To)
+                    continue;
+
+                std::array<glm::dvec3, 3> p = { ToDVec3(positions[tri[0]]), ToDVec3(positions[tri[1]]), ToDVec3(positions[tri[2]]) };
+                const glm::dvec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    if (tri[j] == c.From)
+                        p[j] = toPos;
+                }
+                const glm::dvec3 after = glm::cross(p[1] - p[0], p[2] - p[0]);
+                if (glm::dot(before, after) <= 0.0)
+                {
+                    isFlipping = true;
+                    break;
+                }
+            }
+            if (isFlipping)
+                continue;
+
+            for (const GLuint t : vertexTriangles[c.From])
+            {
+                GLuint* tri = &result[t * 3];
+                if (isTriangleRemoved[t])
+                    continue;
+
+                if (tri[0] == c.To || tri[1] == c.To || tri[2] == c.To)
+                {
+                    isTriangleRemoved[t] = true;
+                    --liveTriangleAmount;
+                    continue;
+                }
+                for (std::size_t j = 0; j < 3; ++j)
+                {
+                    if (tri[j] == c.From)
+                        tri[j] = c.To;
+                }
+                vertexTriangles[c.To].emplace_back(t);
+            }
+            vertexTriangles[c.From].clear();
+            quadrics[c.To] += quadrics[c.From];
+            ++versions[c.From];
+            ++versions[c.To];
+            resultCost = std::max(resultCost, c.Cost);
+
+            // Every collapse touching the target changed its cost
+            std::erase_if(vertexTriangles[c.To], [&isTriangleRemoved](GLuint t) { return isTriangleRemoved[t]; });
+            gatherNeighbours(c.To, toNeighbours);
+            for (const GLuint n : toNeighbours)
+            {
+                pushCollapse(c.To, n);
+                pushCollapse(n, c.To);
+            }
+        }
+
+        std::size_t resultIndexAmount = 0;
+        for (std::size_t t = 0; t < triangleAmount; ++t)
+        {
+            if (isTriangleRemoved[t])
+                continue;
+            for (std::size_t j = 0; j < 3; ++j)
+                result[resultIndexAmount++] = result[t * 3 + j];
+        }
+        result.resize(resultIndexAmount);
+        return static_cast<float>(std::sqrt(resultCost));
+    }
+}
\ No newline at end of file
@@ -4,16 +4,27 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string_view>
 
 #include "common/FileUtils.h"
+#include "common/Profiler.h"
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
 
 namespace RyuRenderer::Graphics
 {
     Shader::Shader(const std::string& vertexShaderFilePath, const std::string& fragmentShaderFilePath)
     {
+        RYU_PROFILE_ZONE("Shader::Shader");
+
+        auto& device = Device::IDevice::Current();
+
         GLuint vs = 0;
         GLuint fs = 0;
 
@@ -40,34 +51,44 @@ namespace RyuRenderer::Graphics
             return;
         }
 
-        programId = glCreateProgram();
-        glAttachShader(programId, vs);
-        glAttachShader(programId, fs);
-        glLinkProgram(programId);
+        programId = device.CreateProgram();
+        device.AttachShader(programId, vs);
+        device.AttachShader(programId, fs);
+        device.LinkProgram(programId);
 
         int success = 0;
-        glGetProgramiv(programId, GL_LINK_STATUS, &success);
+        device.GetProgramiv(programId, GL_LINK_STATUS, &success);
         if (!success)
         {
             constexpr int errlogLen = 4096;
             char errLog[errlogLen];
-            glGetProgramInfoLog(programId, 4096, NULL, errLog);
+            device.GetProgramInfoLog(programId, 4096, NULL, errLog);
             std::cerr << "ERROR: shader program (vs: \"" << vertexShaderFilePath << "\",fs: \"" << fragmentShaderFilePath << "\") linking failed!\n" << errLog << std::endl;
-            glDeleteProgram(programId);
+            device.DeleteProgram(programId);
             programId = 0;
         }
+        else
+        {
+            ReflectUniforms();
+            ReflectVertexInputs();
+        }
 
-        glDeleteShader(vs);
-        glDeleteShader(fs);
+        device.DeleteShader(vs);
+        device.DeleteShader(fs);
         vertexSource = vertexShaderFilePath;
         fragmentSource = fragmentShaderFilePath;
     }
 
     Shader::Shader(const std::string& localGPUBinaryFilePath)
     {
+        RYU_PROFILE_ZONE("Shader::Shader");
+
         if (!LoadShaderByLocalGPUBinaryFile(localGPUBinaryFilePath, programId))
             return;
 
+        ReflectUniforms();
+        ReflectVertexInputs();
+
         binarySource = localGPUBinaryFilePath;
     }
 
@@ -75,12 +96,18 @@ namespace RyuRenderer::Graphics
     {
         Clear();
         programId = other.programId;
-        uniformLocations = other.uniformLocations;
+        uniforms = std::move(other.uniforms);
+        uniformIdxs = std::move(other.uniformIdxs);
+        uniformShadow = std::move(other.uniformShadow);
+        vertexInputs = std::move(other.vertexInputs);
         vertexSource = other.vertexSource;
         fragmentSource = other.fragmentSource;
         binarySource = other.binarySource;
         other.programId = 0;
-        other.uniformLocations.clear();
+        other.uniforms.clear();
+        other.uniformIdxs.clear();
+        other.uniformShadow.clear();
+        other.vertexInputs.clear();
         other.vertexSource.clear();
         other.fragmentSource.clear();
         other.binarySource.clear();
@@ -98,12 +125,18 @@ namespace RyuRenderer::Graphics
 
         Clear();
         programId = other.programId;
-        uniformLocations = other.uniformLocations;
+        uniforms = std::move(other.uniforms);
+        uniformIdxs = std::move(other.uniformIdxs);
+        uniformShadow = std::move(other.uniformShadow);
+        vertexInputs = std::move(other.vertexInputs);
         vertexSource = other.vertexSource;
         fragmentSource = other.fragmentSource;
         binarySource = other.binarySource;
         other.programId = 0;
-        other.uniformLocations.clear();
+        other.uniforms.clear();
+        other.uniformIdxs.clear();
+        other.uniformShadow.clear();
+        other.vertexInputs.clear();
         other.vertexSource.clear();
         other.fragmentSource.clear();
         other.binarySource.clear();
@@ -115,255 +148,165 @@ namespace RyuRenderer::Graphics
         if (!IsValid())
             return false;
 
-        if (IsUsing())
-            return true;
-
-        glUseProgram(programId);
-        lastestUsedProgramId = programId;
+        Device::StateTracker::GetInstance().UseProgram(programId);
         return true;
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const std::vector<bool>& bools)
+    UniformHandle Shader::GetUniformHandle(std::string_view uniformName)
     {
-        if (!IsUsing())
-            return false;
+        if (!IsValid())
+            return UniformHandle();
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
+        const auto& it = uniformIdxs.find(uniformName);
+        if (it != uniformIdxs.end())
+            return uniforms[it->second].Location == -1 ? UniformHandle() : UniformHandle{ it->second };
 
-        const auto& size = bools.size();
-        if (size == 1)
-        {
-            glUniform1i(loc, bools[0]);
-            return true;
-        }
-        if (size == 2)
-        {
-            glUniform2i(loc, bools[0], bools[1]);
-            return true;
-        }
-        if (size == 3)
-        {
-            glUniform3i(loc, bools[0], bools[1], bools[2]);
-            return true;
-        }
-        if (size == 4)
-        {
-            glUniform4i(loc, bools[0], bools[1], bools[2], bools[3]);
-            return true;
-        }
-        return false;
+        // Not reflected (e.g. on the recording device), ask the driver once and remember the answer, misses included
+        UniformInfo u;
+        u.Name = uniformName;
+        u.Location = Device::IDevice::Current().GetUniformLocation(programId, u.Name.c_str());
+        if (u.Location == -1)
+            std::cerr << "Shader uniform: \"" << uniformName << "\" not found." << std::endl;
+
+        const bool isFound = u.Location != -1;
+        GLint idx = AddUniform(std::move(u));
+        return isFound ? UniformHandle{ idx } : UniformHandle();
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const std::vector<int>& ints)
+    bool Shader::SetUniform(UniformHandle handle, const glm::vec2& floats)
     {
-        if (!IsUsing())
-            return false;
-
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
+        const auto* values = glm::value_ptr(floats);
+        return UploadUniform(handle, values, sizeof(glm::vec2), [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, 2, 1, values);
+        });
+    }
 
-        const auto& size = ints.size();
-        if (size == 1)
-        {
-            glUniform1i(loc, ints[0]);
-            return true;
-        }
-        if (size == 2)
-        {
-            glUniform2i(loc, ints[0], ints[1]);
-            return true;
-        }
-        if (size == 3)
-        {
-            glUniform3i(loc, ints[0], ints[1], ints[2]);
-            return true;
-        }
-        if (size == 4)
-        {
-            glUniform4i(loc, ints[0], ints[1], ints[2], ints[3]);
-            return true;
-        }
-        return false;
+    bool Shader::SetUniform(UniformHandle handle, const glm::vec3& floats)
+    {
+        const auto* values = glm::value_ptr(floats);
+        return UploadUniform(handle, values, sizeof(glm::vec3), [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, 3, 1, values);
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const std::vector<unsigned int>& uints)
+    bool Shader::SetUniform(UniformHandle handle, const glm::vec4& floats)
     {
-        if (!IsUsing())
-            return false;
+        const auto* values = glm::value_ptr(floats);
+        return UploadUniform(handle, values, sizeof(glm::vec4), [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, 4, 1, values);
+        });
+    }
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
+    bool Shader::SetUniform(UniformHandle handle, const glm::mat2& mat)
+    {
+        const auto* values = glm::value_ptr(mat);
+        return UploadUniform(handle, values, sizeof(glm::mat2), [&](GLint loc) {
+            Device::IDevice::Current().UniformMatrixfv(loc, 2, 1, GL_FALSE, values);
+        });
+    }
 
-        const auto& size = uints.size();
-        if (size == 1)
-        {
-            glUniform1ui(loc, uints[0]);
-            return true;
-        }
-        if (size == 2)
-        {
-            glUniform2ui(loc, uints[0], uints[1]);
-            return true;
-        }
-        if (size == 3)
-        {
-            glUniform3ui(loc, uints[0], uints[1], uints[2]);
-            return true;
-        }
-        if (size == 4)
-        {
-            glUniform4ui(loc, uints[0], uints[1], uints[2], uints[3]);
-            return true;
-        }
-        return false;
+    bool Shader::SetUniform(UniformHandle handle, const glm::mat3& mat)
+    {
+        const auto* values = glm::value_ptr(mat);
+        return UploadUniform(handle, values, sizeof(glm::mat3), [&](GLint loc) {
+            Device::IDevice::Current().UniformMatrixfv(loc, 3, 1, GL_FALSE, values);
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const glm::vec2& floats)
+    bool Shader::SetUniform(UniformHandle handle, const glm::mat4& mat)
     {
-        if (!IsUsing())
-            return false;
+        const auto* values = glm::value_ptr(mat);
+        return UploadUniform(handle, values, sizeof(glm::mat4), [&](GLint loc) {
+            Device::IDevice::Current().UniformMatrixfv(loc, 4, 1, GL_FALSE, values);
+        });
+    }
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const GLint> values, GLint components)
+    {
+        if (components < 1 || components > 4 || values.size() < static_cast<std::size_t>(components))
             return false;
 
-        glUniform2f(loc, floats.x, floats.y);
-        return true;
+        const GLsizei count = static_cast<GLsizei>(values.size() / components);
+        return UploadUniform(handle, values.data(), sizeof(GLint) * components * count, [&](GLint loc) {
+            Device::IDevice::Current().Uniformiv(loc, components, count, values.data());
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const glm::vec3& floats)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const GLuint> values, GLint components)
     {
-        if (!IsUsing())
-            return false;
-
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
+        if (components < 1 || components > 4 || values.size() < static_cast<std::size_t>(components))
             return false;
 
-        glUniform3f(loc, floats.x, floats.y, floats.z);
-        return true;
+        const GLsizei count = static_cast<GLsizei>(values.size() / components);
+        return UploadUniform(handle, values.data(), sizeof(GLuint) * components * count, [&](GLint loc) {
+            Device::IDevice::Current().Uniformuiv(loc, components, count, values.data());
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const glm::vec4& floats)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const GLfloat> values, GLint components)
     {
-        if (!IsUsing())
-            return false;
-
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
+        if (components < 1 || components > 4 || values.size() < static_cast<std::size_t>(components))
             return false;
 
-        glUniform4f(loc, floats.x, floats.y, floats.z, floats.w);
-        return true;
+        const GLsizei count = static_cast<GLsizei>(values.size() / components);
+        return UploadUniform(handle, values.data(), sizeof(GLfloat) * components * count, [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, components, count, values.data());
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const std::vector<float>& floats)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const GLdouble> values, GLint components)
     {
-        if (!IsUsing())
+        if (components < 1 || components > 4 || values.size() < static_cast<std::size_t>(components))
             return false;
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
-
-        const auto& size = floats.size();
-        if (size == 1)
-        {
-            glUniform1f(loc, floats[0]);
-            return true;
-        }
-        if (size == 2)
-        {
-            glUniform2f(loc, floats[0], floats[1]);
-            return true;
-        }
-        if (size == 3)
-        {
-            glUniform3f(loc, floats[0], floats[1], floats[2]);
-            return true;
-        }
-        if (size == 4)
-        {
-            glUniform4f(loc, floats[0], floats[1], floats[2], floats[3]);
-            return true;
-        }
-        return false;
+        const GLsizei count = static_cast<GLsizei>(values.size() / components);
+        return UploadUniform(handle, values.data(), sizeof(GLdouble) * components * count, [&](GLint loc) {
+            Device::IDevice::Current().Uniformdv(loc, components, count, values.data());
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const std::vector<double>& doubles)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const glm::vec2> values)
     {
-        if (!IsUsing())
+        if (values.empty())
             return false;
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
-
-        const auto& size = doubles.size();
-        if (size == 1)
-        {
-            glUniform1d(loc, doubles[0]);
-            return true;
-        }
-        if (size == 2)
-        {
-            glUniform2d(loc, doubles[0], doubles[1]);
-            return true;
-        }
-        if (size == 3)
-        {
-            glUniform3d(loc, doubles[0], doubles[1], doubles[2]);
-            return true;
-        }
-        if (size == 4)
-        {
-            glUniform4d(loc, doubles[0], doubles[1], doubles[2], doubles[3]);
-            return true;
-        }
-        return false;
+        const GLsizei count = static_cast<GLsizei>(values.size());
+        return UploadUniform(handle, values.data(), values.size_bytes(), [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, 2, count, glm::value_ptr(values.front()));
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const glm::mat2& mat)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const glm::vec3> values)
     {
-        if (!IsUsing())
+        if (values.empty())
             return false;
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
-
-        glUniformMatrix2fv(loc, 1, GL_FALSE, glm::value_ptr(mat));
-        return true;
+        const GLsizei count = static_cast<GLsizei>(values.size());
+        return UploadUniform(handle, values.data(), values.size_bytes(), [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, 3, count, glm::value_ptr(values.front()));
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const glm::mat3& mat)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const glm::vec4> values)
     {
-        if (!IsUsing())
+        if (values.empty())
             return false;
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
-
-        glUniformMatrix3fv(loc, 1, GL_FALSE, glm::value_ptr(mat));
-        return true;
+        const GLsizei count = static_cast<GLsizei>(values.size());
+        return UploadUniform(handle, values.data(), values.size_bytes(), [&](GLint loc) {
+            Device::IDevice::Current().Uniformfv(loc, 4, count, glm::value_ptr(values.front()));
+        });
     }
 
-    bool Shader::SetUniform(const std::string& uniformName, const glm::mat4& mat)
+    bool Shader::SetUniform(UniformHandle handle, std::span<const glm::mat4> values)
     {
-        if (!IsUsing())
+        if (values.empty())
             return false;
 
-        GLint loc = GetUniformLocation(uniformName);
-        if (loc == -1)
-            return false;
-
-        glUniformMatrix4fv(loc, 1, GL_FALSE, glm::value_ptr(mat));
-        return true;
+        const GLsizei count = static_cast<GLsizei>(values.size());
+        return UploadUniform(handle, values.data(), values.size_bytes(), [&](GLint loc) {
+            Device::IDevice::Current().UniformMatrixfv(loc, 4, count, GL_FALSE, glm::value_ptr(values.front()));
+        });
     }
 
     bool Shader::SaveLocalGPUBinaryToFile(const std::string& localGPUBinaryFilePath) const
@@ -372,13 +315,13 @@ namespace RyuRenderer::Graphics
             return false;
 
         GLint bufferSize = 0;
-        glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &bufferSize);
+        Device::IDevice::Current().GetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &bufferSize);
         if (bufferSize <= 0)
             return false;
 
         GLenum format = 0;
         std::vector<std::byte> buffer(bufferSize);
-        glGetProgramBinary(programId, bufferSize, nullptr, &format, buffer.data());
+        Device::IDevice::Current().GetProgramBinary(programId, bufferSize, nullptr, &format, buffer.data());
 
         std::ofstream file(localGPUBinaryFilePath, std::ios::binary);
         if (!file.is_open())
@@ -399,23 +342,49 @@ namespace RyuRenderer::Graphics
 
     bool Shader::IsUsing() const
     {
-        if (programId == 0)
+        return Device::StateTracker::GetInstance().IsProgramUsing(programId);
+    }
+
+    bool Shader::CheckVertexFormat(const VertexFormat& format) const
+    {
+        if (!IsValid())
             return false;
 
-        if (IsCleanMode)
-        {
-            if (lastestUsedProgramId == 0)
-                return false;
+        const std::string& source = vertexSource.empty() ? binarySource : vertexSource;
 
-            return lastestUsedProgramId == programId;
+        bool isMatched = true;
+        for (const auto& input : vertexInputs)
+        {
+            if (input.Location < 0 || static_cast<GLuint>(input.Location) >= format.AttributeAmount)
+            {
+                std::cerr << "ERROR: vertex input \"" << input.Name << "\" at location " << input.Location <<
+                    " of shader \"" << source << "\" is not provided by the vertex format." << std::endl;
+                isMatched = false;
+                continue;
+            }
+
+            const auto& attribute = format.Attributes[input.Location];
+            const GLint componentAmount = GetVertexInputComponentAmount(input.Type);
+            if (componentAmount == 0)
+            {
+                std::cerr << "ERROR: vertex input \"" << input.Name << "\" of shader \"" << source <<
+                    "\" is not a float type, it can not be fed by the vertex format." << std::endl;
+                isMatched = false;
+            }
+            else if (componentAmount != attribute.ComponentAmount)
+            {
+                std::cerr << "ERROR: vertex input \"" << input.Name << "\" of shader \"" << source << "\" has " <<
+                    componentAmount << " components, the vertex format provides " << attribute.ComponentAmount << "." << std::endl;
+                isMatched = false;
+            }
         }
 
-        GLint currentProgram = 0;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &currentProgram);
-        if (currentProgram == 0)
-            return false;
+        return isMatched;
+    }
 
-        return programId == currentProgram;
+    GLuint Shader::GetId() const
+    {
+        return programId;
     }
 
     const std::string& Shader::GetVertexSource() const { return vertexSource; }
@@ -426,11 +395,14 @@ namespace RyuRenderer::Graphics
     {
         if (programId != 0)
         {
-            glDeleteProgram(programId);
+            Device::StateTracker::GetInstance().DeleteProgram(programId);
             programId = 0;
         }
 
-        uniformLocations.clear();
+        uniforms.clear();
+        uniformIdxs.clear();
+        uniformShadow.clear();
+        vertexInputs.clear();
 
         vertexSource.clear();
         fragmentSource.clear();
@@ -442,28 +414,31 @@ namespace RyuRenderer::Graphics
         GLenum shaderType,
         GLuint& outShader)
     {
+        auto& device = Device::IDevice::Current();
+
         outShader = 0;
 
-        const auto& str =
+        auto str =
             Common::FileUtils::GetInstance().ReadFileString(shaderSourceCodeFilePath);
         if (str.empty())
             return false;
+        DowngradeVersionDirective(str);
 
         const char* strC = str.c_str();
 
-        outShader = glCreateShader(shaderType);
-        glShaderSource(outShader, 1, &strC, NULL);
-        glCompileShader(outShader);
+        outShader = device.CreateShader(shaderType);
+        device.ShaderSource(outShader, 1, &strC, NULL);
+        device.CompileShader(outShader);
 
         int success = 0;
-        glGetShaderiv(outShader, GL_COMPILE_STATUS, &success);
+        device.GetShaderiv(outShader, GL_COMPILE_STATUS, &success);
         if (!success)
         {
             constexpr int errlogLen = 4096;
             char errLog[errlogLen];
-            glGetShaderInfoLog(outShader, errlogLen, NULL, errLog);
+            device.GetShaderInfoLog(outShader, errlogLen, NULL, errLog);
             std::cerr << "ERROR: shader file \"" << shaderSourceCodeFilePath << "\" compilation failed!\n" << errLog << std::endl;
-            glDeleteShader(outShader);
+            device.DeleteShader(outShader);
             return false;
         };
         return true;
@@ -475,6 +450,8 @@ namespace RyuRenderer::Graphics
         GLuint& outShader
     )
     {
+        auto& device = Device::IDevice::Current();
+
         outShader = 0;
 
         const auto& buffer =
@@ -482,19 +459,19 @@ namespace RyuRenderer::Graphics
         if (buffer.empty())
             return false;
 
-        outShader = glCreateShader(shaderType);
-        glShaderBinary(1, &outShader, GL_SHADER_BINARY_FORMAT_SPIR_V, buffer.data(), buffer.size());
-        glSpecializeShader(outShader, "main", 0, NULL, NULL);
+        outShader = device.CreateShader(shaderType);
+        device.ShaderBinary(1, &outShader, GL_SHADER_BINARY_FORMAT_SPIR_V, buffer.data(), buffer.size());
+        device.SpecializeShader(outShader, "main", 0, NULL, NULL);
 
         int success = 0;
-        glGetShaderiv(outShader, GL_COMPILE_STATUS, &success);
+        device.GetShaderiv(outShader, GL_COMPILE_STATUS, &success);
         if (!success)
         {
             constexpr int errlogLen = 4096;
             char errLog[errlogLen];
-            glGetShaderInfoLog(outShader, errlogLen, NULL, errLog);
+            device.GetShaderInfoLog(outShader, errlogLen, NULL, errLog);
             std::cerr << "ERROR: shader spv file \"" << spvFilePath << "\" compilation failed!\n" << errLog << std::endl;
-            glDeleteShader(outShader);
+            device.DeleteShader(outShader);
             return false;
         };
         return true;
@@ -505,6 +482,8 @@ namespace RyuRenderer::Graphics
         GLuint& shaderProgram
     )
     {
+        auto& device = Device::IDevice::Current();
+
         shaderProgram = 0;
 
         std::ifstream file(spvFilePath, std::ios::binary | std::ios::ate);
@@ -525,18 +504,18 @@ namespace RyuRenderer::Graphics
 
         file.close();
 
-        shaderProgram = glCreateProgram();
-        glProgramBinary(shaderProgram, format, buffer.data(), buffer.size());
+        shaderProgram = device.CreateProgram();
+        device.ProgramBinary(shaderProgram, format, buffer.data(), buffer.size());
 
         int success = 0;
-        glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+        device.GetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
         if (!success)
         {
             constexpr int errlogLen = 4096;
             char errLog[errlogLen];
-            glGetProgramInfoLog(shaderProgram, 4096, NULL, errLog);
+            device.GetProgramInfoLog(shaderProgram, 4096, NULL, errLog);
             std::cerr << "ERROR: shader program binary file: \"" << spvFilePath << "\" linking failed!\n" << errLog << std::endl;
-            glDeleteProgram(shaderProgram);
+            device.DeleteProgram(shaderProgram);
             shaderProgram = 0;
             return false;
         }
@@ -544,21 +523,217 @@ namespace RyuRenderer::Graphics
         return true;
     }
 
-    GLint Shader::GetUniformLocation(const std::string& uniformName)
+    void Shader::DowngradeVersionDirective(std::string& shaderSourceCode)
     {
-        if (!IsValid())
-            return -1;
+        // Contexts below 4.6 (e.g. Mesa llvmpipe in headless mode) reject "#version 460",
+        //     shaders without 4.6 only features still compile with the highest supported version.
+        if (maxGLSLVersion < 0)
+        {
+            GLint major = 0;
+            GLint minor = 0;
+            Device::IDevice::Current().GetIntegerv(GL_MAJOR_VERSION, &major);
+            Device::IDevice::Current().GetIntegerv(GL_MINOR_VERSION, &minor);
+            maxGLSLVersion = major * 100 + minor * 10;
+        }
+
+        constexpr std::string_view directive = "#version ";
+        auto pos = shaderSourceCode.find(directive);
+        if (pos == std::string::npos)
+            return;
+        pos += directive.size();
+
+        int version = 0;
+        size_t end = pos;
+        while (end < shaderSourceCode.size() && std::isdigit(static_cast<unsigned char>(shaderSourceCode[end])))
+            version = version * 10 + (shaderSourceCode[end++] - '0');
 
-        const auto& it = uniformLocations.find(uniformName);
-        if (it != uniformLocations.end())
+        if (maxGLSLVersion <= 0 || version <= maxGLSLVersion)
+            return;
+        shaderSourceCode.replace(pos, end - pos, std::to_string(maxGLSLVersion));
+    }
+
+    void Shader::ReflectUniforms()
+    {
+        auto& device = Device::IDevice::Current();
+
+        GLint uniformAmount = 0;
+        device.GetProgramInterfaceiv(programId, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformAmount);
+        if (uniformAmount <= 0)
+            return;
+
+        GLint maxNameLength = 0;
+        device.GetProgramInterfaceiv(programId, GL_UNIFORM, GL_MAX_NAME_LENGTH, &maxNameLength);
+        std::vector<GLchar> nameBuffer(std::max(maxNameLength, 1));
+
+        constexpr GLenum props[] = { GL_BLOCK_INDEX, GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION };
+        constexpr GLsizei propAmount = static_cast<GLsizei>(std::size(props));
+        for (GLint i = 0; i < uniformAmount; ++i)
+        {
+            GLint values[propAmount] = { -1, GL_NONE, 0, -1 };
+            device.GetProgramResourceiv(programId, GL_UNIFORM, i, propAmount, props, propAmount, nullptr, values);
+
+            // Uniform block members have no location, they are fed by UniformBuffer
+            if (values[0] != -1 || values[3] == -1)
+                continue;
+
+            GLsizei nameLength = 0;
+            device.GetProgramResourceName(programId, GL_UNIFORM, i, static_cast<GLsizei>(nameBuffer.size()), &nameLength, nameBuffer.data());
+            if (nameLength <= 0)
+                continue;
+
+            UniformInfo u;
+            u.Name.assign(nameBuffer.data(), nameLength);
+            u.Type = static_cast<GLenum>(values[1]);
+            u.ArraySize = std::max(values[2], 1);
+            u.Location = values[3];
+
+            const std::size_t shadowSize = GetUniformTypeSize(u.Type) * u.ArraySize;
+            if (shadowSize > 0)
+            {
+                u.ShadowOffset = uniformShadow.size();
+                u.ShadowSize = shadowSize;
+                uniformShadow.resize(uniformShadow.size() + shadowSize);
+            }
+
+            // Arrays are reported as "name[0]", they are also reachable by "name"
+            std::string arrayName;
+            if (u.Name.ends_with("[0]"))
+                arrayName = u.Name.substr(0, u.Name.size() - 3);
+
+            GLint idx = AddUniform(std::move(u));
+            if (!arrayName.empty())
+                uniformIdxs.try_emplace(std::move(arrayName), idx);
+        }
+    }
+
+    void Shader::ReflectVertexInputs()
+    {
+        auto& device = Device::IDevice::Current();
+
+        GLint inputAmount = 0;
+        device.GetProgramInterfaceiv(programId, GL_PROGRAM_INPUT, GL_ACTIVE_RESOURCES, &inputAmount);
+        if (inputAmount <= 0)
+            return;
+
+        GLint maxNameLength = 0;
+        device.GetProgramInterfaceiv(programId, GL_PROGRAM_INPUT, GL_MAX_NAME_LENGTH, &maxNameLength);
+        std::vector<GLchar> nameBuffer(std::max(maxNameLength, 1));
+
+        constexpr GLenum props[] = { GL_TYPE, GL_LOCATION };
+        constexpr GLsizei propAmount = static_cast<GLsizei>(std::size(props));
+        for (GLint i = 0; i < inputAmount; ++i)
+        {
+            GLint values[propAmount] = { GL_NONE, -1 };
+            device.GetProgramResourceiv(programId, GL_PROGRAM_INPUT, i, propAmount, props, propAmount, nullptr, values);
+
+            // Built-in inputs like gl_VertexID have no location
+            if (values[1] == -1)
+                continue;
+
+            GLsizei nameLength = 0;
+            device.GetProgramResourceName(programId, GL_PROGRAM_INPUT, i, static_cast<GLsizei>(nameBuffer.size()), &nameLength, nameBuffer.data());
+
+            VertexInputInfo input;
+            input.Name.assign(nameBuffer.data(), std::max(nameLength, 0));
+            input.Type = static_cast<GLenum>(values[0]);
+            input.Location = values[1];
+            vertexInputs.emplace_back(std::move(input));
+        }
+    }
+
+    GLint Shader::AddUniform(UniformInfo&& uniform)
+    {
+        GLint idx = static_cast<GLint>(uniforms.size());
+        auto [it, isInserted] = uniformIdxs.try_emplace(uniform.Name, idx);
+        if (!isInserted)
             return it->second;
 
-        GLint loc = glGetUniformLocation(programId, uniformName.c_str());
-        if (loc == -1)
-            std::cerr << "Shader uniform: \"" << uniformName << "\" not found." << std::endl;
-        else
-            uniformLocations[uniformName] = loc;
+        uniforms.emplace_back(std::move(uniform));
+        return idx;
+    }
 
-        return loc;
+    bool Shader::UpdateUniformShadow(UniformInfo& uniform, const void* data, std::size_t dataSize)
+    {
+        // Uniforms found after reflection get their shadow storage on the first upload
+        if (uniform.ShadowSize == 0)
+        {
+            uniform.ShadowOffset = uniformShadow.size();
+            uniform.ShadowSize = dataSize;
+            uniformShadow.resize(uniformShadow.size() + dataSize);
+        }
+
+        if (dataSize > uniform.ShadowSize)
+        {
+            uniform.ShadowKnownSize = 0;
+            return true;
+        }
+
+        std::byte* shadow = uniformShadow.data() + uniform.ShadowOffset;
+        if (dataSize <= uniform.ShadowKnownSize &&
+            std::memcmp(shadow, data, dataSize) == 0)
+            return false;
+
+        std::memcpy(shadow, data, dataSize);
+        uniform.ShadowKnownSize = std::max(uniform.ShadowKnownSize, dataSize);
+        return true;
+    }
+
+    std::size_t Shader::GetUniformTypeSize(GLenum type)
+    {
+        switch (type)
+        {
+        case GL_FLOAT:
+        case GL_INT:
+        case GL_UNSIGNED_INT:
+        case GL_BOOL:
+            return 4;
+        case GL_FLOAT_VEC2:
+        case GL_INT_VEC2:
+        case GL_UNSIGNED_INT_VEC2:
+        case GL_BOOL_VEC2:
+        case GL_DOUBLE:
+            return 8;
+        case GL_FLOAT_VEC3:
+        case GL_INT_VEC3:
+        case GL_UNSIGNED_INT_VEC3:
+        case GL_BOOL_VEC3:
+            return 12;
+        case GL_FLOAT_VEC4:
+        case GL_INT_VEC4:
+        case GL_UNSIGNED_INT_VEC4:
+        case GL_BOOL_VEC4:
+        case GL_DOUBLE_VEC2:
+        case GL_FLOAT_MAT2:
+            return 16;
+        case GL_DOUBLE_VEC3:
+            return 24;
+        case GL_DOUBLE_VEC4:
+            return 32;
+        case GL_FLOAT_MAT3:
+            return 36;
+        case GL_FLOAT_MAT4:
+            return 64;
+        default:
+            // Samplers, images and uncommon matrices are sized by their first upload
+            return 0;
+        }
+    }
+
+    GLint Shader::GetVertexInputComponentAmount(GLenum type)
+    {
+        switch (type)
+        {
+        case GL_FLOAT:
+            return 1;
+        case GL_FLOAT_VEC2:
+            return 2;
+        case GL_FLOAT_VEC3:
+            return 3;
+        case GL_FLOAT_VEC4:
+            return 4;
+        default:
+            // Integer and double inputs need glVertexAttribIFormat or glVertexAttribLFormat, matrices take several locations
+            return 0;
+        }
     }
 }
\ No newline at end of file
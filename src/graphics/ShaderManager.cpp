@@ -27,6 +27,22 @@ namespace RyuRenderer::Graphics::ShaderManagerImpl
         return Create(localGPUBinaryFilePath);
     }
 
+    std::shared_ptr<Shader> ShaderManagerImpl::FindOrCreate(
+        const std::string& vertexShaderFilePath,
+        const std::string& fragmentShaderFilePath,
+        const VertexFormat& expectedFormat
+    )
+    {
+        auto p = Find(vertexShaderFilePath, fragmentShaderFilePath);
+        if (p)
+            return p;
+
+        p = Create(vertexShaderFilePath, fragmentShaderFilePath);
+        if (p)
+            p->CheckVertexFormat(expectedFormat);
+        return p;
+    }
+
     bool ShaderManagerImpl::BeforeCreate(const std::string& vertexShaderFilePath, const std::string& fragmentShaderFilePath)
     {
         auto p = Find(vertexShaderFilePath, fragmentShaderFilePath);
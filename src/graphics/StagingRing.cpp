@@ -0,0 +1,181 @@
+#include "graphics/StagingRing.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics
+{
+    StagingRing::StagingRing(GLsizeiptr c)
+    {
+        if (c <= 0)
+            return;
+
+        auto& device = Device::IDevice::Current();
+
+        // Coherent, so written bytes are visible to copies issued afterwards without any flush
+        constexpr GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        device.GenBuffers(1, &id);
+        Device::StateTracker::GetInstance().BindBuffer(GL_COPY_READ_BUFFER, id);
+        device.BufferStorage(GL_COPY_READ_BUFFER, c, nullptr, flags);
+        data = static_cast<std::byte*>(device.MapBufferRange(GL_COPY_READ_BUFFER, 0, c, flags));
+        if (!data)
+        {
+            std::cerr << "Failed to map staging ring." << std::endl;
+            Clear();
+            return;
+        }
+        capacity = c;
+    }
+
+    StagingRing::StagingRing(StagingRing&& other) noexcept
+    {
+        *this = std::move(other);
+    }
+
+    StagingRing::~StagingRing()
+    {
+        Clear();
+    }
+
+    StagingRing& StagingRing::operator=(StagingRing&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        id = std::exchange(other.id, 0);
+        data = std::exchange(other.data, nullptr);
+        capacity = std::exchange(other.capacity, 0);
+        head = std::exchange(other.head, 0);
+        usedBytes = std::exchange(other.usedBytes, 0);
+        frameBytes = std::exchange(other.frameBytes, 0);
+        regions = std::move(other.regions);
+        other.regions.clear();
+        return *this;
+    }
+
+    StagingRing::Allocation StagingRing::Allocate(GLsizeiptr bytes, GLsizeiptr alignment)
+    {
+        if (!IsValid() || bytes <= 0 || bytes > capacity)
+            return {};
+
+        Retire();
+
+        GLintptr offset = (head + alignment - 1) & ~static_cast<GLintptr>(alignment - 1);
+        // Allocations never straddle the end, the tail of the ring is skipped instead
+        if (offset + bytes > capacity)
+            offset = 0;
+        const GLsizeiptr consumedBytes = offset >= head ? offset - head + bytes : capacity - head + bytes;
+        if (usedBytes + consumedBytes > capacity)
+            return {};
+
+        head = offset + bytes;
+        usedBytes += consumedBytes;
+        frameBytes += consumedBytes;
+
+        Allocation a;
+        a.Offset = offset;
+        a.Data = data + offset;
+        return a;
+    }
+
+    StagingRing::Allocation StagingRing::AllocateElements(GLsizeiptr elementBytes, size_t maxElementAmount, size_t& elementAmount)
+    {
+        elementAmount = 0;
+        if (!IsValid() || elementBytes <= 0)
+            return {};
+
+        Retire();
+        elementAmount = std::min(maxElementAmount, static_cast<size_t>((capacity - usedBytes) / elementBytes));
+        if (elementAmount == 0)
+            return {};
+
+        auto a = Allocate(static_cast<GLsizeiptr>(elementAmount) * elementBytes);
+        // The tail of the ring may be too short, the front half of the free bytes is not
+        if (!a.IsValid() && elementAmount > 1)
+        {
+            elementAmount /= 2;
+            a = Allocate(static_cast<GLsizeiptr>(elementAmount) * elementBytes);
+        }
+        if (!a.IsValid())
+            elementAmount = 0;
+        return a;
+    }
+
+    void StagingRing::EndFrame()
+    {
+        if (!IsValid())
+            return;
+
+        Retire();
+        if (frameBytes <= 0)
+            return;
+
+        Region r;
+        r.Fence = Device::IDevice::Current().FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        r.Bytes = frameBytes;
+        regions.emplace_back(r);
+        frameBytes = 0;
+    }
+
+    bool StagingRing::IsValid() const
+    {
+        return id != 0 && data;
+    }
+
+    GLuint StagingRing::GetId() const
+    {
+        return id;
+    }
+
+    GLsizeiptr StagingRing::GetCapacity() const
+    {
+        return capacity;
+    }
+
+    GLsizeiptr StagingRing::GetUsedBytes() const
+    {
+        return usedBytes;
+    }
+
+    void StagingRing::Retire()
+    {
+        auto& device = Device::IDevice::Current();
+        while (!regions.empty())
+        {
+            // Zero timeout only polls, the frame loop is never blocked
+            const GLenum result = device.ClientWaitSync(regions.front().Fence, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+                break;
+
+            device.DeleteSync(regions.front().Fence);
+            usedBytes -= regions.front().Bytes;
+            regions.pop_front();
+        }
+    }
+
+    void StagingRing::Clear()
+    {
+        auto& device = Device::IDevice::Current();
+        for (const auto& r : regions)
+            device.DeleteSync(r.Fence);
+        regions.clear();
+
+        // Deleting a buffer unmaps it
+        if (id != 0)
+        {
+            Device::StateTracker::GetInstance().DeleteBuffers(1, &id);
+            id = 0;
+        }
+
+        data = nullptr;
+        capacity = 0;
+        head = 0;
+        usedBytes = 0;
+        frameBytes = 0;
+    }
+}
\ No newline at end of file
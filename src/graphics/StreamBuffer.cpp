@@ -0,0 +1,121 @@
+#include "graphics/StreamBuffer.h"
+
+#include <algorithm>
+
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics
+{
+    StreamBuffer::StreamBuffer(GLenum t, GLuint bIdx)
+    {
+        target = t;
+        bindingIdx = bIdx;
+
+        Device::IDevice::Current().GenBuffers(1, &id);
+    }
+
+    StreamBuffer::StreamBuffer(StreamBuffer&& other) noexcept
+    {
+        Clear();
+        id = other.id;
+        target = other.target;
+        bindingIdx = other.bindingIdx;
+        capacity = other.capacity;
+        other.id = 0;
+        other.target = GL_NONE;
+        other.bindingIdx = 0;
+        other.capacity = 0;
+    }
+
+    StreamBuffer::~StreamBuffer()
+    {
+        Clear();
+    }
+
+    StreamBuffer& StreamBuffer::operator=(StreamBuffer&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        id = other.id;
+        target = other.target;
+        bindingIdx = other.bindingIdx;
+        capacity = other.capacity;
+        other.id = 0;
+        other.target = GL_NONE;
+        other.bindingIdx = 0;
+        other.capacity = 0;
+        return *this;
+    }
+
+    bool StreamBuffer::Update(const void* data, GLsizeiptr dataSize)
+    {
+        if (!IsValid() || !data || dataSize <= 0)
+            return false;
+
+        auto& device = Device::IDevice::Current();
+
+        // Grows by half again, so slowly growing uploads do not reallocate every frame
+        if (dataSize > capacity)
+            capacity = std::max(dataSize, capacity + capacity / 2);
+
+        Device::StateTracker::GetInstance().BindBuffer(target, id);
+        device.BufferData(target, capacity, nullptr, GL_STREAM_DRAW);
+        device.BufferSubData(target, 0, dataSize, data);
+        return true;
+    }
+
+    bool StreamBuffer::Use() const
+    {
+        if (!IsValid())
+            return false;
+
+        auto& states = Device::StateTracker::GetInstance();
+        if (IsIndexedTarget())
+            states.BindBufferBase(target, bindingIdx, id);
+        else
+            states.BindBuffer(target, id);
+        return true;
+    }
+
+    bool StreamBuffer::IsValid() const
+    {
+        return id != 0;
+    }
+
+    bool StreamBuffer::IsUsing() const
+    {
+        if (id == 0)
+            return false;
+
+        auto& states = Device::StateTracker::GetInstance();
+        if (IsIndexedTarget())
+            return states.IsBufferBaseBound(target, bindingIdx, id);
+        return states.IsBufferBound(target, id);
+    }
+
+    GLuint StreamBuffer::GetId() const
+    {
+        return id;
+    }
+
+    bool StreamBuffer::IsIndexedTarget() const
+    {
+        return target == GL_UNIFORM_BUFFER || target == GL_SHADER_STORAGE_BUFFER;
+    }
+
+    void StreamBuffer::Clear()
+    {
+        if (id != 0)
+        {
+            Device::StateTracker::GetInstance().DeleteBuffers(1, &id);
+            id = 0;
+        }
+
+        target = GL_NONE;
+        bindingIdx = 0;
+        capacity = 0;
+    }
+}
\ No newline at end of file
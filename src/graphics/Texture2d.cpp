@@ -2,14 +2,23 @@
 
 #include "stb/stb_image.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "common/Macros.h"
+#include "common/Profiler.h"
+#include "graphics/CompressedTextureFile.h"
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
 
 namespace RyuRenderer::Graphics
 {
     Texture2d::Texture2d(GLenum f, GLint uIdx, int w, int h)
     {
+        RYU_PROFILE_ZONE("Texture2d::Texture2d");
+
+        auto& device = Device::IDevice::Current();
+
         FAILTEST_RTN(
             f != GL_NONE &&
             uIdx >= 0 ||
@@ -23,26 +32,31 @@ namespace RyuRenderer::Graphics
         width = w;
         height = h;
 
-        glGenTextures(1, &id);
-        glActiveTexture(unitId);
-        glBindTexture(GL_TEXTURE_2D, id);
-        lastestUsedTexture2dIds[unitId] = id;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        device.GenTextures(1, &id);
+        Device::StateTracker::GetInstance().BindTexture(uIdx, GL_TEXTURE_2D, id);
+        device.TexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
+        device.GenerateMipmap(GL_TEXTURE_2D);
 
-        glBindTexture(GL_TEXTURE_2D, 0);
-        lastestUsedTexture2dIds[unitId] = 0;
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     }
 
     Texture2d::Texture2d(const std::string& textureFilePath, GLint unitIdx, GLenum sWrapping, GLenum tWrapping)
     {
+        RYU_PROFILE_ZONE("Texture2d::Texture2d");
+
+        auto& device = Device::IDevice::Current();
+
         FAILTEST_RTN(unitIdx >= 0 && unitIdx < GetMaxTextureAmount(), "Texture unit id is oversize for OpenGL.");
 
+        if (CompressedTextureFile::IsCompressedTexturePath(textureFilePath))
+        {
+            LoadCompressed(textureFilePath, unitIdx, sWrapping, tWrapping);
+            return;
+        }
+
         if (textureFilePath.ends_with(".jpg"))
         {
             format = GL_RGB;
@@ -69,22 +83,43 @@ namespace RyuRenderer::Graphics
 
         unitId = GetTextureUnitId(unitIdx);
 
-        glGenTextures(1, &id);
-        glActiveTexture(unitId);
-        glBindTexture(GL_TEXTURE_2D, id);
-        lastestUsedTexture2dIds[unitId] = id;
+        device.GenTextures(1, &id);
+        Device::StateTracker::GetInstance().BindTexture(unitIdx, GL_TEXTURE_2D, id);
 
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, textureData);
-        glGenerateMipmap(GL_TEXTURE_2D);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sWrapping);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tWrapping);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        device.TexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, textureData);
+        device.GenerateMipmap(GL_TEXTURE_2D);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sWrapping);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tWrapping);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
         source = textureFilePath;
         stbi_image_free(textureData);
-        glBindTexture(GL_TEXTURE_2D, 0);
-        lastestUsedTexture2dIds[unitId] = 0;
+    }
+
+    Texture2d::Texture2d(const std::string& textureSource, GLenum f, int w, int h, GLint unitIdx, GLenum sWrapping, GLenum tWrapping)
+    {
+        auto& device = Device::IDevice::Current();
+
+        FAILTEST_RTN(unitIdx >= 0 && unitIdx < GetMaxTextureAmount(), "Texture unit id is oversize for OpenGL.");
+        FAILTEST_RTN(f != GL_NONE && w > 0 && h > 0, "Invaild texture arguements");
+
+        unitId = GetTextureUnitId(unitIdx);
+        format = f;
+        width = w;
+        height = h;
+
+        device.GenTextures(1, &id);
+        // Storage only, a bound unpack buffer must not be read
+        Device::StateTracker::GetInstance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        Device::StateTracker::GetInstance().BindTexture(unitIdx, GL_TEXTURE_2D, id);
+        device.TexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, NULL);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sWrapping);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tWrapping);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+        source = textureSource;
     }
 
     Texture2d::Texture2d(Texture2d&& other) noexcept
@@ -95,12 +130,14 @@ namespace RyuRenderer::Graphics
         format = other.format;
         width = other.width;
         height = other.height;
+        isTopDown = other.isTopDown;
         source = other.source;
         other.id = 0;
         other.unitId = 0;
         other.format = 0;
         other.width = 0;
         other.height = 0;
+        other.isTopDown = false;
         other.source.clear();
     }
 
@@ -120,74 +157,112 @@ namespace RyuRenderer::Graphics
         format = other.format;
         width = other.width;
         height = other.height;
+        isTopDown = other.isTopDown;
         source = other.source;
         other.id = 0;
         other.unitId = 0;
         other.format = GL_NONE;
         other.width = 0;
         other.height = 0;
+        other.isTopDown = false;
         other.source.clear();
         return *this;
     }
 
-    bool Texture2d::Use() const
+    bool Texture2d::UploadRows(GLint firstRow, GLsizei rowAmount, const void* pixels, GLint level)
     {
-        if (!IsValid())
+        if (!IsValid() || level < 0 || firstRow < 0 || rowAmount <= 0)
             return false;
 
-        if (IsUsing())
+        auto& device = Device::IDevice::Current();
+        const int levelWidth = std::max(width >> level, 1);
+        const int levelHeight = std::max(height >> level, 1);
+        if (IsCompressed())
+        {
+            if (firstRow + rowAmount > (levelHeight + 3) / 4)
+                return false;
+
+            // The last block row may cover less than 4 texel rows
+            const GLint y = firstRow * 4;
+            const GLsizei h = std::min(rowAmount * 4, levelHeight - y);
+            const auto imageSize = static_cast<GLsizei>(CompressedTextureFile::GetLevelBytes(format, levelWidth, rowAmount * 4));
+            Device::StateTracker::GetInstance().BindTexture(GetTextureUnitIdx(unitId), GL_TEXTURE_2D, id);
+            device.CompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, y, levelWidth, h, format, imageSize, pixels);
             return true;
+        }
+
+        if (firstRow + rowAmount > levelHeight)
+            return false;
 
-        glActiveTexture(unitId);
-        glBindTexture(GL_TEXTURE_2D, id);
-        lastestUsedTexture2dIds[unitId] = id;
+        Device::StateTracker::GetInstance().BindTexture(GetTextureUnitIdx(unitId), GL_TEXTURE_2D, id);
+        device.TexSubImage2D(GL_TEXTURE_2D, level, 0, firstRow, levelWidth, rowAmount, format, GL_UNSIGNED_BYTE, pixels);
         return true;
     }
 
-    bool Texture2d::IsValid() const
+    void Texture2d::GenerateMipmap()
     {
-        return id != 0 &&
-            format != GL_NONE &&
-            GetTextureUnitIdx(unitId) >= 0 &&
-            GetTextureUnitIdx(unitId) < GetMaxTextureAmount() &&
-            width >= 0 &&
-            height >= 0;
+        if (!IsValid() || IsCompressed())
+            return;
+
+        Device::StateTracker::GetInstance().BindTexture(GetTextureUnitIdx(unitId), GL_TEXTURE_2D, id);
+        Device::IDevice::Current().GenerateMipmap(GL_TEXTURE_2D);
     }
 
-    bool Texture2d::IsUsing() const
+    bool Texture2d::Reallocate(GLenum f, int w, int h, GLint levelAmount, bool isTopDownRows)
     {
-        if (unitId == 0)
+        if (!IsValid() || f == GL_NONE || w <= 0 || h <= 0 || levelAmount <= 0)
             return false;
 
-        if (IsCleanMode)
-        {
-            const auto& it = lastestUsedTexture2dIds.find(unitId);
-            if (it == lastestUsedTexture2dIds.end())
-                return false;
+        auto& device = Device::IDevice::Current();
 
-            if (it->second == 0)
-                return false;
+        // NULL would be an offset into a bound unpack buffer instead of no data
+        auto& states = Device::StateTracker::GetInstance();
+        states.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        states.BindTexture(GetTextureUnitIdx(unitId), GL_TEXTURE_2D, id);
 
-            if (it->second == unitId)
-                return true;
-            return false;
-        }
+        format = f;
+        width = w;
+        height = h;
+        isTopDown = isTopDownRows;
+        // Specific compressed formats allocate through TexImage2D too, the client format only matters with data
+        const GLenum clientFormat = IsCompressed() ? GL_RGBA : format;
+        for (GLint level = 0; level < levelAmount; ++level)
+            device.TexImage2D(GL_TEXTURE_2D, level, format, std::max(w >> level, 1), std::max(h >> level, 1), 0, clientFormat, GL_UNSIGNED_BYTE, NULL);
+        // 1000 is the GL default, GenerateMipmap() fills whatever the size needs
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, IsCompressed() ? levelAmount - 1 : 1000);
+        return true;
+    }
 
-        GLint prevActiveUnitId;
-        glGetIntegerv(GL_ACTIVE_TEXTURE, &prevActiveUnitId);
+    bool Texture2d::IsCompressed() const
+    {
+        return CompressedTextureFile::GetBlockBytes(format) != 0;
+    }
 
-        if (prevActiveUnitId != unitId)
-            glActiveTexture(unitId);
+    bool Texture2d::Use() const
+    {
+        if (!IsValid())
+            return false;
 
-        GLint currentId = 0;
-        glGetIntegerv(GL_TEXTURE_BINDING_2D, &currentId);
+        Device::StateTracker::GetInstance().BindTexture(GetTextureUnitIdx(unitId), GL_TEXTURE_2D, id);
+        return true;
+    }
 
-        bool isUsing = currentId == id;
+    bool Texture2d::IsValid() const
+    {
+        return id != 0 &&
+            format != GL_NONE &&
+            GetTextureUnitIdx(unitId) >= 0 &&
+            GetTextureUnitIdx(unitId) < GetMaxTextureAmount() &&
+            width >= 0 &&
+            height >= 0;
+    }
 
-        if (prevActiveUnitId != unitId)
-            glActiveTexture(prevActiveUnitId);
+    bool Texture2d::IsUsing() const
+    {
+        if (id == 0)
+            return false;
 
-        return isUsing;
+        return Device::StateTracker::GetInstance().IsTextureBound(GetTextureUnitIdx(unitId), GL_TEXTURE_2D, id);
     }
 
     GLuint Texture2d::GetId() const
@@ -208,18 +283,50 @@ namespace RyuRenderer::Graphics
         return source;
     }
 
-    void Texture2d::Clear()
+    bool Texture2d::IsTopDown() const
+    {
+        return isTopDown;
+    }
+
+    void Texture2d::LoadCompressed(const std::string& textureFilePath, GLint unitIdx, GLenum sWrapping, GLenum tWrapping)
     {
-        if (IsUsing())
+        CompressedTextureFile file;
+        if (!file.Open(textureFilePath))
+            return;
+
+        auto& device = Device::IDevice::Current();
+        const auto& levels = file.GetLevels();
+        unitId = GetTextureUnitId(unitIdx);
+        format = file.GetFormat();
+        width = levels[0].Width;
+        height = levels[0].Height;
+        isTopDown = file.IsTopDown();
+
+        device.GenTextures(1, &id);
+        Device::StateTracker::GetInstance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        Device::StateTracker::GetInstance().BindTexture(unitIdx, GL_TEXTURE_2D, id);
+        // Blocks go from the mapping to the driver, nothing is decoded or copied on the CPU
+        for (size_t i = 0; i < levels.size(); ++i)
         {
-            glActiveTexture(unitId);
-            glBindTexture(GL_TEXTURE_2D, 0);
-            lastestUsedTexture2dIds[unitId] = 0;
+            device.CompressedTexImage2D(
+                GL_TEXTURE_2D, static_cast<GLint>(i), format, levels[i].Width, levels[i].Height, 0,
+                static_cast<GLsizei>(levels[i].Bytes.size()), levels[i].Bytes.data());
         }
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(levels.size()) - 1);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, sWrapping);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, tWrapping);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        device.TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
+        source = textureFilePath;
+    }
+
+    void Texture2d::Clear()
+    {
+        // Deleted textures are unbound from every unit by GL, the tracker follows
         if (id != 0)
         {
-            glDeleteTextures(1, &id);
+            Device::StateTracker::GetInstance().DeleteTextures(1, &id);
             id = 0;
         }
 
@@ -227,6 +334,7 @@ namespace RyuRenderer::Graphics
         format = GL_NONE;
         width = 0;
         height = 0;
+        isTopDown = false;
         source.clear();
     }
 
@@ -234,7 +342,7 @@ namespace RyuRenderer::Graphics
     {
         if (maxTextureAmount < 0)
         {
-            glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureAmount);
+            Device::IDevice::Current().GetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureAmount);
         }
 
         return maxTextureAmount;
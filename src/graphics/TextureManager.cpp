@@ -1,6 +1,17 @@
 #include "graphics/TextureManager.h"
 
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
 #include <functional>
+#include <iostream>
+
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+#include "graphics/CompressedTextureFile.h"
+#include "graphics/device/StateTracker.h"
 
 namespace RyuRenderer::Graphics::TextureManagerImpl
 {
@@ -26,6 +37,219 @@ namespace RyuRenderer::Graphics::TextureManagerImpl
         return p;
     }
 
+    std::shared_ptr<Texture2d> TextureManagerImpl::Add2d(const std::shared_ptr<Texture2d>& texture)
+    {
+        if (!texture)
+            return nullptr;
+
+        std::unique_lock<std::shared_mutex> lock(mutex);
+        const std::string source = texture->GetSource();
+        auto it = std::find_if(products.begin(), products.end(), [&source](const auto& p) { return CompareTextureBySource(p, source); });
+        if (it != products.end())
+            return std::dynamic_pointer_cast<Texture2d>(*it);
+
+        products.emplace_back(texture);
+        lock.unlock();
+        AfterCreate(texture);
+        return texture;
+    }
+
+    std::shared_ptr<Texture2d> TextureManagerImpl::FindOrCreate2dAsync(const std::string& source, GLint unitIdx, GLenum sWrapping, GLenum tWrapping)
+    {
+        RYU_PROFILE_ZONE("TextureManager::FindOrCreate2dAsync");
+
+        auto p = Find(source);
+        if (p)
+            return std::dynamic_pointer_cast<Texture2d>(p);
+
+        // Same formats as Texture2d reading the file itself, compressed files know theirs after being read
+        GLenum format = GL_NONE;
+        int channelAmount = 0;
+        if (CompressedTextureFile::IsCompressedTexturePath(source))
+        {
+            format = GL_RGBA;
+            channelAmount = 4;
+        }
+        else if (source.ends_with(".jpg"))
+        {
+            format = GL_RGB;
+            channelAmount = 3;
+        }
+        else if (source.ends_with(".png"))
+        {
+            format = GL_RGBA;
+            channelAmount = 4;
+        }
+        else
+        {
+            std::cerr << "The suffix of the image file should be jpg, png, ktx2 or dds." << std::endl;
+            return nullptr;
+        }
+
+        auto placeholder = std::make_shared<Texture2d>(source, format, 1, 1, unitIdx, sWrapping, tWrapping);
+        if (!placeholder->IsValid())
+            return nullptr;
+        constexpr unsigned char black[4] = { 0, 0, 0, 255 };
+        placeholder->UploadRows(0, 1, black);
+        placeholder->GenerateMipmap();
+
+        // Registered before decoding, so later requests find it and nothing is decoded twice
+        auto added = Add2d(placeholder);
+        if (added != placeholder)
+            return added;
+
+        PendingUpload& pu = pendingUploads.emplace_back();
+        pu.Target = placeholder;
+        // The job only holds the path, dropping the request never frees a GL object on a worker
+        pu.Decoded = Common::ThreadPool::GetInstance().Submit([source, format, channelAmount]() { return Decode(source, format, channelAmount); });
+        return placeholder;
+    }
+
+    void TextureManagerImpl::UpdateUploads()
+    {
+        RYU_PROFILE_ZONE("TextureManager::UpdateUploads");
+
+        lastFrameUploadedBytes = 0;
+        if (pendingUploads.empty())
+            return;
+
+        // Whole rows of large images have to fit into one frame
+        const size_t frameBytes = std::max<size_t>(UploadBytesPerFrame, 64 << 10);
+        if (!uploadRing.IsValid())
+            uploadRing = StagingRing(static_cast<GLsizeiptr>(frameBytes * 3));
+        if (!uploadRing.IsValid())
+            return;
+
+        size_t budgetBytes = frameBytes;
+        for (auto it = pendingUploads.begin(); it != pendingUploads.end();)
+        {
+            auto& pu = *it;
+            if (!pu.IsDecoded)
+            {
+                if (pu.Decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                {
+                    ++it;
+                    continue;
+                }
+
+                pu.Image = pu.Decoded.get();
+                pu.IsDecoded = true;
+                // A file which can not be read keeps its placeholder, as does one with rows wider than a frame
+                const auto& levels = pu.Image.Levels;
+                if (levels.empty() ||
+                    levels[0].RowBytes > frameBytes ||
+                    !pu.Target->Reallocate(
+                        pu.Image.Format, levels[0].Width, levels[0].Height, static_cast<GLint>(levels.size()), pu.Image.IsTopDown)) {
+                    it = pendingUploads.erase(it);
+                    continue;
+                }
+            }
+
+            if (!UploadRows(pu, budgetBytes))
+                break;
+
+            // Nothing to do for compressed textures, all their levels came from the file
+            pu.Target->GenerateMipmap();
+            it = pendingUploads.erase(it);
+        }
+        // Later texture uploads from client memory must not read from the ring
+        Device::StateTracker::GetInstance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        uploadRing.EndFrame();
+        lastFrameUploadedBytes = frameBytes - budgetBytes;
+    }
+
+    size_t TextureManagerImpl::GetPendingAmount() const
+    {
+        return pendingUploads.size();
+    }
+
+    size_t TextureManagerImpl::GetLastFrameUploadedBytes() const
+    {
+        return lastFrameUploadedBytes;
+    }
+
+    void TextureManagerImpl::Clear()
+    {
+        for (const auto& p : products)
+            ReleaseSlot(p.get());
+        pendingUploads.clear();
+        uploadRing = StagingRing();
+        lastFrameUploadedBytes = 0;
+        base::Clear();
+    }
+
+    TextureManagerImpl::DecodedImage TextureManagerImpl::Decode(const std::string& source, GLenum format, int channelAmount)
+    {
+        RYU_PROFILE_ZONE("TextureManager::Decode");
+
+        DecodedImage image;
+        if (CompressedTextureFile::IsCompressedTexturePath(source))
+        {
+            // The mapping is only read here, the ring is filled from the copy on the render thread
+            CompressedTextureFile file;
+            if (!file.Open(source))
+                return {};
+
+            image.Format = file.GetFormat();
+            image.IsTopDown = file.IsTopDown();
+            const size_t blockBytes = CompressedTextureFile::GetBlockBytes(image.Format);
+            for (const auto& fileLevel : file.GetLevels())
+            {
+                auto& level = image.Levels.emplace_back();
+                level.Width = fileLevel.Width;
+                level.Height = fileLevel.Height;
+                level.RowBytes = static_cast<size_t>((fileLevel.Width + 3) / 4) * blockBytes;
+                level.RowAmount = (fileLevel.Height + 3) / 4;
+                const auto* bytes = reinterpret_cast<const unsigned char*>(fileLevel.Bytes.data());
+                level.Pixels.assign(bytes, bytes + fileLevel.Bytes.size());
+            }
+            return image;
+        }
+
+        auto& level = image.Levels.emplace_back();
+        int fileChannelAmount = 0;
+        unsigned char* data = stbi_load(source.c_str(), &level.Width, &level.Height, &fileChannelAmount, channelAmount);
+        if (!data)
+        {
+            std::cerr << "Can not load texture file: " << source << "." << std::endl;
+            return {};
+        }
+
+        image.Format = format;
+        level.RowBytes = static_cast<size_t>(level.Width) * channelAmount;
+        level.RowAmount = level.Height;
+        level.Pixels.assign(data, data + level.RowBytes * level.Height);
+        stbi_image_free(data);
+        return image;
+    }
+
+    bool TextureManagerImpl::UploadRows(PendingUpload& pu, size_t& budgetBytes)
+    {
+        Device::StateTracker::GetInstance().BindBuffer(GL_PIXEL_UNPACK_BUFFER, uploadRing.GetId());
+        for (; pu.LevelIdx < pu.Image.Levels.size(); ++pu.LevelIdx, pu.RowIdx = 0)
+        {
+            const auto& level = pu.Image.Levels[pu.LevelIdx];
+            // Unpack rows are 4 byte aligned by default, blocks are 8 or 16 bytes anyway
+            const size_t rowPitch = (level.RowBytes + 3) & ~static_cast<size_t>(3);
+            while (pu.RowIdx < level.RowAmount)
+            {
+                size_t rowAmount = 0;
+                const auto a = uploadRing.AllocateElements(
+                    static_cast<GLsizeiptr>(rowPitch), std::min(static_cast<size_t>(level.RowAmount - pu.RowIdx), budgetBytes / rowPitch), rowAmount);
+                if (!a.IsValid())
+                    return false;
+
+                for (size_t r = 0; r < rowAmount; ++r)
+                    std::memcpy(a.Data + r * rowPitch, level.Pixels.data() + (pu.RowIdx + r) * level.RowBytes, level.RowBytes);
+                pu.Target->UploadRows(pu.RowIdx, static_cast<GLsizei>(rowAmount), reinterpret_cast<const void*>(a.Offset), static_cast<GLint>(pu.LevelIdx));
+
+                pu.RowIdx += static_cast<int>(rowAmount);
+                budgetBytes -= rowAmount * rowPitch;
+            }
+        }
+        return true;
+    }
+
     bool TextureManagerImpl::BeforeCreate(const std::string& source)
     {
         auto p = Find(source);
@@ -58,13 +282,12 @@ namespace RyuRenderer::Graphics::TextureManagerImpl
 
     bool TextureManagerImpl::Remove(const std::string& source)
     {
-        auto predicate = std::bind(
-            &CompareTextureBySource,
-            std::placeholders::_1,
-            source
-        );
+        auto p = Find(source);
+        if (!p)
+            return false;
 
-        return base::Remove(predicate);
+        ReleaseSlot(p.get());
+        return base::RemoveAll(p) > 0;
     }
 
     size_t TextureManagerImpl::RemoveAll(const std::string& source)
@@ -75,9 +298,61 @@ namespace RyuRenderer::Graphics::TextureManagerImpl
             source
         );
 
+        for (const auto& p : base::FindAll(predicate))
+            ReleaseSlot(p.get());
         return base::RemoveAll(predicate);
     }
 
+    TextureHandle TextureManagerImpl::GetHandle(const std::shared_ptr<ITexture>& texture) const
+    {
+        if (!texture)
+            return {};
+
+        auto it = slotIdxsByTexture.find(texture.get());
+        if (it == slotIdxsByTexture.end())
+            return {};
+        return TextureHandle{ it->second, slots[it->second].Generation };
+    }
+
+    const ITexture* TextureManagerImpl::Resolve(TextureHandle handle) const
+    {
+        if (!handle.IsValid() || static_cast<size_t>(handle.SlotIdx) >= slots.size())
+            return nullptr;
+
+        const auto& slot = slots[handle.SlotIdx];
+        return slot.Generation == handle.Generation ? slot.Texture : nullptr;
+    }
+
+    void TextureManagerImpl::AfterCreate(const std::shared_ptr<ITexture>& p) noexcept
+    {
+        int32_t slotIdx = 0;
+        if (freeSlotIdxs.empty())
+        {
+            slotIdx = static_cast<int32_t>(slots.size());
+            slots.emplace_back();
+        }
+        else
+        {
+            slotIdx = freeSlotIdxs.back();
+            freeSlotIdxs.pop_back();
+        }
+        slots[slotIdx].Texture = p.get();
+        slotIdxsByTexture[p.get()] = slotIdx;
+    }
+
+    void TextureManagerImpl::ReleaseSlot(const ITexture* texture)
+    {
+        auto it = slotIdxsByTexture.find(texture);
+        if (it == slotIdxsByTexture.end())
+            return;
+
+        auto& slot = slots[it->second];
+        slot.Texture = nullptr;
+        ++slot.Generation;
+        freeSlotIdxs.emplace_back(it->second);
+        slotIdxsByTexture.erase(it);
+    }
+
     bool TextureManagerImpl::CompareTextureBySource(
         const std::shared_ptr<ITexture>& p,
         const std::string& source
@@ -0,0 +1,105 @@
+#include "graphics/UniformBuffer.h"
+
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics
+{
+    UniformBuffer::UniformBuffer(GLsizeiptr s, GLuint bIdx)
+    {
+        if (s <= 0)
+            return;
+
+        auto& device = Device::IDevice::Current();
+
+        size = s;
+        bindingIdx = bIdx;
+
+        device.GenBuffers(1, &id);
+        Device::StateTracker::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, id);
+        device.BufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    UniformBuffer::UniformBuffer(UniformBuffer&& other) noexcept
+    {
+        Clear();
+        id = other.id;
+        size = other.size;
+        bindingIdx = other.bindingIdx;
+        other.id = 0;
+        other.size = 0;
+        other.bindingIdx = 0;
+    }
+
+    UniformBuffer::~UniformBuffer()
+    {
+        Clear();
+    }
+
+    UniformBuffer& UniformBuffer::operator=(UniformBuffer&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        id = other.id;
+        size = other.size;
+        bindingIdx = other.bindingIdx;
+        other.id = 0;
+        other.size = 0;
+        other.bindingIdx = 0;
+        return *this;
+    }
+
+    bool UniformBuffer::Update(const void* data, GLsizeiptr dataSize) const
+    {
+        if (!IsValid() || !data || dataSize <= 0 || dataSize > size)
+            return false;
+
+        auto& device = Device::IDevice::Current();
+
+        Device::StateTracker::GetInstance().BindBuffer(GL_UNIFORM_BUFFER, id);
+        device.BufferData(GL_UNIFORM_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
+        device.BufferSubData(GL_UNIFORM_BUFFER, 0, dataSize, data);
+        return true;
+    }
+
+    bool UniformBuffer::Use() const
+    {
+        if (!IsValid())
+            return false;
+
+        Device::StateTracker::GetInstance().BindBufferBase(GL_UNIFORM_BUFFER, bindingIdx, id);
+        return true;
+    }
+
+    bool UniformBuffer::IsValid() const
+    {
+        return id != 0 && size > 0;
+    }
+
+    bool UniformBuffer::IsUsing() const
+    {
+        if (id == 0)
+            return false;
+
+        return Device::StateTracker::GetInstance().IsBufferBaseBound(GL_UNIFORM_BUFFER, bindingIdx, id);
+    }
+
+    GLuint UniformBuffer::GetBindingIdx() const
+    {
+        return bindingIdx;
+    }
+
+    void UniformBuffer::Clear()
+    {
+        if (id != 0)
+        {
+            Device::StateTracker::GetInstance().DeleteBuffers(1, &id);
+            id = 0;
+        }
+
+        size = 0;
+        bindingIdx = 0;
+    }
+}
\ No newline at end of file
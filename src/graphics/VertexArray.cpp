@@ -0,0 +1,109 @@
+#include "graphics/VertexArray.h"
+
+#include "graphics/device/IDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics
+{
+    VertexArray::VertexArray(const VertexFormat& f)
+    {
+        if (f.AttributeAmount <= 0 || f.AttributeAmount > VertexFormat::MaxAttributeAmount)
+            return;
+
+        auto& device = Device::IDevice::Current();
+        auto& states = Device::StateTracker::GetInstance();
+
+        format = f;
+
+        device.GenVertexArrays(1, &id);
+        states.BindVertexArray(id);
+        for (GLuint i = 0; i < format.AttributeAmount; ++i)
+        {
+            const auto& a = format.Attributes[i];
+            if (a.ComponentAmount <= 0)
+                continue;
+
+            device.EnableVertexAttribArray(i);
+            device.VertexAttribFormat(i, a.ComponentAmount, a.DataType, a.IsNormalized, a.RelativeOffset);
+            device.VertexAttribBinding(i, a.BindingIdx);
+        }
+        for (GLuint i = 0; i < VertexFormat::MaxAttributeAmount; ++i)
+        {
+            if (format.BindingDivisors[i] != 0)
+                device.VertexBindingDivisor(i, format.BindingDivisors[i]);
+        }
+
+        // Unbind, so later element array buffer binds never modify this VAO
+        states.BindVertexArray(0);
+    }
+
+    VertexArray::VertexArray(VertexArray&& other) noexcept
+    {
+        Clear();
+        id = other.id;
+        format = other.format;
+        other.id = 0;
+        other.format = {};
+    }
+
+    VertexArray::~VertexArray()
+    {
+        Clear();
+    }
+
+    VertexArray& VertexArray::operator=(VertexArray&& other) noexcept
+    {
+        if (this == &other)
+            return *this;
+
+        Clear();
+        id = other.id;
+        format = other.format;
+        other.id = 0;
+        other.format = {};
+        return *this;
+    }
+
+    bool VertexArray::Use() const
+    {
+        if (!IsValid())
+            return false;
+
+        Device::StateTracker::GetInstance().BindVertexArray(id);
+        return true;
+    }
+
+    bool VertexArray::IsValid() const
+    {
+        return id != 0;
+    }
+
+    bool VertexArray::IsUsing() const
+    {
+        if (!IsValid())
+            return false;
+
+        return Device::StateTracker::GetInstance().IsVertexArrayBound(id);
+    }
+
+    GLuint VertexArray::GetId() const
+    {
+        return id;
+    }
+
+    const VertexFormat& VertexArray::GetFormat() const
+    {
+        return format;
+    }
+
+    void VertexArray::Clear()
+    {
+        // Deleted objects are unbound by GL, the tracker follows
+        if (id != 0)
+        {
+            Device::StateTracker::GetInstance().DeleteVertexArrays(1, &id);
+            id = 0;
+        }
+        format = {};
+    }
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "graphics/VertexArrayManager.h"
+
+#include <functional>
+
+namespace RyuRenderer::Graphics::VertexArrayManagerImpl
+{
+    std::shared_ptr<VertexArray> VertexArrayManagerImpl::FindOrCreate(const VertexFormat& format)
+    {
+        auto p = Find(format);
+        if (p)
+            return p;
+
+        p = Create(format);
+        if (p && !p->IsValid())
+        {
+            base::RemoveAll(p);
+            return nullptr;
+        }
+        return p;
+    }
+
+    bool VertexArrayManagerImpl::BeforeCreate(const VertexFormat& format)
+    {
+        auto p = Find(format);
+        if (p)
+            return false;
+        return true;
+    }
+
+    std::shared_ptr<VertexArray> VertexArrayManagerImpl::Find(const VertexFormat& format) const
+    {
+        auto predicate = std::bind(
+            &CompareVertexArrayByFormat,
+            std::placeholders::_1,
+            std::cref(format)
+        );
+
+        return base::Find(predicate);
+    }
+
+    bool VertexArrayManagerImpl::Remove(const VertexFormat& format)
+    {
+        auto predicate = std::bind(
+            &CompareVertexArrayByFormat,
+            std::placeholders::_1,
+            std::cref(format)
+        );
+
+        return base::Remove(predicate);
+    }
+
+    bool VertexArrayManagerImpl::CompareVertexArrayByFormat(
+        const std::shared_ptr<VertexArray>& p,
+        const VertexFormat& format
+    ) {
+        if (!p)
+            return false;
+        return p->GetFormat() == format;
+    }
+}
\ No newline at end of file
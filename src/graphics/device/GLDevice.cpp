@@ -0,0 +1,493 @@
+#include "graphics/device/GLDevice.h"
+
+namespace RyuRenderer::Graphics::Device
+{
+    void GLDevice::GetIntegerv(GLenum pname, GLint* data)
+    {
+        glGetIntegerv(pname, data);
+    }
+
+    void GLDevice::Enable(GLenum cap)
+    {
+        glEnable(cap);
+    }
+
+    void GLDevice::Disable(GLenum cap)
+    {
+        glDisable(cap);
+    }
+
+    void GLDevice::BlendFunc(GLenum sfactor, GLenum dfactor)
+    {
+        glBlendFunc(sfactor, dfactor);
+    }
+
+    void GLDevice::StencilFunc(GLenum func, GLint ref, GLuint mask)
+    {
+        glStencilFunc(func, ref, mask);
+    }
+
+    void GLDevice::StencilMask(GLuint mask)
+    {
+        glStencilMask(mask);
+    }
+
+    void GLDevice::StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+    {
+        glStencilOp(sfail, dpfail, dppass);
+    }
+
+    void GLDevice::DepthFunc(GLenum func)
+    {
+        glDepthFunc(func);
+    }
+
+    void GLDevice::DepthMask(GLboolean flag)
+    {
+        glDepthMask(flag);
+    }
+
+    void GLDevice::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        glViewport(x, y, width, height);
+    }
+
+    void GLDevice::ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+    {
+        glClearColor(red, green, blue, alpha);
+    }
+
+    void GLDevice::Clear(GLbitfield mask)
+    {
+        glClear(mask);
+    }
+
+    void GLDevice::Flush()
+    {
+        glFlush();
+    }
+
+    void GLDevice::Finish()
+    {
+        glFinish();
+    }
+
+    void GLDevice::GenBuffers(GLsizei n, GLuint* buffers)
+    {
+        glGenBuffers(n, buffers);
+    }
+
+    void GLDevice::DeleteBuffers(GLsizei n, const GLuint* buffers)
+    {
+        glDeleteBuffers(n, buffers);
+    }
+
+    void GLDevice::BindBuffer(GLenum target, GLuint buffer)
+    {
+        glBindBuffer(target, buffer);
+    }
+
+    void GLDevice::BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+    {
+        glBufferData(target, size, data, usage);
+    }
+
+    void GLDevice::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        glBufferSubData(target, offset, size, data);
+    }
+
+    void GLDevice::BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+    {
+        glBufferStorage(target, size, data, flags);
+    }
+
+    void GLDevice::CopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size)
+    {
+        glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+    }
+
+    void GLDevice::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        glBindBufferBase(target, index, buffer);
+    }
+
+    void* GLDevice::MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+    {
+        return glMapBufferRange(target, offset, length, access);
+    }
+
+    GLboolean GLDevice::UnmapBuffer(GLenum target)
+    {
+        return glUnmapBuffer(target);
+    }
+
+    void GLDevice::GenVertexArrays(GLsizei n, GLuint* arrays)
+    {
+        glGenVertexArrays(n, arrays);
+    }
+
+    void GLDevice::DeleteVertexArrays(GLsizei n, const GLuint* arrays)
+    {
+        glDeleteVertexArrays(n, arrays);
+    }
+
+    void GLDevice::BindVertexArray(GLuint array)
+    {
+        glBindVertexArray(array);
+    }
+
+    void GLDevice::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+    {
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+
+    void GLDevice::EnableVertexAttribArray(GLuint index)
+    {
+        glEnableVertexAttribArray(index);
+    }
+
+    void GLDevice::VertexAttribFormat(GLuint attribIdx, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset)
+    {
+        glVertexAttribFormat(attribIdx, size, type, normalized, relativeOffset);
+    }
+
+    void GLDevice::VertexAttribBinding(GLuint attribIdx, GLuint bindingIdx)
+    {
+        glVertexAttribBinding(attribIdx, bindingIdx);
+    }
+
+    void GLDevice::BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride)
+    {
+        glBindVertexBuffer(bindingIdx, buffer, offset, stride);
+    }
+
+    void GLDevice::VertexBindingDivisor(GLuint bindingIdx, GLuint divisor)
+    {
+        glVertexBindingDivisor(bindingIdx, divisor);
+    }
+
+    void GLDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        glDrawElements(mode, count, type, indices);
+    }
+
+    void GLDevice::DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex)
+    {
+        glDrawElementsBaseVertex(mode, count, type, indices, basevertex);
+    }
+
+    void GLDevice::DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex)
+    {
+        glDrawElementsInstancedBaseVertex(mode, count, type, indices, instancecount, basevertex);
+    }
+
+    void GLDevice::MultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+    {
+        glMultiDrawElementsIndirect(mode, type, indirect, drawcount, stride);
+    }
+
+    void GLDevice::GenTextures(GLsizei n, GLuint* textures)
+    {
+        glGenTextures(n, textures);
+    }
+
+    void GLDevice::DeleteTextures(GLsizei n, const GLuint* textures)
+    {
+        glDeleteTextures(n, textures);
+    }
+
+    void GLDevice::BindTexture(GLenum target, GLuint texture)
+    {
+        glBindTexture(target, texture);
+    }
+
+    void GLDevice::ActiveTexture(GLenum texture)
+    {
+        glActiveTexture(texture);
+    }
+
+    void GLDevice::TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+    {
+        glTexImage2D(target, level, internalformat, width, height, border, format, type, pixels);
+    }
+
+    void GLDevice::TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+    {
+        glTexSubImage2D(target, level, xoffset, yoffset, width, height, format, type, pixels);
+    }
+
+    void GLDevice::CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+    {
+        glCompressedTexImage2D(target, level, internalformat, width, height, border, imageSize, data);
+    }
+
+    void GLDevice::CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data)
+    {
+        glCompressedTexSubImage2D(target, level, xoffset, yoffset, width, height, format, imageSize, data);
+    }
+
+    void GLDevice::TexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        glTexParameteri(target, pname, param);
+    }
+
+    void GLDevice::GenerateMipmap(GLenum target)
+    {
+        glGenerateMipmap(target);
+    }
+
+    void GLDevice::GenFramebuffers(GLsizei n, GLuint* framebuffers)
+    {
+        glGenFramebuffers(n, framebuffers);
+    }
+
+    void GLDevice::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+    {
+        glDeleteFramebuffers(n, framebuffers);
+    }
+
+    void GLDevice::BindFramebuffer(GLenum target, GLuint framebuffer)
+    {
+        glBindFramebuffer(target, framebuffer);
+    }
+
+    void GLDevice::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+    {
+        glFramebufferTexture2D(target, attachment, textarget, texture, level);
+    }
+
+    GLenum GLDevice::CheckFramebufferStatus(GLenum target)
+    {
+        return glCheckFramebufferStatus(target);
+    }
+
+    void GLDevice::GenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+    {
+        glGenRenderbuffers(n, renderbuffers);
+    }
+
+    void GLDevice::DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+    {
+        glDeleteRenderbuffers(n, renderbuffers);
+    }
+
+    void GLDevice::BindRenderbuffer(GLenum target, GLuint renderbuffer)
+    {
+        glBindRenderbuffer(target, renderbuffer);
+    }
+
+    void GLDevice::RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+    {
+        glRenderbufferStorage(target, internalformat, width, height);
+    }
+
+    void GLDevice::FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+    {
+        glFramebufferRenderbuffer(target, attachment, renderbuffertarget, renderbuffer);
+    }
+
+    void GLDevice::GenQueries(GLsizei n, GLuint* ids)
+    {
+        glGenQueries(n, ids);
+    }
+
+    void GLDevice::DeleteQueries(GLsizei n, const GLuint* ids)
+    {
+        glDeleteQueries(n, ids);
+    }
+
+    void GLDevice::BeginQuery(GLenum target, GLuint id)
+    {
+        glBeginQuery(target, id);
+    }
+
+    void GLDevice::EndQuery(GLenum target)
+    {
+        glEndQuery(target);
+    }
+
+    void GLDevice::GetQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+    {
+        glGetQueryObjectiv(id, pname, params);
+    }
+
+    void GLDevice::GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+    {
+        glGetQueryObjectui64v(id, pname, params);
+    }
+
+    GLsync GLDevice::FenceSync(GLenum condition, GLbitfield flags)
+    {
+        return glFenceSync(condition, flags);
+    }
+
+    GLenum GLDevice::ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+    {
+        return glClientWaitSync(sync, flags, timeout);
+    }
+
+    void GLDevice::DeleteSync(GLsync sync)
+    {
+        glDeleteSync(sync);
+    }
+
+    GLuint GLDevice::CreateShader(GLenum type)
+    {
+        return glCreateShader(type);
+    }
+
+    void GLDevice::DeleteShader(GLuint shader)
+    {
+        glDeleteShader(shader);
+    }
+
+    void GLDevice::ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+    {
+        glShaderSource(shader, count, string, length);
+    }
+
+    void GLDevice::CompileShader(GLuint shader)
+    {
+        glCompileShader(shader);
+    }
+
+    void GLDevice::ShaderBinary(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length)
+    {
+        glShaderBinary(count, shaders, binaryFormat, binary, length);
+    }
+
+    void GLDevice::SpecializeShader(GLuint shader, const GLchar* pEntryPoint, GLuint numSpecializationConstants, const GLuint* pConstantIndex, const GLuint* pConstantValue)
+    {
+        glSpecializeShader(shader, pEntryPoint, numSpecializationConstants, pConstantIndex, pConstantValue);
+    }
+
+    void GLDevice::GetShaderiv(GLuint shader, GLenum pname, GLint* params)
+    {
+        glGetShaderiv(shader, pname, params);
+    }
+
+    void GLDevice::GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        glGetShaderInfoLog(shader, bufSize, length, infoLog);
+    }
+
+    GLuint GLDevice::CreateProgram()
+    {
+        return glCreateProgram();
+    }
+
+    void GLDevice::DeleteProgram(GLuint program)
+    {
+        glDeleteProgram(program);
+    }
+
+    void GLDevice::AttachShader(GLuint program, GLuint shader)
+    {
+        glAttachShader(program, shader);
+    }
+
+    void GLDevice::LinkProgram(GLuint program)
+    {
+        glLinkProgram(program);
+    }
+
+    void GLDevice::UseProgram(GLuint program)
+    {
+        glUseProgram(program);
+    }
+
+    void GLDevice::GetProgramiv(GLuint program, GLenum pname, GLint* params)
+    {
+        glGetProgramiv(program, pname, params);
+    }
+
+    void GLDevice::GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        glGetProgramInfoLog(program, bufSize, length, infoLog);
+    }
+
+    void GLDevice::ProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+    {
+        glProgramBinary(program, binaryFormat, binary, length);
+    }
+
+    void GLDevice::GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+    {
+        glGetProgramBinary(program, bufSize, length, binaryFormat, binary);
+    }
+
+    GLint GLDevice::GetUniformLocation(GLuint program, const GLchar* name)
+    {
+        return glGetUniformLocation(program, name);
+    }
+
+    void GLDevice::GetProgramInterfaceiv(GLuint program, GLenum programInterface, GLenum pname, GLint* params)
+    {
+        glGetProgramInterfaceiv(program, programInterface, pname, params);
+    }
+
+    void GLDevice::GetProgramResourceiv(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params)
+    {
+        glGetProgramResourceiv(program, programInterface, index, propCount, props, bufSize, length, params);
+    }
+
+    void GLDevice::GetProgramResourceName(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name)
+    {
+        glGetProgramResourceName(program, programInterface, index, bufSize, length, name);
+    }
+
+    void GLDevice::Uniformiv(GLint location, GLint components, GLsizei count, const GLint* value)
+    {
+        switch (components)
+        {
+        case 1: glUniform1iv(location, count, value); break;
+        case 2: glUniform2iv(location, count, value); break;
+        case 3: glUniform3iv(location, count, value); break;
+        case 4: glUniform4iv(location, count, value); break;
+        }
+    }
+
+    void GLDevice::Uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value)
+    {
+        switch (components)
+        {
+        case 1: glUniform1uiv(location, count, value); break;
+        case 2: glUniform2uiv(location, count, value); break;
+        case 3: glUniform3uiv(location, count, value); break;
+        case 4: glUniform4uiv(location, count, value); break;
+        }
+    }
+
+    void GLDevice::Uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value)
+    {
+        switch (components)
+        {
+        case 1: glUniform1fv(location, count, value); break;
+        case 2: glUniform2fv(location, count, value); break;
+        case 3: glUniform3fv(location, count, value); break;
+        case 4: glUniform4fv(location, count, value); break;
+        }
+    }
+
+    void GLDevice::Uniformdv(GLint location, GLint components, GLsizei count, const GLdouble* value)
+    {
+        switch (components)
+        {
+        case 1: glUniform1dv(location, count, value); break;
+        case 2: glUniform2dv(location, count, value); break;
+        case 3: glUniform3dv(location, count, value); break;
+        case 4: glUniform4dv(location, count, value); break;
+        }
+    }
+
+    void GLDevice::UniformMatrixfv(GLint location, GLint dimension, GLsizei count, GLboolean transpose, const GLfloat* value)
+    {
+        switch (dimension)
+        {
+        case 2: glUniformMatrix2fv(location, count, transpose, value); break;
+        case 3: glUniformMatrix3fv(location, count, transpose, value); break;
+        case 4: glUniformMatrix4fv(location, count, transpose, value); break;
+        }
+    }
+}
\ No newline at end of file
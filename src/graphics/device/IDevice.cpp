@@ -0,0 +1,20 @@
+#include "graphics/device/IDevice.h"
+
+#include "graphics/device/GLDevice.h"
+#include "graphics/device/StateTracker.h"
+
+namespace RyuRenderer::Graphics::Device
+{
+    void IDevice::SetCurrent(std::shared_ptr<IDevice> d)
+    {
+        current = std::move(d);
+        // Tracked states belong to the previous device
+        StateTracker::GetInstance().Invalidate();
+    }
+
+    IDevice& IDevice::GetDefault()
+    {
+        static GLDevice device;
+        return device;
+    }
+}
\ No newline at end of file
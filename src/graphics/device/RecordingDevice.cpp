@@ -0,0 +1,797 @@
+#include "graphics/device/RecordingDevice.h"
+
+#include <cstdint>
+#include <iterator>
+#include <numeric>
+
+namespace RyuRenderer::Graphics::Device
+{
+    RecordingDevice::RecordingDevice(bool isRecording)
+    {
+        IsRecording = isRecording;
+    }
+
+    void RecordingDevice::GetIntegerv(GLenum pname, GLint* data)
+    {
+        Record(Command::COMMAND_GET_INTEGERV, pname);
+        if (!data)
+            return;
+
+        switch (pname)
+        {
+        case GL_MAJOR_VERSION: *data = 4; break;
+        case GL_MINOR_VERSION: *data = 6; break;
+        case GL_MAX_VERTEX_ATTRIBS: *data = 16; break;
+        case GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS: *data = 80; break;
+        case GL_MAX_COLOR_ATTACHMENTS: *data = 8; break;
+        case GL_VERTEX_ARRAY_BINDING: *data = boundVertexArray; break;
+        case GL_ARRAY_BUFFER_BINDING: *data = boundBuffers[GL_ARRAY_BUFFER]; break;
+        case GL_ELEMENT_ARRAY_BUFFER_BINDING: *data = boundBuffers[GL_ELEMENT_ARRAY_BUFFER]; break;
+        case GL_UNIFORM_BUFFER_BINDING: *data = boundBuffers[GL_UNIFORM_BUFFER]; break;
+        case GL_CURRENT_PROGRAM: *data = boundProgram; break;
+        case GL_FRAMEBUFFER_BINDING: *data = boundFramebuffer; break;
+        case GL_RENDERBUFFER_BINDING: *data = boundRenderbuffer; break;
+        case GL_ACTIVE_TEXTURE: *data = activeTexture; break;
+        case GL_TEXTURE_BINDING_2D:
+        {
+            const auto& it = boundTexture2ds.find(activeTexture);
+            *data = it != boundTexture2ds.end() ? it->second : 0;
+            break;
+        }
+        default: *data = 0; break;
+        }
+    }
+
+    void RecordingDevice::Enable(GLenum cap)
+    {
+        Record(Command::COMMAND_ENABLE, cap);
+    }
+
+    void RecordingDevice::Disable(GLenum cap)
+    {
+        Record(Command::COMMAND_DISABLE, cap);
+    }
+
+    void RecordingDevice::BlendFunc(GLenum sfactor, GLenum dfactor)
+    {
+        Record(Command::COMMAND_BLEND_FUNC, sfactor, dfactor);
+    }
+
+    void RecordingDevice::StencilFunc(GLenum func, GLint ref, GLuint mask)
+    {
+        Record(Command::COMMAND_STENCIL_FUNC, func, ref, mask);
+    }
+
+    void RecordingDevice::StencilMask(GLuint mask)
+    {
+        Record(Command::COMMAND_STENCIL_MASK, GL_NONE, 0, mask);
+    }
+
+    void RecordingDevice::StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+    {
+        Record(Command::COMMAND_STENCIL_OP, sfail, dpfail, dppass);
+    }
+
+    void RecordingDevice::DepthFunc(GLenum func)
+    {
+        Record(Command::COMMAND_DEPTH_FUNC, func);
+    }
+
+    void RecordingDevice::DepthMask(GLboolean flag)
+    {
+        Record(Command::COMMAND_DEPTH_MASK, GL_NONE, flag);
+    }
+
+    void RecordingDevice::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        Record(Command::COMMAND_VIEWPORT, GL_NONE, 0, static_cast<GLsizeiptr>(width) * height);
+    }
+
+    void RecordingDevice::ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha)
+    {
+        Record(Command::COMMAND_CLEAR_COLOR);
+    }
+
+    void RecordingDevice::Clear(GLbitfield mask)
+    {
+        Record(Command::COMMAND_CLEAR, mask);
+    }
+
+    void RecordingDevice::Flush()
+    {
+        Record(Command::COMMAND_FLUSH);
+    }
+
+    void RecordingDevice::Finish()
+    {
+        Record(Command::COMMAND_FINISH);
+    }
+
+    void RecordingDevice::GenBuffers(GLsizei n, GLuint* buffers)
+    {
+        Record(Command::COMMAND_GEN_BUFFERS, GL_NONE, 0, n);
+        GenNames(n, buffers);
+    }
+
+    void RecordingDevice::DeleteBuffers(GLsizei n, const GLuint* buffers)
+    {
+        Record(Command::COMMAND_DELETE_BUFFERS, GL_NONE, n > 0 && buffers ? buffers[0] : 0, n);
+        for (GLsizei i = 0; buffers && i < n; ++i)
+        {
+            for (auto& b : boundBuffers)
+            {
+                if (b.second == buffers[i])
+                    b.second = 0;
+            }
+            mappedBuffers.erase(buffers[i]);
+        }
+    }
+
+    void RecordingDevice::BindBuffer(GLenum target, GLuint buffer)
+    {
+        Record(Command::COMMAND_BIND_BUFFER, target, buffer);
+        boundBuffers[target] = buffer;
+    }
+
+    void RecordingDevice::BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage)
+    {
+        Record(Command::COMMAND_BUFFER_DATA, target, boundBuffers[target], size);
+    }
+
+    void RecordingDevice::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data)
+    {
+        Record(Command::COMMAND_BUFFER_SUB_DATA, target, boundBuffers[target], size);
+    }
+
+    void RecordingDevice::BufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags)
+    {
+        Record(Command::COMMAND_BUFFER_STORAGE, target, boundBuffers[target], size);
+    }
+
+    void RecordingDevice::CopyBufferSubData(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size)
+    {
+        Record(Command::COMMAND_COPY_BUFFER_SUB_DATA, writeTarget, boundBuffers[writeTarget], size);
+    }
+
+    void RecordingDevice::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        Record(Command::COMMAND_BIND_BUFFER_BASE, target, buffer, index);
+        // Indexed binding also binds the generic binding point
+        boundBuffers[target] = buffer;
+    }
+
+    void* RecordingDevice::MapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access)
+    {
+        const GLuint buffer = boundBuffers[target];
+        Record(Command::COMMAND_MAP_BUFFER_RANGE, target, buffer, length);
+        if (buffer == 0 || offset < 0 || length <= 0)
+            return nullptr;
+
+        auto& memory = mappedBuffers[buffer];
+        if (memory.size() < static_cast<size_t>(offset + length))
+            memory.resize(static_cast<size_t>(offset + length));
+        return memory.data() + offset;
+    }
+
+    GLboolean RecordingDevice::UnmapBuffer(GLenum target)
+    {
+        Record(Command::COMMAND_UNMAP_BUFFER, target, boundBuffers[target]);
+        return GL_TRUE;
+    }
+
+    void RecordingDevice::GenVertexArrays(GLsizei n, GLuint* arrays)
+    {
+        Record(Command::COMMAND_GEN_VERTEX_ARRAYS, GL_NONE, 0, n);
+        GenNames(n, arrays);
+    }
+
+    void RecordingDevice::DeleteVertexArrays(GLsizei n, const GLuint* arrays)
+    {
+        Record(Command::COMMAND_DELETE_VERTEX_ARRAYS, GL_NONE, n > 0 && arrays ? arrays[0] : 0, n);
+        for (GLsizei i = 0; arrays && i < n; ++i)
+        {
+            if (boundVertexArray == arrays[i])
+                boundVertexArray = 0;
+        }
+    }
+
+    void RecordingDevice::BindVertexArray(GLuint array)
+    {
+        Record(Command::COMMAND_BIND_VERTEX_ARRAY, GL_NONE, array);
+        boundVertexArray = array;
+    }
+
+    void RecordingDevice::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer)
+    {
+        Record(Command::COMMAND_VERTEX_ATTRIB_POINTER, type, index, size);
+    }
+
+    void RecordingDevice::EnableVertexAttribArray(GLuint index)
+    {
+        Record(Command::COMMAND_ENABLE_VERTEX_ATTRIB_ARRAY, GL_NONE, index);
+    }
+
+    void RecordingDevice::VertexAttribFormat(GLuint attribIdx, GLint size, GLenum type, GLboolean normalized, GLuint relativeOffset)
+    {
+        Record(Command::COMMAND_VERTEX_ATTRIB_FORMAT, type, attribIdx, size);
+    }
+
+    void RecordingDevice::VertexAttribBinding(GLuint attribIdx, GLuint bindingIdx)
+    {
+        Record(Command::COMMAND_VERTEX_ATTRIB_BINDING, GL_NONE, attribIdx, bindingIdx);
+    }
+
+    void RecordingDevice::BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride)
+    {
+        Record(Command::COMMAND_BIND_VERTEX_BUFFER, GL_NONE, buffer, bindingIdx);
+    }
+
+    void RecordingDevice::VertexBindingDivisor(GLuint bindingIdx, GLuint divisor)
+    {
+        Record(Command::COMMAND_VERTEX_BINDING_DIVISOR, GL_NONE, bindingIdx, divisor);
+    }
+
+    void RecordingDevice::DrawElements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+    {
+        Record(Command::COMMAND_DRAW_ELEMENTS, mode, boundVertexArray, count);
+    }
+
+    void RecordingDevice::DrawElementsBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLint basevertex)
+    {
+        Record(Command::COMMAND_DRAW_ELEMENTS_BASE_VERTEX, mode, boundVertexArray, count);
+    }
+
+    void RecordingDevice::DrawElementsInstancedBaseVertex(GLenum mode, GLsizei count, GLenum type, const void* indices, GLsizei instancecount, GLint basevertex)
+    {
+        Record(Command::COMMAND_DRAW_ELEMENTS_INSTANCED_BASE_VERTEX, mode, boundVertexArray, count);
+    }
+
+    void RecordingDevice::MultiDrawElementsIndirect(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride)
+    {
+        Record(Command::COMMAND_MULTI_DRAW_ELEMENTS_INDIRECT, mode, boundVertexArray, drawcount);
+    }
+
+    void RecordingDevice::GenTextures(GLsizei n, GLuint* textures)
+    {
+        Record(Command::COMMAND_GEN_TEXTURES, GL_NONE, 0, n);
+        GenNames(n, textures);
+    }
+
+    void RecordingDevice::DeleteTextures(GLsizei n, const GLuint* textures)
+    {
+        Record(Command::COMMAND_DELETE_TEXTURES, GL_NONE, n > 0 && textures ? textures[0] : 0, n);
+        for (GLsizei i = 0; textures && i < n; ++i)
+        {
+            for (auto& [unit, texture] : boundTexture2ds)
+            {
+                if (texture == textures[i])
+                    texture = 0;
+            }
+        }
+    }
+
+    void RecordingDevice::BindTexture(GLenum target, GLuint texture)
+    {
+        Record(Command::COMMAND_BIND_TEXTURE, target, texture);
+        if (target == GL_TEXTURE_2D)
+            boundTexture2ds[activeTexture] = texture;
+    }
+
+    void RecordingDevice::ActiveTexture(GLenum texture)
+    {
+        Record(Command::COMMAND_ACTIVE_TEXTURE, texture);
+        activeTexture = texture;
+    }
+
+    void RecordingDevice::TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels)
+    {
+        const auto& it = boundTexture2ds.find(activeTexture);
+        GLuint texture = it != boundTexture2ds.end() ? it->second : 0;
+        Record(Command::COMMAND_TEX_IMAGE_2D, target, texture, static_cast<GLsizeiptr>(width) * height);
+    }
+
+    void RecordingDevice::TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* pixels)
+    {
+        const auto& it = boundTexture2ds.find(activeTexture);
+        GLuint texture = it != boundTexture2ds.end() ? it->second : 0;
+        Record(Command::COMMAND_TEX_SUB_IMAGE_2D, target, texture, static_cast<GLsizeiptr>(width) * height);
+    }
+
+    void RecordingDevice::CompressedTexImage2D(GLenum target, GLint level, GLenum internalformat, GLsizei width, GLsizei height, GLint border, GLsizei imageSize, const void* data)
+    {
+        const auto& it = boundTexture2ds.find(activeTexture);
+        GLuint texture = it != boundTexture2ds.end() ? it->second : 0;
+        Record(Command::COMMAND_COMPRESSED_TEX_IMAGE_2D, target, texture, imageSize);
+    }
+
+    void RecordingDevice::CompressedTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLsizei imageSize, const void* data)
+    {
+        const auto& it = boundTexture2ds.find(activeTexture);
+        GLuint texture = it != boundTexture2ds.end() ? it->second : 0;
+        Record(Command::COMMAND_COMPRESSED_TEX_SUB_IMAGE_2D, target, texture, imageSize);
+    }
+
+    void RecordingDevice::TexParameteri(GLenum target, GLenum pname, GLint param)
+    {
+        Record(Command::COMMAND_TEX_PARAMETERI, pname, param);
+    }
+
+    void RecordingDevice::GenerateMipmap(GLenum target)
+    {
+        Record(Command::COMMAND_GENERATE_MIPMAP, target);
+    }
+
+    void RecordingDevice::GenFramebuffers(GLsizei n, GLuint* framebuffers)
+    {
+        Record(Command::COMMAND_GEN_FRAMEBUFFERS, GL_NONE, 0, n);
+        GenNames(n, framebuffers);
+    }
+
+    void RecordingDevice::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+    {
+        Record(Command::COMMAND_DELETE_FRAMEBUFFERS, GL_NONE, n > 0 && framebuffers ? framebuffers[0] : 0, n);
+        for (GLsizei i = 0; framebuffers && i < n; ++i)
+        {
+            if (boundFramebuffer == framebuffers[i])
+                boundFramebuffer = 0;
+        }
+    }
+
+    void RecordingDevice::BindFramebuffer(GLenum target, GLuint framebuffer)
+    {
+        Record(Command::COMMAND_BIND_FRAMEBUFFER, target, framebuffer);
+        boundFramebuffer = framebuffer;
+    }
+
+    void RecordingDevice::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+    {
+        Record(Command::COMMAND_FRAMEBUFFER_TEXTURE_2D, attachment, texture);
+    }
+
+    GLenum RecordingDevice::CheckFramebufferStatus(GLenum target)
+    {
+        Record(Command::COMMAND_CHECK_FRAMEBUFFER_STATUS, target, boundFramebuffer);
+        return GL_FRAMEBUFFER_COMPLETE;
+    }
+
+    void RecordingDevice::GenRenderbuffers(GLsizei n, GLuint* renderbuffers)
+    {
+        Record(Command::COMMAND_GEN_RENDERBUFFERS, GL_NONE, 0, n);
+        GenNames(n, renderbuffers);
+    }
+
+    void RecordingDevice::DeleteRenderbuffers(GLsizei n, const GLuint* renderbuffers)
+    {
+        Record(Command::COMMAND_DELETE_RENDERBUFFERS, GL_NONE, n > 0 && renderbuffers ? renderbuffers[0] : 0, n);
+        for (GLsizei i = 0; renderbuffers && i < n; ++i)
+        {
+            if (boundRenderbuffer == renderbuffers[i])
+                boundRenderbuffer = 0;
+        }
+    }
+
+    void RecordingDevice::BindRenderbuffer(GLenum target, GLuint renderbuffer)
+    {
+        Record(Command::COMMAND_BIND_RENDERBUFFER, target, renderbuffer);
+        boundRenderbuffer = renderbuffer;
+    }
+
+    void RecordingDevice::RenderbufferStorage(GLenum target, GLenum internalformat, GLsizei width, GLsizei height)
+    {
+        Record(Command::COMMAND_RENDERBUFFER_STORAGE, internalformat, boundRenderbuffer, static_cast<GLsizeiptr>(width) * height);
+    }
+
+    void RecordingDevice::FramebufferRenderbuffer(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer)
+    {
+        Record(Command::COMMAND_FRAMEBUFFER_RENDERBUFFER, attachment, renderbuffer);
+    }
+
+    void RecordingDevice::GenQueries(GLsizei n, GLuint* ids)
+    {
+        Record(Command::COMMAND_GEN_QUERIES, GL_NONE, 0, n);
+        GenNames(n, ids);
+    }
+
+    void RecordingDevice::DeleteQueries(GLsizei n, const GLuint* ids)
+    {
+        Record(Command::COMMAND_DELETE_QUERIES, GL_NONE, n > 0 && ids ? ids[0] : 0, n);
+    }
+
+    void RecordingDevice::BeginQuery(GLenum target, GLuint id)
+    {
+        Record(Command::COMMAND_BEGIN_QUERY, target, id);
+    }
+
+    void RecordingDevice::EndQuery(GLenum target)
+    {
+        Record(Command::COMMAND_END_QUERY, target);
+    }
+
+    void RecordingDevice::GetQueryObjectiv(GLuint id, GLenum pname, GLint* params)
+    {
+        Record(Command::COMMAND_GET_QUERY_OBJECTIV, pname, id);
+        // Nothing runs on this device, so results are always available and zero
+        if (params)
+            *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    void RecordingDevice::GetQueryObjectui64v(GLuint id, GLenum pname, GLuint64* params)
+    {
+        Record(Command::COMMAND_GET_QUERY_OBJECTUI64V, pname, id);
+        if (params)
+            *params = pname == GL_QUERY_RESULT_AVAILABLE ? GL_TRUE : 0;
+    }
+
+    GLsync RecordingDevice::FenceSync(GLenum condition, GLbitfield flags)
+    {
+        GLuint name = 0;
+        GenNames(1, &name);
+        Record(Command::COMMAND_FENCE_SYNC, condition, name);
+        return reinterpret_cast<GLsync>(static_cast<uintptr_t>(name));
+    }
+
+    GLenum RecordingDevice::ClientWaitSync(GLsync sync, GLbitfield flags, GLuint64 timeout)
+    {
+        // Nothing is ever in flight
+        Record(Command::COMMAND_CLIENT_WAIT_SYNC, GL_NONE, static_cast<GLint>(reinterpret_cast<uintptr_t>(sync)));
+        return GL_ALREADY_SIGNALED;
+    }
+
+    void RecordingDevice::DeleteSync(GLsync sync)
+    {
+        Record(Command::COMMAND_DELETE_SYNC, GL_NONE, static_cast<GLint>(reinterpret_cast<uintptr_t>(sync)));
+    }
+
+    GLuint RecordingDevice::CreateShader(GLenum type)
+    {
+        GLuint shader = 0;
+        GenNames(1, &shader);
+        Record(Command::COMMAND_CREATE_SHADER, type, shader);
+        return shader;
+    }
+
+    void RecordingDevice::DeleteShader(GLuint shader)
+    {
+        Record(Command::COMMAND_DELETE_SHADER, GL_NONE, shader);
+    }
+
+    void RecordingDevice::ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length)
+    {
+        Record(Command::COMMAND_SHADER_SOURCE, GL_NONE, shader, count);
+    }
+
+    void RecordingDevice::CompileShader(GLuint shader)
+    {
+        Record(Command::COMMAND_COMPILE_SHADER, GL_NONE, shader);
+    }
+
+    void RecordingDevice::ShaderBinary(GLsizei count, const GLuint* shaders, GLenum binaryFormat, const void* binary, GLsizei length)
+    {
+        Record(Command::COMMAND_SHADER_BINARY, binaryFormat, count > 0 && shaders ? shaders[0] : 0, length);
+    }
+
+    void RecordingDevice::SpecializeShader(GLuint shader, const GLchar* pEntryPoint, GLuint numSpecializationConstants, const GLuint* pConstantIndex, const GLuint* pConstantValue)
+    {
+        Record(Command::COMMAND_SPECIALIZE_SHADER, GL_NONE, shader, numSpecializationConstants);
+    }
+
+    void RecordingDevice::GetShaderiv(GLuint shader, GLenum pname, GLint* params)
+    {
+        Record(Command::COMMAND_GET_SHADERIV, pname, shader);
+        if (params)
+            *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+    }
+
+    void RecordingDevice::GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        Record(Command::COMMAND_GET_SHADER_INFO_LOG, GL_NONE, shader);
+        if (length)
+            *length = 0;
+        if (infoLog && bufSize > 0)
+            infoLog[0] = '\0';
+    }
+
+    GLuint RecordingDevice::CreateProgram()
+    {
+        GLuint program = 0;
+        GenNames(1, &program);
+        Record(Command::COMMAND_CREATE_PROGRAM, GL_NONE, program);
+        return program;
+    }
+
+    void RecordingDevice::DeleteProgram(GLuint program)
+    {
+        Record(Command::COMMAND_DELETE_PROGRAM, GL_NONE, program);
+        uniformLocations.erase(program);
+        if (boundProgram == program)
+            boundProgram = 0;
+    }
+
+    void RecordingDevice::AttachShader(GLuint program, GLuint shader)
+    {
+        Record(Command::COMMAND_ATTACH_SHADER, GL_NONE, program, shader);
+    }
+
+    void RecordingDevice::LinkProgram(GLuint program)
+    {
+        Record(Command::COMMAND_LINK_PROGRAM, GL_NONE, program);
+    }
+
+    void RecordingDevice::UseProgram(GLuint program)
+    {
+        Record(Command::COMMAND_USE_PROGRAM, GL_NONE, program);
+        boundProgram = program;
+    }
+
+    void RecordingDevice::GetProgramiv(GLuint program, GLenum pname, GLint* params)
+    {
+        Record(Command::COMMAND_GET_PROGRAMIV, pname, program);
+        if (params)
+            *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;
+    }
+
+    void RecordingDevice::GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog)
+    {
+        Record(Command::COMMAND_GET_PROGRAM_INFO_LOG, GL_NONE, program);
+        if (length)
+            *length = 0;
+        if (infoLog && bufSize > 0)
+            infoLog[0] = '\0';
+    }
+
+    void RecordingDevice::ProgramBinary(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length)
+    {
+        Record(Command::COMMAND_PROGRAM_BINARY, binaryFormat, program, length);
+    }
+
+    void RecordingDevice::GetProgramBinary(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary)
+    {
+        Record(Command::COMMAND_GET_PROGRAM_BINARY, GL_NONE, program);
+        if (length)
+            *length = 0;
+        if (binaryFormat)
+            *binaryFormat = GL_NONE;
+    }
+
+    GLint RecordingDevice::GetUniformLocation(GLuint program, const GLchar* name)
+    {
+        Record(Command::COMMAND_GET_UNIFORM_LOCATION, GL_NONE, program);
+        if (!name)
+            return -1;
+
+        // Every name exists, locations are handed out in query order per program
+        auto& locations = uniformLocations[program];
+        auto [it, isInserted] = locations.try_emplace(name, static_cast<GLint>(locations.size()));
+        return it->second;
+    }
+
+    void RecordingDevice::GetProgramInterfaceiv(GLuint program, GLenum programInterface, GLenum pname, GLint* params)
+    {
+        Record(Command::COMMAND_GET_PROGRAM_INTERFACEIV, pname, program);
+        // Nothing is linked on this device, programs expose no active resources
+        if (params)
+            *params = 0;
+    }
+
+    void RecordingDevice::GetProgramResourceiv(GLuint program, GLenum programInterface, GLuint index, GLsizei propCount, const GLenum* props, GLsizei bufSize, GLsizei* length, GLint* params)
+    {
+        Record(Command::COMMAND_GET_PROGRAM_RESOURCEIV, programInterface, program);
+        if (length)
+            *length = 0;
+    }
+
+    void RecordingDevice::GetProgramResourceName(GLuint program, GLenum programInterface, GLuint index, GLsizei bufSize, GLsizei* length, GLchar* name)
+    {
+        Record(Command::COMMAND_GET_PROGRAM_RESOURCE_NAME, programInterface, program);
+        if (length)
+            *length = 0;
+        if (name && bufSize > 0)
+            name[0] = '\0';
+    }
+
+    void RecordingDevice::Uniformiv(GLint location, GLint components, GLsizei count, const GLint* value)
+    {
+        Record(Command::COMMAND_UNIFORMIV, GL_NONE, location, static_cast<GLsizeiptr>(components) * count);
+    }
+
+    void RecordingDevice::Uniformuiv(GLint location, GLint components, GLsizei count, const GLuint* value)
+    {
+        Record(Command::COMMAND_UNIFORMUIV, GL_NONE, location, static_cast<GLsizeiptr>(components) * count);
+    }
+
+    void RecordingDevice::Uniformfv(GLint location, GLint components, GLsizei count, const GLfloat* value)
+    {
+        Record(Command::COMMAND_UNIFORMFV, GL_NONE, location, static_cast<GLsizeiptr>(components) * count);
+    }
+
+    void RecordingDevice::Uniformdv(GLint location, GLint components, GLsizei count, const GLdouble* value)
+    {
+        Record(Command::COMMAND_UNIFORMDV, GL_NONE, location, static_cast<GLsizeiptr>(components) * count);
+    }
+
+    void RecordingDevice::UniformMatrixfv(GLint location, GLint dimension, GLsizei count, GLboolean transpose, const GLfloat* value)
+    {
+        Record(Command::COMMAND_UNIFORM_MATRIXFV, GL_NONE, location, static_cast<GLsizeiptr>(dimension) * dimension * count);
+    }
+
+    void RecordingDevice::Reset()
+    {
+        commandAmounts.fill(0);
+        commands.clear();
+    }
+
+    unsigned long long RecordingDevice::GetCommandAmount(Command::CommandType t) const
+    {
+        if (t < 0 || t >= Command::COMMAND_TYPE_AMOUNT)
+            return 0;
+        return commandAmounts[t];
+    }
+
+    unsigned long long RecordingDevice::GetTotalCommandAmount() const
+    {
+        return std::accumulate(commandAmounts.begin(), commandAmounts.end(), 0ull);
+    }
+
+    unsigned long long RecordingDevice::GetDrawCallAmount() const
+    {
+        return
+            commandAmounts[Command::COMMAND_DRAW_ELEMENTS] +
+            commandAmounts[Command::COMMAND_DRAW_ELEMENTS_BASE_VERTEX] +
+            commandAmounts[Command::COMMAND_DRAW_ELEMENTS_INSTANCED_BASE_VERTEX] +
+            commandAmounts[Command::COMMAND_MULTI_DRAW_ELEMENTS_INDIRECT];
+    }
+
+    unsigned long long RecordingDevice::GetStateChangeAmount() const
+    {
+        return
+            commandAmounts[Command::COMMAND_ENABLE] +
+            commandAmounts[Command::COMMAND_DISABLE] +
+            commandAmounts[Command::COMMAND_BLEND_FUNC] +
+            commandAmounts[Command::COMMAND_STENCIL_FUNC] +
+            commandAmounts[Command::COMMAND_STENCIL_MASK] +
+            commandAmounts[Command::COMMAND_STENCIL_OP] +
+            commandAmounts[Command::COMMAND_DEPTH_FUNC] +
+            commandAmounts[Command::COMMAND_DEPTH_MASK] +
+            commandAmounts[Command::COMMAND_VIEWPORT] +
+            commandAmounts[Command::COMMAND_BIND_BUFFER] +
+            commandAmounts[Command::COMMAND_BIND_VERTEX_BUFFER] +
+            commandAmounts[Command::COMMAND_BIND_BUFFER_BASE] +
+            commandAmounts[Command::COMMAND_BIND_VERTEX_ARRAY] +
+            commandAmounts[Command::COMMAND_BIND_TEXTURE] +
+            commandAmounts[Command::COMMAND_ACTIVE_TEXTURE] +
+            commandAmounts[Command::COMMAND_BIND_FRAMEBUFFER] +
+            commandAmounts[Command::COMMAND_BIND_RENDERBUFFER] +
+            commandAmounts[Command::COMMAND_USE_PROGRAM];
+    }
+
+    unsigned long long RecordingDevice::GetUniformUploadAmount() const
+    {
+        return
+            commandAmounts[Command::COMMAND_UNIFORMIV] +
+            commandAmounts[Command::COMMAND_UNIFORMUIV] +
+            commandAmounts[Command::COMMAND_UNIFORMFV] +
+            commandAmounts[Command::COMMAND_UNIFORMDV] +
+            commandAmounts[Command::COMMAND_UNIFORM_MATRIXFV];
+    }
+
+    const std::vector<RecordingDevice::Command>& RecordingDevice::GetCommands() const
+    {
+        return commands;
+    }
+
+    const char* RecordingDevice::GetCommandName(Command::CommandType t)
+    {
+        static constexpr const char* names[] = {
+            "GetIntegerv",
+            "Enable",
+            "Disable",
+            "BlendFunc",
+            "StencilFunc",
+            "StencilMask",
+            "StencilOp",
+            "DepthFunc",
+            "DepthMask",
+            "Viewport",
+            "ClearColor",
+            "Clear",
+            "Flush",
+            "Finish",
+            "GenBuffers",
+            "DeleteBuffers",
+            "BindBuffer",
+            "BufferData",
+            "BufferSubData",
+            "BufferStorage",
+            "CopyBufferSubData",
+            "BindBufferBase",
+            "MapBufferRange",
+            "UnmapBuffer",
+            "GenVertexArrays",
+            "DeleteVertexArrays",
+            "BindVertexArray",
+            "VertexAttribPointer",
+            "EnableVertexAttribArray",
+            "VertexAttribFormat",
+            "VertexAttribBinding",
+            "BindVertexBuffer",
+            "VertexBindingDivisor",
+            "DrawElements",
+            "DrawElementsBaseVertex",
+            "DrawElementsInstancedBaseVertex",
+            "MultiDrawElementsIndirect",
+            "GenTextures",
+            "DeleteTextures",
+            "BindTexture",
+            "ActiveTexture",
+            "TexImage2D",
+            "TexSubImage2D",
+            "CompressedTexImage2D",
+            "CompressedTexSubImage2D",
+            "TexParameteri",
+            "GenerateMipmap",
+            "GenFramebuffers",
+            "DeleteFramebuffers",
+            "BindFramebuffer",
+            "FramebufferTexture2D",
+            "CheckFramebufferStatus",
+            "GenRenderbuffers",
+            "DeleteRenderbuffers",
+            "BindRenderbuffer",
+            "RenderbufferStorage",
+            "FramebufferRenderbuffer",
+            "GenQueries",
+            "DeleteQueries",
+            "BeginQuery",
+            "EndQuery",
+            "GetQueryObjectiv",
+            "GetQueryObjectui64v",
+            "FenceSync",
+            "ClientWaitSync",
+            "DeleteSync",
+            "CreateShader",
+            "DeleteShader",
+            "ShaderSource",
+            "CompileShader",
+            "ShaderBinary",
+            "SpecializeShader",
+            "GetShaderiv",
+            "GetShaderInfoLog",
+            "CreateProgram",
+            "DeleteProgram",
+            "AttachShader",
+            "LinkProgram",
+            "UseProgram",
+            "GetProgramiv",
+            "GetProgramInfoLog",
+            "ProgramBinary",
+            "GetProgramBinary",
+            "GetUniformLocation",
+            "GetProgramInterfaceiv",
+            "GetProgramResourceiv",
+            "GetProgramResourceName",
+            "Uniformiv",
+            "Uniformuiv",
+            "Uniformfv",
+            "Uniformdv",
+            "UniformMatrixfv"
+        };
+        static_assert(std::size(names) == Command::COMMAND_TYPE_AMOUNT, "Command names mismatch command types");
+
+        if (t < 0 || t >= Command::COMMAND_TYPE_AMOUNT)
+            return "Unknown";
+        return names[t];
+    }
+
+    void RecordingDevice::Record(Command::CommandType t, GLenum target, GLint id, GLsizeiptr amount)
+    {
+        ++commandAmounts[t];
+        if (IsRecording)
+            commands.emplace_back(Command{ t, target, id, amount });
+    }
+
+    void RecordingDevice::GenNames(GLsizei n, GLuint* names)
+    {
+        for (GLsizei i = 0; names && i < n; ++i)
+            names[i] = nextName++;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include "graphics/device/StateTracker.h"
+
+#include "graphics/device/IDevice.h"
+
+namespace RyuRenderer::Graphics::Device
+{
+    void StateTracker::UseProgram(GLuint p)
+    {
+        if (Change(program, p))
+            IDevice::Current().UseProgram(p);
+    }
+
+    void StateTracker::BindVertexArray(GLuint array)
+    {
+        if (!Change(vertexArray, array))
+            return;
+
+        IDevice::Current().BindVertexArray(array);
+        // Element array and vertex buffer bindings belong to the vertex array
+        *FindBuffer(GL_ELEMENT_ARRAY_BUFFER) = {};
+        vertexBuffers.clear();
+    }
+
+    void StateTracker::BindBuffer(GLenum target, GLuint buffer)
+    {
+        auto* t = FindBuffer(target);
+        if (!t)
+        {
+            ++issuedCallAmount;
+            IDevice::Current().BindBuffer(target, buffer);
+            return;
+        }
+
+        if (Change(*t, buffer))
+            IDevice::Current().BindBuffer(target, buffer);
+    }
+
+    void StateTracker::BindVertexBuffer(GLuint bindingIdx, GLuint buffer, GLintptr offset, GLsizei stride)
+    {
+        if (bindingIdx >= vertexBuffers.size())
+            vertexBuffers.resize(bindingIdx + 1);
+
+        if (Change(vertexBuffers[bindingIdx], { buffer, offset, stride }))
+            IDevice::Current().BindVertexBuffer(bindingIdx, buffer, offset, stride);
+    }
+
+    void StateTracker::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+    {
+        auto* t = FindBufferBase(target, index);
+        if (!t)
+        {
+            ++issuedCallAmount;
+            IDevice::Current().BindBufferBase(target, index, buffer);
+            return;
+        }
+
+        if (!Change(*t, buffer))
+            return;
+
+        IDevice::Current().BindBufferBase(target, index, buffer);
+        *FindBuffer(target) = { buffer, true };
+    }
+
+    void StateTracker::BindTexture(GLint unitIdx, GLenum target, GLuint texture)
+    {
+        auto& device = IDevice::Current();
+
+        auto* t = FindTexture(unitIdx, target);
+        if (t && t->Is(texture))
+        {
+            ++elidedCallAmount;
+            return;
+        }
+
+        if (Change(activeTextureUnitIdx, unitIdx))
+            device.ActiveTexture(GL_TEXTURE0 + unitIdx);
+
+        ++issuedCallAmount;
+        device.BindTexture(target, texture);
+        if (t)
+            *t = { texture, true };
+    }
+
+    void StateTracker::BindFramebuffer(GLenum target, GLuint framebuffer)
+    {
+        bool isChanged = false;
+        if (target == GL_FRAMEBUFFER)
+            isChanged = !drawFramebuffer.Is(framebuffer) || !readFramebuffer.Is(framebuffer);
+        else if (target == GL_DRAW_FRAMEBUFFER)
+            isChanged = !drawFramebuffer.Is(framebuffer);
+        else if (target == GL_READ_FRAMEBUFFER)
+            isChanged = !readFramebuffer.Is(framebuffer);
+
+        if (!isChanged)
+        {
+            ++elidedCallAmount;
+            return;
+        }
+
+        ++issuedCallAmount;
+        IDevice::Current().BindFramebuffer(target, framebuffer);
+        if (target != GL_READ_FRAMEBUFFER)
+            drawFramebuffer = { framebuffer, true };
+        if (target != GL_DRAW_FRAMEBUFFER)
+            readFramebuffer = { framebuffer, true };
+    }
+
+    bool StateTracker::IsProgramUsing(GLuint p) const
+    {
+        return p != 0 && program.Is(p);
+    }
+
+    bool StateTracker::IsVertexArrayBound(GLuint array) const
+    {
+        return vertexArray.Is(array);
+    }
+
+    bool StateTracker::IsBufferBound(GLenum target, GLuint buffer) const
+    {
+        const auto* t = FindBuffer(target);
+        return t && t->Is(buffer);
+    }
+
+    bool StateTracker::IsVertexBufferBound(GLuint bindingIdx, GLuint buffer) const
+    {
+        return bindingIdx < vertexBuffers.size() &&
+            vertexBuffers[bindingIdx].IsKnown &&
+            std::get<0>(vertexBuffers[bindingIdx].Value) == buffer;
+    }
+
+    bool StateTracker::IsBufferBaseBound(GLenum target, GLuint index, GLuint buffer) const
+    {
+        const auto* t = FindBufferBase(target, index);
+        return t && t->Is(buffer);
+    }
+
+    bool StateTracker::IsTextureBound(GLint unitIdx, GLenum target, GLuint texture) const
+    {
+        const auto* t = FindTexture(unitIdx, target);
+        return t && t->Is(texture);
+    }
+
+    bool StateTracker::IsFramebufferBound(GLenum target, GLuint framebuffer) const
+    {
+        if (target == GL_READ_FRAMEBUFFER)
+            return readFramebuffer.Is(framebuffer);
+        if (target == GL_DRAW_FRAMEBUFFER)
+            return drawFramebuffer.Is(framebuffer);
+        return drawFramebuffer.Is(framebuffer) && readFramebuffer.Is(framebuffer);
+    }
+
+    void StateTracker::DeleteProgram(GLuint p)
+    {
+        IDevice::Current().DeleteProgram(p);
+        // A deleted program stays in use until another one is used, but its name can be reused right away
+        if (program.Is(p))
+            program = {};
+    }
+
+    void StateTracker::DeleteVertexArrays(GLsizei n, const GLuint* arrays)
+    {
+        IDevice::Current().DeleteVertexArrays(n, arrays);
+        for (GLsizei i = 0; arrays && i < n; ++i)
+        {
+            if (arrays[i] != 0 && vertexArray.Is(arrays[i]))
+            {
+                vertexArray = { 0, true };
+                *FindBuffer(GL_ELEMENT_ARRAY_BUFFER) = {};
+                vertexBuffers.clear();
+            }
+        }
+    }
+
+    void StateTracker::DeleteBuffers(GLsizei n, const GLuint* b)
+    {
+        IDevice::Current().DeleteBuffers(n, b);
+        for (GLsizei i = 0; b && i < n; ++i)
+        {
+            for (auto& t : buffers)
+            {
+                if (b[i] != 0 && t.Is(b[i]))
+                    t = { 0, true };
+            }
+            for (auto& bases : bufferBases)
+            {
+                for (auto& t : bases)
+                {
+                    if (b[i] != 0 && t.Is(b[i]))
+                        t = { 0, true };
+                }
+            }
+            // Only the buffer of the binding point is reverted, so forget the whole binding
+            for (auto& t : vertexBuffers)
+            {
+                if (b[i] != 0 && t.IsKnown && std::get<0>(t.Value) == b[i])
+                    t = {};
+            }
+        }
+    }
+
+    void StateTracker::DeleteTextures(GLsizei n, const GLuint* t)
+    {
+        IDevice::Current().DeleteTextures(n, t);
+        for (GLsizei i = 0; t && i < n; ++i)
+        {
+            for (auto& unit : textures)
+            {
+                for (auto& target : unit)
+                {
+                    if (t[i] != 0 && target.Is(t[i]))
+                        target = { 0, true };
+                }
+            }
+        }
+    }
+
+    void StateTracker::DeleteFramebuffers(GLsizei n, const GLuint* framebuffers)
+    {
+        IDevice::Current().DeleteFramebuffers(n, framebuffers);
+        for (GLsizei i = 0; framebuffers && i < n; ++i)
+        {
+            if (framebuffers[i] == 0)
+                continue;
+            if (drawFramebuffer.Is(framebuffers[i]))
+                drawFramebuffer = { 0, true };
+            if (readFramebuffer.Is(framebuffers[i]))
+                readFramebuffer = { 0, true };
+        }
+    }
+
+    void StateTracker::Enable(GLenum cap)
+    {
+        SetEnabled(cap, true);
+    }
+
+    void StateTracker::Disable(GLenum cap)
+    {
+        SetEnabled(cap, false);
+    }
+
+    void StateTracker::BlendFunc(GLenum sfactor, GLenum dfactor)
+    {
+        if (Change(blendFunc, { sfactor, dfactor }))
+            IDevice::Current().BlendFunc(sfactor, dfactor);
+    }
+
+    void StateTracker::DepthFunc(GLenum func)
+    {
+        if (Change(depthFunc, func))
+            IDevice::Current().DepthFunc(func);
+    }
+
+    void StateTracker::DepthMask(GLboolean flag)
+    {
+        if (Change(depthMask, flag))
+            IDevice::Current().DepthMask(flag);
+    }
+
+    void StateTracker::StencilFunc(GLenum func, GLint ref, GLuint mask)
+    {
+        if (Change(stencilFunc, { func, ref, mask }))
+            IDevice::Current().StencilFunc(func, ref, mask);
+    }
+
+    void StateTracker::StencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+    {
+        if (Change(stencilOp, { sfail, dpfail, dppass }))
+            IDevice::Current().StencilOp(sfail, dpfail, dppass);
+    }
+
+    void StateTracker::StencilMask(GLuint mask)
+    {
+        if (Change(stencilMask, mask))
+            IDevice::Current().StencilMask(mask);
+    }
+
+    void StateTracker::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+    {
+        if (Change(viewport, { x, y, width, height }))
+            IDevice::Current().Viewport(x, y, width, height);
+    }
+
+    void StateTracker::Invalidate()
+    {
+        program = {};
+        vertexArray = {};
+        vertexBuffers.clear();
+        buffers = {};
+        for (auto& bases : bufferBases)
+            bases.clear();
+        activeTextureUnitIdx = {};
+        textures.clear();
+        drawFramebuffer = {};
+        readFramebuffer = {};
+
+        enables.clear();
+        blendFunc = {};
+        depthFunc = {};
+        depthMask = {};
+        stencilFunc = {};
+        stencilOp = {};
+        stencilMask = {};
+        viewport = {};
+    }
+
+    void StateTracker::ResetCallAmounts()
+    {
+        issuedCallAmount = 0;
+        elidedCallAmount = 0;
+    }
+
+    unsigned long long StateTracker::GetIssuedCallAmount() const
+    {
+        return issuedCallAmount;
+    }
+
+    unsigned long long StateTracker::GetElidedCallAmount() const
+    {
+        return elidedCallAmount;
+    }
+
+    StateTracker::Tracked<GLuint>* StateTracker::FindBuffer(GLenum target)
+    {
+        return const_cast<Tracked<GLuint>*>(static_cast<const StateTracker*>(this)->FindBuffer(target));
+    }
+
+    const StateTracker::Tracked<GLuint>* StateTracker::FindBuffer(GLenum target) const
+    {
+        switch (target)
+        {
+        case GL_ARRAY_BUFFER: return &buffers[0];
+        case GL_ELEMENT_ARRAY_BUFFER: return &buffers[1];
+        case GL_UNIFORM_BUFFER: return &buffers[2];
+        case GL_SHADER_STORAGE_BUFFER: return &buffers[3];
+        case GL_DRAW_INDIRECT_BUFFER: return &buffers[4];
+        case GL_COPY_READ_BUFFER: return &buffers[5];
+        case GL_COPY_WRITE_BUFFER: return &buffers[6];
+        case GL_PIXEL_UNPACK_BUFFER: return &buffers[7];
+        default: return nullptr;
+        }
+    }
+
+    StateTracker::Tracked<GLuint>* StateTracker::FindBufferBase(GLenum target, GLuint index)
+    {
+        if (target == GL_UNIFORM_BUFFER && index >= bufferBases[0].size())
+            bufferBases[0].resize(index + 1);
+        else if (target == GL_SHADER_STORAGE_BUFFER && index >= bufferBases[1].size())
+            bufferBases[1].resize(index + 1);
+        return const_cast<Tracked<GLuint>*>(static_cast<const StateTracker*>(this)->FindBufferBase(target, index));
+    }
+
+    const StateTracker::Tracked<GLuint>* StateTracker::FindBufferBase(GLenum target, GLuint index) const
+    {
+        const std::vector<Tracked<GLuint>>* bases = nullptr;
+        if (target == GL_UNIFORM_BUFFER)
+            bases = &bufferBases[0];
+        else if (target == GL_SHADER_STORAGE_BUFFER)
+            bases = &bufferBases[1];
+
+        if (!bases || index >= bases->size())
+            return nullptr;
+        return &(*bases)[index];
+    }
+
+    StateTracker::Tracked<GLuint>* StateTracker::FindTexture(GLint unitIdx, GLenum target)
+    {
+        if (unitIdx < 0)
+            return nullptr;
+        if (static_cast<size_t>(unitIdx) >= textures.size())
+            textures.resize(static_cast<size_t>(unitIdx) + 1);
+        return const_cast<Tracked<GLuint>*>(static_cast<const StateTracker*>(this)->FindTexture(unitIdx, target));
+    }
+
+    const StateTracker::Tracked<GLuint>* StateTracker::FindTexture(GLint unitIdx, GLenum target) const
+    {
+        if (unitIdx < 0 || static_cast<size_t>(unitIdx) >= textures.size())
+            return nullptr;
+
+        switch (target)
+        {
+        case GL_TEXTURE_2D: return &textures[unitIdx][TEXTURE_TARGET_2D];
+        case GL_TEXTURE_CUBE_MAP: return &textures[unitIdx][TEXTURE_TARGET_CUBE_MAP];
+        case GL_TEXTURE_2D_ARRAY: return &textures[unitIdx][TEXTURE_TARGET_2D_ARRAY];
+        case GL_TEXTURE_3D: return &textures[unitIdx][TEXTURE_TARGET_3D];
+        default: return nullptr;
+        }
+    }
+
+    void StateTracker::SetEnabled(GLenum cap, bool isEnabled)
+    {
+        if (!Change(enables[cap], isEnabled))
+            return;
+
+        if (isEnabled)
+            IDevice::Current().Enable(cap);
+        else
+            IDevice::Current().Disable(cap);
+    }
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "glm/gtc/type_ptr.hpp"
 
 #include <cmath>
+#include <limits>
 
 #include "graphics/scene/Scene.h"
 
@@ -261,6 +262,16 @@ namespace RyuRenderer::Graphics::Scene
         return aspectRatio;
     }
 
+    float Camera::GetScreenSizeScale(float viewDis) const
+    {
+        if (!isPerspective)
+            return orthoHeight > 0.f ? 1.f / orthoHeight : 0.f;
+
+        // Objects at or behind the eye cover the whole screen
+        const float viewHeight = 2.f * viewDis * std::tan(glm::radians(vFOV) * 0.5f);
+        return viewHeight > 0.f ? 1.f / viewHeight : std::numeric_limits<float>::max();
+    }
+
     bool Camera::GetIsVFOVPriority()
     {
         return isVFOVPriority;
@@ -10,6 +10,48 @@ namespace RyuRenderer::Graphics::Scene
         shader->Use();
     }
 
+    uint32_t IMaterial::GetInstanceSortId(const MaterialInstance& instance) const
+    {
+        return 0;
+    }
+
+    bool IMaterial::IsTranslucent() const
+    {
+        return false;
+    }
+
+    bool IMaterial::IsInstancingSupported() const
+    {
+        return false;
+    }
+
+    void IMaterial::SetInstanced(bool isInstanced) const
+    {
+    }
+
+    void IMaterial::SetVertexDecode(const Mesh::VertexDecode& decode) const
+    {
+    }
+
+    bool IMaterial::IsMultiDrawSupported() const
+    {
+        return false;
+    }
+
+    bool IMaterial::BindMultiDraw(const MaterialInstance& instance) const
+    {
+        return false;
+    }
+
+    bool IMaterial::IsMultiDrawCompatible(const MaterialInstance& a, const MaterialInstance& b) const
+    {
+        return a == b;
+    }
+
+    void IMaterial::WriteMaterialRecord(const MaterialInstance& instance, MaterialRecord& record) const
+    {
+    }
+
     bool IMaterial::IsVaild() const
     {
         if (!shader ||
@@ -18,6 +60,11 @@ namespace RyuRenderer::Graphics::Scene
         return true;
     }
 
+    GLuint IMaterial::GetShaderId() const
+    {
+        return shader ? shader->GetId() : 0;
+    }
+
     std::string IMaterial::GetName() const
     {
         return name;
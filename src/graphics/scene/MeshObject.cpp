@@ -0,0 +1,22 @@
+#include "graphics/scene/MeshObject.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    void MeshObject::UpdateBounds()
+    {
+        LocalBounds = Bounds();
+        for (const auto& m : Meshes)
+            LocalBounds.Merge(m.GetBounds());
+        // Coarser levels stay close to the surface of the full detail one
+        for (const auto& chain : LodMeshes)
+        {
+            if (!chain.Levels.empty())
+                LocalBounds.Merge(chain.Levels[0].GetBounds());
+        }
+    }
+
+    Bounds MeshObject::GetWorldBounds() const
+    {
+        return LocalBounds.Transform(Transformer.GetMatrix());
+    }
+}
\ No newline at end of file
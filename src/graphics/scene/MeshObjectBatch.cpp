@@ -1,11 +1,13 @@
 #include "glad/gl.h"
 #include "graphics/scene/MeshObjectBatch.h"
 #include "graphics/scene/IMaterial.h"
+#include "common/Profiler.h"
 
 #include "assimp/Importer.hpp"
 #include "assimp/scene.h"
 #include "assimp/postprocess.h"
 
+#include <algorithm>
 #include <iostream>
 #include <filesystem>
 #include <typeinfo>
@@ -20,34 +22,103 @@ namespace RyuRenderer::Graphics::Scene
         Material = material;
     }
 
-    void MeshObjectBatch::Draw(const glm::mat4& view, const glm::mat4& projection) const
+    void MeshObjectBatch::Submit(
+        RenderQueue& queue, const glm::mat4& view, uint8_t passIdx, const LodSelector* lodSelector, const uint8_t* visibleFlags) const
     {
+        RYU_PROFILE_ZONE("MeshObjectBatch::Submit");
+
         if (!IsVaild())
             return;
 
-        for (auto& mo : MeshObjects)
-        {
-            const auto model = mo.Transformer.GetMatrix();
+        // Gather per object model matrices into one stream, draw items point into it
+        modelStream.resize(MeshObjects.size() + InstancedMeshObjects.size());
+        size_t i = 0;
+        for (const auto& mo : MeshObjects)
+            modelStream[i++] = mo.Transformer.GetMatrix();
+        for (const auto& imo : InstancedMeshObjects)
+            modelStream[i++] = imo.Transformer.GetMatrix();
+
+        const IMaterial* material = Material.get();
+        const bool isTranslucent = material->IsTranslucent();
+        const uint32_t shaderId = material->GetShaderId();
 
-            auto md = mo.MaterialData;
-            if (md.type() == typeid(PhongBlinnMaterialData))
+        size_t visibleAmount = 0;
+        size_t culledAmount = 0;
+        i = 0;
+        for (const auto& mo : MeshObjects)
+        {
+            const size_t objectIdx = i;
+            const auto& model = modelStream[i++];
+            if (visibleFlags && !visibleFlags[objectIdx])
             {
-                auto data = std::any_cast<PhongBlinnMaterialData>(md);
-                data.Model = model;
-                data.View = view;
-                data.Projection = projection;
-                md = data;
+                ++culledAmount;
+                continue;
             }
+            ++visibleAmount;
+
+            const float viewDis = -(view * model[3]).z;
+            const uint32_t materialId = material->GetInstanceSortId(mo.MaterialData);
 
-            Material->SetData(md);
-            Material->Use();
+            auto submitMesh = [&](const Mesh& m)
+            {
+                RenderQueue::DrawItem item;
+                item.Key = queue.MakeKey(passIdx, isTranslucent, shaderId, materialId, m.GetId(), viewDis);
+                item.Material = material;
+                item.Instance = &mo.MaterialData;
+                item.Mesh = &m;
+                item.Model = &model;
+                queue.Submit(item);
+            };
 
             for (const auto& m : mo.Meshes)
-                m.Draw();
+                submitMesh(m);
+
+            if (mo.LodMeshes.empty())
+                continue;
+
+            // Errors are in object space, the largest axis scale of the model bounds how much they grow
+            float maxObjectError = 0.f;
+            if (lodSelector && lodSelector->ViewCamera)
+            {
+                const float scale = std::max({
+                    glm::length(glm::vec3(model[0])), glm::length(glm::vec3(model[1])), glm::length(glm::vec3(model[2])) });
+                const float screenScale = lodSelector->ViewCamera->GetScreenSizeScale(viewDis) * scale;
+                if (screenScale > 0.f)
+                    maxObjectError = lodSelector->MaxScreenError / screenScale;
+            }
+            for (const auto& chain : mo.LodMeshes)
+                submitMesh(chain.Levels[chain.SelectLevel(maxObjectError)]);
+        }
+
+        queue.CountCulling(visibleAmount, culledAmount);
+
+        if (!material->IsInstancingSupported())
+            return;
+
+        for (const auto& imo : InstancedMeshObjects)
+        {
+            const auto& model = modelStream[i++];
+            if (imo.Instances.GetInstanceAmount() <= 0)
+                continue;
+
+            const float viewDis = -(view * model[3]).z;
+            const uint32_t materialId = material->GetInstanceSortId(imo.MaterialData);
+
+            for (const auto& m : imo.Meshes)
+            {
+                RenderQueue::DrawItem item;
+                item.Key = queue.MakeKey(passIdx, isTranslucent, shaderId, materialId, m.GetId(), viewDis);
+                item.Material = material;
+                item.Instance = &imo.MaterialData;
+                item.Mesh = &m;
+                item.Model = &model;
+                item.Instances = &imo.Instances;
+                queue.Submit(item);
+            }
         }
     }
     
-    bool MeshObjectBatch::Match(const type_info& materialType) const
+    bool MeshObjectBatch::Match(const std::type_info& materialType) const
     {
         if (typeid(*Material.get()) == materialType)
             return true;
@@ -56,7 +127,7 @@ namespace RyuRenderer::Graphics::Scene
 
     bool MeshObjectBatch::IsVaild() const
     {
-        if (MeshObjects.empty())
+        if (MeshObjects.empty() && InstancedMeshObjects.empty())
             return false;
         if (!Material)
             return false;
@@ -0,0 +1,239 @@
+#include "graphics/scene/ModelImporter.h"
+
+#include "assimp/Importer.hpp"
+#include "assimp/scene.h"
+#include "assimp/postprocess.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    namespace ModelImporter
+    {
+        // Simplified levels of the full detail one, each with its own compacted vertices in cache friendly order
+        static void BuildLodLevels(ImportedMesh& im, const MeshLodSettings& settings, GLuint cacheSize)
+        {
+            RYU_PROFILE_ZONE("ModelImporter::BuildLodLevels");
+
+            // full stays valid while levels are appended
+            im.Levels.reserve(im.Levels.size() + settings.Levels.size());
+            const auto& full = im.Levels[0];
+            const float extent = MeshSimplifier::GetExtent(full.Indices, full.Positions);
+            for (const auto& ls : settings.Levels)
+            {
+                ImportedMeshLevel level;
+                const size_t targetIndexAmount = static_cast<size_t>(full.Indices.size() / 3 * ls.TriangleRatio) * 3;
+                const float error = MeshSimplifier::Simplify(
+                    full.Indices, full.Positions, targetIndexAmount, ls.MaxError * extent, level.Indices);
+
+                // Levels which barely shrink are not worth their memory
+                const size_t lastIndexAmount = im.Levels.back().Indices.size();
+                if (level.Indices.empty() || level.Indices.size() * 10 > lastIndexAmount * 9)
+                    break;
+
+                MeshOptimizer::OptimizeVertexCache(level.Indices, full.Positions.size(), cacheSize);
+                std::vector<GLuint> remap;
+                const size_t vertexAmount = MeshOptimizer::GenerateFetchRemap(level.Indices, full.Positions.size(), remap);
+                MeshOptimizer::RemapIndices(level.Indices, remap);
+                level.Positions = full.Positions;
+                level.Normals = full.Normals;
+                level.TexCoords = full.TexCoords;
+                MeshOptimizer::RemapVertices(level.Positions, remap, vertexAmount);
+                MeshOptimizer::RemapVertices(level.Normals, remap, vertexAmount);
+                MeshOptimizer::RemapVertices(level.TexCoords, remap, vertexAmount);
+                level.Error = std::max(error, im.Levels.back().Error);
+                im.Levels.emplace_back(std::move(level));
+            }
+        }
+
+        static std::string GetTextureName(const aiMaterial* mat, aiTextureType t)
+        {
+            if (mat->GetTextureCount(t) <= 0)
+                return std::string();
+
+            aiString textureFileName;
+            mat->GetTexture(t, 0, &textureFileName);
+            return textureFileName.C_Str();
+        }
+
+        static void ConvertMesh(const aiMesh& mesh, ImportedMesh& im)
+        {
+            im.Name = mesh.mName.C_Str();
+            im.MaterialIdx = mesh.mMaterialIndex;
+            auto& full = im.Levels.emplace_back();
+            full.Indices.reserve(static_cast<size_t>(mesh.mNumFaces) * 3);
+            for (unsigned int i = 0; i < mesh.mNumFaces; ++i)
+            {
+                const auto& face = mesh.mFaces[i];
+                full.Indices.insert(full.Indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
+            }
+
+            static_assert(sizeof(aiVector3D) == sizeof(std::array<float, 3>));
+            const auto* positions = reinterpret_cast<const std::array<float, 3>*>(mesh.mVertices);
+            const auto* normals = reinterpret_cast<const std::array<float, 3>*>(mesh.mNormals);
+            full.Positions.assign(positions, positions + mesh.mNumVertices);
+            full.Normals.assign(normals, normals + mesh.mNumVertices);
+            full.TexCoords.resize(mesh.mNumVertices);
+            for (unsigned int i = 0; i < mesh.mNumVertices; ++i)
+            {
+                const auto& t = mesh.mTextureCoords[0][i];
+                full.TexCoords[i] = { t.x, t.y };
+            }
+        }
+
+        template <typename T>
+        static uint64_t HashBytes(uint64_t hash, const std::vector<T>& data)
+        {
+            const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+            for (size_t i = 0; i < data.size() * sizeof(T); ++i)
+            {
+                hash ^= bytes[i];
+                hash *= 0x100000001B3ull;
+            }
+            return hash;
+        }
+
+        static uint64_t HashMesh(const ImportedMesh& im)
+        {
+            uint64_t hash = 0xCBF29CE484222325ull;
+            for (const auto& level : im.Levels)
+            {
+                hash = HashBytes(hash, level.Indices);
+                hash = HashBytes(hash, level.Positions);
+                hash = HashBytes(hash, level.Normals);
+                hash = HashBytes(hash, level.TexCoords);
+            }
+            return hash;
+        }
+
+        bool Import(
+            const std::string& modelFilePath,
+            const MeshOptimizationSettings& optimization,
+            const MeshLodSettings& lod,
+            ImportedModel& model,
+            size_t threadAmount,
+            ModelImportStats* stats)
+        {
+            RYU_PROFILE_ZONE("ModelImporter::Import");
+
+            const auto readStart = std::chrono::steady_clock::now();
+            Assimp::Importer importer;
+            const aiScene* scene = importer.ReadFile(
+                modelFilePath,
+                aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
+            if (!scene ||
+                scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
+                !scene->mMeshes)
+            {
+                std::cerr << "Assimp load file error: " << importer.GetErrorString() << std::endl;
+                return false;
+            }
+
+            const auto processStart = std::chrono::steady_clock::now();
+            const bool isConverted = Convert(*scene, optimization, lod, model, threadAmount);
+            const auto processEnd = std::chrono::steady_clock::now();
+            if (stats)
+            {
+                stats->ReadTimeInMs = std::chrono::duration<double, std::milli>(processStart - readStart).count();
+                stats->ProcessTimeInMs = std::chrono::duration<double, std::milli>(processEnd - processStart).count();
+                const size_t poolThreadAmount = Common::ThreadPool::GetInstance().GetThreadAmount() + 1;
+                stats->ThreadAmount = std::min(
+                    threadAmount > 0 ? std::min(threadAmount, poolThreadAmount) : poolThreadAmount,
+                    std::max<size_t>(model.Meshes.size(), 1));
+            }
+            return isConverted;
+        }
+
+        bool Convert(
+            const aiScene& scene,
+            const MeshOptimizationSettings& optimization,
+            const MeshLodSettings& lod,
+            ImportedModel& model,
+            size_t threadAmount)
+        {
+            RYU_PROFILE_ZONE("ModelImporter::Convert");
+
+            if (scene.mNumMeshes <= 0 || !scene.mMeshes)
+                return false;
+
+            model.Materials.resize(scene.mNumMaterials);
+            for (unsigned int i = 0; i < scene.mNumMaterials; ++i)
+            {
+                const aiMaterial* material = scene.mMaterials[i];
+                if (!material)
+                    continue;
+                model.Materials[i].DiffuseTexture = GetTextureName(material, aiTextureType_DIFFUSE);
+                model.Materials[i].SpecularTexture = GetTextureName(material, aiTextureType_SPECULAR);
+                model.Materials[i].EmissionTexture = GetTextureName(material, aiTextureType_EMISSIVE);
+            }
+
+            // Skipped meshes are sorted out up front, so messages keep the scene order and every job knows its slot
+            std::vector<const aiMesh*> meshes;
+            meshes.reserve(scene.mNumMeshes);
+            for (unsigned int i = 0; i < scene.mNumMeshes; ++i)
+            {
+                const aiMesh* mesh = scene.mMeshes[i];
+                if (!mesh ||
+                    mesh->mMaterialIndex >= scene.mNumMaterials ||
+                    !scene.mMaterials[mesh->mMaterialIndex])
+                    continue;
+
+                if (!mesh->HasNormals())
+                {
+                    std::cerr << "Model mesh data has no normals." << std::endl;
+                    continue;
+                }
+                if (!(mesh->mTextureCoords[0]))
+                {
+                    std::cerr << "Model mesh data has no texture coords." << std::endl;
+                    continue;
+                }
+                meshes.push_back(mesh);
+            }
+
+            // Meshes are independent, each result only depends on its own data
+            const size_t firstMeshIdx = model.Meshes.size();
+            model.Meshes.resize(firstMeshIdx + meshes.size());
+            Common::ThreadPool::GetInstance().ParallelFor(meshes.size(), [&](size_t i)
+            {
+                RYU_PROFILE_ZONE("ModelImporter::ConvertMesh");
+
+                auto& im = model.Meshes[firstMeshIdx + i];
+                ConvertMesh(*meshes[i], im);
+                auto& full = im.Levels[0];
+                if (optimization.IsEnabled)
+                {
+                    im.OptimizationReport = MeshOptimizer::Optimize(
+                        optimization, full.Indices, full.Positions, full.Normals, full.TexCoords);
+                }
+                if (lod.IsEnabled)
+                    BuildLodLevels(im, lod, optimization.CacheSize);
+                im.ContentHash = HashMesh(im);
+            }, threadAmount);
+
+            for (size_t meshIdx = firstMeshIdx; meshIdx < model.Meshes.size(); ++meshIdx)
+            {
+                const auto& im = model.Meshes[meshIdx];
+                if (optimization.IsEnabled)
+                {
+                    const auto& r = im.OptimizationReport;
+                    std::clog << "Mesh " << im.Name << " optimized, vertices " << r.SourceVertexAmount
+                        << " -> " << r.VertexAmount << ", ACMR " << r.Before.ACMR << " -> " << r.After.ACMR
+                        << ", ATVR " << r.Before.ATVR << " -> " << r.After.ATVR << "." << std::endl;
+                }
+                for (size_t i = 1; i < im.Levels.size(); ++i)
+                {
+                    std::clog << "Mesh " << im.Name << " LOD " << i << ", triangles "
+                        << im.Levels[0].Indices.size() / 3 << " -> " << im.Levels[i].Indices.size() / 3
+                        << ", error " << im.Levels[i].Error << "." << std::endl;
+                }
+            }
+            return true;
+        }
+    }
+}
\ No newline at end of file
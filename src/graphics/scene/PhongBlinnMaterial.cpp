@@ -1,6 +1,8 @@
 #include "graphics/scene/PhongBlinnMaterial.h"
 
+#include "common/Profiler.h"
 #include "graphics/ShaderManager.h"
+#include "graphics/TextureManager.h"
 #include "graphics/scene/Scene.h"
 
 namespace RyuRenderer::Graphics::Scene
@@ -8,109 +10,178 @@ namespace RyuRenderer::Graphics::Scene
     PhongBlinnMaterial::PhongBlinnMaterial()
     {
         name = "PhongBlinnMaterial";
+        // Instance attributes follow the binding of the interleaved vertices
         shader = Graphics::ShaderManager::GetInstance().FindOrCreate(
             "res/shaders/3d-blinn-phong-material.vert",
-            "res/shaders/3d-blinn-phong-material.frag");
+            "res/shaders/3d-blinn-phong-material.frag",
+            InstanceBuffer::MakeVertexFormat(MeshVertexLayout::InterleavedFormat, 1));
+        if (!shader)
+            return;
+
+        handles.Model = shader->GetUniformHandle("model");
+        handles.ViewNormalMatrix = shader->GetUniformHandle("viewNormalMatrix");
+        handles.Ambient = shader->GetUniformHandle("material.ambient");
+        handles.HasDiffuse = shader->GetUniformHandle("hasDiffuse");
+        handles.Diffuse = shader->GetUniformHandle("material.diffuse");
+        handles.IsDiffuseTopDown = shader->GetUniformHandle("isDiffuseTopDown");
+        handles.HasSpecular = shader->GetUniformHandle("hasSpecular");
+        handles.Specular = shader->GetUniformHandle("material.specular");
+        handles.IsSpecularTopDown = shader->GetUniformHandle("isSpecularTopDown");
+        handles.HasEmission = shader->GetUniformHandle("hasEmission");
+        handles.Emission = shader->GetUniformHandle("material.emission");
+        handles.IsEmissionTopDown = shader->GetUniformHandle("isEmissionTopDown");
+        handles.Shininess = shader->GetUniformHandle("material.shininess");
+        handles.IsMultiDraw = shader->GetUniformHandle("isMultiDraw");
+        handles.IsInstanced = shader->GetUniformHandle("isInstanced");
+        handles.PositionDecodeOffset = shader->GetUniformHandle("positionDecodeOffset");
+        handles.PositionDecodeScale = shader->GetUniformHandle("positionDecodeScale");
+        handles.IsNormalOctahedral = shader->GetUniformHandle("isNormalOctahedral");
+    }
+
+    bool PhongBlinnMaterial::Bind(const MaterialInstance& instance) const
+    {
+        RYU_PROFILE_ZONE("PhongBlinnMaterial::Bind");
+
+        const auto* data = std::get_if<PhongBlinnMaterialData>(&instance);
+        if (!data || !IsVaild())
+            return false;
+
+        // Unchanged material values are skipped by the shader's uniform shadow
+        shader->SetUniform(handles.IsMultiDraw, false);
+        BindTextures(*data);
+        shader->SetUniform(handles.Ambient, data->Ambient);
+        shader->SetUniform(handles.Shininess, data->Shininess);
+        return true;
+    }
+
+    bool PhongBlinnMaterial::IsInstancingSupported() const
+    {
+        return true;
     }
 
-    void PhongBlinnMaterial::SetData(const std::any& d)
+    void PhongBlinnMaterial::SetInstanced(bool isInstanced) const
     {
-        if (d.type() != typeid(PhongBlinnMaterialData))
+        if (!IsVaild())
             return;
 
-        data = std::any_cast<PhongBlinnMaterialData>(d);
+        shader->SetUniform(handles.IsInstanced, isInstanced);
     }
 
-    void PhongBlinnMaterial::Use() const
+    void PhongBlinnMaterial::SetVertexDecode(const Mesh::VertexDecode& decode) const
     {
         if (!IsVaild())
             return;
 
-        // Set material basic data
-        if (data.Diffuse)
-            data.Diffuse->Use();
-        if (data.Specular)
-            data.Specular->Use();
-        if (data.Emission)
-            data.Emission->Use();
-
-        IMaterial::Use();
-
-        // Set mvp
-        shader->SetUniform("model", data.Model);
-        shader->SetUniform("view", data.View);
-        shader->SetUniform("projection", data.Projection);
-        glm::mat3 viewNormalMatrix = glm::transpose(glm::inverse(glm::mat3(data.View * data.Model)));
-        shader->SetUniform("viewNormalMatrix", viewNormalMatrix);
-
-        // Set directional light
-        if (data.DirectionLight)
-        {
-            shader->SetUniform("directionalLight.color", data.DirectionLight->Color);
-            shader->SetUniform(
-                "directionalLight.viewDirection",
-                glm::transpose(glm::inverse(glm::mat3(data.View))) * data.DirectionLight->Transformer.GetFrontDirection());
-        }
+        shader->SetUniform(handles.PositionDecodeOffset, decode.PositionOffset);
+        shader->SetUniform(handles.PositionDecodeScale, decode.PositionScale);
+        shader->SetUniform(handles.IsNormalOctahedral, decode.IsNormalOctahedral);
+    }
 
-        // Set point lights
-        if (data.PointLights)
-        {
-            size_t pointLightCount = data.PointLights->size();
-            constexpr size_t maxPointLightCount = 32;
-            pointLightCount = pointLightCount > maxPointLightCount ? 32 : pointLightCount;
-            shader->SetUniform("activePointLightCount", (int)pointLightCount);
-            for (size_t i = 0; i < pointLightCount; ++i)
-            {
-                auto& l = data.PointLights->at(i);
-
-                std::string pointPrefix = "pointLights[" + std::to_string(i) + "].";
-                shader->SetUniform(pointPrefix + "color", l.Color);
-                shader->SetUniform(pointPrefix + "viewPos", glm::vec3(data.View * glm::vec4(l.Transformer.GetPosition(), 1.0f)));
-                shader->SetUniform(pointPrefix + "attenuationConstant", l.AttenuationConstant);
-                shader->SetUniform(pointPrefix + "attenuationLinear", l.AttenuationLinear);
-                shader->SetUniform(pointPrefix + "attenuationQuadratic", l.AttenuationQuadratic);
-            }
-        }
+    bool PhongBlinnMaterial::IsMultiDrawSupported() const
+    {
+        return true;
+    }
+
+    bool PhongBlinnMaterial::BindMultiDraw(const MaterialInstance& instance) const
+    {
+        RYU_PROFILE_ZONE("PhongBlinnMaterial::BindMultiDraw");
+
+        const auto* data = std::get_if<PhongBlinnMaterialData>(&instance);
+        if (!data || !IsVaild())
+            return false;
+
+        shader->SetUniform(handles.IsMultiDraw, true);
+        BindTextures(*data);
+        return true;
+    }
+
+    bool PhongBlinnMaterial::IsMultiDrawCompatible(const MaterialInstance& a, const MaterialInstance& b) const
+    {
+        const auto* dataA = std::get_if<PhongBlinnMaterialData>(&a);
+        const auto* dataB = std::get_if<PhongBlinnMaterialData>(&b);
+        if (!dataA || !dataB)
+            return false;
+
+        return dataA->Diffuse == dataB->Diffuse &&
+            dataA->Specular == dataB->Specular &&
+            dataA->Emission == dataB->Emission;
+    }
+
+    void PhongBlinnMaterial::WriteMaterialRecord(const MaterialInstance& instance, MaterialRecord& record) const
+    {
+        const auto* data = std::get_if<PhongBlinnMaterialData>(&instance);
+        if (!data)
+            return;
 
-        // Set spot light
-        if (data.SpotLights)
+        record.Values[0] = glm::vec4(data->Ambient, data->Shininess);
+    }
+
+    void PhongBlinnMaterial::BindTextures(const PhongBlinnMaterialData& data) const
+    {
+        const auto& textures = TextureManager::GetInstance();
+        const ITexture* diffuse = textures.Resolve(data.Diffuse);
+        const ITexture* specular = textures.Resolve(data.Specular);
+        const ITexture* emission = textures.Resolve(data.Emission);
+        if (diffuse)
+            diffuse->Use();
+        if (specular)
+            specular->Use();
+        if (emission)
+            emission->Use();
+
+        // Flags are always written, an instance without a texture must not sample the one of the previous instance
+        //     Top down textures are files which could not be flipped on load, the shader flips V for them
+        shader->SetUniform(handles.HasDiffuse, diffuse != nullptr);
+        if (diffuse)
         {
-            size_t spotLightCount = data.SpotLights->size();
-            constexpr size_t maxSpotLightCount = 32;
-            spotLightCount = spotLightCount > maxSpotLightCount ? 32 : spotLightCount;
-            shader->SetUniform("activeSpotLightCount", (int)spotLightCount);
-            for (size_t i = 0; i < spotLightCount; ++i)
-            {
-                auto& l = data.SpotLights->at(i);
-
-                std::string spotPrefix = "spotLights[" + std::to_string(i) + "].";
-                shader->SetUniform(spotPrefix + "color", l.Color);
-                shader->SetUniform(spotPrefix + "viewPos", glm::vec3(data.View * glm::vec4(l.Transformer.GetPosition(), 1.0f)));
-                shader->SetUniform(spotPrefix + "viewDirection", glm::transpose(glm::inverse(glm::mat3(data.View))) * l.Transformer.GetFrontDirection());
-                shader->SetUniform(spotPrefix + "innerCutOffCos", l.InnerCutOffCos);
-                shader->SetUniform(spotPrefix + "outerCutOffCos", l.OuterCutOffCos);
-                shader->SetUniform(spotPrefix + "attenuationConstant", l.AttenuationConstant);
-                shader->SetUniform(spotPrefix + "attenuationLinear", l.AttenuationLinear);
-                shader->SetUniform(spotPrefix + "attenuationQuadratic", l.AttenuationQuadratic);
-            }
+            shader->SetUniform(handles.Diffuse, Scene::GetTextureUnitIdxByType(aiTextureType_DIFFUSE));
+            shader->SetUniform(handles.IsDiffuseTopDown, diffuse->IsTopDown());
         }
-
-        shader->SetUniform("material.ambient", data.Ambient);
-        if (data.Diffuse)
+        shader->SetUniform(handles.HasSpecular, specular != nullptr);
+        if (specular)
         {
-            shader->SetUniform("hasDiffuse", true);
-            shader->SetUniform("material.diffuse", Scene::GetTextureUnitIdxByType(aiTextureType_DIFFUSE));
+            shader->SetUniform(handles.Specular, Scene::GetTextureUnitIdxByType(aiTextureType_SPECULAR));
+            shader->SetUniform(handles.IsSpecularTopDown, specular->IsTopDown());
         }
-        if (data.Specular)
+        shader->SetUniform(handles.HasEmission, emission != nullptr);
+        if (emission)
         {
-            shader->SetUniform("hasSpecular", true);
-            shader->SetUniform("material.specular", Scene::GetTextureUnitIdxByType(aiTextureType_SPECULAR));
+            shader->SetUniform(handles.Emission, Scene::GetTextureUnitIdxByType(aiTextureType_EMISSIVE));
+            shader->SetUniform(handles.IsEmissionTopDown, emission->IsTopDown());
         }
-        if (data.Emission)
+    }
+
+    uint32_t PhongBlinnMaterial::GetInstanceSortId(const MaterialInstance& instance) const
+    {
+        const auto* data = std::get_if<PhongBlinnMaterialData>(&instance);
+        if (!data)
+            return 0;
+
+        // Packing the handles into 32 bits would let different sets collide, a dense id is exact
+        //     and stays small enough for the material bits of the sort key
+        const TextureSet set = { data->Diffuse, data->Specular, data->Emission };
+        return textureSetIds.try_emplace(set, static_cast<uint32_t>(textureSetIds.size() + 1)).first->second;
+    }
+
+    size_t PhongBlinnMaterial::TextureSetHash::operator()(const TextureSet& s) const
+    {
+        size_t h = 0;
+        for (const auto& t : s)
         {
-            shader->SetUniform("hasEmission", true);
-            shader->SetUniform("material.emission", Scene::GetTextureUnitIdxByType(aiTextureType_EMISSIVE));
+            const uint64_t v = static_cast<uint64_t>(static_cast<uint32_t>(t.SlotIdx)) << 32 | t.Generation;
+            h = h * 0x9E3779B97F4A7C15ull + std::hash<uint64_t>{}(v);
         }
-        shader->SetUniform("material.shininess", data.Shininess);
+        return h;
+    }
+
+    void PhongBlinnMaterial::SetTransform(const glm::mat4& model, const glm::mat4& view) const
+    {
+        if (!IsVaild())
+            return;
+
+        // View and projection come from the frame uniform block, lights from the lights uniform block
+        shader->SetUniform(handles.Model, model);
+        glm::mat3 viewNormalMatrix = glm::transpose(glm::inverse(glm::mat3(view * model)));
+        shader->SetUniform(handles.ViewNormalMatrix, viewNormalMatrix);
     }
 }
\ No newline at end of file
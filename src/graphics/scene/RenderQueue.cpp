@@ -0,0 +1,326 @@
+#include "graphics/scene/RenderQueue.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "common/Profiler.h"
+#include "graphics/device/IDevice.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    void RenderQueue::Submit(const DrawItem& item)
+    {
+        if (!item.Material || !item.Instance || !item.Mesh || !item.Model)
+            return;
+
+        items.emplace_back(item);
+    }
+
+    void RenderQueue::Execute(const glm::mat4& view)
+    {
+        RYU_PROFILE_ZONE("RenderQueue::Execute");
+
+        if (items.empty())
+            return;
+
+        const unsigned long long submitOrderChangeAmount = CountStateChanges(
+            items.size(), [this](size_t i) -> const DrawItem& { return items[i]; });
+
+        Sort();
+
+        const unsigned long long sortedChangeAmount = CountStateChanges(
+            sortEntries.size(), [this](size_t i) -> const DrawItem& { return items[sortEntries[i].ItemIdx]; });
+        issuedStateChangeAmount += sortedChangeAmount;
+        if (submitOrderChangeAmount > sortedChangeAmount)
+            savedStateChangeAmount += submitOrderChangeAmount - sortedChangeAmount;
+
+        BuildRuns(view);
+        UploadRuns();
+
+        auto& device = Device::IDevice::Current();
+        const IMaterial* lastMaterial = nullptr;
+        const MaterialInstance* lastInstance = nullptr;
+        bool isInstanceBound = false;
+        for (const auto& r : runs)
+        {
+            const auto& first = items[sortEntries[r.FirstEntryIdx].ItemIdx];
+
+            if (first.Material != lastMaterial)
+            {
+                first.Material->Use();
+                lastMaterial = first.Material;
+                lastInstance = nullptr;
+            }
+
+            if (r.IsMultiDraw)
+            {
+                // The shader is switched to the records, the next single draw has to bind its instance again
+                lastInstance = nullptr;
+                if (!first.Material->BindMultiDraw(*first.Instance))
+                    continue;
+
+                first.Mesh->Bind();
+                device.MultiDrawElementsIndirect(
+                    GL_TRIANGLES,
+                    first.Mesh->GetIndexType(),
+                    reinterpret_cast<const void*>(static_cast<uintptr_t>(r.FirstCommandIdx) * sizeof(DrawElementsIndirectCommand)),
+                    static_cast<GLsizei>(r.EntryAmount),
+                    0);
+                continue;
+            }
+
+            // Equal instances of different objects are bound once
+            if (!lastInstance || (lastInstance != first.Instance && *lastInstance != *first.Instance))
+            {
+                isInstanceBound = first.Material->Bind(*first.Instance);
+                lastInstance = first.Instance;
+            }
+            if (!isInstanceBound)
+                continue;
+
+            first.Material->SetTransform(*first.Model, view);
+            first.Material->SetInstanced(first.Instances != nullptr);
+            first.Material->SetVertexDecode(first.Mesh->GetVertexDecode());
+            if (first.Instances)
+                first.Mesh->DrawInstanced(*first.Instances);
+            else
+                first.Mesh->Draw();
+        }
+
+        Clear();
+    }
+
+    void RenderQueue::Clear()
+    {
+        // Capacity is kept, steady frames do not allocate
+        items.clear();
+        sortEntries.clear();
+        sortScratch.clear();
+        runs.clear();
+        drawRecords.clear();
+        materialRecords.clear();
+        commands.clear();
+    }
+
+    void RenderQueue::ReleaseBuffers()
+    {
+        drawRecordBuffer = Graphics::StreamBuffer();
+        materialRecordBuffer = Graphics::StreamBuffer();
+        commandBuffer = Graphics::StreamBuffer();
+    }
+
+    void RenderQueue::SetDepthRange(float nearDis, float farDis)
+    {
+        depthNearDis = std::max(nearDis, 1e-6f);
+        depthFarDis = std::max(farDis, depthNearDis * 2.f);
+    }
+
+    uint64_t RenderQueue::MakeKey(
+        uint8_t passIdx,
+        bool isTranslucent,
+        uint32_t shaderId,
+        uint32_t materialId,
+        uint32_t meshId,
+        float viewDis
+    ) const
+    {
+        float t = std::log(std::max(viewDis, depthNearDis) / depthNearDis) / std::log(depthFarDis / depthNearDis);
+        t = std::clamp(t, 0.f, 1.f);
+
+        uint64_t key = static_cast<uint64_t>(passIdx & (MaxPassAmount - 1)) << 60;
+        if (!isTranslucent)
+        {
+            const uint64_t depth = static_cast<uint64_t>(t * 0x7FFF);
+            key |= static_cast<uint64_t>(shaderId & 0xFFF) << 47;
+            key |= static_cast<uint64_t>(materialId & 0xFFFF) << 31;
+            key |= static_cast<uint64_t>(meshId & 0xFFFF) << 15;
+            key |= depth;
+        }
+        else
+        {
+            const uint64_t invertedDepth = 0xFFFFFF - static_cast<uint64_t>(t * 0xFFFFFF);
+            key |= uint64_t(1) << 59;
+            key |= invertedDepth << 35;
+            key |= static_cast<uint64_t>(shaderId & 0xFFF) << 23;
+            key |= static_cast<uint64_t>(materialId & 0xFFF) << 11;
+            key |= static_cast<uint64_t>(meshId & 0x7FF);
+        }
+        return key;
+    }
+
+    size_t RenderQueue::GetItemAmount() const
+    {
+        return items.size();
+    }
+
+    void RenderQueue::ResetCallAmounts()
+    {
+        issuedStateChangeAmount = 0;
+        savedStateChangeAmount = 0;
+        visibleObjectAmount = 0;
+        culledObjectAmount = 0;
+    }
+
+    unsigned long long RenderQueue::GetIssuedStateChangeAmount() const
+    {
+        return issuedStateChangeAmount;
+    }
+
+    unsigned long long RenderQueue::GetSavedStateChangeAmount() const
+    {
+        return savedStateChangeAmount;
+    }
+
+    void RenderQueue::CountCulling(size_t visibleAmount, size_t culledAmount)
+    {
+        visibleObjectAmount += visibleAmount;
+        culledObjectAmount += culledAmount;
+    }
+
+    unsigned long long RenderQueue::GetVisibleObjectAmount() const
+    {
+        return visibleObjectAmount;
+    }
+
+    unsigned long long RenderQueue::GetCulledObjectAmount() const
+    {
+        return culledObjectAmount;
+    }
+
+    void RenderQueue::Sort()
+    {
+        RYU_PROFILE_ZONE("RenderQueue::Sort");
+
+        sortEntries.resize(items.size());
+        sortScratch.resize(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+            sortEntries[i] = { items[i].Key, static_cast<uint32_t>(i) };
+
+        // LSD radix sort, 8 bits per pass, passes where every key shares the same byte are skipped
+        constexpr size_t bucketAmount = 256;
+        std::array<size_t, bucketAmount> offsets;
+        for (size_t shift = 0; shift < 64; shift += 8)
+        {
+            offsets.fill(0);
+            for (const auto& e : sortEntries)
+                ++offsets[(e.Key >> shift) & 0xFF];
+            if (offsets[(sortEntries.front().Key >> shift) & 0xFF] == sortEntries.size())
+                continue;
+
+            size_t sum = 0;
+            for (auto& o : offsets)
+            {
+                const size_t amount = o;
+                o = sum;
+                sum += amount;
+            }
+            for (const auto& e : sortEntries)
+                sortScratch[offsets[(e.Key >> shift) & 0xFF]++] = e;
+            sortEntries.swap(sortScratch);
+        }
+    }
+
+    void RenderQueue::BuildRuns(const glm::mat4& view)
+    {
+        RYU_PROFILE_ZONE("RenderQueue::BuildRuns");
+
+        const uint32_t entryAmount = static_cast<uint32_t>(sortEntries.size());
+        uint32_t i = 0;
+        while (i < entryAmount)
+        {
+            const auto& first = items[sortEntries[i].ItemIdx];
+
+            DrawRun r;
+            r.FirstEntryIdx = i;
+            r.FirstCommandIdx = static_cast<uint32_t>(commands.size());
+            r.IsMultiDraw = IsMultiDrawEnabled && !first.Instances && first.Material->IsMultiDrawSupported();
+            if (!r.IsMultiDraw)
+            {
+                r.EntryAmount = 1;
+                runs.emplace_back(r);
+                ++i;
+                continue;
+            }
+
+            // Draws of one run share the bound textures and every buffer binding of the page
+            const GLuint pageId = first.Mesh->GetId();
+            const MaterialInstance* lastInstance = nullptr;
+            for (; i < entryAmount; ++i)
+            {
+                const auto& item = items[sortEntries[i].ItemIdx];
+                if (item.Material != first.Material ||
+                    item.Instances ||
+                    item.Mesh->GetId() != pageId ||
+                    !first.Material->IsMultiDrawCompatible(*first.Instance, *item.Instance))
+                    break;
+
+                // Equal instances of neighbouring draws share one material record
+                if (!lastInstance || (lastInstance != item.Instance && *lastInstance != *item.Instance))
+                {
+                    item.Material->WriteMaterialRecord(*item.Instance, materialRecords.emplace_back());
+                    lastInstance = item.Instance;
+                }
+
+                // Normals are not affected by the position decode, only the model of the record includes it
+                const auto& decode = item.Mesh->GetVertexDecode();
+                auto& d = drawRecords.emplace_back();
+                d.Model = decode.IsPositionDecoded() ? *item.Model * decode.GetPositionMatrix() : *item.Model;
+                d.ViewNormalMatrix = glm::mat4(glm::transpose(glm::inverse(glm::mat3(view * *item.Model))));
+                d.MaterialIdx = static_cast<uint32_t>(materialRecords.size() - 1);
+                d.VertexFlags = decode.IsNormalOctahedral ? static_cast<uint32_t>(DrawRecord::VERTEX_FLAG_NORMAL_OCTAHEDRAL) : 0u;
+
+                commands.emplace_back(item.Mesh->GetDrawCommand(static_cast<GLuint>(drawRecords.size() - 1)));
+                ++r.EntryAmount;
+            }
+            runs.emplace_back(r);
+        }
+    }
+
+    void RenderQueue::UploadRuns()
+    {
+        RYU_PROFILE_ZONE("RenderQueue::UploadRuns");
+
+        if (commands.empty())
+            return;
+
+        // Created on first use, so queues which never multi draw hold no buffers
+        if (!commandBuffer.IsValid())
+        {
+            drawRecordBuffer = Graphics::StreamBuffer(GL_SHADER_STORAGE_BUFFER, DrawRecord::BindingIdx);
+            materialRecordBuffer = Graphics::StreamBuffer(GL_SHADER_STORAGE_BUFFER, MaterialRecord::BindingIdx);
+            commandBuffer = Graphics::StreamBuffer(GL_DRAW_INDIRECT_BUFFER);
+        }
+
+        drawRecordBuffer.Update(std::span<const DrawRecord>(drawRecords));
+        drawRecordBuffer.Use();
+        materialRecordBuffer.Update(std::span<const MaterialRecord>(materialRecords));
+        materialRecordBuffer.Use();
+        commandBuffer.Update(std::span<const DrawElementsIndirectCommand>(commands));
+        commandBuffer.Use();
+    }
+
+    template <typename F>
+    unsigned long long RenderQueue::CountStateChanges(size_t itemAmount, F&& getItem)
+    {
+        unsigned long long amount = 0;
+        const IMaterial* lastMaterial = nullptr;
+        const MaterialInstance* lastInstance = nullptr;
+        for (size_t i = 0; i < itemAmount; ++i)
+        {
+            const DrawItem& item = getItem(i);
+            if (item.Material != lastMaterial)
+            {
+                ++amount;
+                lastMaterial = item.Material;
+                lastInstance = nullptr;
+            }
+            if (!lastInstance || (lastInstance != item.Instance && *lastInstance != *item.Instance))
+            {
+                ++amount;
+                lastInstance = item.Instance;
+            }
+        }
+        return amount;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,352 @@
+#include "graphics/scene/RyuMeshFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "common/Profiler.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    static_assert(std::is_trivially_copyable_v<RyuMeshFile::Header>);
+    static_assert(std::is_trivially_copyable_v<RyuMeshFile::MeshRecord>);
+    static_assert(std::is_trivially_copyable_v<RyuMeshFile::LevelRecord>);
+    static_assert(std::is_trivially_copyable_v<RyuMeshFile::MaterialRecord>);
+    static_assert(sizeof(RyuMeshFile::Header) == 64);
+    static_assert(sizeof(RyuMeshFile::MeshRecord) == 24);
+    static_assert(sizeof(RyuMeshFile::LevelRecord) == 120);
+    static_assert(sizeof(RyuMeshFile::MaterialRecord) == 24);
+
+    namespace
+    {
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) / alignment * alignment;
+        }
+
+        size_t GetIndexBytes(uint32_t indexType)
+        {
+            return indexType == GL_UNSIGNED_SHORT ? sizeof(GLushort) : sizeof(GLuint);
+        }
+    }
+
+    Bounds RyuMeshFile::LevelRecord::GetBounds() const
+    {
+        Bounds b;
+        b.Min = glm::vec3(BoundsMin[0], BoundsMin[1], BoundsMin[2]);
+        b.Max = glm::vec3(BoundsMax[0], BoundsMax[1], BoundsMax[2]);
+        b.Center = glm::vec3(BoundsCenter[0], BoundsCenter[1], BoundsCenter[2]);
+        b.Radius = BoundsRadius;
+        return b;
+    }
+
+    bool RyuMeshFile::Write(const ImportedModel& model, const std::string& filePath)
+    {
+        RYU_PROFILE_ZONE("RyuMeshFile::Write");
+
+        std::string strings;
+        auto addString = [&strings](const std::string& s)
+        {
+            StringRange range;
+            range.Offset = static_cast<uint32_t>(strings.size());
+            range.Length = static_cast<uint32_t>(s.size());
+            strings += s;
+            return range;
+        };
+
+        std::vector<MeshRecord> meshes;
+        std::vector<LevelRecord> levels;
+        std::vector<MaterialRecord> materials;
+        for (const auto& m : model.Materials)
+        {
+            MaterialRecord& record = materials.emplace_back();
+            record.DiffuseTexture = addString(m.DiffuseTexture);
+            record.SpecularTexture = addString(m.SpecularTexture);
+            record.EmissionTexture = addString(m.EmissionTexture);
+        }
+
+        // Blob offsets are relative to the first page after the tables until those are laid out
+        uint64_t blobBytes = 0;
+        auto addBlob = [&blobBytes](uint64_t bytes)
+        {
+            BlobRange range;
+            range.Offset = blobBytes;
+            range.Bytes = bytes;
+            blobBytes = AlignUp(blobBytes + bytes, BlobAlignment);
+            return range;
+        };
+
+        for (const auto& im : model.Meshes)
+        {
+            if (im.MaterialIdx >= model.Materials.size())
+            {
+                std::cerr << "Mesh " << im.Name << " references a missing material." << std::endl;
+                return false;
+            }
+
+            MeshRecord& mesh = meshes.emplace_back();
+            mesh.Name = addString(im.Name);
+            mesh.MaterialIdx = im.MaterialIdx;
+            mesh.FirstLevelIdx = static_cast<uint32_t>(levels.size());
+            mesh.LevelAmount = static_cast<uint32_t>(im.Levels.size());
+            for (const auto& il : im.Levels)
+            {
+                const size_t vertexAmount = il.Positions.size();
+                if (il.Normals.size() != vertexAmount || il.TexCoords.size() != vertexAmount ||
+                    vertexAmount > std::numeric_limits<uint32_t>::max() || il.Indices.size() > std::numeric_limits<uint32_t>::max())
+                {
+                    std::cerr << "Mesh " << im.Name << " has invalid vertex data." << std::endl;
+                    return false;
+                }
+
+                const Bounds b = Bounds::FromPositions(il.Positions);
+                LevelRecord& level = levels.emplace_back();
+                level.VertexAmount = static_cast<uint32_t>(vertexAmount);
+                level.IndexAmount = static_cast<uint32_t>(il.Indices.size());
+                level.IndexType = vertexAmount <= static_cast<size_t>(std::numeric_limits<GLushort>::max()) + 1
+                    ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+                level.Error = il.Error;
+                level.BoundsMin = { b.Min.x, b.Min.y, b.Min.z };
+                level.BoundsMax = { b.Max.x, b.Max.y, b.Max.z };
+                level.BoundsCenter = { b.Center.x, b.Center.y, b.Center.z };
+                level.BoundsRadius = b.Radius;
+                level.Indices = addBlob(il.Indices.size() * GetIndexBytes(level.IndexType));
+                level.Positions = addBlob(vertexAmount * sizeof(il.Positions[0]));
+                level.Normals = addBlob(vertexAmount * sizeof(il.Normals[0]));
+                level.TexCoords = addBlob(vertexAmount * sizeof(il.TexCoords[0]));
+            }
+        }
+
+        Header header;
+        header.Magic = Magic;
+        header.Version = Version;
+        header.MeshAmount = static_cast<uint32_t>(meshes.size());
+        header.LevelAmount = static_cast<uint32_t>(levels.size());
+        header.MaterialAmount = static_cast<uint32_t>(materials.size());
+        header.StringBytes = static_cast<uint32_t>(strings.size());
+        header.MeshTableOffset = sizeof(Header);
+        header.LevelTableOffset = header.MeshTableOffset + meshes.size() * sizeof(MeshRecord);
+        header.MaterialTableOffset = header.LevelTableOffset + levels.size() * sizeof(LevelRecord);
+        header.StringTableOffset = header.MaterialTableOffset + materials.size() * sizeof(MaterialRecord);
+        const uint64_t firstBlobOffset = AlignUp(header.StringTableOffset + strings.size(), BlobAlignment);
+        header.FileBytes = firstBlobOffset + blobBytes;
+
+        for (auto& level : levels)
+        {
+            for (BlobRange* range : { &level.Indices, &level.Positions, &level.Normals, &level.TexCoords })
+                range->Offset += firstBlobOffset;
+        }
+
+        std::vector<std::byte> bytes(header.FileBytes);
+        auto writeAt = [&bytes](uint64_t offset, const void* data, size_t size)
+        {
+            if (size > 0)
+                std::memcpy(bytes.data() + offset, data, size);
+        };
+        writeAt(0, &header, sizeof(header));
+        writeAt(header.MeshTableOffset, meshes.data(), meshes.size() * sizeof(MeshRecord));
+        writeAt(header.LevelTableOffset, levels.data(), levels.size() * sizeof(LevelRecord));
+        writeAt(header.MaterialTableOffset, materials.data(), materials.size() * sizeof(MaterialRecord));
+        writeAt(header.StringTableOffset, strings.data(), strings.size());
+
+        size_t levelIdx = 0;
+        for (const auto& im : model.Meshes)
+        {
+            for (const auto& il : im.Levels)
+            {
+                const LevelRecord& level = levels[levelIdx++];
+                if (level.IndexType == GL_UNSIGNED_SHORT)
+                {
+                    GLushort* dst = reinterpret_cast<GLushort*>(bytes.data() + level.Indices.Offset);
+                    for (size_t i = 0; i < il.Indices.size(); ++i)
+                        dst[i] = static_cast<GLushort>(il.Indices[i]);
+                }
+                else
+                {
+                    writeAt(level.Indices.Offset, il.Indices.data(), level.Indices.Bytes);
+                }
+                writeAt(level.Positions.Offset, il.Positions.data(), level.Positions.Bytes);
+                writeAt(level.Normals.Offset, il.Normals.data(), level.Normals.Bytes);
+                writeAt(level.TexCoords.Offset, il.TexCoords.data(), level.TexCoords.Bytes);
+            }
+        }
+
+        std::ofstream stream(filePath, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            std::cerr << "Failed to open " << filePath << " for writing." << std::endl;
+            return false;
+        }
+        stream.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!stream)
+        {
+            std::cerr << "Failed to write " << filePath << "." << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    bool RyuMeshFile::Open(const std::string& filePath)
+    {
+        RYU_PROFILE_ZONE("RyuMeshFile::Open");
+
+        Close();
+        if (!file.Open(filePath))
+            return false;
+
+        if (file.GetBytes().size() < sizeof(Header))
+        {
+            std::cerr << "Cooked mesh file " << filePath << " is truncated." << std::endl;
+            Close();
+            return false;
+        }
+        header = reinterpret_cast<const Header*>(file.GetBytes().data());
+        if (header->Magic != Magic || header->Version != Version)
+        {
+            std::cerr << "Cooked mesh file " << filePath << " has version " << header->Version
+                << ", expected " << Version << ". Cook it again." << std::endl;
+            Close();
+            return false;
+        }
+        if (!Validate())
+        {
+            std::cerr << "Cooked mesh file " << filePath << " is corrupted." << std::endl;
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void RyuMeshFile::Close()
+    {
+        file.Close();
+        header = nullptr;
+    }
+
+    bool RyuMeshFile::IsOpen() const
+    {
+        return header != nullptr;
+    }
+
+    std::span<const RyuMeshFile::MeshRecord> RyuMeshFile::GetMeshes() const
+    {
+        if (!header)
+            return {};
+        return std::span<const MeshRecord>(
+            reinterpret_cast<const MeshRecord*>(file.GetBytes().data() + header->MeshTableOffset), header->MeshAmount);
+    }
+
+    std::span<const RyuMeshFile::LevelRecord> RyuMeshFile::GetLevels(const MeshRecord& mesh) const
+    {
+        if (!header)
+            return {};
+        return std::span<const LevelRecord>(
+            reinterpret_cast<const LevelRecord*>(file.GetBytes().data() + header->LevelTableOffset) + mesh.FirstLevelIdx, mesh.LevelAmount);
+    }
+
+    std::span<const RyuMeshFile::MaterialRecord> RyuMeshFile::GetMaterials() const
+    {
+        if (!header)
+            return {};
+        return std::span<const MaterialRecord>(
+            reinterpret_cast<const MaterialRecord*>(file.GetBytes().data() + header->MaterialTableOffset), header->MaterialAmount);
+    }
+
+    std::string_view RyuMeshFile::GetString(const StringRange& range) const
+    {
+        if (!header)
+            return {};
+        return std::string_view(
+            reinterpret_cast<const char*>(file.GetBytes().data() + header->StringTableOffset) + range.Offset, range.Length);
+    }
+
+    std::span<const std::array<float, 3>> RyuMeshFile::GetPositions(const LevelRecord& level) const
+    {
+        return GetBlob<std::array<float, 3>>(level.Positions);
+    }
+
+    std::span<const std::array<float, 3>> RyuMeshFile::GetNormals(const LevelRecord& level) const
+    {
+        return GetBlob<std::array<float, 3>>(level.Normals);
+    }
+
+    std::span<const std::array<float, 2>> RyuMeshFile::GetTexCoords(const LevelRecord& level) const
+    {
+        return GetBlob<std::array<float, 2>>(level.TexCoords);
+    }
+
+    std::span<const GLushort> RyuMeshFile::GetShortIndices(const LevelRecord& level) const
+    {
+        if (level.IndexType != GL_UNSIGNED_SHORT)
+            return {};
+        return GetBlob<GLushort>(level.Indices);
+    }
+
+    std::span<const GLuint> RyuMeshFile::GetIndices(const LevelRecord& level) const
+    {
+        if (level.IndexType != GL_UNSIGNED_INT)
+            return {};
+        return GetBlob<GLuint>(level.Indices);
+    }
+
+    bool RyuMeshFile::IsInside(uint64_t offset, uint64_t bytes) const
+    {
+        const uint64_t fileBytes = file.GetBytes().size();
+        return offset <= fileBytes && bytes <= fileBytes - offset;
+    }
+
+    bool RyuMeshFile::Validate() const
+    {
+        // Only ranges are checked, index values are trusted like any other build output
+        if (header->FileBytes != file.GetBytes().size() ||
+            !IsInside(header->MeshTableOffset, static_cast<uint64_t>(header->MeshAmount) * sizeof(MeshRecord)) ||
+            !IsInside(header->LevelTableOffset, static_cast<uint64_t>(header->LevelAmount) * sizeof(LevelRecord)) ||
+            !IsInside(header->MaterialTableOffset, static_cast<uint64_t>(header->MaterialAmount) * sizeof(MaterialRecord)) ||
+            !IsInside(header->StringTableOffset, header->StringBytes) ||
+            header->MeshTableOffset % alignof(MeshRecord) != 0 ||
+            header->LevelTableOffset % alignof(LevelRecord) != 0 ||
+            header->MaterialTableOffset % alignof(MaterialRecord) != 0)
+            return false;
+
+        auto isStringValid = [this](const StringRange& range)
+        {
+            return range.Offset <= header->StringBytes && range.Length <= header->StringBytes - range.Offset;
+        };
+        auto isBlobValid = [this](const BlobRange& range, uint64_t bytes)
+        {
+            return range.Bytes == bytes && range.Offset % BlobAlignment == 0 && IsInside(range.Offset, range.Bytes);
+        };
+
+        for (const auto& material : GetMaterials())
+        {
+            if (!isStringValid(material.DiffuseTexture) ||
+                !isStringValid(material.SpecularTexture) ||
+                !isStringValid(material.EmissionTexture))
+                return false;
+        }
+        for (const auto& mesh : GetMeshes())
+        {
+            if (!isStringValid(mesh.Name) ||
+                mesh.MaterialIdx >= header->MaterialAmount ||
+                mesh.FirstLevelIdx > header->LevelAmount ||
+                mesh.LevelAmount > header->LevelAmount - mesh.FirstLevelIdx)
+                return false;
+
+            for (const auto& level : GetLevels(mesh))
+            {
+                if (level.IndexType != GL_UNSIGNED_SHORT && level.IndexType != GL_UNSIGNED_INT)
+                    return false;
+                const uint64_t vertexAmount = level.VertexAmount;
+                if (!isBlobValid(level.Indices, static_cast<uint64_t>(level.IndexAmount) * GetIndexBytes(level.IndexType)) ||
+                    !isBlobValid(level.Positions, vertexAmount * sizeof(std::array<float, 3>)) ||
+                    !isBlobValid(level.Normals, vertexAmount * sizeof(std::array<float, 3>)) ||
+                    !isBlobValid(level.TexCoords, vertexAmount * sizeof(std::array<float, 2>)))
+                    return false;
+            }
+        }
+        return true;
+    }
+}
\ No newline at end of file
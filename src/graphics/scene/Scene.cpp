@@ -1,13 +1,22 @@
 #include "graphics/scene/Scene.h"
 
+#include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
+#include <span>
 #include <typeinfo>
 
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+#include "graphics/MeshLodChain.h"
 #include "graphics/ShaderManager.h"
 #include "graphics/TextureManager.h"
 #include "graphics/scene/IMaterial.h"
 #include "graphics/scene/PhongBlinnMaterial.h"
+#include "graphics/scene/RenderQueue.h"
+#include "graphics/scene/RyuMeshFile.h"
+#include "graphics/scene/SceneUniformBlocks.h"
 #include "graphics/scene/Transform.h"
 #include "graphics/scene/MeshObject.h"
 
@@ -50,11 +59,19 @@ namespace RyuRenderer::Graphics::Scene
         ));
 
         // init shaders
-        lightShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
+        lightShader = Graphics::ShaderManager::GetInstance().FindOrCreate(
+            "res/shaders/3d-instanced-color.vert", "res/shaders/3d-instanced-color.frag",
+            InstanceBuffer::MakeVertexFormat(VertexLayout<Position3f>::InterleavedFormat, 1));
+
+        // init uniform buffers
+        frameUniformBuffer = Graphics::UniformBuffer(sizeof(FrameUniformBlock), FrameUniformBlock::BindingIdx);
+        lightsUniformBuffer = Graphics::UniformBuffer(sizeof(LightsUniformBlock), LightsUniformBlock::BindingIdx);
     }
 
     bool Scene::Load(const std::string& modelFilePath)
     {
+        RYU_PROFILE_ZONE("Scene::Load");
+
         if (!std::filesystem::exists(modelFilePath))
             return false;
         const auto p = std::filesystem::path(modelFilePath);
@@ -63,233 +80,378 @@ namespace RyuRenderer::Graphics::Scene
             !std::filesystem::is_directory(textureFileRootPath)) {
             return false;
         }
+        const std::string trp = textureFileRootPath.string();
 
-        Assimp::Importer importer;
-        const aiScene* scene = importer.ReadFile(
-            modelFilePath,
-            aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-        if (!scene ||
-            scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
-            !scene->mMeshes)
-        {
-            std::cerr << "Assimp load file error: " << importer.GetErrorString() << std::endl;
-            return false;
-        }
-        if (scene->mNumMeshes <= 0)
+        // Cooked files carry the optimized levels of the import settings they were cooked with
+        if (p.extension() == RyuMeshFile::Extension)
+            return LoadCooked(modelFilePath, trp);
+
+        ImportedModel model;
+        if (!ModelImporter::Import(modelFilePath, MeshImportOptimization, MeshImportLod, model, MeshImportThreadAmount))
             return false;
 
-        Transform defaultTransformer;
-        for (unsigned int i = 0; i < scene->mNumMeshes; ++i)
+        auto createMesh = [this](const ImportedMesh& im, const ImportedMeshLevel& level)
         {
-            aiMesh* mesh = scene->mMeshes[i];
-            if (!mesh ||
-                mesh->mMaterialIndex < 0)
-                continue;
-
-            aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-            if (!material)
-                continue;
-
-            // load mesh
-            std::vector<GLuint> indices;
-            for (unsigned int i = 0; i < mesh->mNumFaces; ++i)
-            {
-                const auto& face = mesh->mFaces[i];
-                for (unsigned int j = 0; j < face.mNumIndices; ++j)
-                    indices.push_back(face.mIndices[j]);
-            }
-            std::vector<std::array<float, 3>> positions;
-            std::vector<std::array<float, 3>> normals;
-            std::vector<std::array<float, 2>> texCoords;
-            bool isMeshVaild = true;
-            for (unsigned int i = 0; i < mesh->mNumVertices; ++i)
+            if (!MeshImportCompression.IsEnabled)
+                return Mesh(PhongBlinnMaterial::MeshVertexLayout(), level.Indices, level.Positions, level.Normals, level.TexCoords);
+
+            MeshCompressionStats stats;
+            Mesh m = MeshCompression::CreateMesh(
+                level.Indices, level.Positions, level.Normals, level.TexCoords, MeshImportCompression, &stats);
+            meshCompressionStats += stats;
+            std::clog << "Mesh " << im.Name << " compressed from " << stats.GetSourceBytes()
+                << " to " << stats.GetBytes() << " bytes, "
+                << static_cast<int>(stats.GetSavedRatio() * 100.0 + 0.5) << "% less memory and vertex fetch bandwidth." << std::endl;
+            return m;
+        };
+
+        for (const auto& im : model.Meshes)
+        {
+            MeshLodChain chain;
+            for (const auto& level : im.Levels)
             {
-                if (!mesh->HasNormals())
-                {
-                    std::cerr << "Model mesh data has no normals." << std::endl;
-                    isMeshVaild = false;
+                Mesh m = createMesh(im, level);
+                if (!m.IsValid())
                     break;
-                }
-                if (!(mesh->mTextureCoords[0]))
-                {
-                    std::cerr << "Model mesh data has no texture coords." << std::endl;
-                    isMeshVaild = false;
-                    break;
-                }
-
-                const auto& v = mesh->mVertices[i];
-                positions.push_back({ v.x, v.y, v.z });
-                const auto& n = mesh->mNormals[i];
-                normals.push_back({ n.x, n.y, n.z });
-                const auto& t = mesh->mTextureCoords[0][i];
-                texCoords.push_back({ t.x, t.y });
+                chain.Levels.emplace_back(std::move(m));
+                chain.Errors.emplace_back(level.Error);
             }
-            if (!isMeshVaild)
-                continue;
+            AddLodChain(std::move(chain), model.Materials[im.MaterialIdx], trp);
+        }
 
-            Mesh m = Mesh(indices, positions, normals, texCoords);
-            if (!m.IsValid())
-            {
-                std::cerr << "Model mesh data is invaild." << std::endl;
-                continue;
-            }
+        return true;
+    }
+
+    std::shared_ptr<SceneLoad> Scene::LoadAsync(const std::string& modelFilePath)
+    {
+        RYU_PROFILE_ZONE("Scene::LoadAsync");
+
+        auto load = std::make_shared<SceneLoad>(modelFilePath, MeshImportOptimization, MeshImportLod, MeshImportThreadAmount);
+        const auto textureFileRootPath = std::filesystem::path(modelFilePath).parent_path();
+        if (!std::filesystem::exists(modelFilePath) ||
+            !std::filesystem::exists(textureFileRootPath) ||
+            !std::filesystem::is_directory(textureFileRootPath)) {
+            load->state = SceneLoad::STATE_FAILED;
+            return load;
+        }
+
+        load->decoded = Common::ThreadPool::GetInstance().Submit([load]() { return load->Decode(); });
+        loads.emplace_back(load);
+        return load;
+    }
+
+    void Scene::UpdateLoads()
+    {
+        RYU_PROFILE_ZONE("Scene::UpdateLoads");
+
+        lastFrameStreamedBytes = 0;
+        if (loads.empty())
+            return;
 
-            // load material
-            std::string trp = textureFileRootPath.string();
-            auto diffuse = GetTexture(material, aiTextureType_DIFFUSE, trp);
-            if (!diffuse)
+        // Whole texture rows have to fit into one frame
+        const size_t frameBytes = std::max<size_t>(StreamingBytesPerFrame, 64 << 10);
+        if (!stagingRing.IsValid())
+            stagingRing = Graphics::StagingRing(static_cast<GLsizeiptr>(frameBytes * 3));
+
+        size_t budgetBytes = frameBytes;
+        for (auto& load : loads)
+        {
+            if (load->state == SceneLoad::STATE_DECODING)
             {
-                std::clog << "Model diffuse texture data is invaild." << std::endl;
-                continue;
+                if (load->decoded.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+                    continue;
+                load->state = load->decoded.get() ? SceneLoad::STATE_UPLOADING : SceneLoad::STATE_FAILED;
             }
-            auto specular = GetTexture(material, aiTextureType_SPECULAR, trp);
-            if (!specular)
+
+            if (load->state == SceneLoad::STATE_UPLOADING && stagingRing.IsValid())
+                load->Upload(stagingRing, budgetBytes);
+
+            for (size_t i = 0; i < load->readyChains.size(); ++i)
             {
-                std::clog << "Model specular texture data is invaild." << std::endl;
+                const uint32_t materialIdx = load->readyMaterialIdxs[i];
+                AddLodChain(
+                    std::move(load->readyChains[i]),
+                    materialIdx < load->model.Materials.size() ? load->model.Materials[materialIdx] : ImportedMaterial(),
+                    load->textureFileRootPath);
             }
-            auto emission = GetTexture(material, aiTextureType_EMISSIVE, trp);
-            if (!emission)
+            load->readyChains.clear();
+            load->readyMaterialIdxs.clear();
+
+            if (load->IsFinished())
+                load->Release();
+        }
+        stagingRing.EndFrame();
+        lastFrameStreamedBytes = frameBytes - budgetBytes;
+
+        loads.remove_if([](const std::shared_ptr<SceneLoad>& load) { return load->IsFinished(); });
+    }
+
+    size_t Scene::GetLastFrameStreamedBytes() const
+    {
+        return lastFrameStreamedBytes;
+    }
+
+    bool Scene::LoadCooked(const std::string& cookedFilePath, const std::string& textureFileRootPath)
+    {
+        RYU_PROFILE_ZONE("Scene::LoadCooked");
+
+        RyuMeshFile file;
+        if (!file.Open(cookedFilePath))
+            return false;
+
+        // Streams are uploaded straight from the mapping, a separate layout mesh copies nothing on the CPU
+        for (const auto& mesh : file.GetMeshes())
+        {
+            MeshLodChain chain;
+            for (const auto& level : file.GetLevels(mesh))
             {
-                std::clog << "Model emission texture data is invaild." << std::endl;
+                Mesh m = level.IndexType == GL_UNSIGNED_SHORT
+                    ? Mesh(PhongBlinnMaterial::MeshVertexLayout(), Mesh::VERTEX_LAYOUT_SEPARATE, file.GetShortIndices(level),
+                        file.GetPositions(level), file.GetNormals(level), file.GetTexCoords(level))
+                    : Mesh(PhongBlinnMaterial::MeshVertexLayout(), Mesh::VERTEX_LAYOUT_SEPARATE, file.GetIndices(level),
+                        file.GetPositions(level), file.GetNormals(level), file.GetTexCoords(level));
+                if (!m.IsValid())
+                    break;
+                m.SetBounds(level.GetBounds());
+                chain.Levels.emplace_back(std::move(m));
+                chain.Errors.emplace_back(level.Error);
             }
 
-            // Build dynamic material
-            const type_info* materialType = nullptr;
-            std::shared_ptr<IMaterial> newMaterial = nullptr;
-            std::any materialData;
-            if (diffuse)
-            {
-                materialType = &typeid(PhongBlinnMaterial);
+            const auto& record = file.GetMaterials()[mesh.MaterialIdx];
+            ImportedMaterial material;
+            material.DiffuseTexture = file.GetString(record.DiffuseTexture);
+            material.SpecularTexture = file.GetString(record.SpecularTexture);
+            material.EmissionTexture = file.GetString(record.EmissionTexture);
+            AddLodChain(std::move(chain), material, textureFileRootPath);
+        }
 
-                newMaterial = std::make_shared<PhongBlinnMaterial>();
+        return true;
+    }
 
-                PhongBlinnMaterialData d = PhongBlinnMaterialData();
-                d.Diffuse = diffuse;
-                d.Specular = specular;
-                d.Emission = emission;
-                d.DirectionLight = &DirectionLight;
-                d.PointLights = &PointLights;
-                d.SpotLights = &SpotLights;
-                materialData = d;
+    void Scene::AddLodChain(MeshLodChain&& chain, const ImportedMaterial& material, const std::string& textureFileRootPath)
+    {
+        if (chain.Levels.empty())
+        {
+            std::cerr << "Model mesh data is invaild." << std::endl;
+            return;
+        }
+        // Meshes without coarser levels are drawn like any other
+        auto addTo = [&chain](MeshObject& mo)
+        {
+            if (chain.Levels.size() > 1)
+                mo.LodMeshes.emplace_back(std::move(chain));
+            else
+                mo.Meshes.emplace_back(std::move(chain.Levels[0]));
+            mo.UpdateBounds();
+        };
+
+        // load material
+        auto diffuse = GetTexture(material.DiffuseTexture, aiTextureType_DIFFUSE, textureFileRootPath);
+        if (!diffuse)
+        {
+            std::clog << "Model diffuse texture data is invaild." << std::endl;
+            return;
+        }
+        auto specular = GetTexture(material.SpecularTexture, aiTextureType_SPECULAR, textureFileRootPath);
+        if (!specular)
+        {
+            std::clog << "Model specular texture data is invaild." << std::endl;
+        }
+        auto emission = GetTexture(material.EmissionTexture, aiTextureType_EMISSIVE, textureFileRootPath);
+        if (!emission)
+        {
+            std::clog << "Model emission texture data is invaild." << std::endl;
+        }
 
-                newMaterial->SetData(materialData);
-            }
-            if (!materialType ||
-                !newMaterial)
+        // Build dynamic material
+        const std::type_info* materialType = nullptr;
+        std::shared_ptr<IMaterial> newMaterial = nullptr;
+        MaterialInstance materialData;
+        if (diffuse)
+        {
+            materialType = &typeid(PhongBlinnMaterial);
+
+            newMaterial = std::make_shared<PhongBlinnMaterial>();
+
+            PhongBlinnMaterialData d = PhongBlinnMaterialData();
+            auto& textures = TextureManager::GetInstance();
+            d.Diffuse = textures.GetHandle(diffuse);
+            d.Specular = textures.GetHandle(specular);
+            d.Emission = textures.GetHandle(emission);
+            materialData = d;
+        }
+        if (!materialType ||
+            !newMaterial)
+            return;
+
+        Transform defaultTransformer;
+        bool isBatchMatch = false;
+        for (auto& mb : MeshObjectBatches)
+        {
+            if (!mb.IsVaild())
+                continue;
+            if (!mb.Match(*materialType))
                 continue;
 
-            bool isBatchMatch = false;
-            for (auto& mb : MeshObjectBatches)
+            isBatchMatch = true;
+
+            bool isObjectMatch = false;
+            for (auto& mo : mb.MeshObjects)
             {
-                if (!mb.IsVaild())
-                    continue;
-                if (!mb.Match(*materialType))
+                if (mo.MaterialData != materialData)
                     continue;
 
-                isBatchMatch = true;
-
-                bool isObjectMatch = false;
-                for (auto& mo : mb.MeshObjects)
-                {
-                    if (mo.MaterialData.type() == typeid(PhongBlinnMaterialData) &&
-                        materialData.type() == typeid(PhongBlinnMaterialData))
-                    {
-                        auto md0 = std::any_cast<PhongBlinnMaterialData>(materialData);
-                        auto md1 = std::any_cast<PhongBlinnMaterialData>(mo.MaterialData);
-
-                        if (md0 != md1)
-                            continue;
-                    }
-                    else
-                    {
-                        continue;
-                    }
-
-                    if (mo.Transformer == defaultTransformer)
-                    {
-                        mo.Meshes.emplace_back(std::move(m));
-                        isObjectMatch = true;
-                    }
-                }
-
-                if (!isObjectMatch)
+                if (mo.Transformer == defaultTransformer)
                 {
-                    MeshObject tmo;
-                    tmo.Meshes.emplace_back(std::move(m));
-                    tmo.Transformer = defaultTransformer;
-                    tmo.MaterialData = materialData;
-                    mb.MeshObjects.emplace_back(std::move(tmo));
+                    addTo(mo);
+                    isObjectMatch = true;
+                    break;
                 }
-                break;
             }
 
-            if (!isBatchMatch)
+            if (!isObjectMatch)
             {
-                MeshObjectBatch tmob(newMaterial);
                 MeshObject tmo;
-                tmo.Meshes.emplace_back(std::move(m));
+                addTo(tmo);
                 tmo.Transformer = defaultTransformer;
                 tmo.MaterialData = materialData;
-                tmob.MeshObjects.emplace_back(std::move(tmo));
-                MeshObjectBatches.emplace_back(std::move(tmob));
+                mb.MeshObjects.emplace_back(std::move(tmo));
             }
+            break;
         }
 
-        return true;
+        if (!isBatchMatch)
+        {
+            MeshObjectBatch tmob(newMaterial);
+            MeshObject tmo;
+            addTo(tmo);
+            tmo.Transformer = defaultTransformer;
+            tmo.MaterialData = materialData;
+            tmob.MeshObjects.emplace_back(std::move(tmo));
+            MeshObjectBatches.emplace_back(std::move(tmob));
+        }
     }
 
     void Scene::Draw() const
     {
+        RYU_PROFILE_ZONE("Scene::Draw");
+
         glm::mat4 view = Camera.GetView();
         glm::mat4 projection = Camera.GetProjection();
 
-        /// draw lights
-        lightShader->Use();
-        lightShader->SetUniform("view", view);
-        lightShader->SetUniform("projection", projection);
-
-        // Point lights
-        for (const auto& l : PointLights)
+        /// Upload per frame uniform blocks, every material program reads them from the fixed binding points
+        FrameUniformBlock frameBlock;
+        frameBlock.View = view;
+        frameBlock.Projection = projection;
+        frameUniformBuffer.Update(frameBlock);
+        frameUniformBuffer.Use();
+
+        LightsUniformBlock lightsBlock;
+        lightsBlock.Set(view, DirectionLight, PointLights, SpotLights);
+        lightsUniformBuffer.Update(lightsBlock);
+        lightsUniformBuffer.Use();
+
+        /// draw lights, one instanced draw for every point and spot light gizmo
+        UpdateLightInstances();
+        if (lightShader && lightInstances.GetInstanceAmount() > 0)
         {
-            lightShader->SetUniform("model", l.Transformer.GetMatrix());
-            lightShader->SetUniform("color", l.Color);
-
+            lightShader->Use();
             for (const auto& lm : lightMeshes)
             {
-                lm.Draw();
+                lm.DrawInstanced(lightInstances);
             }
         }
 
-        // Spot lights
-        for (const auto& l : SpotLights)
+        /// Draw mesh batches through the render queue, sorted by program, material and mesh
+        auto& queue = RenderQueue::GetInstance();
+        queue.SetDepthRange(Camera.GetNearPlane(), Camera.GetFarPlane());
+        if (IsFrustumCulling)
+            GetObjectBvh().CullFrustum(Frustum::FromMatrix(projection * view), objectVisibleFlags);
+        LodSelector lodSelector;
+        lodSelector.ViewCamera = &Camera;
+        lodSelector.MaxScreenError = LodMaxScreenError;
+        // Flags are numbered over the objects of every batch in order, invalid batches included
+        size_t firstObjectIdx = 0;
+        for (auto& o : MeshObjectBatches)
         {
-            lightShader->SetUniform("model", l.Transformer.GetMatrix());
-            lightShader->SetUniform("color", l.Color);
+            const uint8_t* visibleFlags = IsFrustumCulling ? objectVisibleFlags.data() + firstObjectIdx : nullptr;
+            firstObjectIdx += o.MeshObjects.size();
+            if (!o.IsVaild())
+                continue;
 
-            for (const auto& lm : lightMeshes)
-            {
-                lm.Draw();
-            }
+            o.Submit(queue, view, 0, &lodSelector, visibleFlags);
         }
+        queue.Execute(view);
+    }
 
-        /// Draw mesh batches
-        for (auto& o : MeshObjectBatches)
+    void Scene::UpdateLightInstances() const
+    {
+        const size_t lightAmount = PointLights.size() + SpotLights.size();
+        while (lightInstanceHandles.size() > lightAmount)
         {
-            if (!o.IsVaild())
-                continue;
+            lightInstances.Remove(lightInstanceHandles.back());
+            lightInstanceHandles.pop_back();
+        }
+        while (lightInstanceHandles.size() < lightAmount)
+            lightInstanceHandles.emplace_back(lightInstances.Add({}));
 
-            o.Draw(view, projection);
+        size_t i = 0;
+        Graphics::InstanceData data;
+        for (const auto& l : PointLights)
+        {
+            data.Model = l.Transformer.GetMatrix();
+            data.Color = glm::vec4(l.Color, 1.f);
+            lightInstances.Update(lightInstanceHandles[i++], data);
+        }
+        for (const auto& l : SpotLights)
+        {
+            data.Model = l.Transformer.GetMatrix();
+            data.Color = glm::vec4(l.Color, 1.f);
+            lightInstances.Update(lightInstanceHandles[i++], data);
         }
     }
 
     void Scene::ClearObjects()
     {
         MeshObjectBatches.clear();
+        meshCompressionStats = {};
+        // A decoding worker keeps its load alive until it returns, nothing of it reaches the scene anymore
+        loads.clear();
+        objectBvh.Clear();
+    }
+
+    const MeshCompressionStats& Scene::GetMeshCompressionStats() const
+    {
+        return meshCompressionStats;
+    }
+
+    const SceneBvh& Scene::GetObjectBvh() const
+    {
+        objectBvh.Update(MeshObjectBatches);
+        return objectBvh;
+    }
+
+    SceneBvh::RayHit Scene::Pick(const glm::vec2& screenPos) const
+    {
+        // Near and far plane points under the screen position, NDC y points up
+        const glm::mat4 inverseViewProjection = glm::inverse(Camera.GetProjection() * Camera.GetView());
+        const glm::vec2 ndc(screenPos.x * 2.f - 1.f, 1.f - screenPos.y * 2.f);
+        glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, -1.f, 1.f);
+        glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.f, 1.f);
+        nearPoint /= nearPoint.w;
+        farPoint /= farPoint.w;
+
+        SceneBvh::Ray ray;
+        ray.Origin = glm::vec3(nearPoint);
+        ray.Direction = glm::vec3(farPoint - nearPoint);
+        // Direction spans the depth range, distances past 1 are behind the far plane
+        return GetObjectBvh().RayCast(ray, 1.f);
     }
 
     void Scene::OnTick(double deltaTimeInS)
     {
         Camera.OnTick(deltaTimeInS);
+        UpdateLoads();
     }
 
     void Scene::OnWindowResize(float aspectRatio)
@@ -368,26 +530,21 @@ namespace RyuRenderer::Graphics::Scene
     }
 
     std::shared_ptr<Graphics::Texture2d> Scene::GetTexture(
-        const aiMaterial* mat, aiTextureType t, const std::string& textureFileRootPath) const
+        const std::string& textureFileName, aiTextureType t, const std::string& textureFileRootPath) const
     {
-        if (!mat)
-            return nullptr;
         if (t == aiTextureType_NONE)
             return nullptr;
         if (textureFileRootPath.empty())
             return nullptr;
-        if (mat->GetTextureCount(t) <= 0)
+        if (textureFileName.empty())
             return nullptr;
 
-        aiString textureFileName;
-        mat->GetTexture(t, 0, &textureFileName);
-        if (textureFileName.length == 0)
-            return nullptr;
-        std::string textureFileNameStr = textureFileName.C_Str();
-        std::filesystem::path fullPath = std::filesystem::path(textureFileRootPath).append(textureFileNameStr);
+        std::filesystem::path fullPath = std::filesystem::path(textureFileRootPath).append(textureFileName);
         if (!std::filesystem::exists(fullPath))
             return nullptr;
 
+        if (IsTextureLoadingAsync)
+            return TextureManager::GetInstance().FindOrCreate2dAsync(fullPath.string(), GetTextureUnitIdxByType(t));
         return TextureManager::GetInstance().FindOrCreate2d(fullPath.string(), GetTextureUnitIdxByType(t));
     }
 
@@ -0,0 +1,589 @@
+#include "graphics/scene/SceneBvh.h"
+
+#include <algorithm>
+#include <array>
+
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    namespace
+    {
+        // Half the surface area, the SAH only compares areas
+        float GetHalfArea(const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec3 d = glm::max(max - min, glm::vec3(0.f));
+            return d.x * d.y + d.y * d.z + d.z * d.x;
+        }
+
+        bool IsOutside(const glm::vec4& plane, const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec3 positiveVertex(
+                plane.x >= 0.f ? max.x : min.x,
+                plane.y >= 0.f ? max.y : min.y,
+                plane.z >= 0.f ? max.z : min.z);
+            return glm::dot(glm::vec3(plane), positiveVertex) + plane.w < 0.f;
+        }
+
+        bool IsInside(const glm::vec4& plane, const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec3 negativeVertex(
+                plane.x >= 0.f ? min.x : max.x,
+                plane.y >= 0.f ? min.y : max.y,
+                plane.z >= 0.f ? min.z : max.z);
+            return glm::dot(glm::vec3(plane), negativeVertex) + plane.w >= 0.f;
+        }
+
+        // Distance along the ray to where it enters the box, max float when it misses or enters past maxDistance
+        float IntersectRay(
+            const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance,
+            const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec3 t0 = (min - origin) * inverseDirection;
+            const glm::vec3 t1 = (max - origin) * inverseDirection;
+            const glm::vec3 tNear = glm::min(t0, t1);
+            const glm::vec3 tFar = glm::max(t0, t1);
+            const float enter = std::max({ tNear.x, tNear.y, tNear.z, 0.f });
+            const float exit = std::min({ tFar.x, tFar.y, tFar.z, maxDistance });
+            return enter <= exit ? enter : std::numeric_limits<float>::max();
+        }
+
+        bool IsOverlapping(const glm::vec3& aMin, const glm::vec3& aMax, const glm::vec3& bMin, const glm::vec3& bMax)
+        {
+            return glm::all(glm::lessThanEqual(aMin, bMax)) && glm::all(glm::lessThanEqual(bMin, aMax));
+        }
+
+        bool IsOverlapping(const glm::vec3& center, float radius, const glm::vec3& min, const glm::vec3& max)
+        {
+            const glm::vec3 d = glm::clamp(center, min, max) - center;
+            return glm::dot(d, d) <= radius * radius;
+        }
+    }
+
+    void SceneBvh::Update(const std::list<MeshObjectBatch>& batches)
+    {
+        RYU_PROFILE_ZONE("SceneBvh::Update");
+
+        size_t amount = 0;
+        for (const auto& batch : batches)
+            amount += batch.MeshObjects.size();
+        if (amount != objects.size())
+        {
+            Build(batches);
+            return;
+        }
+
+        dirtyLeafIdxs.clear();
+        size_t i = 0;
+        for (const auto& batch : batches)
+        {
+            for (const auto& mo : batch.MeshObjects)
+            {
+                Object& o = objects[i++];
+                if (o.Source != &mo)
+                {
+                    Build(batches);
+                    return;
+                }
+                if (o.TransformVersion == mo.Transformer.GetVersion() && o.LocalBounds == mo.LocalBounds)
+                    continue;
+
+                const Bounds worldBounds = mo.LocalBounds.Transform(mo.Transformer.GetMatrix());
+                // Objects entering or leaving the tree change the ranges of its nodes
+                if (worldBounds.IsValid() != o.WorldBounds.IsValid())
+                {
+                    Build(batches);
+                    return;
+                }
+                o.TransformVersion = mo.Transformer.GetVersion();
+                o.LocalBounds = mo.LocalBounds;
+                o.WorldBounds = worldBounds;
+                if (o.LeafIdx != UINT32_MAX)
+                    dirtyLeafIdxs.push_back(o.LeafIdx);
+            }
+        }
+
+        if (dirtyLeafIdxs.empty())
+            return;
+        ++refitAmount;
+
+        // Children come after their parent, so one backward pass refits bottom up. Few moved objects only walk up from their leaves
+        if (dirtyLeafIdxs.size() * 8 >= nodeAmount)
+        {
+            for (size_t nodeIdx = nodeAmount; nodeIdx-- > 0;)
+                FitNode(nodes[nodeIdx]);
+        }
+        else
+        {
+            for (uint32_t leafIdx : dirtyLeafIdxs)
+            {
+                for (uint32_t nodeIdx = leafIdx; nodeIdx != UINT32_MAX; nodeIdx = nodes[nodeIdx].ParentIdx)
+                {
+                    Node& node = nodes[nodeIdx];
+                    const glm::vec3 oldMin = node.Min;
+                    const glm::vec3 oldMax = node.Max;
+                    FitNode(node);
+                    if (nodeIdx != leafIdx && node.Min == oldMin && node.Max == oldMax)
+                        break;
+                }
+            }
+        }
+
+        cost = ComputeCost();
+        if (cost > buildCost * RebuildCostRatio)
+            Build(batches);
+    }
+
+    void SceneBvh::Build(const std::list<MeshObjectBatch>& batches)
+    {
+        RYU_PROFILE_ZONE("SceneBvh::Build");
+
+        objects.clear();
+        objectIdxs.clear();
+        unboundedObjectIdxs.clear();
+        dirtyLeafIdxs.clear();
+        for (const auto& batch : batches)
+        {
+            for (const auto& mo : batch.MeshObjects)
+            {
+                Object o;
+                o.Source = &mo;
+                o.LocalBounds = mo.LocalBounds;
+                o.WorldBounds = mo.LocalBounds.Transform(mo.Transformer.GetMatrix());
+                o.TransformVersion = mo.Transformer.GetVersion();
+
+                const uint32_t objectIdx = static_cast<uint32_t>(objects.size());
+                if (o.WorldBounds.IsValid())
+                    objectIdxs.push_back(objectIdx);
+                else
+                    unboundedObjectIdxs.push_back(objectIdx);
+                objects.emplace_back(o);
+            }
+        }
+
+        ++buildAmount;
+        nodeAmount = 0;
+        cost = 0.f;
+        buildCost = 0.f;
+        if (objectIdxs.empty())
+        {
+            nodes.clear();
+            return;
+        }
+
+        centroids.resize(objects.size());
+        for (uint32_t objectIdx : objectIdxs)
+            centroids[objectIdx] = (objects[objectIdx].WorldBounds.Min + objects[objectIdx].WorldBounds.Max) * 0.5f;
+
+        // A binary tree with at least one object per leaf never has more nodes than this
+        nodes.assign(objectIdxs.size() * 2 - 1, Node());
+        std::atomic<uint32_t> nextNodeIdx = 1;
+        BuildNode(0, 0, static_cast<uint32_t>(objectIdxs.size()), nextNodeIdx);
+        nodeAmount = nextNodeIdx.load();
+
+        cost = ComputeCost();
+        buildCost = cost;
+    }
+
+    void SceneBvh::Clear()
+    {
+        objects.clear();
+        objectIdxs.clear();
+        unboundedObjectIdxs.clear();
+        nodes.clear();
+        centroids.clear();
+        dirtyLeafIdxs.clear();
+        nodeAmount = 0;
+        cost = 0.f;
+        buildCost = 0.f;
+    }
+
+    size_t SceneBvh::CullFrustum(const Frustum& frustum, std::vector<uint8_t>& visibleFlags) const
+    {
+        RYU_PROFILE_ZONE("SceneBvh::CullFrustum");
+
+        visibleFlags.assign(objects.size(), 0);
+        for (uint32_t objectIdx : unboundedObjectIdxs)
+            visibleFlags[objectIdx] = 1;
+        size_t visibleAmount = unboundedObjectIdxs.size();
+        if (nodeAmount == 0)
+            return visibleAmount;
+
+        // Planes a node is fully inside of are dropped for its subtree
+        struct Entry
+        {
+            uint32_t NodeIdx = 0;
+            uint32_t PlaneMask = 0;
+        };
+        constexpr uint32_t allPlanesMask = (1u << 6) - 1;
+
+        std::vector<Entry> stack;
+        stack.reserve(64);
+        stack.push_back({ 0, allPlanesMask });
+        while (!stack.empty())
+        {
+            const Entry entry = stack.back();
+            stack.pop_back();
+
+            const Node& node = nodes[entry.NodeIdx];
+            uint32_t planeMask = entry.PlaneMask;
+            bool isOutside = false;
+            for (uint32_t p = 0; p < 6 && !isOutside; ++p)
+            {
+                if (!(planeMask & (1u << p)))
+                    continue;
+                isOutside = IsOutside(frustum.Planes[p], node.Min, node.Max);
+                if (IsInside(frustum.Planes[p], node.Min, node.Max))
+                    planeMask &= ~(1u << p);
+            }
+            if (isOutside)
+                continue;
+
+            if (planeMask == 0)
+            {
+                MarkSubtreeVisible(node, visibleFlags);
+                visibleAmount += node.ObjectAmount;
+                continue;
+            }
+
+            if (!node.IsLeaf())
+            {
+                stack.push_back({ node.LeftChildIdx, planeMask });
+                stack.push_back({ node.LeftChildIdx + 1, planeMask });
+                continue;
+            }
+
+            for (uint32_t i = node.FirstObject; i < node.FirstObject + node.ObjectAmount; ++i)
+            {
+                const Bounds& b = objects[objectIdxs[i]].WorldBounds;
+                bool isObjectOutside = false;
+                for (uint32_t p = 0; p < 6 && !isObjectOutside; ++p)
+                {
+                    if (!(planeMask & (1u << p)))
+                        continue;
+                    const glm::vec4& plane = frustum.Planes[p];
+                    isObjectOutside = glm::dot(glm::vec3(plane), b.Center) + plane.w < -b.Radius || IsOutside(plane, b.Min, b.Max);
+                }
+                if (isObjectOutside)
+                    continue;
+                visibleFlags[objectIdxs[i]] = 1;
+                ++visibleAmount;
+            }
+        }
+        return visibleAmount;
+    }
+
+    SceneBvh::RayHit SceneBvh::RayCast(const Ray& ray, float maxDistance) const
+    {
+        RayHit hit;
+        if (nodeAmount == 0)
+            return hit;
+
+        const glm::vec3 inverseDirection = 1.f / ray.Direction;
+        hit.Distance = maxDistance;
+
+        std::vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if (IntersectRay(ray.Origin, inverseDirection, hit.Distance, node.Min, node.Max) == std::numeric_limits<float>::max())
+                continue;
+
+            if (node.IsLeaf())
+            {
+                for (uint32_t i = node.FirstObject; i < node.FirstObject + node.ObjectAmount; ++i)
+                {
+                    const Object& o = objects[objectIdxs[i]];
+                    const float distance = IntersectRay(ray.Origin, inverseDirection, hit.Distance, o.WorldBounds.Min, o.WorldBounds.Max);
+                    if (distance < hit.Distance || (distance == hit.Distance && !hit.IsHit()))
+                    {
+                        hit.Object = o.Source;
+                        hit.Distance = distance;
+                    }
+                }
+                continue;
+            }
+
+            // The nearer child is popped first, so it usually shortens the ray before the other one is tested
+            const Node& left = nodes[node.LeftChildIdx];
+            const Node& right = nodes[node.LeftChildIdx + 1];
+            const float leftDistance = IntersectRay(ray.Origin, inverseDirection, hit.Distance, left.Min, left.Max);
+            const float rightDistance = IntersectRay(ray.Origin, inverseDirection, hit.Distance, right.Min, right.Max);
+            if (leftDistance <= rightDistance)
+            {
+                stack.push_back(node.LeftChildIdx + 1);
+                stack.push_back(node.LeftChildIdx);
+            }
+            else
+            {
+                stack.push_back(node.LeftChildIdx);
+                stack.push_back(node.LeftChildIdx + 1);
+            }
+        }
+
+        if (!hit.IsHit())
+            hit.Distance = std::numeric_limits<float>::max();
+        return hit;
+    }
+
+    void SceneBvh::QueryBox(const glm::vec3& min, const glm::vec3& max, std::vector<const MeshObject*>& result) const
+    {
+        if (nodeAmount == 0)
+            return;
+
+        std::vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if (!IsOverlapping(min, max, node.Min, node.Max))
+                continue;
+
+            if (!node.IsLeaf())
+            {
+                stack.push_back(node.LeftChildIdx);
+                stack.push_back(node.LeftChildIdx + 1);
+                continue;
+            }
+            for (uint32_t i = node.FirstObject; i < node.FirstObject + node.ObjectAmount; ++i)
+            {
+                const Object& o = objects[objectIdxs[i]];
+                if (IsOverlapping(min, max, o.WorldBounds.Min, o.WorldBounds.Max))
+                    result.push_back(o.Source);
+            }
+        }
+    }
+
+    void SceneBvh::QuerySphere(const glm::vec3& center, float radius, std::vector<const MeshObject*>& result) const
+    {
+        if (nodeAmount == 0)
+            return;
+
+        std::vector<uint32_t> stack;
+        stack.reserve(64);
+        stack.push_back(0);
+        while (!stack.empty())
+        {
+            const Node& node = nodes[stack.back()];
+            stack.pop_back();
+            if (!IsOverlapping(center, radius, node.Min, node.Max))
+                continue;
+
+            if (!node.IsLeaf())
+            {
+                stack.push_back(node.LeftChildIdx);
+                stack.push_back(node.LeftChildIdx + 1);
+                continue;
+            }
+            for (uint32_t i = node.FirstObject; i < node.FirstObject + node.ObjectAmount; ++i)
+            {
+                const Object& o = objects[objectIdxs[i]];
+                if (IsOverlapping(center, radius, o.WorldBounds.Min, o.WorldBounds.Max))
+                    result.push_back(o.Source);
+            }
+        }
+    }
+
+    SceneBvh::Stats SceneBvh::GetStats() const
+    {
+        Stats stats;
+        stats.ObjectAmount = objects.size();
+        stats.NodeAmount = nodeAmount;
+        stats.BuildAmount = buildAmount;
+        stats.RefitAmount = refitAmount;
+        stats.Cost = cost;
+        stats.BuildCost = buildCost;
+        return stats;
+    }
+
+    void SceneBvh::BuildNode(uint32_t nodeIdx, uint32_t firstObject, uint32_t objectAmount, std::atomic<uint32_t>& nextNodeIdx)
+    {
+        Node& node = nodes[nodeIdx];
+        node.FirstObject = firstObject;
+        node.ObjectAmount = objectAmount;
+        node.LeftChildIdx = 0;
+
+        const auto begin = objectIdxs.begin() + firstObject;
+        const auto end = begin + objectAmount;
+        auto getCentroid = [this](uint32_t objectIdx) -> const glm::vec3&
+        {
+            return centroids[objectIdx];
+        };
+
+        glm::vec3 centroidMin(std::numeric_limits<float>::max());
+        glm::vec3 centroidMax(std::numeric_limits<float>::lowest());
+        node.Min = glm::vec3(std::numeric_limits<float>::max());
+        node.Max = glm::vec3(std::numeric_limits<float>::lowest());
+        for (auto it = begin; it != end; ++it)
+        {
+            const Bounds& b = objects[*it].WorldBounds;
+            node.Min = glm::min(node.Min, b.Min);
+            node.Max = glm::max(node.Max, b.Max);
+            centroidMin = glm::min(centroidMin, getCentroid(*it));
+            centroidMax = glm::max(centroidMax, getCentroid(*it));
+        }
+
+        if (objectAmount == 1)
+        {
+            objects[*begin].LeafIdx = nodeIdx;
+            return;
+        }
+
+        /// Binned SAH, objects go to one of BinAmount slices of the centroid bounds on each axis
+        struct Bin
+        {
+            glm::vec3 Min = glm::vec3(std::numeric_limits<float>::max());
+            glm::vec3 Max = glm::vec3(std::numeric_limits<float>::lowest());
+            uint32_t ObjectAmount = 0;
+        };
+
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestBinIdx = 0;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            const float extent = centroidMax[axis] - centroidMin[axis];
+            if (!(extent > 0.f))
+                continue;
+
+            const float binScale = BinAmount / extent;
+            std::array<Bin, BinAmount> bins;
+            for (auto it = begin; it != end; ++it)
+            {
+                const Bounds& b = objects[*it].WorldBounds;
+                const uint32_t binIdx = std::min(
+                    static_cast<uint32_t>((getCentroid(*it)[axis] - centroidMin[axis]) * binScale), BinAmount - 1);
+                bins[binIdx].Min = glm::min(bins[binIdx].Min, b.Min);
+                bins[binIdx].Max = glm::max(bins[binIdx].Max, b.Max);
+                ++bins[binIdx].ObjectAmount;
+            }
+
+            // Right side costs of splitting after bin i, swept from the right
+            std::array<float, BinAmount> rightCosts = {};
+            Bin right;
+            for (uint32_t i = BinAmount - 1; i > 0; --i)
+            {
+                right.Min = glm::min(right.Min, bins[i].Min);
+                right.Max = glm::max(right.Max, bins[i].Max);
+                right.ObjectAmount += bins[i].ObjectAmount;
+                rightCosts[i - 1] = right.ObjectAmount > 0 ? GetHalfArea(right.Min, right.Max) * right.ObjectAmount : -1.f;
+            }
+
+            Bin left;
+            for (uint32_t i = 0; i < BinAmount - 1; ++i)
+            {
+                left.Min = glm::min(left.Min, bins[i].Min);
+                left.Max = glm::max(left.Max, bins[i].Max);
+                left.ObjectAmount += bins[i].ObjectAmount;
+                if (left.ObjectAmount == 0 || rightCosts[i] < 0.f)
+                    continue;
+
+                const float splitCost = GetHalfArea(left.Min, left.Max) * left.ObjectAmount + rightCosts[i];
+                if (splitCost < bestCost)
+                {
+                    bestCost = splitCost;
+                    bestAxis = axis;
+                    bestBinIdx = i;
+                }
+            }
+        }
+
+        // Costs are scaled by the node area, one traversal step costs as much as one object test
+        const float area = GetHalfArea(node.Min, node.Max);
+        if (objectAmount <= MaxLeafObjectAmount && (bestAxis < 0 || area + bestCost >= area * objectAmount))
+        {
+            for (auto it = begin; it != end; ++it)
+                objects[*it].LeafIdx = nodeIdx;
+            return;
+        }
+
+        uint32_t leftAmount = objectAmount / 2;
+        if (bestAxis >= 0)
+        {
+            const float binScale = BinAmount / (centroidMax[bestAxis] - centroidMin[bestAxis]);
+            const auto middle = std::partition(begin, end, [&](uint32_t objectIdx)
+            {
+                const uint32_t binIdx = std::min(
+                    static_cast<uint32_t>((getCentroid(objectIdx)[bestAxis] - centroidMin[bestAxis]) * binScale), BinAmount - 1);
+                return binIdx <= bestBinIdx;
+            });
+            leftAmount = static_cast<uint32_t>(middle - begin);
+        }
+        // Coincident centroids cannot be told apart by position, any half is as good
+        if (leftAmount == 0 || leftAmount == objectAmount)
+            leftAmount = objectAmount / 2;
+
+        const uint32_t leftChildIdx = nextNodeIdx.fetch_add(2);
+        node.LeftChildIdx = leftChildIdx;
+        nodes[leftChildIdx].ParentIdx = nodeIdx;
+        nodes[leftChildIdx + 1].ParentIdx = nodeIdx;
+
+        auto buildChild = [&](size_t childIdx)
+        {
+            if (childIdx == 0)
+                BuildNode(leftChildIdx, firstObject, leftAmount, nextNodeIdx);
+            else
+                BuildNode(leftChildIdx + 1, firstObject + leftAmount, objectAmount - leftAmount, nextNodeIdx);
+        };
+        if (objectAmount >= ParallelBuildObjectAmount)
+        {
+            Common::ThreadPool::GetInstance().ParallelFor(2, buildChild);
+        }
+        else
+        {
+            buildChild(0);
+            buildChild(1);
+        }
+    }
+
+    void SceneBvh::FitNode(Node& node) const
+    {
+        node.Min = glm::vec3(std::numeric_limits<float>::max());
+        node.Max = glm::vec3(std::numeric_limits<float>::lowest());
+        if (!node.IsLeaf())
+        {
+            const Node& left = nodes[node.LeftChildIdx];
+            const Node& right = nodes[node.LeftChildIdx + 1];
+            node.Min = glm::min(left.Min, right.Min);
+            node.Max = glm::max(left.Max, right.Max);
+            return;
+        }
+
+        for (uint32_t i = node.FirstObject; i < node.FirstObject + node.ObjectAmount; ++i)
+        {
+            const Bounds& b = objects[objectIdxs[i]].WorldBounds;
+            node.Min = glm::min(node.Min, b.Min);
+            node.Max = glm::max(node.Max, b.Max);
+        }
+    }
+
+    float SceneBvh::ComputeCost() const
+    {
+        if (nodeAmount == 0)
+            return 0.f;
+
+        const float rootArea = GetHalfArea(nodes[0].Min, nodes[0].Max);
+        if (!(rootArea > 0.f))
+            return 0.f;
+
+        float sum = 0.f;
+        for (size_t i = 0; i < nodeAmount; ++i)
+        {
+            const Node& node = nodes[i];
+            sum += GetHalfArea(node.Min, node.Max) * (node.IsLeaf() ? node.ObjectAmount : 1.f);
+        }
+        return sum / rootArea;
+    }
+
+    void SceneBvh::MarkSubtreeVisible(const Node& node, std::vector<uint8_t>& visibleFlags) const
+    {
+        for (uint32_t i = node.FirstObject; i < node.FirstObject + node.ObjectAmount; ++i)
+            visibleFlags[objectIdxs[i]] = 1;
+    }
+}
\ No newline at end of file
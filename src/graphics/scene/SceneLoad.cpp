@@ -0,0 +1,458 @@
+#include "graphics/scene/SceneLoad.h"
+
+#include "stb/stb_image.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <unordered_map>
+
+#include "common/Profiler.h"
+#include "common/ThreadPool.h"
+#include "graphics/CompressedTextureFile.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/TextureManager.h"
+#include "graphics/device/StateTracker.h"
+#include "graphics/scene/PhongBlinnMaterial.h"
+#include "graphics/scene/Scene.h"
+
+namespace RyuRenderer::Graphics::Scene
+{
+    SceneLoad::SceneLoad(
+        const std::string& modelFilePath,
+        const MeshOptimizationSettings& optimization,
+        const MeshLodSettings& lod,
+        size_t threadAmount)
+    {
+        source = modelFilePath;
+        textureFileRootPath = std::filesystem::path(modelFilePath).parent_path().string();
+        optimizationSettings = optimization;
+        lodSettings = lod;
+        importThreadAmount = threadAmount;
+    }
+
+    SceneLoad::State SceneLoad::GetState() const
+    {
+        return state;
+    }
+
+    bool SceneLoad::IsFinished() const
+    {
+        return state == STATE_DONE || state == STATE_FAILED;
+    }
+
+    float SceneLoad::GetProgress() const
+    {
+        if (state == STATE_DONE)
+            return 1.f;
+        if (state == STATE_DECODING || totalBytes == 0)
+            return 0.f;
+        return static_cast<float>(static_cast<double>(uploadedBytes) / totalBytes);
+    }
+
+    size_t SceneLoad::GetUploadedBytes() const
+    {
+        return uploadedBytes;
+    }
+
+    size_t SceneLoad::GetTotalBytes() const
+    {
+        // The worker is still counting
+        if (state == STATE_DECODING)
+            return 0;
+        return totalBytes;
+    }
+
+    size_t SceneLoad::GetMeshAmount() const
+    {
+        if (state == STATE_DECODING)
+            return 0;
+        return meshAmount;
+    }
+
+    size_t SceneLoad::GetReadyMeshAmount() const
+    {
+        return readyMeshAmount;
+    }
+
+    const std::string& SceneLoad::GetSource() const
+    {
+        return source;
+    }
+
+    bool SceneLoad::Decode()
+    {
+        RYU_PROFILE_ZONE("SceneLoad::Decode");
+
+        if (std::filesystem::path(source).extension() == RyuMeshFile::Extension)
+        {
+            if (!cookedFile.Open(source))
+                return false;
+            AddCookedMeshes();
+        }
+        else
+        {
+            if (!ModelImporter::Import(source, optimizationSettings, lodSettings, model, importThreadAmount))
+                return false;
+            AddImportedMeshes();
+        }
+        DecodeTextures();
+        meshAmount = meshes.size();
+
+        for (const auto& pm : meshes)
+        {
+            for (const auto& level : pm.Levels)
+            {
+                for (const auto& s : level.Streams)
+                    totalBytes += s.Bytes.size();
+            }
+        }
+        for (const auto& pt : textures)
+        {
+            for (const auto& level : pt.Levels)
+                totalBytes += level.Pixels.size();
+        }
+        return true;
+    }
+
+    void SceneLoad::AddCookedMeshes()
+    {
+        for (const auto& record : cookedFile.GetMaterials())
+        {
+            auto& material = model.Materials.emplace_back();
+            material.DiffuseTexture = cookedFile.GetString(record.DiffuseTexture);
+            material.SpecularTexture = cookedFile.GetString(record.SpecularTexture);
+            material.EmissionTexture = cookedFile.GetString(record.EmissionTexture);
+        }
+
+        // Streams are copied straight out of the mapping, it stays open until the load is done
+        for (const auto& mesh : cookedFile.GetMeshes())
+        {
+            auto& pm = meshes.emplace_back();
+            pm.MaterialIdx = mesh.MaterialIdx;
+            for (const auto& level : cookedFile.GetLevels(mesh))
+            {
+                auto& pl = pm.Levels.emplace_back();
+                pl.VertexAmount = static_cast<GLsizei>(level.VertexAmount);
+                pl.IndexAmount = static_cast<GLsizei>(level.IndexAmount);
+                pl.IndexType = level.IndexType;
+                if (level.IndexType == GL_UNSIGNED_SHORT)
+                    pl.Streams[0] = { std::as_bytes(cookedFile.GetShortIndices(level)), sizeof(GLushort) };
+                else
+                    pl.Streams[0] = { std::as_bytes(cookedFile.GetIndices(level)), sizeof(GLuint) };
+                pl.Streams[1] = { std::as_bytes(cookedFile.GetPositions(level)), sizeof(std::array<float, 3>) };
+                pl.Streams[2] = { std::as_bytes(cookedFile.GetNormals(level)), sizeof(std::array<float, 3>) };
+                pl.Streams[3] = { std::as_bytes(cookedFile.GetTexCoords(level)), sizeof(std::array<float, 2>) };
+                pl.LevelBounds = level.GetBounds();
+                pl.Error = level.Error;
+            }
+        }
+    }
+
+    void SceneLoad::AddImportedMeshes()
+    {
+        for (size_t i = 0; i < model.Meshes.size(); ++i)
+        {
+            const auto& im = model.Meshes[i];
+            auto& pm = meshes.emplace_back();
+            pm.MaterialIdx = im.MaterialIdx;
+            pm.SourceIdx = i;
+            for (const auto& level : im.Levels)
+            {
+                auto& pl = pm.Levels.emplace_back();
+                pl.VertexAmount = static_cast<GLsizei>(level.Positions.size());
+                pl.IndexAmount = static_cast<GLsizei>(level.Indices.size());
+                pl.IndexType = GL_UNSIGNED_INT;
+                pl.Streams[0] = { std::as_bytes(std::span(level.Indices)), sizeof(GLuint) };
+                pl.Streams[1] = { std::as_bytes(std::span(level.Positions)), sizeof(std::array<float, 3>) };
+                pl.Streams[2] = { std::as_bytes(std::span(level.Normals)), sizeof(std::array<float, 3>) };
+                pl.Streams[3] = { std::as_bytes(std::span(level.TexCoords)), sizeof(std::array<float, 2>) };
+                pl.LevelBounds = Bounds::FromPositions(level.Positions);
+                pl.Error = level.Error;
+            }
+        }
+    }
+
+    void SceneLoad::DecodeTextures()
+    {
+        RYU_PROFILE_ZONE("SceneLoad::DecodeTextures");
+
+        // Paths are built like Scene::GetTexture builds them, so the scene finds the streamed textures by source
+        std::unordered_map<std::string, int> textureIdxs;
+        auto findOrAdd = [this, &textureIdxs](const std::string& textureFileName, aiTextureType t)
+        {
+            if (textureFileName.empty() || textureFileRootPath.empty())
+                return -1;
+            const std::string path = std::filesystem::path(textureFileRootPath).append(textureFileName).string();
+            if (!std::filesystem::exists(path))
+                return -1;
+
+            auto [it, isAdded] = textureIdxs.try_emplace(path, static_cast<int>(textures.size()));
+            if (isAdded)
+            {
+                auto& pt = textures.emplace_back();
+                pt.Path = path;
+                pt.UnitIdx = Scene::GetTextureUnitIdxByType(t);
+            }
+            return it->second;
+        };
+
+        materialTextureIdxs.resize(model.Materials.size());
+        for (size_t i = 0; i < model.Materials.size(); ++i)
+        {
+            const auto& m = model.Materials[i];
+            materialTextureIdxs[i] = {
+                findOrAdd(m.DiffuseTexture, aiTextureType_DIFFUSE),
+                findOrAdd(m.SpecularTexture, aiTextureType_SPECULAR),
+                findOrAdd(m.EmissionTexture, aiTextureType_EMISSIVE)
+            };
+        }
+
+        // Texture files are independent, the decoder keeps no state between images
+        Common::ThreadPool::GetInstance().ParallelFor(textures.size(), [this](size_t i)
+        {
+            RYU_PROFILE_ZONE("SceneLoad::DecodeTexture");
+
+            auto& pt = textures[i];
+            auto known = TextureManager::GetInstance().Find(pt.Path);
+            if (known)
+            {
+                pt.Target = std::dynamic_pointer_cast<Texture2d>(known);
+                pt.IsFinished = true;
+                return;
+            }
+
+            if (CompressedTextureFile::IsCompressedTexturePath(pt.Path))
+            {
+                // Blocks need no decoding, only the mapping is read here and the ring is filled from the copy
+                CompressedTextureFile file;
+                if (!file.Open(pt.Path))
+                {
+                    pt.IsFinished = true;
+                    return;
+                }
+
+                pt.Format = file.GetFormat();
+                pt.IsTopDown = file.IsTopDown();
+                const size_t blockBytes = CompressedTextureFile::GetBlockBytes(pt.Format);
+                for (const auto& fileLevel : file.GetLevels())
+                {
+                    auto& level = pt.Levels.emplace_back();
+                    level.Width = fileLevel.Width;
+                    level.Height = fileLevel.Height;
+                    level.RowBytes = static_cast<size_t>((fileLevel.Width + 3) / 4) * blockBytes;
+                    level.RowAmount = (fileLevel.Height + 3) / 4;
+                    const auto* bytes = reinterpret_cast<const unsigned char*>(fileLevel.Bytes.data());
+                    level.Pixels.assign(bytes, bytes + fileLevel.Bytes.size());
+                }
+                return;
+            }
+
+            // Same formats as Texture2d reading the file itself
+            int channelAmount = 0;
+            if (pt.Path.ends_with(".jpg"))
+            {
+                pt.Format = GL_RGB;
+                channelAmount = 3;
+            }
+            else if (pt.Path.ends_with(".png"))
+            {
+                pt.Format = GL_RGBA;
+                channelAmount = 4;
+            }
+            else
+            {
+                std::cerr << "The suffix of the image file should be jpg, png, ktx2 or dds." << std::endl;
+                pt.IsFinished = true;
+                return;
+            }
+
+            auto& level = pt.Levels.emplace_back();
+            int fileChannelAmount = 0;
+            unsigned char* data = stbi_load(pt.Path.c_str(), &level.Width, &level.Height, &fileChannelAmount, channelAmount);
+            if (!data)
+            {
+                std::cerr << "Can not load texture file: " << pt.Path << "." << std::endl;
+                pt.Levels.clear();
+                pt.IsFinished = true;
+                return;
+            }
+            level.RowBytes = static_cast<size_t>(level.Width) * channelAmount;
+            level.RowAmount = level.Height;
+            level.Pixels.assign(data, data + level.RowBytes * level.Height);
+            stbi_image_free(data);
+        });
+    }
+
+    void SceneLoad::Upload(StagingRing& ring, size_t& budgetBytes)
+    {
+        RYU_PROFILE_ZONE("SceneLoad::Upload");
+
+        // Meshes go in file order, each after the textures of its material, so objects appear one by one
+        while (nextMeshIdx < meshes.size())
+        {
+            auto& pm = meshes[nextMeshIdx];
+            if (pm.MaterialIdx < materialTextureIdxs.size())
+            {
+                for (int textureIdx : materialTextureIdxs[pm.MaterialIdx])
+                {
+                    if (textureIdx >= 0 && !UploadTexture(textures[textureIdx], ring, budgetBytes))
+                        return;
+                }
+            }
+            if (!UploadMesh(pm, ring, budgetBytes))
+                return;
+
+            MeshLodChain chain;
+            for (auto& level : pm.Levels)
+            {
+                if (!level.Target.IsValid())
+                    break;
+                chain.Levels.emplace_back(std::move(level.Target));
+                chain.Errors.emplace_back(level.Error);
+            }
+            readyChains.emplace_back(std::move(chain));
+            readyMaterialIdxs.emplace_back(pm.MaterialIdx);
+            ++readyMeshAmount;
+
+            pm.Levels.clear();
+            if (!cookedFile.IsOpen() && pm.SourceIdx < model.Meshes.size())
+                model.Meshes[pm.SourceIdx] = {};
+            ++nextMeshIdx;
+        }
+        state = STATE_DONE;
+    }
+
+    bool SceneLoad::UploadTexture(PendingTexture& pt, StagingRing& ring, size_t& budgetBytes)
+    {
+        if (pt.IsFinished)
+            return true;
+
+        if (!pt.Target)
+        {
+            // The storage constructor passes its format on as the client format, compressed storage comes from Reallocate
+            const auto& level0 = pt.Levels[0];
+            const bool isCompressed = CompressedTextureFile::GetBlockBytes(pt.Format) != 0;
+            pt.Target = isCompressed ?
+                std::make_shared<Texture2d>(pt.Path, GL_RGBA, 1, 1, pt.UnitIdx) :
+                std::make_shared<Texture2d>(pt.Path, pt.Format, level0.Width, level0.Height, pt.UnitIdx);
+            if (!pt.Target->IsValid() ||
+                (isCompressed && !pt.Target->Reallocate(
+                    pt.Format, level0.Width, level0.Height, static_cast<GLint>(pt.Levels.size()), pt.IsTopDown))) {
+                pt.Target = nullptr;
+                pt.Levels = {};
+                pt.IsFinished = true;
+                return true;
+            }
+        }
+
+        auto& states = Device::StateTracker::GetInstance();
+        states.BindBuffer(GL_PIXEL_UNPACK_BUFFER, ring.GetId());
+        for (; pt.LevelIdx < pt.Levels.size(); ++pt.LevelIdx, pt.RowIdx = 0)
+        {
+            const auto& level = pt.Levels[pt.LevelIdx];
+            // Unpack rows are 4 byte aligned by default, blocks are 8 or 16 bytes anyway
+            const size_t rowPitch = (level.RowBytes + 3) & ~static_cast<size_t>(3);
+            while (pt.RowIdx < level.RowAmount)
+            {
+                size_t rowAmount = 0;
+                const auto a = ring.AllocateElements(
+                    static_cast<GLsizeiptr>(rowPitch), std::min(static_cast<size_t>(level.RowAmount - pt.RowIdx), budgetBytes / rowPitch), rowAmount);
+                if (!a.IsValid())
+                    break;
+
+                for (size_t r = 0; r < rowAmount; ++r)
+                    std::memcpy(a.Data + r * rowPitch, level.Pixels.data() + (pt.RowIdx + r) * level.RowBytes, level.RowBytes);
+                pt.Target->UploadRows(pt.RowIdx, static_cast<GLsizei>(rowAmount), reinterpret_cast<const void*>(a.Offset), static_cast<GLint>(pt.LevelIdx));
+
+                pt.RowIdx += static_cast<int>(rowAmount);
+                budgetBytes -= rowAmount * rowPitch;
+                uploadedBytes += rowAmount * level.RowBytes;
+            }
+            if (pt.RowIdx < level.RowAmount)
+                break;
+        }
+        // Later texture uploads from client memory must not read from the ring
+        states.BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (pt.LevelIdx < pt.Levels.size())
+            return false;
+
+        // Nothing to do for compressed textures, all their levels came from the file
+        pt.Target->GenerateMipmap();
+        pt.Target = TextureManager::GetInstance().Add2d(pt.Target);
+        pt.Levels = {};
+        pt.IsFinished = true;
+        return true;
+    }
+
+    bool SceneLoad::UploadMesh(PendingMesh& pm, StagingRing& ring, size_t& budgetBytes)
+    {
+        auto& pool = GeometryPool::GetInstance();
+        while (pm.LevelIdx < pm.Levels.size())
+        {
+            auto& level = pm.Levels[pm.LevelIdx];
+            if (!level.Target.IsValid())
+            {
+                level.Target = Mesh(PhongBlinnMaterial::MeshVertexLayout(), level.VertexAmount, level.IndexAmount, level.IndexType);
+                // Coarser levels are useless without this one, the chain ends before it
+                if (!level.Target.IsValid())
+                {
+                    pm.Levels.resize(pm.LevelIdx);
+                    break;
+                }
+                level.Target.SetBounds(level.LevelBounds);
+            }
+
+            while (pm.StreamIdx < level.Streams.size())
+            {
+                const auto& s = level.Streams[pm.StreamIdx];
+                const size_t elementAmount = s.Bytes.size() / s.ElementBytes;
+                while (pm.ElementIdx < elementAmount)
+                {
+                    size_t amount = 0;
+                    const auto a = ring.AllocateElements(
+                        static_cast<GLsizeiptr>(s.ElementBytes), std::min(elementAmount - pm.ElementIdx, budgetBytes / s.ElementBytes), amount);
+                    if (!a.IsValid())
+                        return false;
+
+                    const size_t bytes = amount * s.ElementBytes;
+                    std::memcpy(a.Data, s.Bytes.data() + pm.ElementIdx * s.ElementBytes, bytes);
+                    if (pm.StreamIdx == 0)
+                    {
+                        pool.CopyIndices(
+                            level.Target.GetGeometry(), ring.GetId(), a.Offset,
+                            static_cast<GLsizei>(pm.ElementIdx), static_cast<GLsizei>(amount));
+                    }
+                    else
+                    {
+                        pool.CopyVertices(
+                            level.Target.GetGeometry(), static_cast<GLuint>(pm.StreamIdx - 1), ring.GetId(), a.Offset,
+                            static_cast<GLsizei>(pm.ElementIdx), static_cast<GLsizei>(amount));
+                    }
+
+                    pm.ElementIdx += amount;
+                    budgetBytes -= bytes;
+                    uploadedBytes += bytes;
+                }
+                ++pm.StreamIdx;
+                pm.ElementIdx = 0;
+            }
+            ++pm.LevelIdx;
+            pm.StreamIdx = 0;
+        }
+        return true;
+    }
+
+    void SceneLoad::Release()
+    {
+        // Levels hold Meshes, which can not be copied, so no assignment from an empty list here
+        meshes.clear();
+        meshes.shrink_to_fit();
+        textures.clear();
+        textures.shrink_to_fit();
+        model.Meshes.clear();
+        model.Meshes.shrink_to_fit();
+        cookedFile.Close();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,51 @@
+#include "graphics/scene/SceneUniformBlocks.h"
+
+#include <algorithm>
+
+namespace RyuRenderer::Graphics::Scene
+{
+    void LightsUniformBlock::Set(
+        const glm::mat4& view,
+        const DirectionalLight& directionLight,
+        const std::vector<PointLight>& pointLights,
+        const std::vector<SpotLight>& spotLights
+    )
+    {
+        const glm::mat3 viewDirectionMatrix = glm::transpose(glm::inverse(glm::mat3(view)));
+
+        // Set directional light
+        DirectionLight.Color = directionLight.Color;
+        DirectionLight.ViewDirection = viewDirectionMatrix * directionLight.Transformer.GetFrontDirection();
+
+        // Set point lights
+        const size_t pointLightAmount = std::min(pointLights.size(), MaxPointLightAmount);
+        ActivePointLightAmount = static_cast<GLint>(pointLightAmount);
+        for (size_t i = 0; i < pointLightAmount; ++i)
+        {
+            const auto& l = pointLights[i];
+            auto& d = PointLights[i];
+            d.Color = l.Color;
+            d.ViewPos = glm::vec3(view * glm::vec4(l.Transformer.GetPosition(), 1.0f));
+            d.AttenuationConstant = l.AttenuationConstant;
+            d.AttenuationLinear = l.AttenuationLinear;
+            d.AttenuationQuadratic = l.AttenuationQuadratic;
+        }
+
+        // Set spot lights
+        const size_t spotLightAmount = std::min(spotLights.size(), MaxSpotLightAmount);
+        ActiveSpotLightAmount = static_cast<GLint>(spotLightAmount);
+        for (size_t i = 0; i < spotLightAmount; ++i)
+        {
+            const auto& l = spotLights[i];
+            auto& d = SpotLights[i];
+            d.Color = l.Color;
+            d.ViewPos = glm::vec3(view * glm::vec4(l.Transformer.GetPosition(), 1.0f));
+            d.ViewDirection = viewDirectionMatrix * l.Transformer.GetFrontDirection();
+            d.InnerCutOffCos = l.InnerCutOffCos;
+            d.OuterCutOffCos = l.OuterCutOffCos;
+            d.AttenuationConstant = l.AttenuationConstant;
+            d.AttenuationLinear = l.AttenuationLinear;
+            d.AttenuationQuadratic = l.AttenuationQuadratic;
+        }
+    }
+}
\ No newline at end of file
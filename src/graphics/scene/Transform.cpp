@@ -8,11 +8,13 @@ namespace RyuRenderer::Graphics::Scene
     {
         glm::vec3 moveDir = glm::normalize(dir);
         position += moveDir * distance;
+        ++version;
     }
 
     void Transform::MoveTo(const glm::vec3& pos)
     {
         position = pos;
+        ++version;
     }
 
     void Transform::Rotate(const glm::vec3& rotateAxis, float degree)
@@ -20,6 +22,7 @@ namespace RyuRenderer::Graphics::Scene
         float angle = glm::radians(degree);
         glm::quat r = glm::angleAxis(angle, rotateAxis);
         rotation = r * rotation;
+        ++version;
     }
 
     void Transform::RotateTo(
@@ -33,6 +36,7 @@ namespace RyuRenderer::Graphics::Scene
 
         glm::mat3 rotationMatrix = glm::mat3(right, up, -front);
         rotation = glm::quat(rotationMatrix);
+        ++version;
     }
 
     void Transform::RotateTo(
@@ -57,6 +61,7 @@ namespace RyuRenderer::Graphics::Scene
             Scene::GetZAxisDirection()
         );
         rotation = rotationX * rotationY * rotationZ;
+        ++version;
     }
 
     void Transform::RotateTo(const glm::vec3& targetDirection)
@@ -90,6 +95,7 @@ namespace RyuRenderer::Graphics::Scene
 
         glm::mat3 rotationMatrix = glm::mat3(right, up, -front);
         rotation = glm::quat(rotationMatrix);
+        ++version;
     }
 
     void Transform::Scale(const glm::vec3& s)
@@ -97,11 +103,13 @@ namespace RyuRenderer::Graphics::Scene
         scale.x *= s.x;
         scale.y *= s.y;
         scale.z *= s.z;
+        ++version;
     }
 
     void Transform::ScaleTo(const glm::vec3& scaleTarget)
     {
         scale = scaleTarget;
+        ++version;
     }
 
     glm::mat4 Transform::GetMatrix() const
@@ -158,4 +166,9 @@ namespace RyuRenderer::Graphics::Scene
     {
         return rotation * Scene::GetDownDirection();
     }
+
+    uint32_t Transform::GetVersion() const
+    {
+        return version;
+    }
 }
\ No newline at end of file
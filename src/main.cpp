@@ -1,12 +1,58 @@
-#include "App/app.h"
+#include "app/App.h"
 #include "app/render-pipeline/BlendPipeline.h"
+#include "common/Profiler.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
 
 using namespace RyuRenderer::App;
 using namespace RyuRenderer::App::RenderPipeline;
 
-int main()
+static void PrintUsage()
+{
+    std::cout <<
+        "Usage:\n"
+        "  ryu-renderer [--headless] [--frames <amount>] [--fixed-dt <seconds>] [--trace <trace.json>]\n";
+}
+
+int main(int argc, char* argv[])
 {
-    if (!App::GetInstance().Init(AppSettings()))
+    AppSettings settings;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        try
+        {
+            if (arg == "--headless")
+                settings.Backend = AppSettings::BackendType::BACKEND_HEADLESS;
+            else if (arg == "--frames" && i + 1 < argc)
+                settings.MaxFrameAmount = std::stoull(argv[++i]);
+            else if (arg == "--fixed-dt" && i + 1 < argc)
+                settings.FixedDeltaTimeInS = std::stod(argv[++i]);
+            else if (arg == "--trace" && i + 1 < argc)
+            {
+                // Dumped when the profiler is destroyed, so closing the window still writes the trace
+                RyuRenderer::Common::Profiler::GetInstance().SetThreadName("Main");
+                RyuRenderer::Common::Profiler::GetInstance().SetDumpPathAtExit(argv[++i]);
+            }
+        }
+        catch (const std::invalid_argument&)
+        {
+            std::cerr << "Invalid value for " << arg << ": " << argv[i] << std::endl;
+            PrintUsage();
+            return 1;
+        }
+        catch (const std::out_of_range&)
+        {
+            std::cerr << "Value for " << arg << " is out of range: " << argv[i] << std::endl;
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    if (!App::GetInstance().Init(settings))
         return -1;
 
     BlendPipeline p;
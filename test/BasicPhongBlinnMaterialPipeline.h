@@ -17,11 +17,13 @@
 #include "graphics/Mesh.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderManager.h"
-#include "graphics/Texture2D.h"
+#include "graphics/Texture2d.h"
 #include "graphics/TextureManager.h"
+#include "graphics/UniformBuffer.h"
 #include "graphics/scene/Camera.h"
 #include "graphics/scene/DirectionalLight.h"
 #include "graphics/scene/PointLight.h"
+#include "graphics/scene/SceneUniformBlocks.h"
 #include "graphics/scene/SpotLight.h"
 
 namespace RyuRenderer::App::RenderPipeline
@@ -212,10 +214,10 @@ namespace RyuRenderer::App::RenderPipeline
                 boxEmission->Use();
 
             // init light shader
-            lightShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
+            lightShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
 
             // init box shader
-            boxShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-blinn-phong-material.vert", "res/shaders/3d-blinn-phong-material.frag");
+            boxShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-blinn-phong-material.vert", "res/shaders/3d-blinn-phong-material.frag");
             if (boxShader)
             {
                 boxShader->Use();
@@ -229,6 +231,10 @@ namespace RyuRenderer::App::RenderPipeline
                 boxShader->SetUniform("material.shininess", boxShininess);
             }
 
+            // init uniform buffers
+            frameUniformBuffer = Graphics::UniformBuffer(sizeof(Graphics::Scene::FrameUniformBlock), Graphics::Scene::FrameUniformBlock::BindingIdx);
+            lightsUniformBuffer = Graphics::UniformBuffer(sizeof(Graphics::Scene::LightsUniformBlock), Graphics::Scene::LightsUniformBlock::BindingIdx);
+
             // init mvp
             view = camera.GetView();
             projection = camera.GetProjection();
@@ -362,43 +368,18 @@ namespace RyuRenderer::App::RenderPipeline
 
             // handle scene objects
             boxShader->Use();
-            boxShader->SetUniform("view", view);
-            boxShader->SetUniform("projection", projection);
 
-            // set directional light
-            boxShader->SetUniform("directionalLight.color", directionLight.Color);
-            boxShader->SetUniform("directionalLight.viewDirection", glm::transpose(glm::inverse(glm::mat3(view))) * directionLight.Transformer.GetFrontDirection());
+            // upload camera and lights
+            Graphics::Scene::FrameUniformBlock frameBlock;
+            frameBlock.View = view;
+            frameBlock.Projection = projection;
+            frameUniformBuffer.Update(frameBlock);
+            frameUniformBuffer.Use();
 
-            // set point light
-            boxShader->SetUniform("activePointLightCount", (int)pointLightCount);
-            for (size_t i = 0; i < pointLightCount; ++i)
-            {
-                auto& l = pointLights[i];
-
-                std::string pointPrefix = "pointLights[" + std::to_string(i) + "].";
-                boxShader->SetUniform(pointPrefix + "color", l.Color);
-                boxShader->SetUniform(pointPrefix + "viewPos", glm::vec3(view * glm::vec4(l.Transformer.GetPosition(), 1.0f)));
-                boxShader->SetUniform(pointPrefix + "attenuationConstant", l.AttenuationConstant);
-                boxShader->SetUniform(pointPrefix + "attenuationLinear", l.AttenuationLinear);
-                boxShader->SetUniform(pointPrefix + "attenuationQuadratic", l.AttenuationQuadratic);
-            }
-
-            // set spot light
-            boxShader->SetUniform("activeSpotLightCount", (int)spotLightCount);
-            for (size_t i = 0; i < spotLightCount; ++i)
-            {
-                auto& l = spotLights[i];
-
-                std::string spotPrefix = "spotLights[" + std::to_string(i) + "].";
-                boxShader->SetUniform(spotPrefix + "color", l.Color);
-                boxShader->SetUniform(spotPrefix + "viewPos", glm::vec3(view * glm::vec4(l.Transformer.GetPosition(), 1.0f)));
-                boxShader->SetUniform(spotPrefix + "viewDirection", glm::transpose(glm::inverse(glm::mat3(view))) * l.Transformer.GetFrontDirection());
-                boxShader->SetUniform(spotPrefix + "innerCutOffCos", l.InnerCutOffCos);
-                boxShader->SetUniform(spotPrefix + "outerCutOffCos", l.OuterCutOffCos);
-                boxShader->SetUniform(spotPrefix + "attenuationConstant", l.AttenuationConstant);
-                boxShader->SetUniform(spotPrefix + "attenuationLinear", l.AttenuationLinear);
-                boxShader->SetUniform(spotPrefix + "attenuationQuadratic", l.AttenuationQuadratic);
-            }
+            Graphics::Scene::LightsUniformBlock lightsBlock;
+            lightsBlock.Set(view, directionLight, pointLights, spotLights);
+            lightsUniformBuffer.Update(lightsBlock);
+            lightsUniformBuffer.Use();
 
             // draw boxes
             for (size_t i = 0; i < modelBoxs.size(); ++i)
@@ -442,6 +423,9 @@ namespace RyuRenderer::App::RenderPipeline
         std::shared_ptr<Graphics::Shader> lightShader;
         std::shared_ptr<Graphics::Shader> boxShader;
 
+        Graphics::UniformBuffer frameUniformBuffer;
+        Graphics::UniformBuffer lightsUniformBuffer;
+
         // lights
         Graphics::Scene::DirectionalLight directionLight = { glm::vec3(0.0f, 0.0f, 0.0f) };
 
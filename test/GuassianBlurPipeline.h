@@ -9,10 +9,11 @@
 #include "app/events/WindowEvent.h"
 #include "app/render-pipeline/IRenderPipeline.h"
 #include "graphics/Frame.h"
+#include "graphics/GpuTimer.h"
 #include "graphics/Mesh.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderManager.h"
-#include "graphics/Texture2D.h"
+#include "graphics/Texture2d.h"
 
 namespace RyuRenderer::App::RenderPipeline
 {
@@ -56,7 +57,7 @@ namespace RyuRenderer::App::RenderPipeline
             // 加载场景贴图
             sceneTexture = Graphics::Texture2d("res/textures/cantarella.jpg", 0);
 
-            simpleShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/2d-texture-vp.vert", "res/shaders/2d-texture-vp.frag");
+            simpleShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/2d-texture-vp.vert", "res/shaders/2d-texture-vp.frag");
             if (simpleShader)
             {
                 simpleShader->Use();
@@ -76,7 +77,7 @@ namespace RyuRenderer::App::RenderPipeline
         void initOtherSettings()
         {
             // 加载 高斯模糊的 shader
-            gaussianBlurShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/2d-gaussian-blur.vert", "res/shaders/2d-gaussian-blur.frag");
+            gaussianBlurShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/2d-gaussian-blur.vert", "res/shaders/2d-gaussian-blur.frag");
             if (gaussianBlurShader)
             {
                 gaussianBlurShader->Use();
@@ -104,37 +105,46 @@ namespace RyuRenderer::App::RenderPipeline
             frames[0].Use();
 
             // 渲染场景本身到 fbo 里面
-            sceneTexture.Use();
-            simpleShader->Use();
-            sceneMesh.Draw();
+            {
+                RYU_PROFILE_GPU_PASS("GaussianBlur::Scene");
+                sceneTexture.Use();
+                simpleShader->Use();
+                sceneMesh.Draw();
+            }
 
             // 进行高斯模糊，水平+垂直共迭代 5 次
-            gaussianBlurShader->Use();
             bool horizontal = true, firstIteration = true;
-            constexpr int amount = 30; // 模糊迭代次数
-            for (unsigned int i = 0; i < amount; ++i)
             {
-                frames[horizontal].Use();
-                if (firstIteration)
-                    sceneTexture.Use();
-                else
-                    frameTextures[!horizontal].Use();
-                gaussianBlurShader->SetUniform("isHorizontal", horizontal);
-
-                // 渲染全屏四边形到 fbo 里
-                fullScreenQuadMesh.Draw();
-
-                // 状态管理
-                horizontal = !horizontal;
-                if (firstIteration)
-                    firstIteration = false;
+                RYU_PROFILE_GPU_PASS("GaussianBlur::PingPong");
+                gaussianBlurShader->Use();
+                constexpr int amount = 30; // 模糊迭代次数
+                for (unsigned int i = 0; i < amount; ++i)
+                {
+                    frames[horizontal].Use();
+                    if (firstIteration)
+                        sceneTexture.Use();
+                    else
+                        frameTextures[!horizontal].Use();
+                    gaussianBlurShader->SetUniform("isHorizontal", horizontal);
+
+                    // 渲染全屏四边形到 fbo 里
+                    fullScreenQuadMesh.Draw();
+
+                    // 状态管理
+                    horizontal = !horizontal;
+                    if (firstIteration)
+                        firstIteration = false;
+                }
             }
             Graphics::Frame::Unuse();
 
             // 把最后一次渲染出的 fbo 纹理作为结果输出到 OpenGl 画布上
-            frameTextures[!horizontal].Use();
-            simpleShader->Use();
-            fullScreenQuadMesh.Draw();
+            {
+                RYU_PROFILE_GPU_PASS("GaussianBlur::Present");
+                frameTextures[!horizontal].Use();
+                simpleShader->Use();
+                fullScreenQuadMesh.Draw();
+            }
         }
 
         void OnWindowResize(const Events::WindowEvent& e)
@@ -22,6 +22,11 @@ namespace RyuRenderer::App::RenderPipeline
     public:
         ModelViewPhongBlinnPipeline() = default;
 
+        explicit ModelViewPhongBlinnPipeline(bool isMeshCompressed)
+        {
+            MainScene.MeshImportCompression.IsEnabled = isMeshCompressed;
+        }
+
         void Init() override
         {
             // init camera
@@ -16,7 +16,7 @@
 #include "graphics/Mesh.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderManager.h"
-#include "graphics/Texture2D.h"
+#include "graphics/Texture2d.h"
 #include "graphics/scene/Camera.h"
 
 namespace RyuRenderer::App::RenderPipeline
@@ -162,10 +162,10 @@ namespace RyuRenderer::App::RenderPipeline
             );
 
             // init light shader
-            lightShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
+            lightShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
 
             // init box shader
-            boxShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-blinn-phong-light.vert", "res/shaders/3d-blinn-phong-light.frag");
+            boxShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-blinn-phong-light.vert", "res/shaders/3d-blinn-phong-light.frag");
 
             // init mvp
             view = camera.GetView();
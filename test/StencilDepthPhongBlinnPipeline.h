@@ -14,15 +14,19 @@
 #include "app/events/KeyEvent.h"
 #include "app/render-pipeline/IRenderPipeline.h"
 #include "graphics/Frame.h"
+#include "graphics/GpuTimer.h"
 #include "graphics/Mesh.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderManager.h"
-#include "graphics/Texture2D.h"
+#include "graphics/Texture2d.h"
 #include "graphics/TextureManager.h"
+#include "graphics/UniformBuffer.h"
+#include "graphics/device/StateTracker.h"
 #include "graphics/scene/Camera.h"
 #include "graphics/scene/DirectionalLight.h"
 #include "graphics/scene/Transform.h"
 #include "graphics/scene/Scene.h"
+#include "graphics/scene/SceneUniformBlocks.h"
 
 namespace RyuRenderer::App::RenderPipeline
 {
@@ -166,7 +170,7 @@ namespace RyuRenderer::App::RenderPipeline
                 boxEmission->Use();
 
             // init shader
-            boxShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-blinn-phong-material.vert", "res/shaders/3d-blinn-phong-material.frag");
+            boxShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-blinn-phong-material.vert", "res/shaders/3d-blinn-phong-material.frag");
             if (boxShader)
             {
                 boxShader->Use();
@@ -179,7 +183,11 @@ namespace RyuRenderer::App::RenderPipeline
                 boxShader->SetUniform("material.emission", 2);
                 boxShader->SetUniform("material.shininess", boxShininess);
             }
-            outlineShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
+
+            // init uniform buffers
+            frameUniformBuffer = Graphics::UniformBuffer(sizeof(Graphics::Scene::FrameUniformBlock), Graphics::Scene::FrameUniformBlock::BindingIdx);
+            lightsUniformBuffer = Graphics::UniformBuffer(sizeof(Graphics::Scene::LightsUniformBlock), Graphics::Scene::LightsUniformBlock::BindingIdx);
+            outlineShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-basic-color.vert", "res/shaders/3d-basic-color.frag");
             if (outlineShader)
             {
                 outlineShader->Use();
@@ -227,60 +235,74 @@ namespace RyuRenderer::App::RenderPipeline
             camera.OnTick(deltaTimeInS);
             view = camera.GetView();
 
-            glStencilMask(0x00);
+            // Upload per frame uniform blocks
+            Graphics::Scene::FrameUniformBlock frameBlock;
+            frameBlock.View = view;
+            frameBlock.Projection = projection;
+            frameUniformBuffer.Update(frameBlock);
+            frameUniformBuffer.Use();
+
+            Graphics::Scene::LightsUniformBlock lightsBlock;
+            lightsBlock.Set(view, directionLight, {}, {});
+            lightsUniformBuffer.Update(lightsBlock);
+            lightsUniformBuffer.Use();
+
+            auto& states = Graphics::Device::StateTracker::GetInstance();
+            states.StencilMask(0x00);
 
             // draw plane
-            const auto mp = planeTramsform.GetMatrix();
-            boxShader->Use();
-            boxShader->SetUniform("view", view);
-            boxShader->SetUniform("projection", projection);
-            boxShader->SetUniform("directionalLight.color", directionLight.Color);
-            boxShader->SetUniform("directionalLight.viewDirection", glm::transpose(glm::inverse(glm::mat3(view))) * directionLight.Transformer.GetFrontDirection());
-            glm::mat3 viewNormalMatrix = glm::transpose(glm::inverse(glm::mat3(view * mp)));
-            boxShader->SetUniform("model", mp);
-            boxShader->SetUniform("viewNormalMatrix", viewNormalMatrix);
-            for (size_t j = 0; j < boxMeshes.size(); ++j)
             {
-                boxMeshes[j].Draw();
+                RYU_PROFILE_GPU_PASS("StencilOutline::Plane");
+                const auto mp = planeTramsform.GetMatrix();
+                boxShader->Use();
+                glm::mat3 viewNormalMatrix = glm::transpose(glm::inverse(glm::mat3(view * mp)));
+                boxShader->SetUniform("model", mp);
+                boxShader->SetUniform("viewNormalMatrix", viewNormalMatrix);
+                for (size_t j = 0; j < boxMeshes.size(); ++j)
+                {
+                    boxMeshes[j].Draw();
+                }
             }
 
-            glStencilFunc(GL_ALWAYS, 1, 0xFF);
-            glStencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
-            glStencilMask(0xFF);
+            states.StencilFunc(GL_ALWAYS, 1, 0xFF);
+            states.StencilOp(GL_KEEP, GL_KEEP, GL_REPLACE);
+            states.StencilMask(0xFF);
 
             // draw box a
-            const auto ma = boxATramsform.GetMatrix();
-            boxShader->Use();
-            boxShader->SetUniform("view", view);
-            boxShader->SetUniform("projection", projection);
-            boxShader->SetUniform("directionalLight.color", directionLight.Color);
-            boxShader->SetUniform("directionalLight.viewDirection", glm::transpose(glm::inverse(glm::mat3(view))) * directionLight.Transformer.GetFrontDirection());
-            viewNormalMatrix = glm::transpose(glm::inverse(glm::mat3(view * ma)));
-            boxShader->SetUniform("model", ma);
-            boxShader->SetUniform("viewNormalMatrix", viewNormalMatrix);
-            for (size_t j = 0; j < boxMeshes.size(); ++j)
             {
-                boxMeshes[j].Draw();
+                RYU_PROFILE_GPU_PASS("StencilOutline::Box");
+                const auto ma = boxATramsform.GetMatrix();
+                boxShader->Use();
+                glm::mat3 viewNormalMatrix = glm::transpose(glm::inverse(glm::mat3(view * ma)));
+                boxShader->SetUniform("model", ma);
+                boxShader->SetUniform("viewNormalMatrix", viewNormalMatrix);
+                for (size_t j = 0; j < boxMeshes.size(); ++j)
+                {
+                    boxMeshes[j].Draw();
+                }
             }
 
-            glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
-            glStencilMask(0x00);
-            glDisable(GL_DEPTH_TEST);
+            states.StencilFunc(GL_NOTEQUAL, 1, 0xFF);
+            states.StencilMask(0x00);
+            states.Disable(GL_DEPTH_TEST);
 
             // draw box b
-            const auto mb = boxBTramsform.GetMatrix();
-            outlineShader->Use();
-            outlineShader->SetUniform("view", view);
-            outlineShader->SetUniform("projection", projection);
-            outlineShader->SetUniform("model", mb);
-
-            for (size_t j = 0; j < boxMeshes.size(); ++j)
             {
-                boxMeshes[j].Draw();
+                RYU_PROFILE_GPU_PASS("StencilOutline::Outline");
+                const auto mb = boxBTramsform.GetMatrix();
+                outlineShader->Use();
+                outlineShader->SetUniform("view", view);
+                outlineShader->SetUniform("projection", projection);
+                outlineShader->SetUniform("model", mb);
+
+                for (size_t j = 0; j < boxMeshes.size(); ++j)
+                {
+                    boxMeshes[j].Draw();
+                }
             }
 
-            glEnable(GL_DEPTH_TEST);
-            glStencilMask(0xFF);
+            states.Enable(GL_DEPTH_TEST);
+            states.StencilMask(0xFF);
         }
     private:
         void OnWindowResize(const Events::WindowEvent& e)
@@ -307,6 +329,9 @@ namespace RyuRenderer::App::RenderPipeline
 
         std::vector<Graphics::Mesh> boxMeshes;
 
+        Graphics::UniformBuffer frameUniformBuffer;
+        Graphics::UniformBuffer lightsUniformBuffer;
+
         // lights
         Graphics::Scene::DirectionalLight directionLight = { glm::vec3(0.0f, 0.0f, 0.0f) };
 
@@ -16,7 +16,7 @@
 #include "graphics/Mesh.h"
 #include "graphics/Shader.h"
 #include "graphics/ShaderManager.h"
-#include "graphics/Texture2D.h"
+#include "graphics/Texture2d.h"
 #include "graphics/scene/Camera.h"
 
 namespace RyuRenderer::App::RenderPipeline
@@ -119,7 +119,7 @@ namespace RyuRenderer::App::RenderPipeline
             boxTexture = Graphics::Texture2d("res/textures/box.jpg", 0);
             boxTexture.Use();
 
-            boxShader = Graphics::ShaderManager::GetInstance().Create("res/shaders/3d-basic-texture.vert", "res/shaders/3d-basic-texture.frag");
+            boxShader = Graphics::ShaderManager::GetInstance().FindOrCreate("res/shaders/3d-basic-texture.vert", "res/shaders/3d-basic-texture.frag");
             if (boxShader)
             {
                 boxShader->Use();
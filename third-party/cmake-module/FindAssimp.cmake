@@ -38,5 +38,29 @@ if (NOT TARGET ASSIMP)
             IMPORTED_LOCATION_DEBUG ${ASSIMP_DLL}
             IMPORTED_LOCATION_RELEASE ${ASSIMP_DLL}
         )
+    else()
+        # Use the system package on other platforms
+        find_path(ASSIMP_INCLUDE_DIR
+            NAMES assimp/Importer.hpp)
+
+        find_library(ASSIMP_LIB
+            NAMES assimp)
+
+        if (ASSIMP_INCLUDE_DIR AND ASSIMP_LIB)
+            add_library(ASSIMP UNKNOWN IMPORTED)
+            set_target_properties(ASSIMP PROPERTIES
+                INTERFACE_INCLUDE_DIRECTORIES "${ASSIMP_INCLUDE_DIR}"
+                IMPORTED_LOCATION ${ASSIMP_LIB}
+            )
+        endif()
+    endif()
+endif()
+
+if (TARGET ASSIMP)
+    set(Assimp_FOUND TRUE)
+else()
+    set(Assimp_FOUND FALSE)
+    if (Assimp_FIND_REQUIRED)
+        message(FATAL_ERROR "Could not find Assimp, please install assimp development package.")
     endif()
 endif()
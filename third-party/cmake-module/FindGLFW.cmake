@@ -43,5 +43,33 @@ if (NOT TARGET GLFW)
             IMPORTED_LOCATION_DEBUG ${GLFW_DLL}
             IMPORTED_LOCATION_RELEASE ${GLFW_DLL}
         )
+    else()
+        # Use the system package on other platforms
+        set(GLFW_DEFINITIONS
+            "GLFW_INCLUDE_NONE"
+            CACHE INTERNAL "GLFW Definitions")
+
+        find_path(GLFW_INCLUDE_DIR
+            NAMES GLFW/glfw3.h)
+
+        find_library(GLFW_LIB
+            NAMES glfw glfw3)
+
+        if (GLFW_INCLUDE_DIR AND GLFW_LIB)
+            add_library(GLFW UNKNOWN IMPORTED)
+            set_target_properties(GLFW PROPERTIES
+                INTERFACE_INCLUDE_DIRECTORIES "${GLFW_INCLUDE_DIR}"
+                IMPORTED_LOCATION ${GLFW_LIB}
+            )
+        endif()
+    endif()
+endif()
+
+if (TARGET GLFW)
+    set(GLFW_FOUND TRUE)
+else()
+    set(GLFW_FOUND FALSE)
+    if (GLFW_FIND_REQUIRED)
+        message(FATAL_ERROR "Could not find GLFW, please install glfw3 development package.")
     endif()
 endif()
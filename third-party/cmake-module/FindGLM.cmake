@@ -14,15 +14,13 @@ set(PROJECT_ROOT ${GPD_RESULT})
 unset(GPD_RESULT)
 
 if (NOT TARGET GLM)
-    if(WIN32)
-        # Set source directory
-        set(SOURCE_DIR ${PROJECT_ROOT}/third-party/glm-1.0.1)
-        # Set include directories
-        set(INCLUDE_DIRS ${SOURCE_DIR}/include)
+    # Set source directory
+    set(SOURCE_DIR ${PROJECT_ROOT}/third-party/glm-1.0.1)
+    # Set include directories
+    set(INCLUDE_DIRS ${SOURCE_DIR}/include)
 
-        add_library(GLM INTERFACE IMPORTED)
-        set_target_properties(GLM PROPERTIES
-            INTERFACE_INCLUDE_DIRECTORIES "${INCLUDE_DIRS}"
-        )
-    endif()
+    add_library(GLM INTERFACE IMPORTED)
+    set_target_properties(GLM PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES "${INCLUDE_DIRS}"
+    )
 endif()
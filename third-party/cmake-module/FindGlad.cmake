@@ -14,19 +14,17 @@ set(PROJECT_ROOT ${GPD_RESULT})
 unset(GPD_RESULT)
 
 if (NOT TARGET Glad)
-    if(WIN32)
-        # Set source directory
-        set(SOURCE_DIR ${PROJECT_ROOT}/third-party/glad-2)
-        # Set include directories
-        set(INCLUDE_DIRS ${SOURCE_DIR}/include)
-        # Set source
-        set(GLAD_SRC_LIST
-            ${SOURCE_DIR}/src/glad.cpp
-            CACHE INTERNAL "GLFW Source list")
+    # Set source directory
+    set(SOURCE_DIR ${PROJECT_ROOT}/third-party/glad-2)
+    # Set include directories
+    set(INCLUDE_DIRS ${SOURCE_DIR}/include)
+    # Set source
+    set(GLAD_SRC_LIST
+        ${SOURCE_DIR}/src/glad.cpp
+        CACHE INTERNAL "GLFW Source list")
 
-        add_library(Glad INTERFACE IMPORTED)
-        set_target_properties(Glad PROPERTIES
-            INTERFACE_INCLUDE_DIRECTORIES "${INCLUDE_DIRS}"
-        )
-    endif()
+    add_library(Glad INTERFACE IMPORTED)
+    set_target_properties(Glad PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES "${INCLUDE_DIRS}"
+    )
 endif()
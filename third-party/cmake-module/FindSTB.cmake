@@ -14,19 +14,17 @@ set(PROJECT_ROOT ${GPD_RESULT})
 unset(GPD_RESULT)
 
 if (NOT TARGET STB)
-    if(WIN32)
-        # Set source directory
-        set(SOURCE_DIR ${PROJECT_ROOT}/third-party/stb)
-        # Set include directories
-        set(INCLUDE_DIRS ${SOURCE_DIR}/include)
-        # Set source
-        set(STB_SRC_LIST
-            ${SOURCE_DIR}/src/stb_image.cpp
-            CACHE INTERNAL "STB Source list")
+    # Set source directory
+    set(SOURCE_DIR ${PROJECT_ROOT}/third-party/stb)
+    # Set include directories
+    set(INCLUDE_DIRS ${SOURCE_DIR}/include)
+    # Set source
+    set(STB_SRC_LIST
+        ${SOURCE_DIR}/src/stb_image.cpp
+        CACHE INTERNAL "STB Source list")
 
-        add_library(STB INTERFACE IMPORTED)
-        set_target_properties(STB PROPERTIES
-            INTERFACE_INCLUDE_DIRECTORIES "${INCLUDE_DIRS}"
-        )
-    endif()
+    add_library(STB INTERFACE IMPORTED)
+    set_target_properties(STB PROPERTIES
+        INTERFACE_INCLUDE_DIRECTORIES "${INCLUDE_DIRS}"
+    )
 endif()